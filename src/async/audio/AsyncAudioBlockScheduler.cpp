@@ -0,0 +1,816 @@
+/**
+@file   AsyncAudioBlockScheduler.cpp
+@brief  Run a segment of an audio graph in fixed size blocks
+@author agent
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <iostream>
+#include <cstring>
+#include <climits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncFdWatch.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioBlockScheduler.h"
+#include "AsyncAudioProcessor.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+class Async::AudioBlockScheduler::Node
+{
+  public:
+    std::vector<float>  buf;
+    std::vector<Node*>  inputs;
+
+    explicit Node(unsigned block_size) : buf(block_size, 0.0f) {}
+    virtual ~Node(void) {}
+    virtual unsigned maxInputs(void) const { return 1; }
+    virtual void process(unsigned len) = 0;
+
+  protected:
+    const float *inputBuf(unsigned len)
+    {
+      if (inputs.empty())
+      {
+        std::fill(buf.begin(), buf.begin()+len, 0.0f);
+        return buf.data();
+      }
+      return inputs.front()->buf.data();
+    }
+};
+
+
+class Async::AudioBlockScheduler::InputNode
+  : public AudioBlockScheduler::Node, public AudioSink
+{
+  public:
+    static const unsigned FIFO_BLOCKS = 4;
+
+    InputNode(AudioBlockScheduler *sched, unsigned block_size)
+      : Node(block_size), sched(sched), fifo(FIFO_BLOCKS * block_size),
+        head(0), cnt(0), is_active(false), do_flush(false), stopped(false)
+    {
+    }
+
+    unsigned maxInputs(void) const override { return 0; }
+    void process(unsigned) override {}
+
+    int writeSamples(const float *samples, int count) override
+    {
+      is_active = true;
+      do_flush = false;
+      unsigned space = fifo.size() - cnt;
+      unsigned n = std::min(static_cast<unsigned>(count), space);
+      unsigned tail = (head + cnt) % fifo.size();
+      unsigned first = std::min(n, static_cast<unsigned>(fifo.size() - tail));
+      memcpy(&fifo[tail], samples, first * sizeof(float));
+      memcpy(&fifo[0], samples + first, (n - first) * sizeof(float));
+      cnt += n;
+      if (n < static_cast<unsigned>(count))
+      {
+        stopped = true;
+      }
+      sched->schedule();
+      return n;
+    }
+
+    void flushSamples(void) override
+    {
+      do_flush = true;
+      sched->schedule();
+    }
+
+    bool isStreaming(void) const { return is_active && !do_flush; }
+    unsigned available(void) const { return cnt; }
+
+    void readBlock(unsigned len)
+    {
+      unsigned n = std::min(len, cnt);
+      unsigned first = std::min(n, static_cast<unsigned>(fifo.size() - head));
+      memcpy(&buf[0], &fifo[head], first * sizeof(float));
+      memcpy(&buf[first], &fifo[0], (n - first) * sizeof(float));
+      std::fill(buf.begin()+n, buf.begin()+len, 0.0f);
+      head = (head + n) % fifo.size();
+      cnt -= n;
+      if (stopped && (n > 0))
+      {
+        stopped = false;
+        sourceResumeOutput();
+      }
+    }
+
+    bool flushRequested(void) const { return do_flush; }
+
+    void flushDone(void)
+    {
+      if (do_flush && (cnt == 0))
+      {
+        do_flush = false;
+        is_active = false;
+        sourceAllSamplesFlushed();
+      }
+    }
+
+  private:
+    AudioBlockScheduler * sched;
+    std::vector<float>    fifo;
+    unsigned              head;
+    unsigned              cnt;
+    bool                  is_active;
+    bool                  do_flush;
+    bool                  stopped;
+};
+
+
+class Async::AudioBlockScheduler::ProcessorNode
+  : public AudioBlockScheduler::Node
+{
+  public:
+    ProcessorNode(AudioProcessor *proc, unsigned block_size)
+      : Node(block_size), proc(proc)
+    {
+    }
+
+    void process(unsigned len) override
+    {
+      if (inputs.empty())
+      {
+        silence.resize(buf.size(), 0.0f);
+        proc->processBlock(buf.data(), silence.data(), len);
+      }
+      else
+      {
+        proc->processBlock(buf.data(), inputs.front()->buf.data(), len);
+      }
+    }
+
+  private:
+    AudioProcessor *    proc;
+    std::vector<float>  silence;
+};
+
+
+class Async::AudioBlockScheduler::MixerNode
+  : public AudioBlockScheduler::Node
+{
+  public:
+    explicit MixerNode(unsigned block_size) : Node(block_size) {}
+
+    unsigned maxInputs(void) const override { return UINT_MAX; }
+
+    void process(unsigned len) override
+    {
+      std::fill(buf.begin(), buf.begin()+len, 0.0f);
+      for (Node *input : inputs)
+      {
+        const float *src = input->buf.data();
+        for (unsigned i=0; i<len; ++i)
+        {
+          buf[i] += src[i];
+        }
+      }
+    }
+};
+
+
+class Async::AudioBlockScheduler::OutputNode
+  : public AudioBlockScheduler::Node, public AudioSource
+{
+  public:
+    OutputNode(AudioBlockScheduler *sched, unsigned block_size)
+      : Node(block_size), sched(sched), pos(0), cnt(0), is_flushed(true),
+        flush_pending(false)
+    {
+    }
+
+    void process(unsigned len) override
+    {
+      const float *src = inputBuf(len);
+      if (src != buf.data())
+      {
+        memcpy(buf.data(), src, len * sizeof(float));
+      }
+    }
+
+    bool isPending(void) const { return pos < cnt; }
+    bool isFlushed(void) const { return is_flushed; }
+
+    void writeBlock(unsigned len)
+    {
+      pos = 0;
+      cnt = len;
+      writeFromBuf();
+    }
+
+    void flush(void)
+    {
+      if (!is_flushed && !flush_pending)
+      {
+        flush_pending = true;
+        sinkFlushSamples();
+      }
+    }
+
+    void resumeOutput(void) override
+    {
+      writeFromBuf();
+      if (!isPending())
+      {
+        sched->schedule();
+      }
+    }
+
+    void allSamplesFlushed(void) override
+    {
+      if (flush_pending)
+      {
+        flush_pending = false;
+        is_flushed = true;
+        sched->outputFlushed();
+      }
+    }
+
+  private:
+    AudioBlockScheduler * sched;
+    unsigned              pos;
+    unsigned              cnt;
+    bool                  is_flushed;
+    bool                  flush_pending;
+
+    void writeFromBuf(void)
+    {
+      while (pos < cnt)
+      {
+        is_flushed = false;
+        flush_pending = false;
+        int written = sinkWriteSamples(&buf[pos], cnt - pos);
+        if (written <= 0)
+        {
+          break;
+        }
+        pos += written;
+      }
+    }
+};
+
+
+class Async::AudioBlockScheduler::Worker : public sigc::trackable
+{
+  public:
+    sigc::signal<void> blockProcessed;
+
+    explicit Worker(AudioBlockScheduler *sched)
+      : sched(sched), notify_pipe{-1, -1}, job(false), stop(false)
+    {
+    }
+
+    ~Worker(void)
+    {
+      if (thread.joinable())
+      {
+        {
+          std::lock_guard<std::mutex> lk(mutex);
+          stop = true;
+        }
+        cond.notify_one();
+        thread.join();
+      }
+      watch.setFd(-1, FdWatch::FD_WATCH_RD);
+      for (int fd : notify_pipe)
+      {
+        if (fd >= 0)
+        {
+          close(fd);
+        }
+      }
+    }
+
+    bool start(void)
+    {
+      if (pipe(notify_pipe) != 0)
+      {
+        cerr << "*** ERROR: Could not create audio block scheduler pipe: "
+             << strerror(errno) << endl;
+        return false;
+      }
+      fcntl(notify_pipe[0], F_SETFL, O_NONBLOCK);
+      watch.setFd(notify_pipe[0], FdWatch::FD_WATCH_RD);
+      watch.activity.connect(mem_fun(*this, &Worker::notificationReceived));
+      thread = std::thread(&Worker::threadFunc, this);
+      return true;
+    }
+
+    void process(void)
+    {
+      {
+        std::lock_guard<std::mutex> lk(mutex);
+        job = true;
+      }
+      cond.notify_one();
+    }
+
+  private:
+    AudioBlockScheduler *   sched;
+    int                     notify_pipe[2];
+    FdWatch                 watch;
+    std::thread             thread;
+    std::mutex              mutex;
+    std::condition_variable cond;
+    bool                    job;
+    bool                    stop;
+
+    void threadFunc(void)
+    {
+      std::unique_lock<std::mutex> lk(mutex);
+      for (;;)
+      {
+        cond.wait(lk, [this]{ return job || stop; });
+        if (job)
+        {
+          lk.unlock();
+          sched->processNodes();
+          lk.lock();
+          job = false;
+          char ch = 1;
+          ssize_t ret = write(notify_pipe[1], &ch, 1);
+          (void)ret;
+        }
+        else
+        {
+          break;
+        }
+      }
+    }
+
+    void notificationReceived(FdWatch *w)
+    {
+      char buf[16];
+      while (read(w->fd(), buf, sizeof(buf)) > 0)
+      {
+      }
+      blockProcessed();
+    }
+};
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+AudioBlockScheduler::AudioBlockScheduler(unsigned block_size)
+  : m_block_size(block_size), m_block_len(0), m_busy(false),
+    m_flushing(false), m_in_schedule(false), m_reschedule(false)
+{
+  assert(m_block_size > 0);
+} /* AudioBlockScheduler::AudioBlockScheduler */
+
+
+AudioBlockScheduler::~AudioBlockScheduler(void)
+{
+  m_worker.reset();
+} /* AudioBlockScheduler::~AudioBlockScheduler */
+
+
+AudioBlockScheduler::NodeId AudioBlockScheduler::addInput(void)
+{
+  InputNode *node = new InputNode(this, m_block_size);
+  m_inputs.push_back(node);
+  return addNode(node);
+} /* AudioBlockScheduler::addInput */
+
+
+AudioBlockScheduler::NodeId AudioBlockScheduler::addProcessor(
+    AudioProcessor *proc)
+{
+  assert(proc != 0);
+  return addNode(new ProcessorNode(proc, m_block_size));
+} /* AudioBlockScheduler::addProcessor */
+
+
+AudioBlockScheduler::NodeId AudioBlockScheduler::addMixer(void)
+{
+  return addNode(new MixerNode(m_block_size));
+} /* AudioBlockScheduler::addMixer */
+
+
+AudioBlockScheduler::NodeId AudioBlockScheduler::addOutput(void)
+{
+  OutputNode *node = new OutputNode(this, m_block_size);
+  m_outputs.push_back(node);
+  return addNode(node);
+} /* AudioBlockScheduler::addOutput */
+
+
+bool AudioBlockScheduler::connect(NodeId from, NodeId to)
+{
+  if ((from >= m_nodes.size()) || (to >= m_nodes.size()) || m_busy)
+  {
+    return false;
+  }
+  Node *to_node = m_nodes[to].get();
+  if (to_node->inputs.size() >= to_node->maxInputs())
+  {
+    return false;
+  }
+  to_node->inputs.push_back(m_nodes[from].get());
+  if (!sortNodes())
+  {
+    to_node->inputs.pop_back();
+    sortNodes();
+    return false;
+  }
+  return true;
+} /* AudioBlockScheduler::connect */
+
+
+AudioSink *AudioBlockScheduler::inputSink(NodeId id)
+{
+  if (id >= m_nodes.size())
+  {
+    return 0;
+  }
+  return dynamic_cast<InputNode*>(m_nodes[id].get());
+} /* AudioBlockScheduler::inputSink */
+
+
+AudioSource *AudioBlockScheduler::outputSource(NodeId id)
+{
+  if (id >= m_nodes.size())
+  {
+    return 0;
+  }
+  return dynamic_cast<OutputNode*>(m_nodes[id].get());
+} /* AudioBlockScheduler::outputSource */
+
+
+bool AudioBlockScheduler::setThreaded(bool threaded)
+{
+  if (threaded == isThreaded())
+  {
+    return true;
+  }
+
+  if (threaded)
+  {
+    std::unique_ptr<Worker> worker(new Worker(this));
+    if (!worker->start())
+    {
+      return false;
+    }
+    worker->blockProcessed.connect(
+        mem_fun(*this, &AudioBlockScheduler::blockProcessed));
+    m_worker = std::move(worker);
+  }
+  else
+  {
+      // Destroying the worker will wait for an ongoing block to finish
+    m_worker.reset();
+    if (m_busy)
+    {
+      blockProcessed();
+    }
+  }
+  return true;
+} /* AudioBlockScheduler::setThreaded */
+
+
+bool AudioBlockScheduler::isThreaded(void) const
+{
+  return m_worker != nullptr;
+} /* AudioBlockScheduler::isThreaded */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+AudioBlockScheduler::NodeId AudioBlockScheduler::addNode(Node *node)
+{
+  m_nodes.push_back(std::unique_ptr<Node>(node));
+  sortNodes();
+  return m_nodes.size() - 1;
+} /* AudioBlockScheduler::addNode */
+
+
+bool AudioBlockScheduler::sortNodes(void)
+{
+    // Kahn's algorithm. A node is put in the processing order when all
+    // nodes that it takes input from are already in the order.
+  std::vector<unsigned> indegree(m_nodes.size(), 0);
+  std::vector<std::vector<size_t>> consumers(m_nodes.size());
+  for (size_t i=0; i<m_nodes.size(); ++i)
+  {
+    for (Node *input : m_nodes[i]->inputs)
+    {
+      for (size_t j=0; j<m_nodes.size(); ++j)
+      {
+        if (m_nodes[j].get() == input)
+        {
+          consumers[j].push_back(i);
+          break;
+        }
+      }
+      indegree[i] += 1;
+    }
+  }
+
+  std::vector<size_t> ready;
+  for (size_t i=0; i<m_nodes.size(); ++i)
+  {
+    if (indegree[i] == 0)
+    {
+      ready.push_back(i);
+    }
+  }
+
+  std::vector<Node*> order;
+  order.reserve(m_nodes.size());
+  for (size_t pos=0; pos<ready.size(); ++pos)
+  {
+    size_t idx = ready[pos];
+    order.push_back(m_nodes[idx].get());
+    for (size_t consumer : consumers[idx])
+    {
+      if (--indegree[consumer] == 0)
+      {
+        ready.push_back(consumer);
+      }
+    }
+  }
+
+  if (order.size() != m_nodes.size())
+  {
+    return false;
+  }
+  m_order.swap(order);
+  return true;
+} /* AudioBlockScheduler::sortNodes */
+
+
+void AudioBlockScheduler::schedule(void)
+{
+  if (m_in_schedule)
+  {
+    m_reschedule = true;
+    return;
+  }
+
+  m_in_schedule = true;
+  do
+  {
+    m_reschedule = false;
+    while (runBlock())
+    {
+    }
+  } while (m_reschedule);
+  m_in_schedule = false;
+} /* AudioBlockScheduler::schedule */
+
+
+bool AudioBlockScheduler::runBlock(void)
+{
+  if (m_busy)
+  {
+    return false;
+  }
+
+  for (OutputNode *output : m_outputs)
+  {
+    if (output->isPending())
+    {
+      return false;
+    }
+  }
+
+    // A block is run when all streaming inputs have a full block. Inputs
+    // that are being flushed contribute the samples they have left.
+  bool streaming = false;
+  bool have_samples = false;
+  unsigned max_avail = 0;
+  for (InputNode *input : m_inputs)
+  {
+    if (input->isStreaming())
+    {
+      if (input->available() < m_block_size)
+      {
+        return false;
+      }
+      streaming = true;
+    }
+    have_samples |= (input->available() > 0);
+    max_avail = std::max(max_avail, input->available());
+  }
+
+  if (!have_samples)
+  {
+    checkFlush();
+    return false;
+  }
+
+  m_block_len = streaming ? m_block_size : std::min(m_block_size, max_avail);
+  for (InputNode *input : m_inputs)
+  {
+    input->readBlock(m_block_len);
+  }
+
+  if (m_worker != nullptr)
+  {
+    m_busy = true;
+    m_worker->process();
+    return false;
+  }
+
+  processNodes();
+  writeOutputs();
+  return true;
+} /* AudioBlockScheduler::runBlock */
+
+
+void AudioBlockScheduler::processNodes(void)
+{
+  for (Node *node : m_order)
+  {
+    node->process(m_block_len);
+  }
+} /* AudioBlockScheduler::processNodes */
+
+
+void AudioBlockScheduler::writeOutputs(void)
+{
+  m_flushing = false;
+  for (OutputNode *output : m_outputs)
+  {
+    output->writeBlock(m_block_len);
+  }
+} /* AudioBlockScheduler::writeOutputs */
+
+
+void AudioBlockScheduler::blockProcessed(void)
+{
+  m_busy = false;
+  writeOutputs();
+  schedule();
+} /* AudioBlockScheduler::blockProcessed */
+
+
+void AudioBlockScheduler::checkFlush(void)
+{
+  if (m_flushing)
+  {
+    return;
+  }
+
+  bool flush_requested = false;
+  for (InputNode *input : m_inputs)
+  {
+    flush_requested |= input->flushRequested();
+  }
+  if (!flush_requested)
+  {
+    return;
+  }
+
+  m_flushing = true;
+  for (OutputNode *output : m_outputs)
+  {
+    output->flush();
+  }
+  outputFlushed();
+} /* AudioBlockScheduler::checkFlush */
+
+
+void AudioBlockScheduler::outputFlushed(void)
+{
+  if (!m_flushing)
+  {
+    return;
+  }
+  for (OutputNode *output : m_outputs)
+  {
+    if (!output->isFlushed())
+    {
+      return;
+    }
+  }
+
+  m_flushing = false;
+  for (InputNode *input : m_inputs)
+  {
+    input->flushDone();
+  }
+} /* AudioBlockScheduler::outputFlushed */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,300 @@
+/**
+@file   AsyncAudioBlockScheduler.h
+@brief  Run a segment of an audio graph in fixed size blocks
+@author agent
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/** @example AsyncAudioBlockScheduler_demo.cpp
+An example of how to use the AudioBlockScheduler class
+*/
+
+#ifndef ASYNC_AUDIO_BLOCK_SCHEDULER_INCLUDED
+#define ASYNC_AUDIO_BLOCK_SCHEDULER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+
+#include <vector>
+#include <memory>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioSink.h>
+#include <AsyncAudioSource.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+class AudioProcessor;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  Run a segment of an audio graph in fixed size blocks
+@author agent
+@date   2026-10-18
+
+The normal audio graph is push driven. Each source write samples to its sink
+in whatever block size it happen to use and the call chain go all the way
+down the graph. This class is an optional alternative for a segment of the
+graph. Audio written to the segment inputs is collected into fixed size
+blocks, 20ms by default. When a full block is available on all active inputs,
+all nodes in the segment are run once, in topological order, each node
+writing its output into its own preallocated buffer. The resulting blocks are
+then written to the sinks connected to the segment outputs.
+
+A segment is built from four kinds of nodes:
+- An input node is an audio sink that the push driven graph write audio to
+- A processor node run an AudioProcessor, which must not change the sample
+  rate, on the output of one other node
+- A mixer node add together the output of any number of other nodes
+- An output node is an audio source that write the result of one other node
+  to the push driven graph
+
+An input that has been flushed, or that never got any audio, is inactive and
+contributes silence. When all inputs have been flushed, the remaining samples
+are processed as a short block and the flush is propagated to the outputs.
+If a sink connected to an output cannot take a whole block, no more blocks
+are processed until it resume output. Samples written to the inputs in the
+meantime are buffered, up to a few blocks, before the writer is stopped.
+
+Segments that do not depend on each other, like the audio chains of separate
+receivers, can each be moved to a worker thread using setThreaded. The
+processor and mixer nodes are then run in the worker thread while all
+interaction with the rest of the audio graph stay in the main thread. Only
+one block is processed at a time so audio processors that are used in a
+threaded segment must not be touched by anything else while the segment is
+running.
+
+\include AsyncAudioBlockScheduler_demo.cpp
+*/
+class AudioBlockScheduler : public sigc::trackable
+{
+  public:
+    typedef unsigned NodeId;
+
+    static const unsigned DEFAULT_BLOCK_SIZE = INTERNAL_SAMPLE_RATE / 50;
+
+    /**
+     * @brief   Constructor
+     * @param   block_size The number of samples in each block
+     */
+    explicit AudioBlockScheduler(unsigned block_size=DEFAULT_BLOCK_SIZE);
+
+    /**
+     * @brief   Destructor
+     */
+    ~AudioBlockScheduler(void);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    AudioBlockScheduler(const AudioBlockScheduler&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    AudioBlockScheduler& operator=(const AudioBlockScheduler&) = delete;
+
+    /**
+     * @brief   Get the block size
+     * @return  Returns the number of samples in each block
+     */
+    unsigned blockSize(void) const { return m_block_size; }
+
+    /**
+     * @brief   Add an input node
+     * @return  Returns the id of the new node
+     *
+     * Use the inputSink function to get the audio sink to connect to.
+     */
+    NodeId addInput(void);
+
+    /**
+     * @brief   Add a processor node
+     * @param   proc The audio processor to run
+     * @return  Returns the id of the new node
+     *
+     * The processor must not change the sample rate and it must not be
+     * connected to any other audio pipe components. The processor is not
+     * owned by the scheduler.
+     */
+    NodeId addProcessor(AudioProcessor *proc);
+
+    /**
+     * @brief   Add a mixer node
+     * @return  Returns the id of the new node
+     */
+    NodeId addMixer(void);
+
+    /**
+     * @brief   Add an output node
+     * @return  Returns the id of the new node
+     *
+     * Use the outputSource function to get the audio source to connect to.
+     */
+    NodeId addOutput(void);
+
+    /**
+     * @brief   Connect the output of one node to the input of another
+     * @param   from The node producing audio
+     * @param   to The node consuming audio
+     * @return  Returns \em true on success or else \em false
+     *
+     * Processor and output nodes can only have one input and input nodes
+     * can have none. Connections that would create a loop are not allowed.
+     */
+    bool connect(NodeId from, NodeId to);
+
+    /**
+     * @brief   Get the audio sink for an input node
+     * @param   id The id of the input node
+     * @return  Returns the audio sink or 0 if the node is not an input
+     */
+    AudioSink *inputSink(NodeId id);
+
+    /**
+     * @brief   Get the audio source for an output node
+     * @param   id The id of the output node
+     * @return  Returns the audio source or 0 if the node is not an output
+     */
+    AudioSource *outputSource(NodeId id);
+
+    /**
+     * @brief   Run the segment in a worker thread
+     * @param   threaded Set to \em true to use a worker thread
+     * @return  Returns \em true on success or else \em false
+     */
+    bool setThreaded(bool threaded);
+
+    /**
+     * @brief   Check if the segment is run in a worker thread
+     * @return  Returns \em true if a worker thread is used
+     */
+    bool isThreaded(void) const;
+
+  private:
+    class Node;
+    class InputNode;
+    class ProcessorNode;
+    class MixerNode;
+    class OutputNode;
+    class Worker;
+
+    const unsigned                      m_block_size;
+    std::vector<std::unique_ptr<Node>>  m_nodes;
+    std::vector<Node*>                  m_order;
+    std::vector<InputNode*>             m_inputs;
+    std::vector<OutputNode*>            m_outputs;
+    std::unique_ptr<Worker>             m_worker;
+    unsigned                            m_block_len;
+    bool                                m_busy;
+    bool                                m_flushing;
+    bool                                m_in_schedule;
+    bool                                m_reschedule;
+
+    NodeId addNode(Node *node);
+    bool sortNodes(void);
+    void schedule(void);
+    bool runBlock(void);
+    void processNodes(void);
+    void writeOutputs(void);
+    void blockProcessed(void);
+    void checkFlush(void);
+    void outputFlushed(void);
+
+    friend class InputNode;
+    friend class OutputNode;
+
+};  /* class AudioBlockScheduler */
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_BLOCK_SCHEDULER_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
@@ -208,6 +208,24 @@ class AudioContainer : public Async::AudioSink
      */
     virtual const char* header(void) { return nullptr; }
 
+    /**
+     * @brief   Write an already encoded audio packet to the container
+     * @param   buf Pointer to the encoded packet
+     * @param   len The size of the encoded packet
+     * @return  Returns \em true on success or else \em false
+     *
+     * This function makes it possible to store audio that have already been
+     * encoded using the codec of the container, e.g. audio received from the
+     * network, without decoding and encoding it again. The default
+     * implementation just return \em false to indicate that the container
+     * does not support pre-encoded packets. Do not mix calls to this function
+     * with writing samples to the container.
+     */
+    virtual bool writeEncodedPacket(const void *buf, size_t len)
+    {
+      return false;
+    }
+
     /**
      * @brief   A signal that is emitted when a block is ready to be written
      * @param   buf Pointer to a buffer containing the data block
@@ -30,6 +30,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <opus.h>
+
 #include <cstring>
 #include <iostream>
 
@@ -167,6 +169,18 @@ void AudioContainerOpus::endStream(void)
 } /* AudioContainerOpus::endStream */
 
 
+bool AudioContainerOpus::writeEncodedPacket(const void *buf, size_t len)
+{
+  int samples = opus_packet_get_nb_samples(
+      reinterpret_cast<const unsigned char*>(buf), len, 48000);
+  if (samples <= 0)
+  {
+    return false;
+  }
+  return addPacket(buf, len, samples);
+} /* AudioContainerOpus::writeEncodedPacket */
+
+
 /****************************************************************************
  *
  * Protected member functions
@@ -203,21 +217,24 @@ void AudioContainerOpus::onWriteEncodedSamples(const void *data, int len)
   //  return;
   //}
 
+  addPacket(data, len, (len > 0) ? 48000 * FRAME_SIZE / 1000 : 0);
+} /* AudioContainerOpus::onWriteEncodedSamples */
+
+
+bool AudioContainerOpus::addPacket(const void *data, int len, int samples)
+{
   m_packet.packet = const_cast<unsigned char*>(
       reinterpret_cast<const unsigned char*>(data));
   m_packet.bytes = len;
   //m_packet.b_o_s = 0;
   //m_packet.e_o_s = 0;
-  if (len > 0)
-  {
-    m_packet.granulepos += 48000 * FRAME_SIZE / 1000;
-  }
+  m_packet.granulepos += samples;
   m_packet.packetno += 1;
 
   if (ogg_stream_packetin(&m_ogg_stream, &m_packet) != 0)
   {
     std::cerr << "*** ERROR: Could not add Ogg packet to stream" << std::endl;
-    return;
+    return false;
   }
   m_pending_packets += 1;
 
@@ -246,8 +263,11 @@ void AudioContainerOpus::onWriteEncodedSamples(const void *data, int len)
   if (ogg_stream_check(&m_ogg_stream) != 0)
   {
     printf("### Ogg stream error\n");
+    return false;
   }
-} /* AudioContainerOpus::onWriteEncodedSamples */
+
+  return true;
+} /* AudioContainerOpus::addPacket */
 
 
 void AudioContainerOpus::oggpackWriteString(oggpack_buffer* oggbuf,
@@ -181,6 +181,17 @@ class AudioContainerOpus : public AudioContainer
      */
     virtual const char* header(void) { return m_header.data(); }
 
+    /**
+     * @brief   Write an already encoded Opus packet to the container
+     * @param   buf Pointer to the encoded packet
+     * @param   len The size of the encoded packet
+     * @return  Returns \em true on success or else \em false
+     *
+     * The duration of the packet is read from the packet itself so packets
+     * using any Opus frame size can be written.
+     */
+    virtual bool writeEncodedPacket(const void *buf, size_t len);
+
   protected:
 
   private:
@@ -199,6 +210,7 @@ class AudioContainerOpus : public AudioContainer
     AudioContainerOpus& operator=(const AudioContainerOpus&);
     void onWriteBlock(const char *buf, size_t len);
     void onWriteEncodedSamples(const void *data, int len);
+    bool addPacket(const void *data, int len, int samples);
     void oggpackWriteString(oggpack_buffer* oggbuf,
                             const char *str, int lenbits=32);
     void oggpackWriteCommentList(oggpack_buffer* oggbuf,
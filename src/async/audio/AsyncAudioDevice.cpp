@@ -59,6 +59,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "AsyncAudioIO.h"
 #include "AsyncAudioDevice.h"
 #include "AsyncAudioDeviceFactory.h"
+#include "AsyncAudioSampleConv.h"
 
 
 /****************************************************************************
@@ -266,19 +267,33 @@ AudioDevice::~AudioDevice(void)
 void AudioDevice::putBlocks(int16_t *buf, size_t frame_cnt)
 {
   //printf("putBlocks: frame_cnt=%zu\n", frame_cnt);
-  float samples[frame_cnt];
+  size_t sample_cnt = frame_cnt * channels;
+  if (rd_buf.size() < sample_cnt)
+  {
+    rd_buf.resize(sample_cnt);
+  }
+  sampleConvS16ToFloat(rd_buf.data(), buf, sample_cnt);
+  putBlocks(rd_buf.data(), frame_cnt);
+} /* AudioDevice::putBlocks */
+
+
+void AudioDevice::putBlocks(const float *buf, size_t frame_cnt)
+{
+  if (rd_chan_buf.size() < frame_cnt)
+  {
+    rd_chan_buf.resize(frame_cnt);
+  }
+  float *samples = rd_chan_buf.data();
   for (size_t ch=0; ch<channels; ch++)
   {
-    for (size_t i=0; i<frame_cnt; i++)
-    {
-        // no divisions in index calculation (embedded system performance !!!)
-      samples[i] = static_cast<float>(buf[i * channels + ch]) / 32768.0;
-    }
     list<AudioIO*>::iterator it;
     for (it=aios.begin(); it!=aios.end(); ++it)
     {
       if ((*it)->channel() == ch)
       {
+          // Extract the samples for each AudioIO object since the receiver
+          // is allowed to modify the buffer
+        sampleDeinterleave(samples, buf, frame_cnt, channels, ch);
         (*it)->audioRead(samples, frame_cnt);
       }
     }
@@ -287,10 +302,23 @@ void AudioDevice::putBlocks(int16_t *buf, size_t frame_cnt)
 
 
 size_t AudioDevice::getBlocks(int16_t *buf, size_t block_cnt)
+{
+  size_t sample_cnt = block_cnt * writeBlocksize() * channels;
+  if (wr_buf.size() < sample_cnt)
+  {
+    wr_buf.resize(sample_cnt);
+  }
+  size_t blocks = getBlocks(wr_buf.data(), block_cnt);
+  sampleConvFloatToS16(buf, wr_buf.data(), sample_cnt);
+  return blocks;
+} /* AudioDevice::getBlocks */
+
+
+size_t AudioDevice::getBlocks(float *buf, size_t block_cnt)
 {
   size_t block_size = writeBlocksize();
   size_t frames_to_write = block_cnt * block_size;
-  memset(buf, 0, channels * frames_to_write * sizeof(*buf));
+  fill_n(buf, channels * frames_to_write, 0.0f);
   
     // Loop through all AudioIO objects and find out if they have any
     // samples to write and how many. The non-flushing AudioIO object with
@@ -346,31 +374,20 @@ size_t AudioDevice::getBlocks(int16_t *buf, size_t block_cnt)
   }
   
     // Fill the sample buffer with samples from the non-idle AudioIO objects.
+    // Samples for the same channel are mixed.
+  if (wr_chan_buf.size() < frames_to_write)
+  {
+    wr_chan_buf.resize(frames_to_write);
+  }
+  float *tmp = wr_chan_buf.data();
   for (it=aios.begin(); it!=aios.end(); ++it)
   {
     if (!(*it)->isIdle())
     {
       size_t channel = (*it)->channel();
-      float tmp[frames_to_write];
       int samples_read = (*it)->readSamples(tmp, frames_to_write);
       assert(samples_read >= 0);
-      for (size_t i=0; i<static_cast<size_t>(samples_read); ++i)
-      {
-	int buf_pos = i * channels + channel;
-	float sample = 32767.0 * tmp[i] + buf[buf_pos];
-	if (sample > 32767)
-	{
-	  buf[buf_pos] = 32767;
-	}
-	else if (sample < -32767)
-	{
-	  buf[buf_pos] = -32767;
-	}
-	else
-	{
-	  buf[buf_pos] = static_cast<int16_t>(sample);
-	}
-      }
+      sampleInterleaveAdd(buf, tmp, samples_read, channels, channel);
     }
   }  
       
@@ -41,6 +41,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
 
 
 /****************************************************************************
@@ -339,6 +340,18 @@ class AudioDevice : public sigc::trackable
      */
     void putBlocks(int16_t *buf, size_t frame_cnt);
 
+    /**
+     * @brief   Write float samples read from audio device to upper layers
+     * @param   buf       Buffer containing frames of samples to write
+     * @param   frame_cnt The number of frames of samples in the buffer
+     *
+     * This function work in the same way as the function above but the
+     * samples are given as floats in the range [-1.0, 1.0]. It can be used
+     * by audio device implementations that convert the samples themselves,
+     * e.g. directly from a memory mapped hardware buffer.
+     */
+    void putBlocks(const float *buf, size_t frame_cnt);
+
     /**
      * @brief   Read samples from upper layers to write to audio device
      * @brief   buf       Buffer which will be filled with frames of samples
@@ -354,6 +367,18 @@ class AudioDevice : public sigc::trackable
      */
     size_t getBlocks(int16_t *buf, size_t block_cnt);
 
+    /**
+     * @brief   Read float samples from upper layers to write to audio device
+     * @brief   buf       Buffer which will be filled with frames of samples
+     * @brief   block_cnt The size of the buffer counted in blocks
+     * @return  The number of blocks actually stored in the buffer
+     *
+     * This function work in the same way as the function above but the
+     * samples are stored as floats. The samples are not clipped so the
+     * caller must clip them when converting to the hardware sample format.
+     */
+    size_t getBlocks(float *buf, size_t block_cnt);
+
   private:
     static const int    DEFAULT_SAMPLE_RATE = INTERNAL_SAMPLE_RATE;
     static const size_t DEFAULT_CHANNELS = 2;
@@ -365,6 +390,10 @@ class AudioDevice : public sigc::trackable
     Mode      	      	current_mode;
     size_t              use_count;
     std::list<AudioIO*> aios;
+    std::vector<float>  rd_buf;
+    std::vector<float>  rd_chan_buf;
+    std::vector<float>  wr_buf;
+    std::vector<float>  wr_chan_buf;
 
 };  /* class AudioDevice */
 
@@ -59,6 +59,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "AsyncAudioDeviceAlsa.h"
 #include "AsyncAudioDeviceFactory.h"
+#include "AsyncAudioSampleConv.h"
 
 
 
@@ -195,7 +196,9 @@ AudioDeviceAlsa::AudioDeviceAlsa(const std::string& dev_name)
   : AudioDevice(dev_name), play_block_size(0), play_block_count(0),
     rec_block_size(0), rec_block_count(0), play_handle(0), 
     rec_handle(0), play_watch(0), rec_watch(0), duplex(false),
-    zerofill_on_underflow(true)
+    zerofill_on_underflow(true), use_mmap(false), play_mmap(false),
+    rec_mmap(false), play_format(SND_PCM_FORMAT_S16_LE),
+    rec_format(SND_PCM_FORMAT_S16_LE)
 {
   assert(AudioDeviceAlsa_creator_registered);
 
@@ -205,6 +208,12 @@ AudioDeviceAlsa::AudioDeviceAlsa(const std::string& dev_name)
     istringstream(zerofill_str) >> zerofill_on_underflow;
   }
 
+  char *mmap_str = getenv("ASYNC_AUDIO_ALSA_MMAP");
+  if (mmap_str != 0)
+  {
+    istringstream(mmap_str) >> use_mmap;
+  }
+
   snd_pcm_t *play, *capture;
 
     // Open the device to check its duplex capability
@@ -313,7 +322,7 @@ bool AudioDeviceAlsa::openDevice(Mode mode)
       return false;
     }
 
-    if (!initParams(play_handle))
+    if (!initParams(play_handle, play_mmap, play_format))
     {
       closeDevice();
       return false;
@@ -350,7 +359,7 @@ bool AudioDeviceAlsa::openDevice(Mode mode)
       return false;
     }
 
-    if (!initParams(rec_handle))
+    if (!initParams(rec_handle, rec_mmap, rec_format))
     {
       closeDevice();
       return false;
@@ -434,6 +443,15 @@ void AudioDeviceAlsa::audioReadHandler(FdWatch *watch, unsigned short revents)
     frames_avail /= rec_block_size;
     frames_avail *= rec_block_size;
 
+    if (rec_mmap)
+    {
+      if (!mmapRead(frames_avail) && !startCapture(rec_handle))
+      {
+        watch->setEnabled(false);
+      }
+      return;
+    }
+
     int16_t buf[frames_avail * channels];
     memset(buf, 0, sizeof(buf));
 
@@ -488,6 +506,42 @@ void AudioDeviceAlsa::writeSpaceAvailable(FdWatch *watch, unsigned short revents
       return;
     }
 
+    if (play_mmap)
+    {
+      size_t sample_cnt = blocks_to_read * play_block_size * channels;
+      if (play_buf.size() < sample_cnt)
+      {
+        play_buf.resize(sample_cnt);
+      }
+        // The buffer is zeroed by getBlocks so zero filling an underflow
+        // just means writing one block of what is already in the buffer
+      int blocks_avail = getBlocks(play_buf.data(), blocks_to_read);
+      if (blocks_avail == 0)
+      {
+        if (!zerofill_on_underflow)
+        {
+          watch->setEnabled(false);
+          return;
+        }
+        blocks_avail = 1;
+      }
+      snd_pcm_uframes_t frames_to_write = blocks_avail * play_block_size;
+      if (!mmapWrite(play_buf.data(), frames_to_write))
+      {
+        if (!startPlayback(play_handle))
+        {
+          watch->setEnabled(false);
+          return;
+        }
+        continue;
+      }
+      if (frames_to_write != static_cast<snd_pcm_uframes_t>(space_avail))
+      {
+        return;
+      }
+      continue;
+    }
+
     int16_t buf[space_avail * channels];
         
     int blocks_avail = getBlocks(buf, blocks_to_read);
@@ -537,7 +591,8 @@ void AudioDeviceAlsa::writeSpaceAvailable(FdWatch *watch, unsigned short revents
 }
 
 
-bool AudioDeviceAlsa::initParams(snd_pcm_t *pcm_handle)
+bool AudioDeviceAlsa::initParams(snd_pcm_t *pcm_handle, bool &mmap,
+                                 snd_pcm_format_t &format)
 {
   snd_pcm_hw_params_t *hw_params;
 
@@ -560,19 +615,43 @@ bool AudioDeviceAlsa::initParams(snd_pcm_t *pcm_handle)
     return false;
   }
 
-  err = snd_pcm_hw_params_set_access(pcm_handle, hw_params,
-				     SND_PCM_ACCESS_RW_INTERLEAVED);
-  if (err < 0)
+  mmap = use_mmap;
+  if (mmap)
   {
-    cerr << "*** ERROR: Set access type failed: "
-	 << snd_strerror(err)
-	 << endl;
-    snd_pcm_hw_params_free (hw_params);
-    return false;
+    err = snd_pcm_hw_params_set_access(pcm_handle, hw_params,
+                                       SND_PCM_ACCESS_MMAP_INTERLEAVED);
+    if (err < 0)
+    {
+      cerr << "*** WARNING: Memory mapped access not supported by ALSA "
+              "device \"" << dev_name << "\" (" << snd_strerror(err)
+           << "). Falling back to read/write access." << endl;
+      mmap = false;
+    }
+  }
+
+  if (!mmap)
+  {
+    err = snd_pcm_hw_params_set_access(pcm_handle, hw_params,
+                                       SND_PCM_ACCESS_RW_INTERLEAVED);
+    if (err < 0)
+    {
+      cerr << "*** ERROR: Set access type failed: "
+           << snd_strerror(err)
+           << endl;
+      snd_pcm_hw_params_free (hw_params);
+      return false;
+    }
   }
 
-  err = snd_pcm_hw_params_set_format(pcm_handle, hw_params,
-				     SND_PCM_FORMAT_S16_LE);
+    // In mmap mode the samples are converted directly from/to the hardware
+    // buffer so devices that only support 32 bit samples can be used too
+  format = SND_PCM_FORMAT_S16_LE;
+  err = snd_pcm_hw_params_set_format(pcm_handle, hw_params, format);
+  if ((err < 0) && mmap)
+  {
+    format = SND_PCM_FORMAT_S32_LE;
+    err = snd_pcm_hw_params_set_format(pcm_handle, hw_params, format);
+  }
   if (err < 0)
   {
     cerr << "*** ERROR: Set sample format failed: "
@@ -794,6 +873,119 @@ bool AudioDeviceAlsa::startCapture(snd_pcm_t *pcm_handle)
 } /* AudioDeviceAlsa::startCapture */
 
 
+bool AudioDeviceAlsa::mmapRead(snd_pcm_uframes_t frame_cnt)
+{
+  size_t sample_cnt = frame_cnt * channels;
+  if (rec_buf.size() < sample_cnt)
+  {
+    rec_buf.resize(sample_cnt);
+  }
+
+    // The hardware buffer may wrap so it may take more than one round to
+    // read all frames
+  float *dest = rec_buf.data();
+  snd_pcm_uframes_t frames_left = frame_cnt;
+  while (frames_left > 0)
+  {
+    const snd_pcm_channel_area_t *areas;
+    snd_pcm_uframes_t offset;
+    snd_pcm_uframes_t frames = frames_left;
+    int err = snd_pcm_mmap_begin(rec_handle, &areas, &offset, &frames);
+    if ((err < 0) || (frames == 0))
+    {
+      return false;
+    }
+
+    const char *src = static_cast<const char *>(areas[0].addr) +
+                      (areas[0].first + offset * areas[0].step) / 8;
+    if (rec_format == SND_PCM_FORMAT_S32_LE)
+    {
+      sampleConvS32ToFloat(dest, reinterpret_cast<const int32_t *>(src),
+                           frames * channels);
+    }
+    else
+    {
+      sampleConvS16ToFloat(dest, reinterpret_cast<const int16_t *>(src),
+                           frames * channels);
+    }
+
+    snd_pcm_sframes_t committed = snd_pcm_mmap_commit(rec_handle, offset,
+                                                      frames);
+    if ((committed < 0) ||
+        (static_cast<snd_pcm_uframes_t>(committed) != frames))
+    {
+      return false;
+    }
+    dest += frames * channels;
+    frames_left -= frames;
+  }
+
+  putBlocks(rec_buf.data(), frame_cnt);
+
+  return true;
+} /* AudioDeviceAlsa::mmapRead */
+
+
+bool AudioDeviceAlsa::mmapWrite(const float *buf, snd_pcm_uframes_t frame_cnt)
+{
+  snd_pcm_uframes_t frames_left = frame_cnt;
+  while (frames_left > 0)
+  {
+    const snd_pcm_channel_area_t *areas;
+    snd_pcm_uframes_t offset;
+    snd_pcm_uframes_t frames = frames_left;
+    int err = snd_pcm_mmap_begin(play_handle, &areas, &offset, &frames);
+    if ((err < 0) || (frames == 0))
+    {
+      return false;
+    }
+
+    char *dest = static_cast<char *>(areas[0].addr) +
+                 (areas[0].first + offset * areas[0].step) / 8;
+    if (play_format == SND_PCM_FORMAT_S32_LE)
+    {
+      sampleConvFloatToS32(reinterpret_cast<int32_t *>(dest), buf,
+                           frames * channels);
+    }
+    else
+    {
+      sampleConvFloatToS16(reinterpret_cast<int16_t *>(dest), buf,
+                           frames * channels);
+    }
+
+    snd_pcm_sframes_t committed = snd_pcm_mmap_commit(play_handle, offset,
+                                                      frames);
+    if ((committed < 0) ||
+        (static_cast<snd_pcm_uframes_t>(committed) != frames))
+    {
+      return false;
+    }
+    buf += frames * channels;
+    frames_left -= frames;
+  }
+
+    // Unlike snd_pcm_writei, committing frames to the mmap buffer does not
+    // start the stream so we have to do that ourself when the start
+    // threshold has been reached
+  if (snd_pcm_state(play_handle) == SND_PCM_STATE_PREPARED)
+  {
+    snd_pcm_sframes_t space_avail = snd_pcm_avail_update(play_handle);
+    if (space_avail < 0)
+    {
+      return false;
+    }
+    size_t frames_in_buf = play_block_count * play_block_size - space_avail;
+    if ((frames_in_buf >= (play_block_count - 1) * play_block_size) &&
+        (snd_pcm_start(play_handle) < 0))
+    {
+      return false;
+    }
+  }
+
+  return true;
+} /* AudioDeviceAlsa::mmapWrite */
+
+
 /*
  * This file has not been truncated
  */
@@ -38,6 +38,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <alsa/asoundlib.h>
 
+#include <vector>
+
 
 /****************************************************************************
  *
@@ -197,16 +199,26 @@ class AudioDeviceAlsa : public AudioDevice
     AlsaWatch   *rec_watch;
     bool        duplex;
     bool        zerofill_on_underflow;
+    bool        use_mmap;
+    bool        play_mmap;
+    bool        rec_mmap;
+    snd_pcm_format_t    play_format;
+    snd_pcm_format_t    rec_format;
+    std::vector<float>  play_buf;
+    std::vector<float>  rec_buf;
 
     AudioDeviceAlsa(const AudioDeviceAlsa&);
     AudioDeviceAlsa& operator=(const AudioDeviceAlsa&);
     void audioReadHandler(FdWatch *watch, unsigned short revents);
     void writeSpaceAvailable(FdWatch *watch, unsigned short revents);
-    bool initParams(snd_pcm_t *pcm_handle);
+    bool initParams(snd_pcm_t *pcm_handle, bool &mmap,
+                    snd_pcm_format_t &format);
     bool getBlockAttributes(snd_pcm_t *pcm_handle, size_t &block_size,
                             size_t &period_size);
     bool startPlayback(snd_pcm_t *pcm_handle);
     bool startCapture(snd_pcm_t *pcm_handle);
+    bool mmapRead(snd_pcm_uframes_t frame_cnt);
+    bool mmapWrite(const float *buf, snd_pcm_uframes_t frame_cnt);
     
 };  /* class AudioDeviceAlsa */
 
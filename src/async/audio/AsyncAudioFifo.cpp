@@ -181,6 +181,32 @@ void AudioFifo::clear(void)
 } /* AudioFifo::clear */
 
 
+unsigned AudioFifo::discardSamples(unsigned count)
+{
+  count = min(count, samplesInFifo(true));
+  if (count == 0)
+  {
+    return 0;
+  }
+
+  tail = (tail + count) % fifo_size;
+  is_full = false;
+
+  if (input_stopped)
+  {
+    input_stopped = false;
+    sourceResumeOutput();
+  }
+
+  if (is_flushing && empty())
+  {
+    sinkFlushSamples();
+  }
+
+  return count;
+} /* AudioFifo::discardSamples */
+
+
 void AudioFifo::setPrebufSamples(unsigned prebuf_samples)
 {
   this->prebuf_samples = min(prebuf_samples, fifo_size-1);
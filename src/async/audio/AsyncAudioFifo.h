@@ -200,6 +200,17 @@ class AudioFifo : public AudioSink, public AudioSource
      */
     void clear(void);
 
+    /**
+     * @brief   Discard the oldest samples in the FIFO
+     * @param   count The number of samples to discard
+     * @return  Returns the number of samples actually discarded
+     *
+     * This function is used to throw away samples from the output end of
+     * the FIFO, e.g. to reduce the delay through it. If there are fewer
+     * samples in the FIFO than requested, all of them are discarded.
+     */
+    unsigned discardSamples(unsigned count);
+
     /**
      * @brief	Set the number of samples that must be in the fifo before
      *		any samples are written out from it.
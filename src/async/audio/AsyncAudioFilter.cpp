@@ -59,6 +59,7 @@ extern "C" {
 };
 
 #include "AsyncAudioFilter.h"
+#include "AsyncBiquadCascade.h"
 
 
 
@@ -96,8 +97,10 @@ namespace Async
       FidRun    	*run;
       FidFunc   	*func;
       void      	*buf;
+      BiquadCascade     sos;
+      bool              use_sos;
 
-      FidVars(void) : ff(0), run(0), func(0), buf(0) {}
+      FidVars(void) : ff(0), run(0), func(0), buf(0), use_sos(false) {}
   };
 };
 
@@ -125,6 +128,7 @@ namespace Async
  *
  ****************************************************************************/
 
+static bool sos_backend_enabled = true;
 
 
 /****************************************************************************
@@ -133,15 +137,27 @@ namespace Async
  *
  ****************************************************************************/
 
+void AudioFilter::setSosBackendEnabled(bool enable)
+{
+  sos_backend_enabled = enable;
+} /* AudioFilter::setSosBackendEnabled */
+
+
+bool AudioFilter::sosBackendEnabled(void)
+{
+  return sos_backend_enabled;
+} /* AudioFilter::sosBackendEnabled */
+
+
 AudioFilter::AudioFilter(int sample_rate)
-  : sample_rate(sample_rate), fv(0), output_gain(1.0f)
+  : sample_rate(sample_rate), fv(0), output_gain(1.0f), sos_gain(1.0)
 {
 
 } /* AudioFilter::AudioFilter */
 
 
 AudioFilter::AudioFilter(const string &filter_spec, int sample_rate)
-  : sample_rate(sample_rate), fv(0), output_gain(1.0f)
+  : sample_rate(sample_rate), fv(0), output_gain(1.0f), sos_gain(1.0)
 {
   if (!parseFilterSpec(filter_spec))
   {
@@ -162,7 +178,20 @@ bool AudioFilter::parseFilterSpec(const std::string &filter_spec)
   deleteFilter();
 
   fv = new FidVars;
-  
+
+    // First try to convert the filter to a cascade of second order
+    // sections. That will fail for filters that cannot be split into
+    // sections of order two or less. In that case, or if the filter
+    // specification is invalid, we fall back to running the filter using
+    // fidlib, which will also give us a proper error message.
+  if (sos_backend_enabled && fv->sos.parseFilterSpec(filter_spec, sample_rate))
+  {
+    fv->use_sos = true;
+    sos_gain = fv->sos.gain();
+    fv->sos.setGain(sos_gain * output_gain);
+    return true;
+  }
+
   char spec_buf[256];
   strncpy(spec_buf, filter_spec.c_str(), sizeof(spec_buf));
   spec_buf[sizeof(spec_buf) - 1] = 0;
@@ -186,11 +215,26 @@ bool AudioFilter::parseFilterSpec(const std::string &filter_spec)
 void AudioFilter::setOutputGain(float gain_db)
 {
   output_gain = powf(10.0f, gain_db / 20.0f);
+  if ((fv != 0) && fv->use_sos)
+  {
+    fv->sos.setGain(sos_gain * output_gain);
+  }
 } /* AudioFilter::setOutputGain */
 
 
+bool AudioFilter::usesSosBackend(void) const
+{
+  return (fv != 0) && fv->use_sos;
+} /* AudioFilter::usesSosBackend */
+
+
 void AudioFilter::reset(void)
 {
+  if (fv->use_sos)
+  {
+    fv->sos.reset();
+    return;
+  }
   fid_run_zapbuf(fv->buf);
 } /* AudioFilter::reset */
 
@@ -206,7 +250,13 @@ void AudioFilter::reset(void)
 void AudioFilter::processSamples(float *dest, const float *src, int count)
 {
   //cout << "AudioFilter::processSamples: len=" << len << endl;
-  
+
+  if (fv->use_sos)
+  {
+    fv->sos.process(dest, src, count);
+    return;
+  }
+
   for (int i=0; i<count; ++i)
   {
     dest[i] = output_gain * fv->func(fv->buf, src[i]);
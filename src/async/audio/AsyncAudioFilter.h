@@ -113,6 +113,24 @@ class FidVars;
 class AudioFilter : public AudioProcessor
 {
   public:
+    /**
+     * @brief   Enable or disable the second order sections backend
+     * @param   enable Set to \em true to enable the backend
+     *
+     * By default, filters that can be split into second order sections are
+     * run using the Async::BiquadCascade class, which is considerably faster
+     * than the generic fidlib filter engine. Disabling the backend will make
+     * all filters created after this call use fidlib. This is mostly useful
+     * for benchmarking and for comparing the output of the two engines.
+     */
+    static void setSosBackendEnabled(bool enable);
+
+    /**
+     * @brief   Check if the second order sections backend is enabled
+     * @return  Returns \em true if the backend is enabled
+     */
+    static bool sosBackendEnabled(void);
+
     /**
      * @brief 	Constuctor
      * @param 	sample_rate The sampling rate
@@ -171,6 +189,13 @@ class AudioFilter : public AudioProcessor
      * @brief Reset the filter state
      */
     void reset(void);
+
+    /**
+     * @brief   Check if the filter is run as second order sections
+     * @return  Returns \em true if the filter use the Async::BiquadCascade
+     *          backend or \em false if the fidlib engine is used
+     */
+    bool usesSosBackend(void) const;
     
     
   protected:
@@ -192,6 +217,7 @@ class AudioFilter : public AudioProcessor
     int         sample_rate;
     FidVars   	*fv;
     float     	output_gain;
+    double      sos_gain;
     std::string error_str;
     
     AudioFilter(const AudioFilter&);
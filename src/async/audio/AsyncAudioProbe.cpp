@@ -0,0 +1,251 @@
+/**
+@file   AsyncAudioProbe.cpp
+@brief  An audio pipe component used to profile an audio graph
+@author agent
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioProbe.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+AudioProbe::ProbeList AudioProbe::probes;
+AudioProbe* AudioProbe::active = nullptr;
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+namespace {
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+double toUs(AudioProbe::Clock::duration d)
+{
+  return std::chrono::duration<double, std::micro>(d).count();
+} /* toUs */
+
+
+}; /* End of anonymous namespace */
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+void AudioProbe::printAll(std::ostream& os)
+{
+  os << "--- Audio profiling statistics ---" << std::endl;
+  for (const auto& probe : probes)
+  {
+    probe->print(os);
+  }
+  os << "----------------------------------" << std::endl;
+} /* AudioProbe::printAll */
+
+
+void AudioProbe::resetAll(void)
+{
+  for (const auto& probe : probes)
+  {
+    probe->reset();
+  }
+} /* AudioProbe::resetAll */
+
+
+AudioProbe::AudioProbe(const std::string& name)
+  : m_name(name), m_reset_time(Clock::now())
+{
+  probes.push_back(this);
+} /* AudioProbe::AudioProbe */
+
+
+AudioProbe::~AudioProbe(void)
+{
+  probes.remove(this);
+} /* AudioProbe::~AudioProbe */
+
+
+void AudioProbe::reset(void)
+{
+  m_stats = Stats();
+  m_reset_time = Clock::now();
+} /* AudioProbe::reset */
+
+
+void AudioProbe::print(std::ostream& os) const
+{
+  double elapsed_s = std::chrono::duration<double>(
+      Clock::now() - m_reset_time).count();
+  double self_us = toUs(m_stats.self_time);
+  double load = (elapsed_s > 0.0) ? (self_us / (elapsed_s * 1e4)) : 0.0;
+  double us_per_ksamp = (m_stats.samples > 0)
+    ? (1000.0 * self_us / m_stats.samples) : 0.0;
+
+  std::ios_base::fmtflags flags(os.flags());
+  os << std::fixed << std::setprecision(1)
+     << m_name << ": "
+     << "calls=" << m_stats.calls
+     << " samples=" << m_stats.samples
+     << " self=" << self_us << "us"
+     << " total=" << toUs(m_stats.total_time) << "us"
+     << " max_call=" << toUs(m_stats.max_call_time) << "us"
+     << " us/ksamp=" << us_per_ksamp
+     << std::setprecision(3)
+     << " load=" << load << "%"
+     << " short_writes=" << m_stats.short_writes
+     << " resumes=" << m_stats.resumes
+     << " flushes=" << m_stats.flushes
+     << std::endl;
+  os.flags(flags);
+} /* AudioProbe::print */
+
+
+int AudioProbe::writeSamples(const float *samples, int count)
+{
+  AudioProbe* parent = active;
+  active = this;
+  Clock::duration prev_child_time = m_child_time;
+  m_child_time = Clock::duration::zero();
+
+  Clock::time_point start = Clock::now();
+  int ret = sinkWriteSamples(samples, count);
+  Clock::duration elapsed = Clock::now() - start;
+
+  m_stats.calls += 1;
+  m_stats.samples += ret;
+  if (ret < count)
+  {
+    m_stats.short_writes += 1;
+  }
+  m_stats.total_time += elapsed;
+  m_stats.self_time += elapsed - std::min(m_child_time, elapsed);
+  m_stats.max_call_time = std::max(m_stats.max_call_time, elapsed);
+
+    // Restore state in case of reentrant calls and account the time spent
+    // in this probe (and downstream probes) to the parent probe
+  m_child_time = prev_child_time;
+  active = parent;
+  if (active != nullptr)
+  {
+    active->m_child_time += elapsed;
+  }
+
+  return ret;
+} /* AudioProbe::writeSamples */
+
+
+void AudioProbe::flushSamples(void)
+{
+  m_stats.flushes += 1;
+  sinkFlushSamples();
+} /* AudioProbe::flushSamples */
+
+
+void AudioProbe::resumeOutput(void)
+{
+  m_stats.resumes += 1;
+  sourceResumeOutput();
+} /* AudioProbe::resumeOutput */
+
+
+void AudioProbe::allSamplesFlushed(void)
+{
+  sourceAllSamplesFlushed();
+} /* AudioProbe::allSamplesFlushed */
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+
+
+/*
+ * This file has not been truncated
+ */
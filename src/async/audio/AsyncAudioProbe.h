@@ -0,0 +1,257 @@
+/**
+@file   AsyncAudioProbe.h
+@brief  An audio pipe component used to profile an audio graph
+@author agent
+@date   2026-10-18
+
+This file contains a passthrough audio pipe component that collect statistics
+about the audio stream passing through it and the time spent in the audio pipe
+components connected after it.
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_PROBE_INCLUDED
+#define ASYNC_AUDIO_PROBE_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <list>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioSink.h>
+#include <AsyncAudioSource.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  An audio pipe component used to profile an audio graph
+@author agent
+@date   2026-10-18
+
+This class is a passthrough audio pipe component that can be inserted in front
+of one or more audio pipe components to measure how much time is spent
+processing the audio. It counts the number of calls and samples written,
+the number of short writes (backpressure from the sink) and the number of
+times that output was resumed by the sink.
+
+The time measured is the time spent in the components following the probe, up
+until the next probe in the chain. Time spent after a downstream probe is
+accounted to that probe. This makes it possible to put a probe in front of
+each stage in a long audio chain and get a per stage cost breakdown.
+
+All probes are registered in a global list so that the statistics for all
+probes in the application can be printed using the AudioProbe::printAll
+function.
+
+The probes are not thread safe. They must only be created, used, printed and
+reset in the main thread, that is the thread running the Async event loop. The
+audio paths that are run by worker threads, like the ones in the reflector UDP
+workers and the audio block scheduler, must not contain any probes.
+*/
+class AudioProbe : public AudioSink, public AudioSource
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief   A struct holding the collected statistics
+     */
+    struct Stats
+    {
+      uint64_t          calls         = 0;  ///< Calls to writeSamples
+      uint64_t          samples       = 0;  ///< Samples accepted by the sink
+      uint64_t          short_writes  = 0;  ///< Sink did not accept all
+      uint64_t          resumes       = 0;  ///< Calls to resumeOutput
+      uint64_t          flushes       = 0;  ///< Calls to flushSamples
+      Clock::duration   self_time     = Clock::duration::zero();
+      Clock::duration   total_time    = Clock::duration::zero();
+      Clock::duration   max_call_time = Clock::duration::zero();
+    };
+
+    /**
+     * @brief   Print statistics for all existing probes
+     * @param   os The stream to print to
+     */
+    static void printAll(std::ostream& os);
+
+    /**
+     * @brief   Reset the statistics for all existing probes
+     */
+    static void resetAll(void);
+
+    /**
+     * @brief   Constructor
+     * @param   name The name of this probe, used when printing statistics
+     */
+    explicit AudioProbe(const std::string& name);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    AudioProbe(const AudioProbe&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    AudioProbe& operator=(const AudioProbe&) = delete;
+
+    /**
+     * @brief   Destructor
+     */
+    virtual ~AudioProbe(void);
+
+    /**
+     * @brief   Get the name of this probe
+     * @return  Returns the name of this probe
+     */
+    const std::string& name(void) const { return m_name; }
+
+    /**
+     * @brief   Get the statistics collected so far
+     * @return  Returns the statistics for this probe
+     */
+    const Stats& stats(void) const { return m_stats; }
+
+    /**
+     * @brief   Reset the statistics for this probe
+     */
+    void reset(void);
+
+    /**
+     * @brief   Print the statistics for this probe
+     * @param   os The stream to print to
+     */
+    void print(std::ostream& os) const;
+
+    /**
+     * @brief   Write samples into this audio sink
+     * @param   samples The buffer containing the samples
+     * @param   count The number of samples in the buffer
+     * @return  Returns the number of samples that has been taken care of
+     */
+    virtual int writeSamples(const float *samples, int count);
+
+    /**
+     * @brief   Tell the sink to flush the previously written samples
+     */
+    virtual void flushSamples(void);
+
+    /**
+     * @brief   Resume audio output to the sink
+     */
+    virtual void resumeOutput(void);
+
+    /**
+     * @brief   The registered sink has flushed all samples
+     */
+    virtual void allSamplesFlushed(void);
+
+  private:
+    using ProbeList = std::list<AudioProbe*>;
+
+    static ProbeList    probes;
+    static AudioProbe*  active;
+
+    std::string         m_name;
+    Stats               m_stats;
+    Clock::time_point   m_reset_time;
+    Clock::duration     m_child_time = Clock::duration::zero();
+
+};  /* class AudioProbe */
+
+
+} /* namespace Async */
+
+#endif /* ASYNC_AUDIO_PROBE_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
@@ -37,6 +37,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <sigc++/sigc++.h>
 #include <string>
+#include <cassert>
 
 
 /****************************************************************************
@@ -150,6 +151,23 @@ class AudioProcessor : public AudioSink, public AudioSource, public sigc::tracka
      * @brief All samples have been flushed by the sink
      */
     void allSamplesFlushed(void);
+
+    /**
+     * @brief Process a block of samples outside of the audio chain
+     * @param dest  Destination buffer, at least count samples long
+     * @param src   Source buffer
+     * @param count Number of samples in the source buffer
+     *
+     * This function is used to run the processor without it being connected
+     * to an audio chain, e.g. by the AudioBlockScheduler. It can only be used
+     * for processors that do not change the sample rate and the processor
+     * must not be used in a normal audio chain at the same time.
+     */
+    void processBlock(float *dest, const float *src, int count)
+    {
+      assert(input_rate == output_rate);
+      processSamples(dest, src, count);
+    }
     
 
   protected:
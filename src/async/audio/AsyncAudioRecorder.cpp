@@ -56,6 +56,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include "AsyncAudioRecorder.h"
+#include "AsyncAudioContainer.h"
 
 
 
@@ -123,7 +124,7 @@ AudioRecorder::AudioRecorder(const string& filename,
 			     int sample_rate)
   : filename(filename), file(NULL), samples_written(0), format(fmt),
     sample_rate(sample_rate), max_samples(0), high_water_mark(0),
-    high_water_mark_reached(false)
+    high_water_mark_reached(false), container(0), write_failed(false)
 {
   timerclear(&begin_timestamp);
   timerclear(&end_timestamp);
@@ -140,6 +141,10 @@ AudioRecorder::AudioRecorder(const string& filename,
       {
         format = FMT_WAV;
       }
+      else if (ext == "opus")
+      {
+        format = FMT_OPUS;
+      }
     }
   }
 } /* AudioRecorder::AudioRecorder */
@@ -162,18 +167,40 @@ bool AudioRecorder::initialize(void)
     return false;
   }
   
+  long header_size = 0;
   if (format == FMT_WAV)
   {
-      // Leave room for the wave file header
-    if (fseek(file, WAVE_HEADER_SIZE, SEEK_SET) != 0)
+    header_size = WAVE_HEADER_SIZE;
+  }
+  else if (format == FMT_OPUS)
+  {
+      // The audio is encoded and paged by the Ogg/Opus audio container and
+      // then written to the file block by block
+    container = createAudioContainer("opus");
+    if (container == 0)
     {
-      setErrMsgFromErrno("fseek");
+      errmsg = "Ogg/Opus support not available";
       fclose(file);
       file = NULL;
       return false;
     }
+    container->writeBlock.connect(
+        sigc::mem_fun(*this, &AudioRecorder::writeContainerBlock));
+    header_size = container->headerSize();
+  }
+
+    // Leave room for the file header
+  if ((header_size > 0) && (fseek(file, header_size, SEEK_SET) != 0))
+  {
+    setErrMsgFromErrno("fseek");
+    delete container;
+    container = 0;
+    fclose(file);
+    file = NULL;
+    return false;
   }
   
+  write_failed = false;
   samples_written = 0;
   high_water_mark_reached = false;
   timerclear(&begin_timestamp);
@@ -201,6 +228,21 @@ bool AudioRecorder::closeFile(void)
     {
       success = writeWaveHeader();
     }
+    else if (container != 0)
+    {
+      container->endStream();
+      rewind(file);
+      if (!write_failed &&
+          (fwrite(container->header(), 1, container->headerSize(), file) !=
+           container->headerSize()))
+      {
+        setErrMsgFromErrno("fwrite");
+        write_failed = true;
+      }
+      success = !write_failed;
+      delete container;
+      container = 0;
+    }
     if (fclose(file) != 0)
     {
       setErrMsgFromErrno("fclose");
@@ -238,6 +280,19 @@ int AudioRecorder::writeSamples(const float *samples, int count)
     timersub(&end_timestamp, &block_time, &begin_timestamp);
   }
   
+  if (container != 0)
+  {
+    container->writeSamples(samples, count);
+    if (write_failed)
+    {
+      errorOccurred();
+      closeFile();
+      return count;
+    }
+    samples_written += count;
+    return checkRecordingLimits(count);
+  }
+
   short buf[count];
   for (int i=0; i<count; ++i)
   {
@@ -267,19 +322,7 @@ int AudioRecorder::writeSamples(const float *samples, int count)
   
   samples_written += written;
   
-  if ((high_water_mark > 0) && (samples_written >= high_water_mark))
-  {
-    high_water_mark = 0;
-    high_water_mark_reached = true;
-  }
-
-  if ((max_samples > 0) && (samples_written >= max_samples))
-  {
-    closeFile();
-    maxRecordingTimeReached();
-  }
-
-  return written;
+  return checkRecordingLimits(written);
 
 } /* AudioRecorder::writeSamples */
 
@@ -378,6 +421,24 @@ bool AudioRecorder::writeWaveHeader(void)
 } /* AudioRecorder::writeWaveHeader */
 
 
+int AudioRecorder::checkRecordingLimits(int written)
+{
+  if ((high_water_mark > 0) && (samples_written >= high_water_mark))
+  {
+    high_water_mark = 0;
+    high_water_mark_reached = true;
+  }
+
+  if ((max_samples > 0) && (samples_written >= max_samples))
+  {
+    closeFile();
+    maxRecordingTimeReached();
+  }
+
+  return written;
+} /* AudioRecorder::checkRecordingLimits */
+
+
 int AudioRecorder::store32bitValue(char *ptr, uint32_t val)
 {
   *ptr++ = val & 0xff;
@@ -408,6 +469,20 @@ void AudioRecorder::setErrMsgFromErrno(const std::string &fname)
 } /* AudioRecorder::setErrMsgFromErrno */
 
 
+void AudioRecorder::writeContainerBlock(const char *buf, size_t len)
+{
+  if (write_failed)
+  {
+    return;
+  }
+  if (fwrite(buf, 1, len, file) != len)
+  {
+    setErrMsgFromErrno("fwrite");
+    write_failed = true;
+  }
+} /* AudioRecorder::writeContainerBlock */
+
+
 
 /*
  * This file has not been truncated
@@ -84,6 +84,8 @@ namespace Async
  *
  ****************************************************************************/
 
+class AudioContainer;
+
   
 
 /****************************************************************************
@@ -114,12 +116,13 @@ namespace Async
 @date   2005-08-29
 
 Use this class to stream audio into a file. The audio is stored in raw format,
-(only samples no header) or WAV format.
+(only samples no header), WAV format or Ogg/Opus format. The Ogg/Opus format is
+only available if the Async library was compiled with Ogg and Opus support.
 */
 class AudioRecorder : public Async::AudioSink
 {
   public:
-    typedef enum { FMT_AUTO, FMT_RAW, FMT_WAV } Format;
+    typedef enum { FMT_AUTO, FMT_RAW, FMT_WAV, FMT_OPUS } Format;
     
     /**
      * @brief 	Default constuctor
@@ -257,13 +260,17 @@ class AudioRecorder : public Async::AudioSink
     struct timeval  begin_timestamp;
     struct timeval  end_timestamp;
     std::string     errmsg;
+    AudioContainer  *container;
+    bool            write_failed;
     
     AudioRecorder(const AudioRecorder&);
     AudioRecorder& operator=(const AudioRecorder&);
     bool writeWaveHeader(void);
+    int checkRecordingLimits(int written);
     int store32bitValue(char *ptr, uint32_t val);
     int store16bitValue(char *ptr, uint16_t val);
     void setErrMsgFromErrno(const std::string &fname);
+    void writeContainerBlock(const char *buf, size_t len);
 
 };  /* class AudioRecorder */
 
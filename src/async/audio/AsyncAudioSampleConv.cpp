@@ -0,0 +1,277 @@
+/**
+@file   AsyncAudioSampleConv.cpp
+@brief  Functions for converting and (de)interleaving audio samples
+@author agent
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SAMPLE_CONV_NEON
+#endif
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncAudioSampleConv.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+namespace {
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+  // The output scale is 32767, not 32768, to match the clipping level so
+  // that a full scale float sample never clip
+const float S16_IN_SCALE = 1.0f / 32768.0f;
+const float S16_OUT_SCALE = 32767.0f;
+const float S32_IN_SCALE = 1.0f / 2147483648.0f;
+const float S32_OUT_SCALE = 32767.0f * 65536.0f;
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+template <typename T>
+inline T clipAndTruncate(float sample, float max_val)
+{
+  return static_cast<T>(min(max(sample, -max_val), max_val));
+} /* clipAndTruncate */
+
+
+}; /* End of anonymous namespace */
+
+
+/****************************************************************************
+ *
+ * Exported functions
+ *
+ ****************************************************************************/
+
+void Async::sampleConvS16ToFloat(float *dest, const int16_t *src, size_t cnt)
+{
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128 scale = _mm_set1_ps(S16_IN_SCALE);
+  for (; i+8<=cnt; i+=8)
+  {
+    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+    __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+    _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    _mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+  }
+#elif defined(SAMPLE_CONV_NEON)
+  for (; i+8<=cnt; i+=8)
+  {
+    int16x8_t s = vld1q_s16(src + i);
+    float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+    float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+    vst1q_f32(dest + i, vmulq_n_f32(lo, S16_IN_SCALE));
+    vst1q_f32(dest + i + 4, vmulq_n_f32(hi, S16_IN_SCALE));
+  }
+#endif
+  for (; i<cnt; ++i)
+  {
+    dest[i] = static_cast<float>(src[i]) * S16_IN_SCALE;
+  }
+} /* sampleConvS16ToFloat */
+
+
+void Async::sampleConvFloatToS16(int16_t *dest, const float *src, size_t cnt)
+{
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128 scale = _mm_set1_ps(S16_OUT_SCALE);
+  const __m128 max_val = _mm_set1_ps(S16_OUT_SCALE);
+  const __m128 min_val = _mm_set1_ps(-S16_OUT_SCALE);
+  for (; i+8<=cnt; i+=8)
+  {
+    __m128 lo = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+    __m128 hi = _mm_mul_ps(_mm_loadu_ps(src + i + 4), scale);
+    lo = _mm_min_ps(_mm_max_ps(lo, min_val), max_val);
+    hi = _mm_min_ps(_mm_max_ps(hi, min_val), max_val);
+    __m128i s = _mm_packs_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), s);
+  }
+#elif defined(SAMPLE_CONV_NEON)
+  const float32x4_t max_val = vdupq_n_f32(S16_OUT_SCALE);
+  const float32x4_t min_val = vdupq_n_f32(-S16_OUT_SCALE);
+  for (; i+8<=cnt; i+=8)
+  {
+    float32x4_t lo = vmulq_n_f32(vld1q_f32(src + i), S16_OUT_SCALE);
+    float32x4_t hi = vmulq_n_f32(vld1q_f32(src + i + 4), S16_OUT_SCALE);
+    lo = vminq_f32(vmaxq_f32(lo, min_val), max_val);
+    hi = vminq_f32(vmaxq_f32(hi, min_val), max_val);
+    int16x8_t s = vcombine_s16(vqmovn_s32(vcvtq_s32_f32(lo)),
+                               vqmovn_s32(vcvtq_s32_f32(hi)));
+    vst1q_s16(dest + i, s);
+  }
+#endif
+  for (; i<cnt; ++i)
+  {
+    dest[i] = clipAndTruncate<int16_t>(src[i] * S16_OUT_SCALE, S16_OUT_SCALE);
+  }
+} /* sampleConvFloatToS16 */
+
+
+void Async::sampleConvS32ToFloat(float *dest, const int32_t *src, size_t cnt)
+{
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128 scale = _mm_set1_ps(S32_IN_SCALE);
+  for (; i+4<=cnt; i+=4)
+  {
+    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(s), scale));
+  }
+#elif defined(SAMPLE_CONV_NEON)
+  for (; i+4<=cnt; i+=4)
+  {
+    float32x4_t s = vcvtq_f32_s32(vld1q_s32(src + i));
+    vst1q_f32(dest + i, vmulq_n_f32(s, S32_IN_SCALE));
+  }
+#endif
+  for (; i<cnt; ++i)
+  {
+    dest[i] = static_cast<float>(src[i]) * S32_IN_SCALE;
+  }
+} /* sampleConvS32ToFloat */
+
+
+void Async::sampleConvFloatToS32(int32_t *dest, const float *src, size_t cnt)
+{
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128 scale = _mm_set1_ps(S32_OUT_SCALE);
+  const __m128 max_val = _mm_set1_ps(S32_OUT_SCALE);
+  const __m128 min_val = _mm_set1_ps(-S32_OUT_SCALE);
+  for (; i+4<=cnt; i+=4)
+  {
+    __m128 s = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+    s = _mm_min_ps(_mm_max_ps(s, min_val), max_val);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                     _mm_cvttps_epi32(s));
+  }
+#elif defined(SAMPLE_CONV_NEON)
+  const float32x4_t max_val = vdupq_n_f32(S32_OUT_SCALE);
+  const float32x4_t min_val = vdupq_n_f32(-S32_OUT_SCALE);
+  for (; i+4<=cnt; i+=4)
+  {
+    float32x4_t s = vmulq_n_f32(vld1q_f32(src + i), S32_OUT_SCALE);
+    s = vminq_f32(vmaxq_f32(s, min_val), max_val);
+    vst1q_s32(dest + i, vcvtq_s32_f32(s));
+  }
+#endif
+  for (; i<cnt; ++i)
+  {
+    dest[i] = clipAndTruncate<int32_t>(src[i] * S32_OUT_SCALE, S32_OUT_SCALE);
+  }
+} /* sampleConvFloatToS32 */
+
+
+void Async::sampleDeinterleave(float *dest, const float *src,
+                               size_t frame_cnt, size_t channels, size_t ch)
+{
+  if (channels == 1)
+  {
+    copy(src, src + frame_cnt, dest);
+    return;
+  }
+  src += ch;
+  for (size_t i=0; i<frame_cnt; ++i)
+  {
+    dest[i] = *src;
+    src += channels;
+  }
+} /* sampleDeinterleave */
+
+
+void Async::sampleInterleaveAdd(float *dest, const float *src,
+                                size_t frame_cnt, size_t channels, size_t ch)
+{
+  dest += ch;
+  for (size_t i=0; i<frame_cnt; ++i)
+  {
+    *dest += src[i];
+    dest += channels;
+  }
+} /* sampleInterleaveAdd */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,188 @@
+/**
+@file   AsyncAudioSampleConv.h
+@brief  Functions for converting and (de)interleaving audio samples
+@author agent
+@date   2026-10-18
+
+These functions are used by the audio device implementations to convert
+between the integer sample formats used by the hardware and the float format
+used internally. The conversion functions use SIMD instructions (SSE2 or NEON)
+when available.
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_AUDIO_SAMPLE_CONV_INCLUDED
+#define ASYNC_AUDIO_SAMPLE_CONV_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <cstddef>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Function declarations
+ *
+ ****************************************************************************/
+
+/**
+ * @brief   Convert 16 bit signed integer samples to float
+ * @param   dest  The destination buffer
+ * @param   src   The source buffer
+ * @param   cnt   The number of samples to convert
+ *
+ * The samples are scaled by 1/32768 so that full scale is in the range
+ * [-1.0, 1.0).
+ */
+void sampleConvS16ToFloat(float *dest, const int16_t *src, size_t cnt);
+
+/**
+ * @brief   Convert float samples to 16 bit signed integer
+ * @param   dest  The destination buffer
+ * @param   src   The source buffer
+ * @param   cnt   The number of samples to convert
+ *
+ * The samples are scaled by 32767 and clipped to [-32767, 32767]. Fractions
+ * are truncated.
+ */
+void sampleConvFloatToS16(int16_t *dest, const float *src, size_t cnt);
+
+/**
+ * @brief   Convert 32 bit signed integer samples to float
+ * @param   dest  The destination buffer
+ * @param   src   The source buffer
+ * @param   cnt   The number of samples to convert
+ *
+ * The samples are scaled by 1/2^31 so that full scale is in the range
+ * [-1.0, 1.0).
+ */
+void sampleConvS32ToFloat(float *dest, const int32_t *src, size_t cnt);
+
+/**
+ * @brief   Convert float samples to 32 bit signed integer
+ * @param   dest  The destination buffer
+ * @param   src   The source buffer
+ * @param   cnt   The number of samples to convert
+ *
+ * The samples are scaled and clipped to the same full scale as for the 16 bit
+ * conversion, shifted up 16 bits.
+ */
+void sampleConvFloatToS32(int32_t *dest, const float *src, size_t cnt);
+
+/**
+ * @brief   Extract one channel from interleaved samples
+ * @param   dest      The destination buffer, frame_cnt samples
+ * @param   src       The interleaved source buffer, frame_cnt frames
+ * @param   frame_cnt The number of frames
+ * @param   channels  The number of channels in each frame
+ * @param   ch        The channel to extract
+ */
+void sampleDeinterleave(float *dest, const float *src, size_t frame_cnt,
+                        size_t channels, size_t ch);
+
+/**
+ * @brief   Add one channel to interleaved samples
+ * @param   dest      The interleaved destination buffer, frame_cnt frames
+ * @param   src       The source buffer, frame_cnt samples
+ * @param   frame_cnt The number of frames
+ * @param   channels  The number of channels in each frame
+ * @param   ch        The channel to add the samples to
+ *
+ * The samples are added to what is already in the destination buffer so
+ * that multiple sources for the same channel are mixed.
+ */
+void sampleInterleaveAdd(float *dest, const float *src, size_t frame_cnt,
+                         size_t channels, size_t ch);
+
+
+} /* namespace */
+
+#endif /* ASYNC_AUDIO_SAMPLE_CONV_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2004-2015 Tobias Blomberg / SM0SVX
+Copyright (C) 2004-2022 Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -35,6 +35,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cassert>
 #include <cstring>
 #include <iostream>
+#include <deque>
+#include <vector>
 
 
 /****************************************************************************
@@ -84,19 +86,23 @@ using namespace Async;
 class Async::AudioSplitter::Branch : public AudioSource
 {
   public:
-    int   current_buf_pos;
     bool  is_flushed;
+    bool  flush_pending;
   
     Branch(AudioSplitter *splitter)
-      : current_buf_pos(0), is_flushed(true), is_enabled(true),
-	is_stopped(false), is_flushing(false), splitter(splitter)
+      : is_flushed(true), flush_pending(false), is_enabled(true),
+	is_stopped(false), is_flushing(false), backlog(0),
+	is_writing_queue(false), is_resume_pending(false), splitter(splitter)
     {
     }
     
     virtual ~Branch(void)
     {
-      if (is_stopped)
+      if (is_stopped || !queue.empty())
       {
+        is_stopped = false;
+        queue.clear();
+        backlog = 0;
       	splitter->branchResumeOutput();
       }
     }
@@ -111,7 +117,10 @@ class Async::AudioSplitter::Branch : public AudioSource
       
       if (!enabled)
       {
-	if (is_stopped)
+        bool had_backlog = !queue.empty();
+        queue.clear();
+        backlog = 0;
+	if (is_stopped || had_backlog)
 	{
 	  is_stopped = false;
 	  splitter->branchResumeOutput();
@@ -144,8 +153,6 @@ class Async::AudioSplitter::Branch : public AudioSource
       	is_stopped = (len == 0);
       }
       
-      current_buf_pos += len;
-      
       return len;
       
     } /* sinkWriteSamples */
@@ -163,13 +170,96 @@ class Async::AudioSplitter::Branch : public AudioSource
       	splitter->branchAllSamplesFlushed();
       }
     } /* sinkFlushSamples */
-    
+
+      /*
+       * Write a block of samples to this branch. Samples that the sink
+       * cannot take right now are kept in the branch queue, holding a
+       * reference to the shared block, so that other branches can go on.
+       * The block is only created, by copying the samples, the first time
+       * a branch need to queue samples.
+       */
+    void writeBlock(const float *samples, int len, SharedBlock &block)
+    {
+      int written = 0;
+      if (queue.empty())
+      {
+        written = sinkWriteSamples(samples, len);
+      }
+      if (written < len)
+      {
+        if (!block)
+        {
+          block = std::make_shared<const std::vector<float> >(
+              samples, samples + len);
+        }
+        queue.push_back(QueuedBlock(block, written));
+        backlog += len - written;
+      }
+    } /* writeBlock */
+
+      /*
+       * Write queued samples to the sink. The sink may call resumeOutput,
+       * and thereby this function, from within sinkWriteSamples. The queue
+       * is then written by the outer call when the sink returns. No
+       * reference into the queue is held across the write since the queue
+       * may also be cleared, e.g. if the branch is disabled.
+       */
+    void writeFromQueue(void)
+    {
+      if (is_writing_queue)
+      {
+        is_resume_pending = true;
+        return;
+      }
+      is_writing_queue = true;
+      do
+      {
+        is_resume_pending = false;
+        while (!queue.empty())
+        {
+          SharedBlock block = queue.front().block;
+          int pos = queue.front().pos;
+          int len = block->size() - pos;
+          int written = sinkWriteSamples(&(*block)[pos], len);
+          if (queue.empty() || (queue.front().block != block))
+          {
+            continue;
+          }
+          queue.front().pos += written;
+          backlog -= written;
+          if (written < len)
+          {
+            break;
+          }
+          queue.pop_front();
+        }
+      } while (is_resume_pending && !queue.empty());
+      is_writing_queue = false;
+    } /* writeFromQueue */
+
+    bool hasBacklog(void) const { return !queue.empty(); }
+    bool backlogFull(void) const { return backlog >= MAX_BACKLOG; }
 
   private:
-    bool      	  is_enabled;
-    bool      	  is_stopped;
-    bool      	  is_flushing;
-    AudioSplitter *splitter;
+      // The maximum number of queued samples before the input is stopped
+    static const int MAX_BACKLOG = INTERNAL_SAMPLE_RATE / 5;
+
+    struct QueuedBlock
+    {
+      SharedBlock block;
+      int         pos;
+      QueuedBlock(const SharedBlock &block, int pos)
+        : block(block), pos(pos) {}
+    };
+
+    bool      	              is_enabled;
+    bool      	              is_stopped;
+    bool      	              is_flushing;
+    std::deque<QueuedBlock>   queue;
+    int                       backlog;
+    bool                      is_writing_queue;
+    bool                      is_resume_pending;
+    AudioSplitter             *splitter;
   
     virtual void resumeOutput(void)
     {
@@ -227,8 +317,7 @@ class Async::AudioSplitter::Branch : public AudioSource
  ****************************************************************************/
 
 AudioSplitter::AudioSplitter(void)
-  : buf(0), buf_size(0), buf_len(0), do_flush(false), input_stopped(false),
-    flushed_branches(0), main_branch(0)
+  : do_flush(false), input_stopped(false), flushed_branches(0), main_branch(0)
 {
   main_branch = new Branch(this);
   branches.push_back(main_branch);
@@ -238,12 +327,11 @@ AudioSplitter::AudioSplitter(void)
 
 AudioSplitter::~AudioSplitter(void)
 {
-  delete [] buf;
   removeAllSinks();
   AudioSource::clearHandler();
+  branches.clear();
   delete main_branch;
   main_branch = 0;
-  branches.clear();
 } /* AudioSplitter::~AudioSplitter */
 
 
@@ -289,16 +377,17 @@ void AudioSplitter::removeSink(AudioSink *sink)
 
 void AudioSplitter::removeAllSinks(void)
 {
+  list<Branch *> old_branches;
+  old_branches.swap(branches);
+  branches.push_back(main_branch);
   list<Branch *>::iterator it;
-  for (it = branches.begin(); it != branches.end(); ++it)
+  for (it = old_branches.begin(); it != old_branches.end(); ++it)
   {
     if (*it != main_branch)
     {
       delete *it;
     }
   }
-  branches.clear();
-  branches.push_back(main_branch);
 } /* AudioSplitter::removeAllSinks */
 
 
@@ -330,38 +419,22 @@ int AudioSplitter::writeSamples(const float *samples, int len)
     return 0;
   }
   
-  if (buf_len > 0)
+  if (backlogFull())
   {
     input_stopped = true;
     return 0;
   }
   
-  bool samples_written = false;
-  
+    // All branches share the same block. It is only copied if at least
+    // one branch cannot take all samples right away.
+  SharedBlock block;
   list<Branch *>::iterator it;
   for (it = branches.begin(); it != branches.end(); ++it)
   {
-    (*it)->current_buf_pos = 0;
-    int written = (*it)->sinkWriteSamples(samples, len);
-    if (written != len)
-    {
-      if (buf_len == 0) // Only copy the buffer one time
-      {
-	if (buf_size < len)
-	{
-	  delete [] buf;
-          buf_size = len;
-	  buf = new float[buf_size];
-	}
-	memcpy(buf, samples, len * sizeof(*samples));
-	buf_len = len;
-      }
-    }
-    samples_written |= (written > 0);
+    (*it)->flush_pending = false;
+    (*it)->writeBlock(samples, len, block);
   }
   
-  writeFromBuffer();
-  
   return len;
   
 } /* AudioSplitter::writeSamples */
@@ -383,12 +456,12 @@ void AudioSplitter::flushSamples(void)
   do_flush = true;
   flushed_branches = 0;
   
-  if (buf_len > 0)
+  list<Branch *>::iterator it;
+  for (it = branches.begin(); it != branches.end(); ++it)
   {
-    return;
+    (*it)->flush_pending = true;
   }
-  
-  flushAllBranches();
+  flushDrainedBranches();
   
 } /* AudioSplitter::flushSamples */
 
@@ -427,71 +500,52 @@ void AudioSplitter::flushSamples(void)
  ****************************************************************************/
 
 
-/*
- *----------------------------------------------------------------------------
- * Method:    
- * Purpose:   
- * Input:     
- * Output:    
- * Author:    
- * Created:   
- * Remarks:   
- * Bugs:      
- *----------------------------------------------------------------------------
- */
-void AudioSplitter::writeFromBuffer(void)
+bool AudioSplitter::backlogFull(void) const
 {
-  bool samples_written = true;
-  bool all_written = (buf_len == 0);
-  
-  //cout << "samples_written=" << samples_written << "  all_written="
-    //   << all_written << endl;
-  
-  while (samples_written && !all_written)
+  list<Branch *>::const_iterator it;
+  for (it = branches.begin(); it != branches.end(); ++it)
   {
-    samples_written = false;
-    all_written = true;
-    list<Branch *>::iterator it;
-    for (it = branches.begin(); it != branches.end(); ++it)
+    if ((*it)->backlogFull())
     {
-      //cout << "(*it)->current_buf_pos=" << (*it)->current_buf_pos
-	//   << "  buf_len=" << buf_len << endl;
-      if ((*it)->current_buf_pos < buf_len)
-      {
-	int written = (*it)->sinkWriteSamples(buf+(*it)->current_buf_pos,
-	      	      	      	      	      buf_len-(*it)->current_buf_pos);
-	//cout << "written=" << written << endl;
-	samples_written |= (written > 0);
-	all_written &= ((*it)->current_buf_pos == buf_len);
-      }
-    }
-    
-    if (all_written)
-    {
-      buf_len = 0;
-      if (do_flush)
-      {
-	flushAllBranches();
-      }
+      return true;
     }
   }
-} /* AudioSplitter::writeFromBuffer */
+  return false;
+} /* AudioSplitter::backlogFull */
 
 
-void AudioSplitter::flushAllBranches(void)
+/*
+ * @brief: Flush branches that have written all their queued samples
+ *
+ * Each branch is flushed as soon as its own queue is empty so that a slow
+ * branch does not hold back the flush of the other branches.
+ */
+void AudioSplitter::flushDrainedBranches(void)
 {
   list<Branch *>::iterator it;
   for (it = branches.begin(); it != branches.end(); ++it)
   {
-    (*it)->sinkFlushSamples();
+    if ((*it)->flush_pending && !(*it)->hasBacklog())
+    {
+      (*it)->flush_pending = false;
+      (*it)->sinkFlushSamples();
+    }
   }
-} /* AudioSplitter::flushAllBranches */
+} /* AudioSplitter::flushDrainedBranches */
 
 
 void AudioSplitter::branchResumeOutput(void)
 {
-  writeFromBuffer();
-  if (input_stopped && (buf_len == 0))
+  list<Branch *>::iterator it;
+  for (it = branches.begin(); it != branches.end(); ++it)
+  {
+    (*it)->writeFromQueue();
+  }
+  if (do_flush)
+  {
+    flushDrainedBranches();
+  }
+  if (input_stopped && !backlogFull())
   {
     input_stopped = false;
     sourceResumeOutput();
@@ -526,10 +580,9 @@ void AudioSplitter::cleanupBranches(void)
   {
     if ((*it != main_branch) && !(*it)->isRegistered())
     {
-      list<Branch *>::iterator delete_it = it;
-      ++it;
-      delete *delete_it;
-      branches.erase(delete_it);
+      Branch *branch = *it;
+      it = branches.erase(it);
+      delete branch;
     }
     else
     {
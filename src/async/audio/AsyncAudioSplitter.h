@@ -6,7 +6,7 @@
 
 \verbatim
 Async - A library for programming event driven applications
-Copyright (C) 2004-2015  Tobias Blomberg / SM0SVX
+Copyright (C) 2004-2022  Tobias Blomberg / SM0SVX
 
 This program is free software; you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -36,6 +36,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <list>
+#include <vector>
+#include <memory>
 #include <sigc++/sigc++.h>
 
 
@@ -113,6 +115,13 @@ namespace Async
 
 This class is part of the audio pipe framework. It is used to split one
 incoming audio source into multiple outgoing sources.
+
+All branches are handed the same incoming buffer. If the sink of a branch
+cannot take all samples, the samples are copied into an immutable reference
+counted block which is queued in that branch together with a read position.
+Other branches are not affected so a slow sink does not stall the fast ones.
+Branches that need to queue samples from the same write share one block.
+The input is only stopped when the queue of some branch grow beyond a limit.
 */
 class AudioSplitter : public Async::AudioSink, public Async::AudioSource,
                       public sigc::trackable
@@ -183,18 +192,16 @@ class AudioSplitter : public Async::AudioSink, public Async::AudioSource,
     
   private:
     class Branch;
+    typedef std::shared_ptr<const std::vector<float> > SharedBlock;
     
     std::list<Branch *> branches;
-    float     	      	*buf;
-    int       	      	buf_size;
-    int       	      	buf_len;
     bool      	      	do_flush;
     bool      	      	input_stopped;
     int       	      	flushed_branches;
     Branch              *main_branch;
     
-    void writeFromBuffer(void);
-    void flushAllBranches(void);
+    bool backlogFull(void) const;
+    void flushDrainedBranches(void);
 
     friend class Branch;
     void branchResumeOutput(void);
@@ -0,0 +1,400 @@
+/**
+@file   AsyncBiquadCascade.cpp
+@brief  A block based cascade of second order IIR filter sections
+@author agent
+@date   2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <clocale>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+extern "C" {
+#include "fidlib.h"
+};
+
+#include "AsyncBiquadCascade.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+namespace {
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+  /*
+   * Convert a fidlib filter to second order sections. The filter list is
+   * walked in the same way as fid_run_new does it so that the resulting
+   * cascade have the same transfer function as the fidlib filter. That is,
+   * each section is an optional IIR element followed by an optional FIR
+   * element. FIR elements of length one are pure gain.
+   */
+bool fidToSections(FidFilter *ff, BiquadCascade& cascade, string& err)
+{
+  double gain = 1.0;
+  while (ff->len != 0)
+  {
+    if ((ff->typ == 'F') && (ff->len == 1))
+    {
+      gain *= ff->val[0];
+      ff = FFNEXT(ff);
+      continue;
+    }
+
+    const double *iir = nullptr;
+    const double *fir = nullptr;
+    int n_iir = 0;
+    int n_fir = 0;
+    if (ff->typ == 'F')
+    {
+      fir = ff->val;
+      n_fir = ff->len;
+      ff = FFNEXT(ff);
+    }
+    else if (ff->typ == 'I')
+    {
+      iir = ff->val;
+      n_iir = ff->len;
+      ff = FFNEXT(ff);
+      while ((ff->typ == 'F') && (ff->len == 1))
+      {
+        gain *= ff->val[0];
+        ff = FFNEXT(ff);
+      }
+      if (ff->typ == 'F')
+      {
+        fir = ff->val;
+        n_fir = ff->len;
+        ff = FFNEXT(ff);
+      }
+    }
+    else
+    {
+      err = "Unknown fidlib filter element type";
+      return false;
+    }
+
+    if ((n_iir > 3) || (n_fir > 3))
+    {
+      err = "The filter cannot be split into second order sections";
+      return false;
+    }
+
+    double b[3] = { 1.0, 0.0, 0.0 };
+    if (n_fir > 0)
+    {
+      b[0] = 0.0;
+      copy(fir, fir + n_fir, b);
+    }
+    double a[3] = { 1.0, 0.0, 0.0 };
+    if (n_iir > 0)
+    {
+      if (iir[0] == 0.0)
+      {
+        err = "Invalid IIR coefficient in filter";
+        return false;
+      }
+      double adj = 1.0 / iir[0];
+      for (int i=1; i<n_iir; ++i)
+      {
+        a[i] = iir[i] * adj;
+      }
+      gain *= adj;
+    }
+
+    BiquadCascade::Section sec = { b[0], b[1], b[2], a[1], a[2] };
+    cascade.addSection(sec);
+  }
+  cascade.setGain(gain);
+  return true;
+} /* fidToSections */
+
+
+  /*
+   * Run a block of interleaved samples through one section in transposed
+   * direct form II.
+   */
+void runSection(const BiquadCascade::Section& sec, double *st, size_t ch_cnt,
+                double *w, size_t cnt)
+{
+  const double b0 = sec.b0;
+  const double b1 = sec.b1;
+  const double b2 = sec.b2;
+  const double a1 = sec.a1;
+  const double a2 = sec.a2;
+  if (ch_cnt == 1)
+  {
+    double s1 = st[0];
+    double s2 = st[1];
+    for (size_t i=0; i<cnt; ++i)
+    {
+      const double x = w[i];
+      const double y = b0 * x + s1;
+      s1 = b1 * x - a1 * y + s2;
+      s2 = b2 * x - a2 * y;
+      w[i] = y;
+    }
+    st[0] = s1;
+    st[1] = s2;
+    return;
+  }
+
+  double *st1 = st;
+  double *st2 = st + ch_cnt;
+  for (size_t i=0; i<cnt; i+=ch_cnt)
+  {
+    double *frame = w + i;
+    for (size_t ch=0; ch<ch_cnt; ++ch)
+    {
+      const double x = frame[ch];
+      const double y = b0 * x + st1[ch];
+      st1[ch] = b1 * x - a1 * y + st2[ch];
+      st2[ch] = b2 * x - a2 * y;
+      frame[ch] = y;
+    }
+  }
+} /* runSection */
+
+
+  /*
+   * Run a block of single channel samples through two consecutive
+   * sections.
+   */
+void runSectionPair(const BiquadCascade::Section& sa,
+                    const BiquadCascade::Section& sb, double *st,
+                    double *w, size_t cnt)
+{
+  double sa1 = st[0];
+  double sa2 = st[1];
+  double sb1 = st[2];
+  double sb2 = st[3];
+  for (size_t i=0; i<cnt; ++i)
+  {
+    const double x = w[i];
+    const double ya = sa.b0 * x + sa1;
+    sa1 = sa.b1 * x - sa.a1 * ya + sa2;
+    sa2 = sa.b2 * x - sa.a2 * ya;
+    const double yb = sb.b0 * ya + sb1;
+    sb1 = sb.b1 * ya - sb.a1 * yb + sb2;
+    sb2 = sb.b2 * ya - sb.a2 * yb;
+    w[i] = yb;
+  }
+  st[0] = sa1;
+  st[1] = sa2;
+  st[2] = sb1;
+  st[3] = sb2;
+} /* runSectionPair */
+
+
+}; /* End of anonymous namespace */
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+BiquadCascade::BiquadCascade(unsigned channels)
+  : m_gain(1.0), m_channels(max(channels, 1U))
+{
+} /* BiquadCascade::BiquadCascade */
+
+
+BiquadCascade::~BiquadCascade(void)
+{
+} /* BiquadCascade::~BiquadCascade */
+
+
+bool BiquadCascade::parseFilterSpec(const std::string &filter_spec,
+                                    int sample_rate)
+{
+  clear();
+  error_str.clear();
+
+  char spec_buf[256];
+  strncpy(spec_buf, filter_spec.c_str(), sizeof(spec_buf));
+  spec_buf[sizeof(spec_buf) - 1] = 0;
+  char *spec = spec_buf;
+  FidFilter *ff = 0;
+  char *old_locale = setlocale(LC_ALL, "C");
+  char *fferr = fid_parse(sample_rate, &spec, &ff);
+  setlocale(LC_ALL, old_locale);
+  if (fferr != 0)
+  {
+    error_str = fferr;
+    free(fferr);
+    return false;
+  }
+
+  bool success = fidToSections(ff, *this, error_str);
+  free(ff);
+  if (!success)
+  {
+    clear();
+  }
+  return success;
+} /* BiquadCascade::parseFilterSpec */
+
+
+void BiquadCascade::clear(void)
+{
+  sections.clear();
+  state.clear();
+  m_gain = 1.0;
+} /* BiquadCascade::clear */
+
+
+void BiquadCascade::addSection(const Section& sec)
+{
+  sections.push_back(sec);
+  state.resize(2 * sections.size() * m_channels, 0.0);
+} /* BiquadCascade::addSection */
+
+
+void BiquadCascade::setChannels(unsigned channels)
+{
+  m_channels = max(channels, 1U);
+  state.assign(2 * sections.size() * m_channels, 0.0);
+} /* BiquadCascade::setChannels */
+
+
+void BiquadCascade::reset(void)
+{
+  fill(state.begin(), state.end(), 0.0);
+} /* BiquadCascade::reset */
+
+
+void BiquadCascade::process(float *dest, const float *src, int frame_cnt)
+{
+  const size_t ch_cnt = m_channels;
+  const size_t cnt = static_cast<size_t>(max(frame_cnt, 0)) * ch_cnt;
+  if (work.size() < cnt)
+  {
+    work.resize(cnt);
+  }
+  double *w = work.data();
+  copy(src, src + cnt, w);
+
+    // Run the whole block through one section at a time, or two at a time
+    // for a single channel. Running two sections in the same loop allow the
+    // CPU to overlap the two recursions, which otherwise is limited by the
+    // latency of the feedback path. The state for each section is stored as
+    // one array of s1 values followed by one array of s2 values, one element
+    // per channel, so that the channel loop can be vectorized.
+  size_t s = 0;
+  if (ch_cnt == 1)
+  {
+    for (; s+1<sections.size(); s+=2)
+    {
+      runSectionPair(sections[s], sections[s+1], &state[2*s], w, cnt);
+    }
+  }
+  for (; s<sections.size(); ++s)
+  {
+    runSection(sections[s], &state[2 * s * ch_cnt], ch_cnt, w, cnt);
+  }
+
+  const double gain = m_gain;
+  for (size_t i=0; i<cnt; ++i)
+  {
+    dest[i] = static_cast<float>(gain * w[i]);
+  }
+} /* BiquadCascade::process */
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+
+
+/*
+ * This file has not been truncated
+ */
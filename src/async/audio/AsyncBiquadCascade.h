@@ -0,0 +1,277 @@
+/**
+@file   AsyncBiquadCascade.h
+@brief  A block based cascade of second order IIR filter sections
+@author agent
+@date   2026-10-18
+
+This file contains a class that implement an IIR filter as a cascade of second
+order sections (biquads). Samples are processed a block at a time, one section
+at a time, which is much more efficient than running the whole filter once for
+each sample. Multiple channels using the same filter can be processed in one
+go, which allow the compiler to use SIMD instructions for the channels.
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_BIQUAD_CASCADE_INCLUDED
+#define ASYNC_BIQUAD_CASCADE_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <string>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  A block based cascade of second order IIR filter sections
+@author agent
+@date   2026-10-18
+
+This class implement an IIR filter as a cascade of second order sections,
+each one on the form
+
+  H(z) = (b0 + b1*z^-1 + b2*z^-2) / (1 + a1*z^-1 + a2*z^-2)
+
+followed by a common gain. The sections are run in transposed direct form II
+with double precision coefficients and state.
+
+The filter can be designed using the same filter specification strings as
+the Async::AudioFilter class. The specification is designed by fidlib and then
+converted to second order sections. All the common filter types (Butterworth,
+Chebyshev, Bessel, biquads) can be converted. Filters containing longer FIR or
+IIR elements cannot be converted and parseFilterSpec will return \em false.
+
+The cascade can be set up to filter more than one channel. The channels must
+then be interleaved in the sample buffers. All channels use the same filter
+coefficients but have their own state. Processing several channels together is
+more efficient than processing them one by one since the channel loop can be
+vectorized by the compiler.
+*/
+class BiquadCascade
+{
+  public:
+    /**
+     * @brief   The coefficients for one second order section
+     */
+    struct Section
+    {
+      double b0;
+      double b1;
+      double b2;
+      double a1;
+      double a2;
+    };
+
+    /**
+     * @brief   Default constructor
+     * @param   channels The number of interleaved channels to filter
+     */
+    explicit BiquadCascade(unsigned channels=1);
+
+    /**
+     * @brief   Destructor
+     */
+    ~BiquadCascade(void);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    BiquadCascade(const BiquadCascade&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    BiquadCascade& operator=(const BiquadCascade&) = delete;
+
+    /**
+     * @brief   Design the filter from a filter specification
+     * @param   filter_spec The filter specification
+     * @param   sample_rate The sampling rate
+     * @return  Returns \em true on success or else \em false
+     *
+     * The filter specification is the same as for the Async::AudioFilter
+     * class. Any previously added sections are removed. If the filter could
+     * not be designed, or could not be converted to second order sections,
+     * \em false is returned and errorString can be used to get a description
+     * of the problem.
+     */
+    bool parseFilterSpec(const std::string &filter_spec, int sample_rate);
+
+    /**
+     * @brief   Get the latest filter creation error
+     * @return  Returns an error string if an error has occured previously
+     */
+    const std::string& errorString(void) const { return error_str; }
+
+    /**
+     * @brief   Remove all sections and reset the gain to one
+     */
+    void clear(void);
+
+    /**
+     * @brief   Add a second order section to the end of the cascade
+     * @param   sec The section coefficients, normalized so that a0 is one
+     */
+    void addSection(const Section& sec);
+
+    /**
+     * @brief   Get the number of sections in the cascade
+     * @return  Returns the number of second order sections
+     */
+    size_t sectionCount(void) const { return sections.size(); }
+
+    /**
+     * @brief   Get the coefficients of all sections
+     * @return  Returns a vector containing all sections
+     */
+    const std::vector<Section>& sectionList(void) const { return sections; }
+
+    /**
+     * @brief   Set the gain to apply to the output of the cascade
+     * @param   gain The (linear) gain
+     */
+    void setGain(double gain) { m_gain = gain; }
+
+    /**
+     * @brief   Get the gain applied to the output of the cascade
+     * @return  Returns the (linear) gain
+     */
+    double gain(void) const { return m_gain; }
+
+    /**
+     * @brief   Set the number of interleaved channels
+     * @param   channels The number of channels
+     *
+     * The filter state is cleared when the number of channels is changed.
+     */
+    void setChannels(unsigned channels);
+
+    /**
+     * @brief   Get the number of interleaved channels
+     * @return  Returns the number of channels
+     */
+    unsigned channels(void) const { return m_channels; }
+
+    /**
+     * @brief   Reset the filter state for all channels
+     */
+    void reset(void);
+
+    /**
+     * @brief   Filter a block of samples
+     * @param   dest The destination buffer
+     * @param   src The source buffer
+     * @param   frame_cnt The number of frames to process
+     *
+     * Filter frame_cnt frames of interleaved samples. Each frame contain one
+     * sample for each channel. The source and destination buffers may be
+     * the same buffer.
+     */
+    void process(float *dest, const float *src, int frame_cnt);
+
+  private:
+    std::vector<Section>  sections;
+    std::vector<double>   state;
+    std::vector<double>   work;
+    double                m_gain;
+    unsigned              m_channels;
+    std::string           error_str;
+
+};  /* class BiquadCascade */
+
+
+} /* namespace */
+
+#endif /* ASYNC_BIQUAD_CASCADE_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
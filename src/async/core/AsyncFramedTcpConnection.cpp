@@ -215,6 +215,21 @@ int FramedTcpConnection::write(const void *buf, int count)
 } /* FramedTcpConnection::write */
 
 
+bool FramedTcpConnection::hasPendingData(void) const
+{
+  return m_size_received || !m_txq.empty() ||
+         TcpConnection::hasPendingData();
+} /* FramedTcpConnection::hasPendingData */
+
+
+int FramedTcpConnection::releaseSocket(void)
+{
+  disconnectCleanup();
+  m_size_received = false;
+  return TcpConnection::releaseSocket();
+} /* FramedTcpConnection::releaseSocket */
+
+
 /****************************************************************************
  *
  * Protected member functions
@@ -187,6 +187,23 @@ class FramedTcpConnection : public TcpConnection
      */
     virtual int write(const void *buf, int count) override;
 
+    /**
+     * @brief   Check if there is buffered data on the connection
+     * @return  Returns \em true if there is buffered data
+     *
+     * Buffered data is a partially received frame or frames that are queued
+     * for transmission.
+     */
+    virtual bool hasPendingData(void) const override;
+
+    /**
+     * @brief   Release the socket from this object
+     * @return  Returns the socket or -1 if not connected
+     *
+     * See TcpConnection::releaseSocket. Queued frames are thrown away.
+     */
+    virtual int releaseSocket(void) override;
+
     /**
      * @brief 	A signal that is emitted when a connection has been terminated
      * @param 	con   	The connection object
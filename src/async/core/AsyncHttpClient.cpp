@@ -0,0 +1,598 @@
+/**
+@file	 AsyncHttpClient.cpp
+@brief   An event driven HTTP client built on the libcurl multi interface
+@author  agent
+@date	 2026-10-18
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <iostream>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncApplication.h>
+#include <AsyncFdWatch.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "AsyncHttpClient.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+struct HttpClient::Request
+{
+  RequestId   id;
+  std::string url;
+  CURL*       easy      = nullptr;
+  Handler     handler;
+  std::string body;
+  long        max_age   = -1;
+  bool        no_store  = false;
+  Response    response;
+  char        errbuf[CURL_ERROR_SIZE];
+};
+
+
+struct HttpClient::SocketWatch
+{
+  FdWatch rd;
+  FdWatch wr;
+};
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+HttpClient::HttpClient(void)
+  : m_timer(0, Timer::TYPE_ONESHOT, false),
+    m_alive(std::make_shared<bool>(true))
+{
+  m_timer.expired.connect(mem_fun(*this, &HttpClient::onTimeout));
+
+  m_multi = curl_multi_init();
+  if (m_multi == nullptr)
+  {
+    cerr << "*** ERROR: Could not initialize the libcurl multi handle" << endl;
+    return;
+  }
+  curl_multi_setopt(m_multi, CURLMOPT_SOCKETFUNCTION,
+                    &HttpClient::socketCallback);
+  curl_multi_setopt(m_multi, CURLMOPT_SOCKETDATA, this);
+  curl_multi_setopt(m_multi, CURLMOPT_TIMERFUNCTION,
+                    &HttpClient::timerCallback);
+  curl_multi_setopt(m_multi, CURLMOPT_TIMERDATA, this);
+} /* HttpClient::HttpClient */
+
+
+HttpClient::~HttpClient(void)
+{
+  *m_alive = false;
+  cancelAll();
+  if (m_multi != nullptr)
+  {
+    curl_multi_cleanup(m_multi);
+    m_multi = nullptr;
+  }
+  m_watches.clear();
+  m_dead_watches.clear();
+} /* HttpClient::~HttpClient */
+
+
+void HttpClient::setCacheMaxAge(unsigned max_age_s)
+{
+  m_cache_max_age = max_age_s;
+  if (m_cache_max_age == 0)
+  {
+    m_cache.clear();
+  }
+} /* HttpClient::setCacheMaxAge */
+
+
+void HttpClient::setCacheSize(size_t size)
+{
+  m_cache_size = size;
+  trimCache(m_cache_size);
+} /* HttpClient::setCacheSize */
+
+
+HttpClient::RequestId HttpClient::get(const std::string& url, Handler handler)
+{
+  RequestId id = m_next_id++;
+  std::unique_ptr<Request> req(new Request);
+  req->id = id;
+  req->url = url;
+  req->handler = handler;
+  req->errbuf[0] = 0;
+  req->response.url = url;
+
+  auto cit = m_cache.find(url);
+  if (cit != m_cache.end())
+  {
+    if (Clock::now() < cit->second.expires)
+    {
+      req->response = cit->second.response;
+      m_requests[id] = std::move(req);
+      m_deferred_done.push_back(id);
+      scheduleTask();
+      return id;
+    }
+    m_cache.erase(cit);
+  }
+
+  if (m_multi != nullptr)
+  {
+    req->easy = curl_easy_init();
+  }
+  if (req->easy == nullptr)
+  {
+    req->response.error = "Could not create a libcurl handle";
+    m_requests[id] = std::move(req);
+    m_deferred_done.push_back(id);
+    scheduleTask();
+    return id;
+  }
+
+  CURL *easy = req->easy;
+  curl_easy_setopt(easy, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(easy, CURLOPT_PRIVATE, req.get());
+  curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, &HttpClient::writeCallback);
+  curl_easy_setopt(easy, CURLOPT_WRITEDATA, req.get());
+  curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, &HttpClient::headerCallback);
+  curl_easy_setopt(easy, CURLOPT_HEADERDATA, req.get());
+  curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, req->errbuf);
+  curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+  curl_easy_setopt(easy, CURLOPT_MAXREDIRS, 5L);
+  curl_easy_setopt(easy, CURLOPT_ACCEPT_ENCODING, "");
+  if (m_timeout_ms > 0)
+  {
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, m_timeout_ms);
+  }
+  if (!m_user_agent.empty())
+  {
+    curl_easy_setopt(easy, CURLOPT_USERAGENT, m_user_agent.c_str());
+  }
+
+  m_requests[id] = std::move(req);
+
+    // Adding the handle will make libcurl set a timeout using the timer
+    // callback. The transfer is then started from the main loop.
+  CURLMcode mc = curl_multi_add_handle(m_multi, easy);
+  if (mc != CURLM_OK)
+  {
+    Request *r = m_requests[id].get();
+    curl_easy_cleanup(r->easy);
+    r->easy = nullptr;
+    r->response.error = curl_multi_strerror(mc);
+    m_deferred_done.push_back(id);
+    scheduleTask();
+  }
+
+  return id;
+} /* HttpClient::get */
+
+
+void HttpClient::cancel(RequestId id)
+{
+  auto it = m_requests.find(id);
+  if (it != m_requests.end())
+  {
+    removeRequest(it->second.get());
+  }
+} /* HttpClient::cancel */
+
+
+void HttpClient::cancelAll(void)
+{
+  while (!m_requests.empty())
+  {
+    removeRequest(m_requests.begin()->second.get());
+  }
+  m_deferred_done.clear();
+} /* HttpClient::cancelAll */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+int HttpClient::socketCallback(CURL *easy, curl_socket_t s, int what,
+                               void *userp, void *socketp)
+{
+  static_cast<HttpClient*>(userp)->updateSocket(s, what);
+  return 0;
+} /* HttpClient::socketCallback */
+
+
+int HttpClient::timerCallback(CURLM *multi, long timeout_ms, void *userp)
+{
+  HttpClient *client = static_cast<HttpClient*>(userp);
+  if (timeout_ms < 0)
+  {
+    client->m_timer.setEnable(false);
+  }
+  else
+  {
+      // A zero timeout mean that libcurl want to be called as soon as
+      // possible. The timer will then expire on the next main loop pass.
+    client->m_timer.setTimeout(timeout_ms);
+    client->m_timer.setEnable(true);
+    client->m_timer.reset();
+  }
+  return 0;
+} /* HttpClient::timerCallback */
+
+
+size_t HttpClient::writeCallback(char *ptr, size_t size, size_t nmemb,
+                                 void *userp)
+{
+  size_t len = size * nmemb;
+  static_cast<Request*>(userp)->body.append(ptr, len);
+  return len;
+} /* HttpClient::writeCallback */
+
+
+size_t HttpClient::headerCallback(char *ptr, size_t size, size_t nmemb,
+                                  void *userp)
+{
+  size_t len = size * nmemb;
+  Request *req = static_cast<Request*>(userp);
+  std::string line(ptr, len);
+  std::transform(line.begin(), line.end(), line.begin(), ::tolower);
+
+    // A new status line is received for each redirect or 1xx response so
+    // only the headers of the last response is used.
+  if (line.compare(0, 5, "http/") == 0)
+  {
+    req->max_age = -1;
+    req->no_store = false;
+  }
+  else if (line.compare(0, 14, "cache-control:") == 0)
+  {
+    if ((line.find("no-store") != string::npos) ||
+        (line.find("no-cache") != string::npos))
+    {
+      req->no_store = true;
+    }
+    size_t pos = line.find("max-age=");
+    if (pos != string::npos)
+    {
+      req->max_age = atol(line.c_str() + pos + 8);
+    }
+  }
+  return len;
+} /* HttpClient::headerCallback */
+
+
+void HttpClient::updateSocket(curl_socket_t s, int what)
+{
+  if (what == CURL_POLL_REMOVE)
+  {
+    auto it = m_watches.find(s);
+    if (it != m_watches.end())
+    {
+        // The watch may be the one emitting the activity signal right now
+        // so it is deleted later, from the main loop.
+      it->second->rd.setEnabled(false);
+      it->second->wr.setEnabled(false);
+      m_dead_watches.push_back(std::move(it->second));
+      m_watches.erase(it);
+      scheduleTask();
+    }
+    return;
+  }
+
+  std::unique_ptr<SocketWatch>& watch = m_watches[s];
+  if (!watch)
+  {
+    watch.reset(new SocketWatch);
+    watch->rd.setFd(s, FdWatch::FD_WATCH_RD);
+    watch->rd.activity.connect(mem_fun(*this, &HttpClient::onActivity));
+    watch->wr.setFd(s, FdWatch::FD_WATCH_WR);
+    watch->wr.activity.connect(mem_fun(*this, &HttpClient::onActivity));
+  }
+  watch->rd.setEnabled((what & CURL_POLL_IN) != 0);
+  watch->wr.setEnabled((what & CURL_POLL_OUT) != 0);
+} /* HttpClient::updateSocket */
+
+
+void HttpClient::onTimeout(Timer *t)
+{
+  socketAction(CURL_SOCKET_TIMEOUT, 0);
+} /* HttpClient::onTimeout */
+
+
+void HttpClient::onActivity(FdWatch *w)
+{
+  int ev_bitmask = (w->type() == FdWatch::FD_WATCH_RD)
+                     ? CURL_CSELECT_IN : CURL_CSELECT_OUT;
+  socketAction(w->fd(), ev_bitmask);
+} /* HttpClient::onActivity */
+
+
+void HttpClient::socketAction(curl_socket_t s, int ev_bitmask)
+{
+  int running = 0;
+  CURLMcode mc = curl_multi_socket_action(m_multi, s, ev_bitmask, &running);
+  if (mc != CURLM_OK)
+  {
+    cerr << "*** ERROR: curl_multi_socket_action failed: "
+         << curl_multi_strerror(mc) << endl;
+  }
+  checkCompleted();
+} /* HttpClient::socketAction */
+
+
+  /*
+   * The finished requests are collected before any handler is called. A
+   * handler may cancel other requests or delete this object so the requests
+   * are looked up again by id and the loop end if this object is gone.
+   */
+void HttpClient::checkCompleted(void)
+{
+  std::vector<std::pair<RequestId, CURLcode>> done;
+  CURLMsg *msg;
+  int msgs_left = 0;
+  while ((msg = curl_multi_info_read(m_multi, &msgs_left)) != nullptr)
+  {
+    if (msg->msg == CURLMSG_DONE)
+    {
+      char *priv = nullptr;
+      curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &priv);
+      done.push_back(std::make_pair(reinterpret_cast<Request*>(priv)->id,
+                                    msg->data.result));
+    }
+  }
+
+  std::shared_ptr<bool> alive(m_alive);
+  for (const auto& item : done)
+  {
+    auto it = m_requests.find(item.first);
+    if (it == m_requests.end())
+    {
+      continue;
+    }
+    finishRequest(it->second.get(), item.second);
+    if (!*alive)
+    {
+      return;
+    }
+  }
+} /* HttpClient::checkCompleted */
+
+
+void HttpClient::finishRequest(Request *req, CURLcode result)
+{
+  Response response;
+  response.url = req->url;
+  response.body = std::move(req->body);
+  curl_easy_getinfo(req->easy, CURLINFO_RESPONSE_CODE, &response.status);
+  if (result != CURLE_OK)
+  {
+    response.error = (req->errbuf[0] != 0) ? req->errbuf
+                                           : curl_easy_strerror(result);
+  }
+  storeInCache(*req, response);
+
+  Handler handler = std::move(req->handler);
+  removeRequest(req);
+  if (handler)
+  {
+    handler(response);
+  }
+} /* HttpClient::finishRequest */
+
+
+void HttpClient::storeInCache(const Request& req, const Response& response)
+{
+  if ((m_cache_max_age == 0) || (m_cache_size == 0) || req.no_store ||
+      !response.ok())
+  {
+    return;
+  }
+  long max_age = m_cache_max_age;
+  if ((req.max_age >= 0) && (req.max_age < max_age))
+  {
+    max_age = req.max_age;
+  }
+  if (max_age == 0)
+  {
+    return;
+  }
+
+  Clock::time_point now = Clock::now();
+  for (auto it = m_cache.begin(); it != m_cache.end(); )
+  {
+    if (it->second.expires <= now)
+    {
+      it = m_cache.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+  m_cache.erase(req.url);
+  trimCache(m_cache_size - 1);
+
+  CacheEntry& entry = m_cache[req.url];
+  entry.response = response;
+  entry.response.from_cache = true;
+  entry.expires = now + std::chrono::seconds(max_age);
+} /* HttpClient::storeInCache */
+
+
+void HttpClient::trimCache(size_t max_entries)
+{
+  while (m_cache.size() > max_entries)
+  {
+    auto oldest = std::min_element(m_cache.begin(), m_cache.end(),
+        [](const CacheMap::value_type& a, const CacheMap::value_type& b)
+        {
+          return a.second.expires < b.second.expires;
+        });
+    m_cache.erase(oldest);
+  }
+} /* HttpClient::trimCache */
+
+
+void HttpClient::deliverDeferred(void)
+{
+  std::shared_ptr<bool> alive(m_alive);
+  while (*alive && !m_deferred_done.empty())
+  {
+    RequestId id = m_deferred_done.front();
+    m_deferred_done.pop_front();
+    auto it = m_requests.find(id);
+    if (it == m_requests.end())
+    {
+      continue;
+    }
+    Response response = std::move(it->second->response);
+    Handler handler = std::move(it->second->handler);
+    m_requests.erase(it);
+    if (handler)
+    {
+      handler(response);
+    }
+  }
+} /* HttpClient::deliverDeferred */
+
+
+void HttpClient::scheduleTask(void)
+{
+  if (!m_task_pending)
+  {
+    m_task_pending = true;
+    Application::app().runTask(mem_fun(*this, &HttpClient::runDeferred));
+  }
+} /* HttpClient::scheduleTask */
+
+
+void HttpClient::runDeferred(void)
+{
+  m_task_pending = false;
+  m_dead_watches.clear();
+  deliverDeferred();
+} /* HttpClient::runDeferred */
+
+
+void HttpClient::removeRequest(Request *req)
+{
+  if (req->easy != nullptr)
+  {
+    curl_multi_remove_handle(m_multi, req->easy);
+    curl_easy_cleanup(req->easy);
+    req->easy = nullptr;
+  }
+  m_requests.erase(req->id);
+} /* HttpClient::removeRequest */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,333 @@
+/**
+@file	 AsyncHttpClient.h
+@brief   An event driven HTTP client built on the libcurl multi interface
+@author  agent
+@date	 2026-10-18
+
+This file contains a class that execute HTTP requests asynchronously using
+the libcurl multi socket interface. The sockets and timeouts used by libcurl
+are handled by the Async main loop so no polling is needed.
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/** @example  AsyncHttpClient_demo.cpp
+An example of how to use the Async::HttpClient class
+*/
+
+
+
+#ifndef ASYNC_HTTP_CLIENT_INCLUDED
+#define ASYNC_HTTP_CLIENT_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+#include <curl/curl.h>
+
+#include <string>
+#include <map>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <functional>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncTimer.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+class FdWatch;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	An event driven HTTP client
+@author agent
+@date   2026-10-18
+
+Use this class to fetch documents over HTTP(S), or any other protocol
+supported by libcurl, without blocking the application. The sockets that
+libcurl use are watched by the Async main loop and the libcurl timeouts are
+handled by an Async::Timer, so a request complete as soon as the data has
+arrived.
+
+Any number of requests may be running at the same time. All requests share
+one libcurl multi handle so connections to the same server are kept open and
+reused between requests.
+
+Successful responses may be kept in a small cache. A cached response is
+used for at most the time set using setCacheMaxAge(). If the server send a
+"Cache-Control: max-age" header that is shorter, it is used instead. The
+cache is disabled by default.
+
+\include AsyncHttpClient_demo.cpp
+*/
+class HttpClient : public sigc::trackable
+{
+  public:
+    /**
+     * @brief   The result of a finished request
+     */
+    struct Response
+    {
+      std::string url;                  ///< The requested URL
+      long        status      = 0;      ///< The HTTP status code
+      std::string body;                 ///< The response body
+      std::string error;                ///< Transfer error, empty if none
+      bool        from_cache  = false;  ///< True if served from the cache
+
+      /**
+       * @brief   Check if the request was successful
+       * @return  Returns \em true on no transfer error and a 2xx status
+       */
+      bool ok(void) const
+      {
+        return error.empty() && (status >= 200) && (status < 300);
+      }
+    };
+
+    /**
+     * @brief   The type of the function called when a request is done
+     */
+    using Handler = std::function<void(const Response&)>;
+
+    /**
+     * @brief   The type used to identify a request
+     */
+    using RequestId = unsigned;
+
+    /**
+     * @brief 	Default constructor
+     */
+    HttpClient(void);
+
+    /**
+     * @brief 	Destructor
+     *
+     * All pending requests are aborted without calling their handlers.
+     */
+    ~HttpClient(void);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    HttpClient(const HttpClient&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    /**
+     * @brief   Set the maximum time a request may take
+     * @param   timeout_ms The timeout in milliseconds, 0 for no timeout
+     *
+     * The timeout is used for requests started after this call.
+     */
+    void setTimeout(long timeout_ms) { m_timeout_ms = timeout_ms; }
+
+    /**
+     * @brief   Set the user agent string sent to the server
+     * @param   user_agent The user agent string
+     */
+    void setUserAgent(const std::string& user_agent)
+    {
+      m_user_agent = user_agent;
+    }
+
+    /**
+     * @brief   Set the maximum age of cached responses
+     * @param   max_age_s The maximum age in seconds, 0 to disable the cache
+     */
+    void setCacheMaxAge(unsigned max_age_s);
+
+    /**
+     * @brief   Set the maximum number of cached responses
+     * @param   size The maximum number of responses to keep in the cache
+     */
+    void setCacheSize(size_t size);
+
+    /**
+     * @brief   Remove all responses from the cache
+     */
+    void clearCache(void) { m_cache.clear(); }
+
+    /**
+     * @brief   Start a GET request
+     * @param   url     The URL to fetch
+     * @param   handler The function to call when the request is done
+     * @return  Returns an id that can be used to cancel the request
+     *
+     * The handler is always called from the main loop, never from within
+     * this function, even if the response is taken from the cache. It is
+     * called exactly once unless the request is cancelled. The HttpClient
+     * object must not be deleted from within the handler.
+     */
+    RequestId get(const std::string& url, Handler handler);
+
+    /**
+     * @brief   Cancel a pending request
+     * @param   id The id returned by the get function
+     *
+     * The handler for the request will not be called. It is safe to cancel
+     * a request that already has finished.
+     */
+    void cancel(RequestId id);
+
+    /**
+     * @brief   Cancel all pending requests
+     */
+    void cancelAll(void);
+
+    /**
+     * @brief   Get the number of pending requests
+     * @return  Returns the number of requests that are not yet finished
+     */
+    size_t pendingRequests(void) const { return m_requests.size(); }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Request;
+    struct SocketWatch;
+
+    struct CacheEntry
+    {
+      Response          response;
+      Clock::time_point expires;
+    };
+
+    using RequestMap = std::map<RequestId, std::unique_ptr<Request>>;
+    using WatchMap = std::map<curl_socket_t, std::unique_ptr<SocketWatch>>;
+    using CacheMap = std::map<std::string, CacheEntry>;
+
+    CURLM*                                    m_multi         = nullptr;
+    Timer                                     m_timer;
+    RequestMap                                m_requests;
+    WatchMap                                  m_watches;
+    std::vector<std::unique_ptr<SocketWatch>> m_dead_watches;
+    std::deque<RequestId>                     m_deferred_done;
+    CacheMap                                  m_cache;
+    RequestId                                 m_next_id       = 1;
+    long                                      m_timeout_ms    = 0;
+    std::string                               m_user_agent;
+    unsigned                                  m_cache_max_age = 0;
+    size_t                                    m_cache_size    = 16;
+    bool                                      m_task_pending  = false;
+    std::shared_ptr<bool>                     m_alive;
+
+    static int socketCallback(CURL *easy, curl_socket_t s, int what,
+                              void *userp, void *socketp);
+    static int timerCallback(CURLM *multi, long timeout_ms, void *userp);
+    static size_t writeCallback(char *ptr, size_t size, size_t nmemb,
+                                void *userp);
+    static size_t headerCallback(char *ptr, size_t size, size_t nmemb,
+                                 void *userp);
+
+    void updateSocket(curl_socket_t s, int what);
+    void onTimeout(Timer *t);
+    void onActivity(FdWatch *w);
+    void socketAction(curl_socket_t s, int ev_bitmask);
+    void checkCompleted(void);
+    void finishRequest(Request *req, CURLcode result);
+    void storeInCache(const Request& req, const Response& response);
+    void trimCache(size_t max_entries);
+    void deliverDeferred(void);
+    void scheduleTask(void);
+    void runDeferred(void);
+    void removeRequest(Request *req);
+
+};  /* class HttpClient */
+
+
+} /* namespace */
+
+#endif /* ASYNC_HTTP_CLIENT_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -265,6 +265,17 @@ int TcpConnection::write(const void *buf, int count)
 } /* TcpConnection::write */
 
 
+int TcpConnection::releaseSocket(void)
+{
+  int released_sock = sock;
+  recv_buf_cnt = 0;
+  wr_watch.setEnabled(false);
+  rd_watch.setEnabled(false);
+  sock = -1;
+  return released_sock;
+} /* TcpConnection::releaseSocket */
+
+
 
 /****************************************************************************
  *
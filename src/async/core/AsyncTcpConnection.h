@@ -237,6 +237,36 @@ class TcpConnection : virtual public sigc::trackable
      * A connection being idle means that it is not connected
      */
     bool isIdle(void) const { return sock == -1; }
+
+    /**
+     * @brief 	Return the socket file descriptor
+     * @return	Returns the currently used socket file descriptor
+     *
+     * Use this function to get the socket file descriptor that is currently
+     * in use. If it is -1 it has not been set.
+     */
+    int socket(void) const { return sock; }
+
+    /**
+     * @brief   Check if there is buffered data on the connection
+     * @return  Returns \em true if there is buffered data
+     *
+     * Buffered data is received data that has not yet been processed or data
+     * that is waiting to be sent.
+     */
+    virtual bool hasPendingData(void) const { return recv_buf_cnt > 0; }
+
+    /**
+     * @brief   Release the socket from this object
+     * @return  Returns the socket or -1 if not connected
+     *
+     * The socket is detached from this object without being closed and the
+     * disconnected signal is not emitted. The caller is responsible for
+     * closing the returned socket. This can for example be used to pass an
+     * established connection on to another process. Buffered data is thrown
+     * away so hasPendingData should be checked first.
+     */
+    virtual int releaseSocket(void);
     
     /**
      * @brief 	A signal that is emitted when a connection has been terminated
@@ -294,15 +324,6 @@ class TcpConnection : virtual public sigc::trackable
      */
     void setRemotePort(uint16_t remote_port);
     
-    /**
-     * @brief 	Return the socket file descriptor
-     * @return	Returns the currently used socket file descriptor
-     *
-     * Use this function to get the socket file descriptor that is currently
-     * in use. If it is -1 it has not been set.
-     */
-    int socket(void) const { return sock; }
-
     /**
      * @brief   Disconnect from the remote peer
      *
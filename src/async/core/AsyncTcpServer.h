@@ -137,6 +137,15 @@ class TcpServer : public TcpServerBase
       : TcpServerBase(port_str, bind_ip)
     {
     }
+
+    /**
+     * @brief   Constructor using an already listening socket
+     * @param   sock The listening socket to use
+     *
+     * The server object take over the ownership of the socket. This can for
+     * example be used for a socket handed over from another process.
+     */
+    explicit TcpServer(int sock) : TcpServerBase(sock) {}
   
     /**
      * @brief 	Destructor
@@ -159,6 +168,27 @@ class TcpServer : public TcpServerBase
      * @param 	con The connected TcpConnection object
      */
     sigc::signal<void, ConT*>  clientConnected;
+
+    /**
+     * @brief   Add an already established connection to this server
+     * @param   sock        The socket for the connection
+     * @param   remote_addr The IP address of the remote host
+     * @param   remote_port The port number of the remote host
+     * @return  Returns the new connection object
+     *
+     * The connection is handled as if it had been accepted by this server,
+     * except that the clientConnected signal is not emitted. This can for
+     * example be used for connections handed over from another process.
+     */
+    ConT *adoptConnection(int sock, const IpAddress& remote_addr,
+                          uint16_t remote_port)
+    {
+      ConT *con = new ConT(sock, remote_addr, remote_port);
+      con->disconnected.connect(
+          mem_fun(*this, &TcpServer<ConT>::onDisconnected));
+      addConnection(con);
+      return con;
+    }
   
     /**
      * @brief 	A signal that is emitted when a client disconnect from the
@@ -172,10 +202,7 @@ class TcpServer : public TcpServerBase
     virtual void createConnection(int sock, const IpAddress& remote_addr,
                                   uint16_t remote_port)
     {
-      ConT *con = new ConT(sock, remote_addr, remote_port);
-      con->disconnected.connect(
-          mem_fun(*this, &TcpServer<ConT>::onDisconnected));
-      addConnection(con);
+      ConT *con = adoptConnection(sock, remote_addr, remote_port);
       clientConnected(con);
     }
     
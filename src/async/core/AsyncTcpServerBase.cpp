@@ -124,7 +124,7 @@ TcpServerBase::TcpServerBase(const string& port_str,
                              const Async::IpAddress &bind_ip)
   : sock(-1), rd_watch(0)
 {
-  if ((sock = socket(AF_INET, SOCK_STREAM, 0)) == -1)
+  if ((sock = ::socket(AF_INET, SOCK_STREAM, 0)) == -1)
   {
     perror("socket");
     cleanup();
@@ -204,6 +204,27 @@ TcpServerBase::TcpServerBase(const string& port_str,
 } /* TcpServerBase::TcpServerBase */
 
 
+TcpServerBase::TcpServerBase(int sock)
+  : sock(sock), rd_watch(0)
+{
+  if (sock < 0)
+  {
+    return;
+  }
+
+    /* Force close on exec */
+  if (fcntl(sock, F_SETFD, 1) == -1)
+  {
+    perror("fcntl(F_SETFD)");
+    cleanup();
+    return;
+  }
+
+  rd_watch = new FdWatch(sock, FdWatch::FD_WATCH_RD);
+  rd_watch->activity.connect(mem_fun(*this, &TcpServerBase::onConnection));
+} /* TcpServerBase::TcpServerBase */
+
+
 TcpServerBase::~TcpServerBase(void)
 {
   cleanup();
@@ -284,6 +305,16 @@ int TcpServerBase::writeExcept(TcpConnection *con, const void *buf, int count)
 } /* TcpServerBase::writeExcept */
 
 
+int TcpServerBase::releaseSocket(void)
+{
+  delete rd_watch;
+  rd_watch = 0;
+  int released_sock = sock;
+  sock = -1;
+  return released_sock;
+} /* TcpServerBase::releaseSocket */
+
+
 /****************************************************************************
  *
  * Protected member functions
@@ -120,6 +120,15 @@ class TcpServerBase : public sigc::trackable
     TcpServerBase(const std::string& port_str,
                   const Async::IpAddress &bind_ip);
 
+    /**
+     * @brief   Constructor using an already listening socket
+     * @param   sock The listening socket to use
+     *
+     * The server object take over the ownership of the socket. This can for
+     * example be used for a socket handed over from another process.
+     */
+    explicit TcpServerBase(int sock);
+
     /**
      * @brief 	Destructor
      */
@@ -164,6 +173,22 @@ class TcpServerBase : public sigc::trackable
      */
     int writeExcept(TcpConnection *con, const void *buf, int count);
 
+    /**
+     * @brief   Return the listening socket
+     * @return  Returns the listening socket or -1 if not listening
+     */
+    int socket(void) const { return sock; }
+
+    /**
+     * @brief   Release the listening socket from this object
+     * @return  Returns the listening socket or -1 if not listening
+     *
+     * The server stop accepting connections and the socket is detached from
+     * this object without being closed. The caller is responsible for
+     * closing the returned socket. Connected clients are not affected.
+     */
+    int releaseSocket(void);
+
   protected:
     virtual void createConnection(int sock, const IpAddress& remote_addr,
                                   uint16_t remote_port) = 0;
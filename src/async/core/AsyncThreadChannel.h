@@ -0,0 +1,372 @@
+/**
+@file	 AsyncThreadChannel.h
+@brief   A channel used to pass messages from threads to the main thread
+@author  agent
+@date	 2026-10-18
+
+This file contains a bounded, lock free message queue that is used to pass
+messages from one or more worker threads to the main thread, which runs the
+Async event loop.
+
+\verbatim
+Async - A library for programming event driven applications
+Copyright (C) 2003-2022 Tobias Blomberg
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef ASYNC_THREAD_CHANNEL_INCLUDED
+#define ASYNC_THREAD_CHANNEL_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncFdWatch.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A channel used to pass messages from threads to the main thread
+@author agent
+@date   2026-10-18
+
+This class is used to pass messages from one or more threads to the main
+thread, that is the thread running the Async event loop. Messages are posted
+to a bounded lock free queue so posting never block and never need a mutex.
+The main thread is woken up through an eventfd. Only one wakeup is issued
+until the main thread has started to process the queue, so a thread posting a
+stream of messages will in most cases only make a system call for the first
+one.
+
+When the main thread is woken up the messagesAvailable signal is emitted. The
+handler should call receive until it return \em false. All other functions
+may be called from any thread.
+
+The message type T must be default constructible and move assignable. A
+typical message type is a std::unique_ptr to a struct holding the data.
+
+The channel object must be created and destroyed by the main thread. Make
+sure that no thread is using the channel when it is destroyed.
+
+\code
+Async::ThreadChannel<std::unique_ptr<Result>> channel(16);
+channel.messagesAvailable.connect([&]()
+  {
+    std::unique_ptr<Result> result;
+    while (channel.receive(result))
+    {
+      handleResult(*result);
+    }
+  });
+std::thread worker([&]() { channel.post(std::unique_ptr<Result>(...)); });
+\endcode
+*/
+template <typename T>
+class ThreadChannel : public sigc::trackable
+{
+  public:
+    /**
+     * @brief 	Constructor
+     * @param 	capacity The maximum number of queued messages
+     *
+     * The capacity is rounded up to the nearest power of two.
+     */
+    explicit ThreadChannel(size_t capacity)
+      : m_mask(roundCapacity(capacity) - 1), m_cells(new Cell[m_mask + 1]),
+        m_enqueue_pos(0), m_wakeup_pending(false), m_event_fd(-1),
+        m_dequeue_pos(0)
+    {
+      for (size_t i=0; i<=m_mask; ++i)
+      {
+        m_cells[i].seq.store(i, std::memory_order_relaxed);
+      }
+      m_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      if (m_event_fd >= 0)
+      {
+        m_watch.activity.connect(
+            sigc::mem_fun(*this, &ThreadChannel::onActivity));
+        m_watch.setFd(m_event_fd, FdWatch::FD_WATCH_RD);
+        m_watch.setEnabled(true);
+      }
+    }
+
+    /**
+     * @brief 	Destructor
+     */
+    ~ThreadChannel(void)
+    {
+      m_watch.setFd(-1, FdWatch::FD_WATCH_RD);
+      if (m_event_fd >= 0)
+      {
+        close(m_event_fd);
+      }
+    }
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    ThreadChannel(const ThreadChannel&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    ThreadChannel& operator=(const ThreadChannel&) = delete;
+
+    /**
+     * @brief   Check if the initialization was successful
+     * @return  Returns \em true if the channel was successfully set up
+     */
+    bool initOk(void) const { return m_event_fd >= 0; }
+
+    /**
+     * @brief   Get the maximum number of queued messages
+     * @return  Returns the capacity of the channel
+     */
+    size_t capacity(void) const { return m_mask + 1; }
+
+    /**
+     * @brief   Post a message to the main thread
+     * @param   msg The message to post
+     * @return  Returns \em true on success or \em false if the queue is full
+     *
+     * This function may be called from any thread, also the main thread.
+     * If the queue is full, the message is left untouched.
+     */
+    bool post(T&& msg)
+    {
+      Cell *cell;
+      size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+      for (;;)
+      {
+        cell = &m_cells[pos & m_mask];
+        size_t seq = cell->seq.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) -
+                        static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+          if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                                                  std::memory_order_relaxed))
+          {
+            break;
+          }
+        }
+        else if (diff < 0)
+        {
+          return false;
+        }
+        else
+        {
+          pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        }
+      }
+      cell->data = std::move(msg);
+      cell->seq.store(pos + 1, std::memory_order_release);
+      notify();
+      return true;
+    }
+
+    /**
+     * @brief   Post a copy of a message to the main thread
+     * @param   msg The message to post
+     * @return  Returns \em true on success or \em false if the queue is full
+     */
+    bool post(const T& msg)
+    {
+      T copy(msg);
+      return post(std::move(copy));
+    }
+
+    /**
+     * @brief   Wake up the main thread without posting a message
+     *
+     * This function may be called from any thread to make the main thread
+     * emit the messagesAvailable signal. It can for example be used to tell
+     * the main thread to check some other state even if the queue is full.
+     */
+    void notify(void)
+    {
+      if (!m_wakeup_pending.exchange(true, std::memory_order_acq_rel) &&
+          (m_event_fd >= 0))
+      {
+        uint64_t cnt = 1;
+        ssize_t ret = write(m_event_fd, &cnt, sizeof(cnt));
+        (void)ret;
+      }
+    }
+
+    /**
+     * @brief   Receive the next message
+     * @param   msg The message is returned in this variable
+     * @return  Returns \em true if a message was received or \em false if
+     *          the queue is empty
+     *
+     * This function must only be called from the main thread.
+     */
+    bool receive(T& msg)
+    {
+      Cell& cell = m_cells[m_dequeue_pos & m_mask];
+      size_t seq = cell.seq.load(std::memory_order_acquire);
+      if (static_cast<intptr_t>(seq) -
+          static_cast<intptr_t>(m_dequeue_pos + 1) < 0)
+      {
+        return false;
+      }
+      msg = std::move(cell.data);
+      cell.data = T();
+      cell.seq.store(m_dequeue_pos + m_mask + 1, std::memory_order_release);
+      ++m_dequeue_pos;
+      return true;
+    }
+
+    /**
+     * @brief   A signal that is emitted when messages may be available
+     *
+     * This signal is emitted in the main thread when a thread has posted
+     * messages or called notify. The handler should call receive until it
+     * return \em false. If not, the handler may not be called again until
+     * another message is posted.
+     */
+    sigc::signal<void> messagesAvailable;
+
+  private:
+    struct Cell
+    {
+      std::atomic<size_t> seq;
+      T                   data;
+    };
+
+    const size_t              m_mask;
+    std::unique_ptr<Cell[]>   m_cells;
+      // The producer and consumer positions are kept apart to not share
+      // a cache line
+    char                      m_pad1[64];
+    std::atomic<size_t>       m_enqueue_pos;
+    std::atomic<bool>         m_wakeup_pending;
+    char                      m_pad2[64];
+    int                       m_event_fd;
+    size_t                    m_dequeue_pos;
+    FdWatch                   m_watch;
+
+    static size_t roundCapacity(size_t capacity)
+    {
+      size_t size = 2;
+      while (size < capacity)
+      {
+        size <<= 1;
+      }
+      return size;
+    }
+
+    void onActivity(FdWatch *w)
+    {
+        // Drain the eventfd before clearing the pending flag. If the flag
+        // was cleared first, a wakeup written after that could be drained
+        // here and the messages posted after it would never be signalled.
+        // Messages posted after the flag is cleared cause a new wakeup.
+      uint64_t cnt;
+      ssize_t ret = read(m_event_fd, &cnt, sizeof(cnt));
+      (void)ret;
+      m_wakeup_pending.exchange(false, std::memory_order_acq_rel);
+      messagesAvailable();
+    }
+
+};  /* class ThreadChannel */
+
+
+} /* namespace */
+
+#endif /* ASYNC_THREAD_CHANNEL_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
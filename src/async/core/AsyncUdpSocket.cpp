@@ -197,18 +197,7 @@ UdpSocket::UdpSocket(uint16_t local_port, const IpAddress &bind_ip)
     }
   }
   
-    // Setup a watch for incoming data
-  rd_watch = new FdWatch(sock, FdWatch::FD_WATCH_RD);
-  assert(rd_watch != 0);
-  rd_watch->activity.connect(mem_fun(*this, &UdpSocket::handleInput));
-
-    // Setup a watch for outgoing data (signals activity when a buffer full
-    // condition occurs)
-  wr_watch = new FdWatch(sock, FdWatch::FD_WATCH_WR);
-  assert(wr_watch != 0);
-  wr_watch->activity.connect(mem_fun(*this, &UdpSocket::sendRest));
-  wr_watch->setEnabled(false);
-  
+  setupWatches();
 } /* UdpSocket::UdpSocket */
 
 
@@ -218,6 +207,27 @@ UdpSocket::~UdpSocket(void)
 } /* UdpSocket::~UdpSocket */
 
 
+bool UdpSocket::setFd(int fd)
+{
+  cleanup();
+  if (fd < 0)
+  {
+    return false;
+  }
+  sock = fd;
+
+  if (fcntl(sock, F_SETFL, O_NONBLOCK) == -1)
+  {
+    perror("fcntl");
+    cleanup();
+    return false;
+  }
+
+  setupWatches();
+  return true;
+} /* UdpSocket::setFd */
+
+
 bool UdpSocket::write(const IpAddress& remote_ip, int remote_port,
     const void *buf, int count)
 {
@@ -321,6 +331,22 @@ void UdpSocket::cleanup(void)
 } /* UdpSocket::cleanup */
 
 
+void UdpSocket::setupWatches(void)
+{
+    // Setup a watch for incoming data
+  rd_watch = new FdWatch(sock, FdWatch::FD_WATCH_RD);
+  assert(rd_watch != 0);
+  rd_watch->activity.connect(mem_fun(*this, &UdpSocket::handleInput));
+
+    // Setup a watch for outgoing data (signals activity when a buffer full
+    // condition occurs)
+  wr_watch = new FdWatch(sock, FdWatch::FD_WATCH_WR);
+  assert(wr_watch != 0);
+  wr_watch->activity.connect(mem_fun(*this, &UdpSocket::sendRest));
+  wr_watch->setEnabled(false);
+} /* UdpSocket::setupWatches */
+
+
 void UdpSocket::handleInput(FdWatch *watch)
 {
   char buf[65536];
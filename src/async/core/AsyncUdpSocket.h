@@ -165,6 +165,17 @@ class UdpSocket : public sigc::trackable
      *          -1 on error
      */
     int fd(void) const { return sock; }
+
+    /**
+     * @brief   Use an already existing socket
+     * @param   fd The UDP socket to use
+     * @return  Returns \em true on success or else \em false
+     *
+     * The current socket is closed and replaced with the given one. The
+     * UdpSocket object take over the ownership of the socket. This can for
+     * example be used for a socket handed over from another process.
+     */
+    bool setFd(int fd);
     
     /**
      * @brief 	A signal that is emitted when data has been received
@@ -191,6 +202,7 @@ class UdpSocket : public sigc::trackable
     UdpPacket * send_buf;
     
     void cleanup(void);
+    void setupWatches(void);
     void handleInput(FdWatch *watch);
     void sendRest(FdWatch *watch);
 
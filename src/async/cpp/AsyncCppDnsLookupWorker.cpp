@@ -126,8 +126,6 @@ using namespace Async;
 CppDnsLookupWorker::CppDnsLookupWorker(const DnsLookup& dns)
   : DnsLookupWorker(dns)
 {
-  m_notifier_watch.activity.connect(
-      sigc::mem_fun(*this, &CppDnsLookupWorker::notificationReceived));
 } /* CppDnsLookupWorker::CppDnsLookupWorker */
 
 
@@ -147,7 +145,13 @@ DnsLookupWorker& CppDnsLookupWorker::operator=(DnsLookupWorker&& other_base)
   m_result = std::move(other.m_result);
   assert(!other.m_result.valid());
 
-  m_notifier_watch = std::move(other.m_notifier_watch);
+  m_result_channel = std::move(other.m_result_channel);
+  if (m_result_channel != nullptr)
+  {
+    m_result_channel->messagesAvailable.clear();
+    m_result_channel->messagesAvailable.connect(
+        sigc::mem_fun(*this, &CppDnsLookupWorker::notificationReceived));
+  }
 
   return *this;
 } /* CppDnsLookupWorker::operator=(DnsLookupWorker&&) */
@@ -169,25 +173,29 @@ bool CppDnsLookupWorker::doLookup(void)
 
   setLookupFailed(false);
 
-  int fd[2];
-  if (pipe(fd) != 0)
+  if (m_result_channel == nullptr)
+  {
+    m_result_channel.reset(new ResultChannel(1));
+    m_result_channel->messagesAvailable.connect(
+        sigc::mem_fun(*this, &CppDnsLookupWorker::notificationReceived));
+  }
+  if (!m_result_channel->initOk())
   {
     char errbuf[256];
     strerror_r(errno, errbuf, sizeof(errbuf));
-    std::cerr << "*** ERROR: Could not create pipe: " << errbuf << std::endl;
+    std::cerr << "*** ERROR: Could not create DNS result channel: "
+              << errbuf << std::endl;
+    m_result_channel.reset();
     setLookupFailed();
     return false;
   }
-  m_notifier_watch.setFd(fd[0], FdWatch::FD_WATCH_RD);
-  m_notifier_watch.setEnabled(true);
 
-  m_ctx = std::unique_ptr<ThreadContext>(new ThreadContext);
-  m_ctx->label = dns().label();
-  m_ctx->type = dns().type();
-  m_ctx->notifier_wr = fd[1];
-  m_ctx->anslen = 0;
-  m_ctx->thread_cerr.clear();
-  m_result = std::async(std::launch::async, workerFunc, std::ref(*m_ctx));
+  std::unique_ptr<ThreadContext> ctx(new ThreadContext);
+  ctx->label = dns().label();
+  ctx->type = dns().type();
+  ctx->anslen = 0;
+  m_result = std::async(std::launch::async, workerFunc, std::move(ctx),
+                        std::ref(*m_result_channel));
 
   return true;
 
@@ -201,11 +209,12 @@ void CppDnsLookupWorker::abortLookup(void)
     m_result.get();
   }
 
-  int fd = m_notifier_watch.fd();
-  if (fd >= 0)
+    // Throw away the result of an aborted lookup
+  if (m_result_channel != nullptr)
   {
-    m_notifier_watch.setFd(-1, FdWatch::FD_WATCH_RD);
-    close(fd);
+    while (m_result_channel->receive(m_ctx))
+    {
+    }
   }
 
   m_ctx.reset();
@@ -224,18 +233,22 @@ void CppDnsLookupWorker::abortLookup(void)
  * Purpose:   This is the function that do the actual DNS lookup. It is
  *    	      started as a separate thread since res_nsearch is a
  *    	      blocking function.
- * Input:     ctx - A context containing query and result parameters
+ * Input:     ctx             - A context containing query and result
+ *                              parameters
+ *            result_channel  - The channel used to return the context
  * Output:    The answer and anslen variables in the ThreadContext will be
- *            filled in with the lookup result. The context will be returned
- *            from this function.
+ *            filled in with the lookup result. The context is posted to the
+ *            main thread through the result channel.
  * Author:    Tobias Blomberg
  * Created:   2021-07-14
  * Remarks:   
  * Bugs:      
  *----------------------------------------------------------------------------
  */
-void CppDnsLookupWorker::workerFunc(CppDnsLookupWorker::ThreadContext& ctx)
+void CppDnsLookupWorker::workerFunc(std::unique_ptr<ThreadContext> ctx_ptr,
+                                    ResultChannel& result_channel)
 {
+  ThreadContext& ctx = *ctx_ptr;
   std::ostream& th_cerr = ctx.thread_cerr;
 
   int qtype = 0;
@@ -335,8 +348,11 @@ void CppDnsLookupWorker::workerFunc(CppDnsLookupWorker::ThreadContext& ctx)
     }
   }
 
-  close(ctx.notifier_wr);
-  ctx.notifier_wr = -1;
+    // The channel has room for exactly one result and only one lookup is
+    // running at a time so posting cannot fail
+  bool posted = result_channel.post(std::move(ctx_ptr));
+  assert(posted);
+  (void)posted;
 } /* CppDnsLookupWorker::workerFunc */
 
 
@@ -346,7 +362,7 @@ void CppDnsLookupWorker::workerFunc(CppDnsLookupWorker::ThreadContext& ctx)
  * Purpose:   When the DNS lookup thread is done, this function will be
  *            called to parse the result and notify the user that an answer
  *            is available.
- * Input:     w - The file watch object (notification pipe)
+ * Input:     None
  * Output:    None
  * Author:    Tobias Blomberg
  * Created:   2005-04-12
@@ -354,13 +370,12 @@ void CppDnsLookupWorker::workerFunc(CppDnsLookupWorker::ThreadContext& ctx)
  * Bugs:      
  *----------------------------------------------------------------------------
  */
-void CppDnsLookupWorker::notificationReceived(FdWatch *w)
+void CppDnsLookupWorker::notificationReceived(void)
 {
-  char buf[1];
-  int cnt = read(w->fd(), buf, sizeof(buf));
-  assert(cnt == 0);
-  close(w->fd());
-  w->setFd(-1, FdWatch::FD_WATCH_RD);
+  if (!m_result_channel->receive(m_ctx))
+  {
+    return;
+  }
 
   m_result.get();
 
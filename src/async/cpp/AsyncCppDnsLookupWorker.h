@@ -46,6 +46,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <string>
 #include <sstream>
 #include <future>
+#include <memory>
 #include <netdb.h>
 
 
@@ -55,7 +56,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
-#include <AsyncFdWatch.h>
+#include <AsyncThreadChannel.h>
 
 
 /****************************************************************************
@@ -163,7 +164,6 @@ class CppDnsLookupWorker : public DnsLookupWorker, public sigc::trackable
     {
       std::string         label;
       DnsLookup::Type     type                = DnsLookup::Type::A;
-      int                 notifier_wr         = -1;
       unsigned char       answer[NS_PACKETSZ];
       int                 anslen              = 0;
       struct addrinfo*    addrinfo            = nullptr;
@@ -180,12 +180,15 @@ class CppDnsLookupWorker : public DnsLookupWorker, public sigc::trackable
       }
     };
 
-    Async::FdWatch                  m_notifier_watch;
+    typedef ThreadChannel<std::unique_ptr<ThreadContext>> ResultChannel;
+
+    std::unique_ptr<ResultChannel>  m_result_channel;
     std::future<void>               m_result;
     std::unique_ptr<ThreadContext>  m_ctx;
 
-    static void workerFunc(ThreadContext& ctx);
-    void notificationReceived(FdWatch *w);
+    static void workerFunc(std::unique_ptr<ThreadContext> ctx,
+                           ResultChannel& result_channel);
+    void notificationReceived(void);
 
 };  /* class CppDnsLookupWorker */
 
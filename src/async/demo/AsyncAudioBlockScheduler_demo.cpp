@@ -0,0 +1,62 @@
+#include <iostream>
+
+#include <AsyncCppApplication.h>
+#include <AsyncAudioBlockScheduler.h>
+#include <AsyncAudioAmp.h>
+#include <AsyncAudioDebugger.h>
+#include <AsyncSigCAudioSource.h>
+#include <AsyncSigCAudioSink.h>
+
+using namespace Async;
+
+int main()
+{
+  CppApplication app;
+
+    // Two inputs, each amplified, mixed together into one output
+  AudioBlockScheduler sched;
+  AudioAmp amp1;
+  amp1.setGain(-6);
+  AudioAmp amp2;
+  amp2.setGain(-6);
+
+  AudioBlockScheduler::NodeId in1 = sched.addInput();
+  AudioBlockScheduler::NodeId in2 = sched.addInput();
+  AudioBlockScheduler::NodeId a1 = sched.addProcessor(&amp1);
+  AudioBlockScheduler::NodeId a2 = sched.addProcessor(&amp2);
+  AudioBlockScheduler::NodeId mix = sched.addMixer();
+  AudioBlockScheduler::NodeId out = sched.addOutput();
+  sched.connect(in1, a1);
+  sched.connect(in2, a2);
+  sched.connect(a1, mix);
+  sched.connect(a2, mix);
+  sched.connect(mix, out);
+  sched.setThreaded(true);
+
+  SigCAudioSource s1;
+  s1.registerSink(sched.inputSink(in1));
+  SigCAudioSource s2;
+  s2.registerSink(sched.inputSink(in2));
+  AudioDebugger dbg(sched.outputSource(out));
+  dbg.setName("scheduler");
+  SigCAudioSink sink;
+  dbg.registerSink(&sink);
+  sink.sigWriteSamples.connect([](float *, int count) { return count; });
+  sink.sigFlushSamples.connect([&]()
+      {
+        sink.allSamplesFlushed();
+        app.quit();
+      });
+
+  float samples[500];
+  for (int i=0; i<500; ++i)
+  {
+    samples[i] = 1.0f;
+  }
+  s1.writeSamples(samples, 500);
+  s2.writeSamples(samples, 500);
+  s1.flushSamples();
+  s2.flushSamples();
+
+  app.exec();
+}
@@ -0,0 +1,168 @@
+#include <iostream>
+
+#include <AsyncCppApplication.h>
+#include <AsyncTimer.h>
+#include <AsyncAudioSplitter.h>
+#include <AsyncAudioSink.h>
+#include <AsyncSigCAudioSource.h>
+
+using namespace std;
+using namespace Async;
+
+  /*
+   * A sink that check that the samples arrive in order. A slow sink only
+   * take a few samples at a time. It resume the output from within
+   * writeSamples every other time, which make the splitter re-enter its
+   * queue handling, and from a timer the rest of the time.
+   */
+class CheckSink : public AudioSink, public sigc::trackable
+{
+  public:
+    static const int SLOW_CHUNK = 100;
+
+    CheckSink(const char *name, bool slow)
+      : name(name), slow(slow), next(0), errors(0), flushed(false),
+        write_cnt(0), resume_timer(10, Timer::TYPE_ONESHOT, false)
+    {
+      resume_timer.expired.connect(mem_fun(*this, &CheckSink::onResumeTimer));
+    }
+
+    virtual int writeSamples(const float *samples, int count)
+    {
+      if (slow && resume_timer.isEnabled())
+      {
+        return 0;
+      }
+      int len = count;
+      if (slow && (len > SLOW_CHUNK))
+      {
+        len = SLOW_CHUNK;
+      }
+      for (int i=0; i<len; ++i)
+      {
+        if (samples[i] != static_cast<float>(next))
+        {
+          if (errors++ == 0)
+          {
+            cout << "*** ERROR[" << name << "]: Expected sample " << next
+                 << " but got " << samples[i] << endl;
+          }
+        }
+        next += 1;
+      }
+      if (slow && (len < count))
+      {
+        if (++write_cnt % 2 == 0)
+        {
+          sourceResumeOutput();
+        }
+        else
+        {
+          resume_timer.setEnable(true);
+        }
+      }
+      return len;
+    }
+
+    virtual void flushSamples(void)
+    {
+      flushed = true;
+      sourceAllSamplesFlushed();
+    }
+
+    const char  *name;
+    bool        slow;
+    int         next;
+    unsigned    errors;
+    bool        flushed;
+
+  private:
+    unsigned    write_cnt;
+    Timer       resume_timer;
+
+    void onResumeTimer(Timer *t)
+    {
+      resume_timer.setEnable(false);
+      sourceResumeOutput();
+    }
+};
+
+
+class Writer : public sigc::trackable
+{
+  public:
+    static const int BLOCK_SIZE = 160;
+    static const int SAMPLE_CNT = 16000;
+
+    Writer(void) : pos(0)
+    {
+      src.sigResumeOutput.connect(mem_fun(*this, &Writer::writeMore));
+      src.sigAllSamplesFlushed.connect(
+          mem_fun(*this, &Writer::onAllSamplesFlushed));
+    }
+
+    void writeMore(void)
+    {
+      float samples[BLOCK_SIZE];
+      while (pos < SAMPLE_CNT)
+      {
+        for (int i=0; i<BLOCK_SIZE; ++i)
+        {
+          samples[i] = pos + i;
+        }
+        int written = src.writeSamples(samples, BLOCK_SIZE);
+        pos += written;
+        if (written < BLOCK_SIZE)
+        {
+          return;
+        }
+      }
+      src.flushSamples();
+    }
+
+    SigCAudioSource src;
+
+  private:
+    int pos;
+
+    void onAllSamplesFlushed(void)
+    {
+      Application::app().quit();
+    }
+};
+
+
+int main(int argc, char **argv)
+{
+  CppApplication app;
+
+  Writer writer;
+  AudioSplitter splitter;
+  writer.src.registerSink(&splitter);
+  CheckSink fast("fast", false);
+  CheckSink slow("slow", true);
+  splitter.addSink(&fast);
+  splitter.addSink(&slow);
+
+  writer.writeMore();
+  app.exec();
+
+  int ret = 0;
+  for (const CheckSink *sink : {&fast, &slow})
+  {
+    if ((sink->next != Writer::SAMPLE_CNT) || !sink->flushed ||
+        (sink->errors > 0))
+    {
+      cout << "*** ERROR[" << sink->name << "]: Received " << sink->next
+           << " of " << Writer::SAMPLE_CNT << " samples, "
+           << sink->errors << " errors, "
+           << (sink->flushed ? "flushed" : "not flushed") << endl;
+      ret = 1;
+    }
+  }
+  if (ret == 0)
+  {
+    cout << "OK: All samples received in order by both sinks" << endl;
+  }
+  return ret;
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <string>
+#include <AsyncCppApplication.h>
+#include <AsyncHttpClient.h>
+
+using namespace Async;
+
+class MyClass : public sigc::trackable
+{
+  public:
+    MyClass(int argc, const char **argv)
+    {
+      http.setTimeout(10000);
+      http.setCacheMaxAge(60);
+
+      for (int i=1; i<argc; ++i)
+      {
+        fetch(argv[i]);
+      }
+      if (argc < 2)
+      {
+        fetch("https://www.svxlink.org/");
+      }
+    }
+
+  private:
+    HttpClient  http;
+    int         pending = 0;
+    bool        refetched = false;
+
+    void fetch(const std::string& url)
+    {
+      ++pending;
+      std::cout << "Fetching " << url << "..." << std::endl;
+      http.get(url, [this](const HttpClient::Response& resp)
+          {
+            onResponse(resp);
+          });
+    }
+
+    void onResponse(const HttpClient::Response& resp)
+    {
+      if (resp.ok())
+      {
+        std::cout << resp.url << ": status=" << resp.status
+                  << " size=" << resp.body.size()
+                  << (resp.from_cache ? " (cached)" : "") << std::endl;
+      }
+      else
+      {
+        std::cout << "*** ERROR: " << resp.url << ": status=" << resp.status
+                  << " " << resp.error << std::endl;
+      }
+
+        // Fetch the first document once more to show the cache in action
+      if (!refetched)
+      {
+        refetched = true;
+        fetch(resp.url);
+      }
+
+      if (--pending == 0)
+      {
+        Application::app().quit();
+      }
+    }
+};
+
+int main(int argc, const char **argv)
+{
+  CppApplication app;
+  MyClass http(argc, argv);
+  app.exec();
+}
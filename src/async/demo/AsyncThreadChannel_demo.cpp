@@ -0,0 +1,147 @@
+#include <stdint.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <AsyncCppApplication.h>
+#include <AsyncTimer.h>
+#include <AsyncThreadChannel.h>
+
+using namespace std;
+using namespace Async;
+
+  /*
+   * Stress test for the ThreadChannel. A number of producer threads post
+   * messages as fast as they can into a small channel. When all producers
+   * have stopped, every message must have been received by the main thread
+   * without any extra wakeup. A lost wakeup leave messages in the queue.
+   */
+class MyClass : public sigc::trackable
+{
+  public:
+    static const unsigned PRODUCERS = 4;
+    static const unsigned MSGS_PER_PRODUCER = 20000;
+
+    MyClass(void)
+      : channel(64), received(PRODUCERS, 0), received_cnt(0), errors(0),
+        producers_done(0), check_timer(100, Timer::TYPE_PERIODIC)
+    {
+      channel.messagesAvailable.connect(
+          mem_fun(*this, &MyClass::onMessagesAvailable));
+      check_timer.expired.connect(mem_fun(*this, &MyClass::onCheckTimer));
+      for (unsigned i=0; i<PRODUCERS; ++i)
+      {
+        producers.push_back(std::thread(&MyClass::producer, this, i));
+      }
+    }
+
+    ~MyClass(void)
+    {
+      for (auto& thread : producers)
+      {
+        if (thread.joinable())
+        {
+          thread.join();
+        }
+      }
+    }
+
+    int result(void) const { return (errors == 0) ? 0 : 1; }
+
+  private:
+    ThreadChannel<uint64_t>   channel;
+    std::vector<std::thread>  producers;
+    std::vector<uint32_t>     received;
+    unsigned                  received_cnt;
+    unsigned                  errors;
+    std::atomic<unsigned>     producers_done;
+    Timer                     check_timer;
+
+    void producer(unsigned id)
+    {
+      for (uint32_t seq=0; seq<MSGS_PER_PRODUCER; ++seq)
+      {
+        uint64_t msg = (static_cast<uint64_t>(id) << 32) | seq;
+        while (!channel.post(msg))
+        {
+          std::this_thread::yield();
+        }
+        if (seq % 64 == 0)
+        {
+          std::this_thread::yield();
+        }
+      }
+      ++producers_done;
+    }
+
+    void onMessagesAvailable(void)
+    {
+      uint64_t msg;
+      while (channel.receive(msg))
+      {
+        unsigned id = msg >> 32;
+        uint32_t seq = msg & 0xffffffff;
+        if ((id >= PRODUCERS) || (seq != received[id]))
+        {
+          cout << "*** ERROR: Unexpected message " << id << ":" << seq
+               << endl;
+          ++errors;
+        }
+        else
+        {
+          ++received[id];
+        }
+        ++received_cnt;
+      }
+    }
+
+    void onCheckTimer(Timer *t)
+    {
+      if (producers_done < PRODUCERS)
+      {
+        return;
+      }
+      if (producers[0].joinable())
+      {
+          // Give the last wakeup one timer period to be handled
+        for (auto& thread : producers)
+        {
+          thread.join();
+        }
+        return;
+      }
+
+        // All wakeups have been handled by now. Any message still in the
+        // queue was never signalled.
+      unsigned left = 0;
+      uint64_t msg;
+      while (channel.receive(msg))
+      {
+        ++left;
+      }
+      if (left > 0)
+      {
+        cout << "*** ERROR: " << left << " messages left in the queue" << endl;
+        ++errors;
+      }
+      if (received_cnt != PRODUCERS * MSGS_PER_PRODUCER)
+      {
+        cout << "*** ERROR: Received " << received_cnt << " of "
+             << PRODUCERS * MSGS_PER_PRODUCER << " messages" << endl;
+        ++errors;
+      }
+      if (errors == 0)
+      {
+        cout << "OK: " << received_cnt << " messages received" << endl;
+      }
+      Application::app().quit();
+    }
+};
+
+int main(int argc, char **argv)
+{
+  CppApplication app;
+  MyClass my_class;
+  app.exec();
+  return my_class.result();
+}
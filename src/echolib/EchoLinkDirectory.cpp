@@ -140,7 +140,9 @@ Directory::Directory(const vector<string>& servers, const string& callsign,
     const IpAddress &bind_ip)
   : com_state(CS_IDLE),       	      	      the_servers(servers),
     the_password(password),   	      	      the_description(""),
+    the_table(new StationTable),
     error_str(""),    	      	      	      get_call_cnt(0),
+    get_call_id(-1),
     ctrl_con(0),
     the_status(StationData::STAT_OFFLINE),    reg_refresh_timer(0),
     current_status(StationData::STAT_OFFLINE),server_changed(false),
@@ -207,10 +209,7 @@ void Directory::getCalls(void)
   }
   else
   {
-    the_links.clear();
-    the_repeaters.clear();
-    the_conferences.clear();
-    the_stations.clear();
+    the_table.reset(new StationTable);
     error("Trying to update the directory list while not registered with the "
       	  "directory server");
     //stationListUpdated();
@@ -249,145 +248,6 @@ void Directory::setDescription(const string& description)
 } /* Directory::setDescription */
 
 
-const StationData *Directory::findCall(const string& call)
-{
-  list<StationData> calls;
-  list<StationData>::const_iterator iter;
-  
-  for (iter=the_links.begin(); iter!=the_links.end(); ++iter)
-  {
-    if (iter->callsign() == call)
-    {
-      return &(*iter);
-    }
-  }
-  
-  for (iter=the_repeaters.begin(); iter!=the_repeaters.end(); ++iter)
-  {
-    if (iter->callsign() == call)
-    {
-      return &(*iter);
-    }
-  }
-  
-  for (iter=the_conferences.begin(); iter!=the_conferences.end(); ++iter)
-  {
-    if (iter->callsign() == call)
-    {
-      return &(*iter);
-    }
-  }
-  
-  for (iter=the_stations.begin(); iter!=the_stations.end(); ++iter)
-  {
-    if (iter->callsign() == call)
-    {
-      return &(*iter);
-    }
-  }
-  
-  return 0;
-  
-} /* Directory::findCall */
-
-
-const StationData *Directory::findStation(int id)
-{
-  list<StationData> calls;
-  list<StationData>::const_iterator iter;
-  
-  for (iter=the_links.begin(); iter!=the_links.end(); ++iter)
-  {
-    if (iter->id() == id)
-    {
-      return &(*iter);
-    }
-  }
-  
-  for (iter=the_repeaters.begin(); iter!=the_repeaters.end(); ++iter)
-  {
-    if (iter->id() == id)
-    {
-      return &(*iter);
-    }
-  }
-  
-  for (iter=the_conferences.begin(); iter!=the_conferences.end(); ++iter)
-  {
-    if (iter->id() == id)
-    {
-      return &(*iter);
-    }
-  }
-  
-  for (iter=the_stations.begin(); iter!=the_stations.end(); ++iter)
-  {
-    if (iter->id() == id)
-    {
-      return &(*iter);
-    }
-  }
-  
-  return 0;
-  
-} /* Directory::findStation */
-
-
-bool Directory::stationCodeEq(const StationData& stn, string code, bool exact)
-{
-  if (exact)
-  {
-    return (stn.code() == code);
-  }
-  else
-  {
-    return (stn.code().find(code) == 0);
-  }
-} /* Directory::stationCodeEq  */
-
-
-void Directory::findStationsByCode(vector<StationData> &stns,
-		const string& code, bool exact)
-{
-  list<StationData>::const_iterator iter;
-  
-  stns.clear();
-
-  for (iter=the_links.begin(); iter!=the_links.end(); ++iter)
-  {
-    if (stationCodeEq(*iter, code, exact))
-    {
-      stns.push_back(*iter);
-    }
-  }
-  
-  for (iter=the_repeaters.begin(); iter!=the_repeaters.end(); ++iter)
-  {
-    if (stationCodeEq(*iter, code, exact))
-    {
-      stns.push_back(*iter);
-    }
-  }
-  
-  for (iter=the_conferences.begin(); iter!=the_conferences.end(); ++iter)
-  {
-    if (stationCodeEq(*iter, code, exact))
-    {
-      stns.push_back(*iter);
-    }
-  }
-  
-  for (iter=the_stations.begin(); iter!=the_stations.end(); ++iter)
-  {
-    if (stationCodeEq(*iter, code, exact))
-    {
-      stns.push_back(*iter);
-    }
-  }
-
-} /* Directory::findStationsByCode  */
-
-
 ostream& EchoLink::operator<<(ostream& os, const StationData& station)
 {
   os  << setiosflags(ios::left)
@@ -495,9 +355,10 @@ int Directory::handleCallList(char *buf, int len)
 	buf[read_len-1] = 0;
 	get_call_cnt = atoi(buf);
 	//printf("Number of calls to get: %d\n", get_call_cnt);
+	get_call_table.reset(new StationTable);
 	if (get_call_cnt > 0)
 	{
-	  get_call_list.clear();
+	  get_call_table->reserve(get_call_cnt);
 	  the_message = "";
 	  com_state = CS_WAITING_FOR_CALL;
 	}
@@ -516,8 +377,7 @@ int Directory::handleCallList(char *buf, int len)
       {
 	read_len = nl-buf+1;
 	buf[read_len-1] = 0;
-	get_call_entry.clear();
-	get_call_entry.setCallsign(buf);
+	get_call_callsign = buf;
 	//printf("Station call: %s\n", get_call_callsign);
 	com_state = CS_WAITING_FOR_DATA;
       }
@@ -531,7 +391,7 @@ int Directory::handleCallList(char *buf, int len)
       {
 	read_len = nl-buf+1;
 	buf[read_len-1] = 0;
-	get_call_entry.setData(buf);
+	get_call_data = buf;
 	//printf("Station data: %s\n", get_call_data);
 	com_state = CS_WAITING_FOR_ID;
       }
@@ -545,7 +405,7 @@ int Directory::handleCallList(char *buf, int len)
       {
 	read_len = nl-buf+1;
 	buf[read_len-1] = 0;
-	get_call_entry.setId(atoi(buf));
+	get_call_id = atoi(buf);
 	//printf("Station id: %s\n", get_call_id);
 	com_state = CS_WAITING_FOR_IP;
       }
@@ -559,33 +419,28 @@ int Directory::handleCallList(char *buf, int len)
       {
 	read_len = nl-buf+1;
 	buf[read_len-1] = 0;
-	get_call_entry.setIp(IpAddress(buf));
 	//printf("Station ip: %s\n", get_call_ip);
 	
-	/*
-	if (strlen(get_call_entry.callsign().c_str()) == 1)
-	{
-	  the_message += get_call_entry.description() + "\n";
-	}
-	else if (strchr(get_call_entry.callsign().c_str(), ' ') != 0)
-	{
-	  error_str = get_call_entry.callsign();
-	}
-	*/
-	
-	if (get_call_entry.callsign() == ".")
+	if (get_call_callsign == ".")
 	{
 	  com_state = CS_WAITING_FOR_CALL;
 	  break;
 	}
 	
-	if (get_call_entry.callsign() == " ")
+	if (get_call_callsign == " ")
 	{
-	  the_message += get_call_entry.description() + "\n";
+	  StationData::Status status;
+	  char time[6];
+	  size_t desc_len = StationData::parseData(get_call_data.c_str(),
+	                                           status, time);
+	  the_message.append(get_call_data, 0, desc_len);
+	  the_message += "\n";
 	}
-	else
+	else if (get_call_table != nullptr)
 	{
-      	  get_call_list.push_back(get_call_entry);
+	  get_call_table->addStation(get_call_callsign.c_str(),
+	                             get_call_data.c_str(), get_call_id,
+	                             IpAddress(buf));
 	}
 
 	if (--get_call_cnt <= 0)
@@ -607,32 +462,14 @@ int Directory::handleCallList(char *buf, int len)
 	if (memcmp(buf, "+++", 3) == 0)
 	{
 	  //printf("End received!\n");
-	  the_links.clear();
-	  the_repeaters.clear();
-	  the_conferences.clear();
-	  the_stations.clear();
-	  list<StationData>::const_iterator it;
-	  for (it = get_call_list.begin(); it != get_call_list.end(); ++it)
+	    // Replace the whole station table in one go so that users of the
+	    // old table never see a partially updated list
+	  if (get_call_table == nullptr)
 	  {
-	    const string &callsign = it->callsign();
-	    if (callsign.rfind("-L") == callsign.size()-2)
-	    {
-	      the_links.push_back(*it);
-	    }
-	    else if (callsign.rfind("-R") == callsign.size()-2)
-	    {
-	      the_repeaters.push_back(*it);
-	    }
-	    else if (callsign.find("*") == 0)
-	    {
-	      the_conferences.push_back(*it);
-	    }
-	    else
-	    {
-	      the_stations.push_back(*it);
-	    }
+	    get_call_table.reset(new StationTable);
 	  }
-	  get_call_list.clear();
+	  get_call_table->finish();
+	  the_table = std::move(get_call_table);
 	  com_state = CS_IDLE;
 	  read_len = 3;
 	}
@@ -49,6 +49,7 @@ An example of how to use the EchoLink::Directory class
 #include <list>
 #include <vector>
 #include <iostream>
+#include <memory>
 
 
 /****************************************************************************
@@ -60,6 +61,7 @@ An example of how to use the EchoLink::Directory class
 #include <AsyncTcpClient.h>
 #include <AsyncTimer.h>
 #include <EchoLinkStationData.h>
+#include <EchoLinkStationTable.h>
 
 
 /****************************************************************************
@@ -262,46 +264,64 @@ class Directory : public sigc::trackable
     
     /**
      * @brief 	Get a list of all active links
-     * @return	Returns a reference to a list of StationData objects
+     * @return	Returns a list of station entries
      *
      * Use this function to get a list of all active links. Links are stations
      * where the callsign end with "-L". For this function to return anything,
      * a previous call to Directory::getCalls must have been made.
+     * The list is valid until the station list is updated again. Use
+     * stationTable to keep the list alive longer than that.
      */
-    const std::list<StationData>& links(void) const { return the_links; }
+    StationTable::List links(void) const { return the_table->links(); }
     
     /**
      * @brief 	Get a list of all active repeasters
-     * @return	Returns a reference to a list of StationData objects
+     * @return	Returns a list of station entries
      *
      * Use this function to get a list of all active repeaters. Repeaters are
      * stations where the callsign end with "-R". For this function to return
      * anything, a previous call to Directory::getCalls must have been made.
+     * The list is valid until the station list is updated again.
      */
-    const std::list<StationData>& repeaters(void) const
+    StationTable::List repeaters(void) const
     {
-      return the_repeaters;
+      return the_table->repeaters();
     }
     
     /**
      * @brief 	Get a list of all active conferences
-     * @return	Returns a reference to a list of StationData objects
+     * @return	Returns a list of station entries
      *
      * Use this function to get a list of all active conferences. Conferences
      * are stations where the callsign is surrounded with "*". For this function
      * to return anything, a previous call to Directory::getCalls must have been
-     * made.
+     * made. The list is valid until the station list is updated again.
      */
-    const std::list<StationData>& conferences(void) const
+    StationTable::List conferences(void) const
     {
-      return the_conferences;
+      return the_table->conferences();
     }
     
     /**
      * @brief 	Get a list of all active "normal" stations
-     * @return	Returns a reference to a list of StationData objects
+     * @return	Returns a list of station entries
+     *
+     * The list is valid until the station list is updated again.
      */
-    const std::list<StationData>& stations(void) const { return the_stations; }
+    StationTable::List stations(void) const { return the_table->stations(); }
+
+    /**
+     * @brief   Get the current station table
+     * @return  Returns a shared pointer to the station table
+     *
+     * The station table is replaced as a whole when the station list is
+     * updated. Holding on to the returned pointer keep the table, and all
+     * lists and entries from it, valid.
+     */
+    std::shared_ptr<const StationTable> stationTable(void) const
+    {
+      return the_table;
+    }
     
     /**
      * @brief 	Get the message returned by the directory server
@@ -316,18 +336,24 @@ class Directory : public sigc::trackable
     /**
      * @brief 	Find a callsign in the station list
      * @param 	call  The callsign to find
-     * @return	Returns a pointer to a StationData object if the callsign was
-     *	      	found. Otherwise a NULL-pointer is returned.
+     * @return	Returns a station entry which is invalid if the callsign was
+     *	      	not found. The entry is valid until the station list is updated.
      */
-    const StationData *findCall(const std::string& call);
+    StationTable::Entry findCall(const std::string& call) const
+    {
+      return the_table->findCall(call);
+    }
     
     /**
      * @brief 	Find a station in the station list given a station ID
      * @param 	id  The ID to find
-     * @return	Returns a pointer to a StationData object if the ID was
-     *	      	found. Otherwise a NULL-pointer is returned.
+     * @return	Returns a station entry which is invalid if the ID was not
+     *	      	found. The entry is valid until the station list is updated.
      */
-    const StationData *findStation(int id);
+    StationTable::Entry findStation(int id) const
+    {
+      return the_table->findStation(id);
+    }
 
     /**
      * @brief	Find stations from their mapping code
@@ -340,7 +366,10 @@ class Directory : public sigc::trackable
      * callsign to code mapping is done see @see EchoLink::StationData::code.
      */
     void findStationsByCode(std::vector<StationData> &stns,
-		    const std::string& code, bool exact=true);
+		    const std::string& code, bool exact=true) const
+    {
+      the_table->findStationsByCode(stns, code, exact);
+    }
     
     /**
      * @brief A signal that is emitted when the registration status changes
@@ -378,16 +407,15 @@ class Directory : public sigc::trackable
     std::string       	      the_callsign;
     std::string       	      the_password;
     std::string       	      the_description;
-    std::list<StationData>    the_links;
-    std::list<StationData>    the_repeaters;
-    std::list<StationData>    the_stations;
-    std::list<StationData>    the_conferences;
+    std::shared_ptr<const StationTable> the_table;
     std::string       	      the_message;
     std::string       	      error_str;
     
     int       	      	      get_call_cnt;
-    StationData       	      get_call_entry;
-    std::list<StationData>    get_call_list;
+    std::string       	      get_call_callsign;
+    std::string       	      get_call_data;
+    int       	      	      get_call_id;
+    std::unique_ptr<StationTable> get_call_table;
     
     DirectoryCon *            ctrl_con;
     std::list<Cmd>    	      cmd_queue;
@@ -414,7 +442,6 @@ class Directory : public sigc::trackable
     void createClientObject(void);
     void onRefreshRegistration(Async::Timer *timer);
     void onCmdTimeout(Async::Timer *timer);
-    bool stationCodeEq(const StationData& stn, std::string code, bool exact);
 
 };  /* class Directory */
 
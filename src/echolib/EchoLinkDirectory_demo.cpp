@@ -47,18 +47,22 @@ class MyClass : public sigc::trackable
     
     void onStationListUpdated(void)
     {
-      const list<StationData>& stations = dir->stations();
-      list<StationData>::const_iterator it;
+      StationTable::List stations = dir->stations();
+      StationTable::List::const_iterator it;
       for (it = stations.begin(); it != stations.end(); ++it)
       {
-	cerr << *it << endl;
+	cerr << (*it).stationData() << endl;
       }
       
       cerr << endl << "Message:" << endl;
       cerr << dir->message() << endl;
       
-      const StationData *mydata = dir->findCall(mycall);
-      cerr << endl << "My station data:" << endl << *mydata << endl;
+      StationTable::Entry mydata = dir->findCall(mycall);
+      if (mydata.isValid())
+      {
+        cerr << endl << "My station data:" << endl << mydata.stationData()
+             << endl;
+      }
       dir->makeOffline();
     }
     
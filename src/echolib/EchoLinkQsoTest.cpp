@@ -139,7 +139,7 @@ using namespace EchoLink;
 EchoLinkQsoTest::EchoLinkQsoTest(const string& callsign, const string& name,
     const string& info, const StationData *station)
   : Qso(station->ip(), callsign, name, info),
-    station(station), chat_mode(false), is_transmitting(false),
+    station(*station), chat_mode(false), is_transmitting(false),
     vox_limit(-1), sigc_sink(0) /*, sigc_src(0)*/
 {
   cout << "Call        : " << station->callsign() << endl;
@@ -288,12 +288,12 @@ void EchoLinkQsoTest::stdinHandler(FdWatch *watch)
   switch (cmd)
   {
     case 'C':
-      cout << "Connecting to " << station->ipStr() << endl;
+      cout << "Connecting to " << station.ipStr() << endl;
       connect();
       break;
 
     case 'D':
-      cout << "Disconnecting from " << station->ipStr() << endl;
+      cout << "Disconnecting from " << station.ipStr() << endl;
       disconnect();
       break;
 
@@ -345,7 +345,7 @@ void EchoLinkQsoTest::printPrompt(void)
   cout << endl;
   cout << "C=Connect  D=Disconnect  <space>=Toggle TX/RX  T=Talk  Q=Quit"
        << endl;
-  cout << station->callsign() << "> ";
+  cout << station.callsign() << "> ";
   cout.flush();
 } /* EchoLinkQsoTest::printPrompt */
 
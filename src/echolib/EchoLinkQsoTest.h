@@ -117,7 +117,7 @@ class EchoLinkQsoTest : public EchoLink::Qso
   protected:
     
   private:
-    const EchoLink::StationData * station;
+    EchoLink::StationData     	  station;
     struct termios    	      	  org_termios;
     Async::FdWatch *   	      	  stdin_watch;
     bool      	      	      	  chat_mode;
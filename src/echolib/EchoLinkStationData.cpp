@@ -35,8 +35,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <algorithm>
+
 #include <cstring>
 #include <cstdlib>
+#include <cctype>
 
 #include <sys/types.h>
 
@@ -145,6 +148,67 @@ string StationData::statusStr(Status status)
 } /* StationData::statusStr */
 
 
+size_t StationData::parseData(const char *data, Status& status, char *time)
+{
+  status = STAT_UNKNOWN;
+  time[0] = 0;
+
+  const char *end_desc = strrchr(data, '[');
+  if (end_desc != 0)
+  {
+    if (strstr(end_desc+1, "ON"))
+    {
+      status = STAT_ONLINE;
+    }
+    else if (strstr(end_desc+1, "BUSY"))
+    {
+      status = STAT_BUSY;
+    }
+
+    const char *space = strchr(end_desc, ' ');
+    if (space != 0)
+    {
+      strncpy(time, space+1, 5);
+      time[5] = 0;
+    }
+  }
+  else
+  {
+    end_desc = data + strlen(data);
+  }
+
+  size_t desc_len = min(static_cast<size_t>(end_desc - data),
+                        static_cast<size_t>(MAXDATA - 1));
+  while ((desc_len > 0) && (data[desc_len-1] == ' '))
+  {
+    --desc_len;
+  }
+  return desc_len;
+} /* StationData::parseData */
+
+
+char StationData::codeDigit(char ch)
+{
+  if ((ch >= 'A') && (ch <= 'R'))
+  {
+    return (ch - 'A') / 3 + 2 + '0';
+  }
+  else if ((ch >= 'S') && (ch <= 'Z'))
+  {
+    return min((ch - 'A' - 1) / 3 + 2 + '0', int('9'));
+  }
+  else if (isdigit(ch))
+  {
+    return ch;
+  }
+  else if (ch == '*')
+  {
+    return 0;
+  }
+  return '1';
+} /* StationData::codeDigit */
+
+
 StationData::StationData(void)
 {
   clear();
@@ -183,42 +247,10 @@ void StationData::setCallsign(const string& callsign)
 
 void StationData::setData(const char *data)
 {
-  char str[MAXDATA];
-  
-  const char *end_desc = strrchr(data, '[');
-  if (end_desc != 0)
-  {
-    if (strstr(end_desc+1, "ON"))
-    {
-      m_status = STAT_ONLINE;
-    }
-    else if (strstr(end_desc+1, "BUSY"))
-    {
-      m_status = STAT_BUSY;
-    }
-    else
-    {
-      m_status = STAT_UNKNOWN;
-    }
-    
-    const char *space = strchr(end_desc, ' ');
-    if (space != 0)
-    {
-      strncpy(str, space+1, 5);
-      str[5] = 0;
-      m_time = str;
-    }
-  }
-  else
-  {
-    end_desc = data + strlen(data);
-  }
-  
-  strncpy(str, data, end_desc-data);
-  str[end_desc-data] = 0;
-  m_description = str;
-  removeTrailingSpaces(m_description);
-  
+  char time[6];
+  size_t desc_len = parseData(data, m_status, time);
+  m_time = time;
+  m_description.assign(data, desc_len);
 } /* StationData::setData */
 
 
@@ -283,52 +315,17 @@ StationData& StationData::operator=(const StationData& rhs)
  * Bugs:      
  *----------------------------------------------------------------------------
  */
-void StationData::removeTrailingSpaces(string& str)
-{
-  int pos = str.find_last_not_of(' ');
-  if (pos >= 0)
-  {
-    ++pos;
-    if (pos < static_cast<int>(str.size()))
-    {
-      str.erase(pos);
-    }
-  }
-  else
-  {
-    str = "";
-  }
-} /* StationData::removeTrailingSpaces */
-
-
 string StationData::callToCode(const string& call)
 {
   string code;
 
   for (unsigned i=0; i<call.length(); ++i)
   {
-    char digit;
-    if ((call[i] >= 'A') && (call[i] <= 'R'))
-    {
-      digit = (call[i] - 'A') / 3 + 2 + '0';
-    }
-    else if ((call[i] >= 'S') && (call[i] <= 'Z'))
-    {
-      digit = min((call[i] - 'A' - 1) / 3 + 2 + '0', int('9'));
-    }
-    else if (isdigit(call[i]))
-    {
-      digit = call[i];
-    }
-    else if (call[i] == '*')
-    {
-      continue;
-    }
-    else
+    char digit = codeDigit(call[i]);
+    if (digit != 0)
     {
-      digit = '1';
+      code += digit;
     }
-    code += digit;
   }
 
   return code;
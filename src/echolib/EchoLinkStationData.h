@@ -131,6 +131,25 @@ class StationData
      * @return  Returns the string representation of the given status code
      */
     static std::string statusStr(Status status);
+
+    /**
+     * @brief   Parse a data string as represented in the directory server
+     * @param   data    The data string to parse
+     * @param   status  Set to the status found in the data string
+     * @param   time    Buffer of at least six characters to store the time in
+     * @return  Returns the length of the description, which start at the
+     *          beginning of the data string, with trailing spaces removed
+     */
+    static size_t parseData(const char *data, Status& status, char *time);
+
+    /**
+     * @brief   Map a callsign character to its code digit
+     * @param   ch The callsign character to map
+     * @return  Returns the code digit or 0 if the character should be ignored
+     *
+     * See the description of the code function for how the mapping is done.
+     */
+    static char codeDigit(char ch);
     
     /**
      * @brief Default constructor
@@ -290,7 +309,6 @@ class StationData
     Async::IpAddress  m_ip;
     std::string       m_code;
   
-    void removeTrailingSpaces(std::string& str);
     std::string callToCode(const std::string& call);
 
 };  /* class StationData */
@@ -0,0 +1,304 @@
+/**
+@file	 EchoLinkStationTable.cpp
+@brief   Contains a class that store the station list in compact form
+@author  agent
+@date	 2026-10-18
+
+This file contains a class that is used to store the station list downloaded
+from the directory server.
+
+\verbatim
+EchoLib - A library for EchoLink communication
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <algorithm>
+
+#include <cstring>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "EchoLinkStationTable.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+using namespace EchoLink;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+StationData StationTable::Entry::stationData(void) const
+{
+  StationData stn;
+  stn.setCallsign(callsign());
+  stn.setStatus(status());
+  stn.setTime(time());
+  stn.setDescription(description());
+  stn.setId(id());
+  stn.setIp(ip());
+  return stn;
+} /* StationTable::Entry::stationData */
+
+
+StationTable::StationTable(void)
+{
+  for (size_t i=0; i<=CAT_COUNT; ++i)
+  {
+    m_cat_begin[i] = 0;
+  }
+} /* StationTable::StationTable */
+
+
+void StationTable::reserve(size_t cnt)
+{
+    // Callsign, code, description and terminating zeros
+  m_arena.reserve(cnt * 48);
+  m_records.reserve(cnt);
+} /* StationTable::reserve */
+
+
+void StationTable::addStation(const char *callsign, const char *data, int id,
+                              const IpAddress& ip)
+{
+  Record rec;
+  StationData::Status status;
+  size_t desc_len = StationData::parseData(data, status, rec.time);
+  size_t call_len = strlen(callsign);
+  rec.callsign = addString(callsign, call_len);
+  rec.description = addString(data, desc_len);
+  rec.code = m_arena.size();
+  for (size_t i=0; i<call_len; ++i)
+  {
+    char digit = StationData::codeDigit(callsign[i]);
+    if (digit != 0)
+    {
+      m_arena.push_back(digit);
+    }
+  }
+  m_arena.push_back(0);
+  rec.id = id;
+  rec.ip = ip.ip4Addr();
+  rec.category = callCategory(callsign, call_len);
+  rec.status = status;
+  m_records.push_back(rec);
+} /* StationTable::addStation */
+
+
+void StationTable::finish(void)
+{
+  const char *arena = m_arena.data();
+  std::stable_sort(m_records.begin(), m_records.end(),
+      [arena](const Record& a, const Record& b)
+      {
+        if (a.category != b.category)
+        {
+          return a.category < b.category;
+        }
+        return strcmp(arena + a.callsign, arena + b.callsign) < 0;
+      });
+
+  size_t pos = 0;
+  for (size_t cat=0; cat<CAT_COUNT; ++cat)
+  {
+    m_cat_begin[cat] = pos;
+    while ((pos < m_records.size()) && (m_records[pos].category == cat))
+    {
+      ++pos;
+    }
+  }
+  m_cat_begin[CAT_COUNT] = pos;
+} /* StationTable::finish */
+
+
+StationTable::Entry StationTable::findCall(const string& call) const
+{
+  const char *arena = m_arena.data();
+  Category cat = callCategory(call.c_str(), call.size());
+  const Record *begin = m_records.data() + m_cat_begin[cat];
+  const Record *end = m_records.data() + m_cat_begin[cat+1];
+  const Record *rec = std::lower_bound(begin, end, call.c_str(),
+      [arena](const Record& r, const char *call)
+      {
+        return strcmp(arena + r.callsign, call) < 0;
+      });
+  if ((rec != end) && (strcmp(arena + rec->callsign, call.c_str()) == 0))
+  {
+    return Entry(arena, rec);
+  }
+  return Entry();
+} /* StationTable::findCall */
+
+
+StationTable::Entry StationTable::findStation(int id) const
+{
+  for (size_t i=0; i<m_records.size(); ++i)
+  {
+    if (m_records[i].id == id)
+    {
+      return Entry(m_arena.data(), &m_records[i]);
+    }
+  }
+  return Entry();
+} /* StationTable::findStation */
+
+
+void StationTable::findStationsByCode(vector<StationData> &stns,
+                                      const string& code, bool exact) const
+{
+  stns.clear();
+  for (size_t i=0; i<m_records.size(); ++i)
+  {
+    const char *stn_code = m_arena.data() + m_records[i].code;
+    if ((strncmp(stn_code, code.c_str(), code.size()) == 0) &&
+        (!exact || (stn_code[code.size()] == 0)))
+    {
+      stns.push_back(Entry(m_arena.data(), &m_records[i]).stationData());
+    }
+  }
+} /* StationTable::findStationsByCode */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+StationTable::Category StationTable::callCategory(const char *call, size_t len)
+{
+  if ((len >= 2) && (call[len-2] == '-') && (call[len-1] == 'L'))
+  {
+    return CAT_LINK;
+  }
+  else if ((len >= 2) && (call[len-2] == '-') && (call[len-1] == 'R'))
+  {
+    return CAT_REPEATER;
+  }
+  else if (call[0] == '*')
+  {
+    return CAT_CONFERENCE;
+  }
+  return CAT_STATION;
+} /* StationTable::callCategory */
+
+
+uint32_t StationTable::addString(const char *str, size_t len)
+{
+  uint32_t pos = m_arena.size();
+  m_arena.insert(m_arena.end(), str, str + len);
+  m_arena.push_back(0);
+  return pos;
+} /* StationTable::addString */
+
+
+StationTable::List StationTable::list(Category cat) const
+{
+  return List(m_arena.data(), m_records.data() + m_cat_begin[cat],
+              m_records.data() + m_cat_begin[cat+1]);
+} /* StationTable::list */
+
+
+
+/*
+ * This file has not been truncated
+ */
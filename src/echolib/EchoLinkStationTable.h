@@ -0,0 +1,433 @@
+/**
+@file	 EchoLinkStationTable.h
+@brief   Contains a class that store the station list in compact form
+@author  agent
+@date	 2026-10-18
+
+This file contains a class that is used to store the station list downloaded
+from the directory server.
+
+\verbatim
+EchoLib - A library for EchoLink communication
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+#ifndef ECHOLINK_STATION_TABLE_INCLUDED
+#define ECHOLINK_STATION_TABLE_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncIpAddress.h>
+#include <EchoLinkStationData.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+namespace EchoLink
+{
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A class for storing the station list in compact form
+@author agent
+@date   2026-10-18
+
+The station list downloaded from the directory server may contain many
+thousands of stations. Storing each station as a StationData object means a
+lot of small memory allocations every time the list is refreshed. This class
+instead store all strings in one character arena and each station as a fixed
+size record in one contiguous vector. The records are grouped per category
+(links, repeaters, conferences and stations) and sorted on callsign within
+each category.
+
+A table is built by calling addStation for each station and then finish when
+all stations have been added. After that the table is never modified. Entries
+and lists handed out by the table point into the table so they are only valid
+as long as the table exist.
+*/
+class StationTable
+{
+  private:
+    struct Record
+    {
+      uint32_t                    callsign;
+      uint32_t                    description;
+      uint32_t                    code;
+      int32_t                     id;
+      Async::IpAddress::Ip4Addr   ip;
+      uint8_t                     category;
+      uint8_t                     status;
+      char                        time[6];
+    };
+
+  public:
+    /**
+     * @brief A lightweight view of one station in the table
+     *
+     * The strings returned by this class point into the table. An entry can
+     * be converted to a free standing StationData object using stationData.
+     */
+    class Entry
+    {
+      public:
+        /**
+         * @brief Default constructor, creating an invalid entry
+         */
+        Entry(void) : m_arena(0), m_rec(0) {}
+
+        /**
+         * @brief   Check if this entry refer to a station
+         * @return  Returns \em true if the entry is valid
+         */
+        bool isValid(void) const { return m_rec != 0; }
+
+        /**
+         * @brief   Get the callsign
+         * @return  Returns the callsign
+         */
+        const char *callsign(void) const
+        {
+          return m_arena + m_rec->callsign;
+        }
+
+        /**
+         * @brief   Get the description/location string
+         * @return  Returns the description/location string
+         */
+        const char *description(void) const
+        {
+          return m_arena + m_rec->description;
+        }
+
+        /**
+         * @brief   Get the code representation of the callsign
+         * @return  Returns the code representation of the callsign
+         */
+        const char *code(void) const { return m_arena + m_rec->code; }
+
+        /**
+         * @brief   Get the status
+         * @return  Returns the status
+         */
+        StationData::Status status(void) const
+        {
+          return static_cast<StationData::Status>(m_rec->status);
+        }
+
+        /**
+         * @brief   Return the string representation of the status
+         * @return  Returns a string representation of the status
+         */
+        std::string statusStr(void) const
+        {
+          return StationData::statusStr(status());
+        }
+
+        /**
+         * @brief   Get the time
+         * @return  Returns the time
+         */
+        const char *time(void) const { return m_rec->time; }
+
+        /**
+         * @brief   Get the EchoLink ID number
+         * @return  Returns the EchoLink ID number
+         */
+        int id(void) const { return m_rec->id; }
+
+        /**
+         * @brief   Get the IP address
+         * @return  Returns the IP address
+         */
+        Async::IpAddress ip(void) const
+        {
+          return Async::IpAddress(m_rec->ip);
+        }
+
+        /**
+         * @brief   Create a StationData object from this entry
+         * @return  Returns a StationData object with the same content
+         */
+        StationData stationData(void) const;
+
+      private:
+        const char *  m_arena;
+        const Record *m_rec;
+
+        Entry(const char *arena, const Record *rec)
+          : m_arena(arena), m_rec(rec) {}
+
+        friend class StationTable;
+    };
+
+    /**
+     * @brief A list of stations in the table, e.g. all links
+     */
+    class List
+    {
+      public:
+        /**
+         * @brief An iterator for iterating over the entries in a list
+         */
+        class const_iterator
+        {
+          public:
+            const_iterator(void) : m_arena(0), m_rec(0) {}
+            const_iterator(const char *arena, const Record *rec)
+              : m_arena(arena), m_rec(rec) {}
+            Entry operator*(void) const { return Entry(m_arena, m_rec); }
+            const_iterator& operator++(void) { ++m_rec; return *this; }
+            bool operator==(const const_iterator& rhs) const
+            {
+              return m_rec == rhs.m_rec;
+            }
+            bool operator!=(const const_iterator& rhs) const
+            {
+              return m_rec != rhs.m_rec;
+            }
+
+          private:
+            const char *  m_arena;
+            const Record *m_rec;
+        };
+
+        /**
+         * @brief Default constructor, creating an empty list
+         */
+        List(void) : m_arena(0), m_begin(0), m_end(0) {}
+
+        /**
+         * @brief   Get the number of stations in the list
+         * @return  Returns the number of stations
+         */
+        size_t size(void) const { return m_end - m_begin; }
+
+        /**
+         * @brief   Check if the list is empty
+         * @return  Returns \em true if the list is empty
+         */
+        bool empty(void) const { return m_begin == m_end; }
+
+        /**
+         * @brief   Get a station from the list
+         * @param   i The index of the station
+         * @return  Returns the station entry
+         */
+        Entry operator[](size_t i) const { return Entry(m_arena, m_begin+i); }
+
+        const_iterator begin(void) const
+        {
+          return const_iterator(m_arena, m_begin);
+        }
+        const_iterator end(void) const
+        {
+          return const_iterator(m_arena, m_end);
+        }
+
+      private:
+        const char *  m_arena;
+        const Record *m_begin;
+        const Record *m_end;
+
+        List(const char *arena, const Record *begin, const Record *end)
+          : m_arena(arena), m_begin(begin), m_end(end) {}
+
+        friend class StationTable;
+    };
+
+    /**
+     * @brief Default constructor, creating an empty table
+     */
+    StationTable(void);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    StationTable(const StationTable&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    StationTable& operator=(const StationTable&) = delete;
+
+    /**
+     * @brief   Reserve space for the given number of stations
+     * @param   cnt The expected number of stations
+     */
+    void reserve(size_t cnt);
+
+    /**
+     * @brief   Add a station to the table
+     * @param   callsign  The callsign of the station
+     * @param   data      The data string as represented in the directory
+     *                    server, see StationData::setData
+     * @param   id        The EchoLink ID number
+     * @param   ip        The IP address of the station
+     *
+     * This function must not be called after finish have been called.
+     */
+    void addStation(const char *callsign, const char *data, int id,
+                    const Async::IpAddress& ip);
+
+    /**
+     * @brief   Finish building the table
+     *
+     * Must be called when all stations have been added. The stations are
+     * sorted into categories and on callsign.
+     */
+    void finish(void);
+
+    /**
+     * @brief   Get the total number of stations in the table
+     * @return  Returns the number of stations
+     */
+    size_t size(void) const { return m_records.size(); }
+
+    /**
+     * @brief   Get a list of all links, callsigns ending with "-L"
+     * @return  Returns a list of entries
+     */
+    List links(void) const { return list(CAT_LINK); }
+
+    /**
+     * @brief   Get a list of all repeaters, callsigns ending with "-R"
+     * @return  Returns a list of entries
+     */
+    List repeaters(void) const { return list(CAT_REPEATER); }
+
+    /**
+     * @brief   Get a list of all conferences, callsigns starting with "*"
+     * @return  Returns a list of entries
+     */
+    List conferences(void) const { return list(CAT_CONFERENCE); }
+
+    /**
+     * @brief   Get a list of all "normal" stations
+     * @return  Returns a list of entries
+     */
+    List stations(void) const { return list(CAT_STATION); }
+
+    /**
+     * @brief   Find a callsign in the table
+     * @param   call The callsign to find
+     * @return  Returns the station entry, which is invalid if not found
+     */
+    Entry findCall(const std::string& call) const;
+
+    /**
+     * @brief   Find a station in the table given a station ID
+     * @param   id The ID to find
+     * @return  Returns the station entry, which is invalid if not found
+     */
+    Entry findStation(int id) const;
+
+    /**
+     * @brief   Find stations from their mapping code
+     * @param   stns  This list is filled in by this function
+     * @param   code  The code to searh for
+     * @param   exact \em true if it should be an exact match or else
+     *                \em false
+     */
+    void findStationsByCode(std::vector<StationData> &stns,
+                            const std::string& code, bool exact) const;
+
+  private:
+    typedef enum
+    {
+      CAT_LINK, CAT_REPEATER, CAT_CONFERENCE, CAT_STATION, CAT_COUNT
+    } Category;
+
+    std::vector<char>   m_arena;
+    std::vector<Record> m_records;
+    size_t              m_cat_begin[CAT_COUNT+1];
+
+    static Category callCategory(const char *call, size_t len);
+    uint32_t addString(const char *str, size_t len);
+    List list(Category cat) const;
+
+};  /* class StationTable */
+
+
+} /* namespace */
+
+#endif /* ECHOLINK_STATION_TABLE_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
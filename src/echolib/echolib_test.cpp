@@ -113,7 +113,7 @@ static void on_error_msg(const string& msg);
 static void on_status_changed(StationData::Status status);
 static void echolink_qso_done(EchoLinkQsoTest *con);
 static void on_station_list_updated(void);
-static void print_call_list(const list<StationData>& calls);
+static void print_call_list(const StationTable::List& calls);
 static void parse_arguments(int argc, const char **argv);
 
 
@@ -383,12 +383,12 @@ static void process_next_stage(void)
     case PS_CONNECT_TO_IP:
       if (connect_to_ip != 0)
       {
-	StationData *station = new StationData;
-	station->setCallsign(connect_to_ip);
-	station->setIp(IpAddress(connect_to_ip));
+	StationData station;
+	station.setCallsign(connect_to_ip);
+	station.setIp(IpAddress(connect_to_ip));
 
 	EchoLinkQsoTest *echolink_qso =
-	    new EchoLinkQsoTest(my_callsign, my_name, my_info, station);
+	    new EchoLinkQsoTest(my_callsign, my_name, my_info, &station);
 	if (!echolink_qso->initOk())
 	{
 	  cerr << "ERROR: Could not create connection to " << connect_to_ip
@@ -505,11 +505,12 @@ static void on_station_list_updated(void)
       
     case PS_CONNECT_TO_CALL:
     {
-      const StationData *station = dir->findCall(connect_to_call);
-      if (station != 0)
+      StationTable::Entry entry = dir->findCall(connect_to_call);
+      if (entry.isValid())
       {
+	StationData station(entry.stationData());
 	EchoLinkQsoTest *echolink_qso =
-	    new EchoLinkQsoTest(my_callsign, my_name, my_info, station);
+	    new EchoLinkQsoTest(my_callsign, my_name, my_info, &station);
 	if (!echolink_qso->initOk())
 	{
 	  cerr << "ERROR: Could not create connection to " << my_callsign
@@ -548,16 +549,17 @@ static void on_station_list_updated(void)
  * Bugs:      
  *----------------------------------------------------------------------------
  */
-static void print_call_list(const list<StationData>& calls)
+static void print_call_list(const StationTable::List& calls)
 {
-  list<StationData>::const_iterator iter;
+  StationTable::List::const_iterator iter;
   for (iter=calls.begin(); iter!=calls.end(); ++iter)
   {
-    if ((filter == 0) || (strstr(iter->callsign().c_str(), filter) != 0))
+    StationTable::Entry stn = *iter;
+    if ((filter == 0) || (strstr(stn.callsign(), filter) != 0))
     printf("%-*s %-4s %5s %-30s %6d %s\n",
-      	StationData::MAXCALL, iter->callsign().c_str(),
-	iter->statusStr().c_str(), iter->time().c_str(),
-	iter->description().c_str(), iter->id(), iter->ipStr().c_str());
+      	StationData::MAXCALL, stn.callsign(),
+	stn.statusStr().c_str(), stn.time(),
+	stn.description(), stn.id(), stn.ip().toString().c_str());
   }  
 } /* print_call_list */
 
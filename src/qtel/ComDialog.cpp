@@ -158,14 +158,16 @@ ComDialog::ComDialog(Directory& dir, const QString& callsign,
 
   init(remote_name);
 
-  const StationData *station = dir.findCall(callsign.toStdString());
-  updateStationData(station);
-  if (station != 0)
+  StationTable::Entry entry = dir.findCall(callsign.toStdString());
+  if (entry.isValid())
   {
-    createConnection(station);
+    StationData station(entry.stationData());
+    updateStationData(&station);
+    createConnection(&station);
   }
   else
   {
+    updateStationData(0);
     dir.getCalls();
   }
 } /* ComDialog::ComDialog */
@@ -513,14 +515,18 @@ void ComDialog::createConnection(const StationData *station)
 
 void ComDialog::onStationListUpdated(void)
 {
-  const StationData *station = dir.findCall(callsign.toStdString());
-  //station = 0;
-  updateStationData(station);
+  StationTable::Entry entry = dir.findCall(callsign.toStdString());
+  StationData station;
+  if (entry.isValid())
+  {
+    station = entry.stationData();
+  }
+  updateStationData(entry.isValid() ? &station : 0);
   if (con == 0)
   {
-    if (station != 0)
+    if (entry.isValid())
     {
-      createConnection(station);
+      createConnection(&station);
     }
     else
     {
@@ -36,8 +36,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <algorithm>
 #include <iostream>
+#include <vector>
 
-#include <QtAlgorithms>
 #include <QtGlobal>
 
 
@@ -131,92 +131,32 @@ EchoLinkDirectoryModel::~EchoLinkDirectoryModel(void)
 
 
 void EchoLinkDirectoryModel::updateStationList(
-				    const list<StationData> &stn_list)
+				    const vector<StationData> &stn_list)
 {
-#if QT_VERSION >= 0x050e00
-  QList<StationData> updated_stations(stn_list.begin(), stn_list.end());
-  std::stable_sort(updated_stations.begin(), updated_stations.end());
-#else
-  QList<StationData> updated_stations =
-      QList<StationData>::fromStdList(stn_list);
-  qStableSort(updated_stations);
-#endif
-  
-  //cout << "### updated_stations=" << updated_stations.count() << endl;  
-  
-  int row = 0;
-  while (!updated_stations.isEmpty() && (row < stations.count()))
-  {
-    const StationData &updated_stn = updated_stations.first();
-    StationData &stn = stations[row];
-    if (updated_stn.callsign() == stn.callsign())
-    {
-      if (updated_stn.description() != stn.description())
-      {
-	QModelIndex stn_index = index(row, 1);
-	stn.setDescription(updated_stn.description());
-	dataChanged(stn_index, stn_index);
-      }
-      if (updated_stn.status() != stn.status())
-      {
-	QModelIndex stn_index = index(row, 2);
-	stn.setStatus(updated_stn.status());
-	dataChanged(stn_index, stn_index);
-      }
-      if (updated_stn.time() != stn.time())
-      {
-	QModelIndex stn_index = index(row, 3);
-	stn.setTime(updated_stn.time());
-	dataChanged(stn_index, stn_index);
-      }
-      if (updated_stn.id() != stn.id())
-      {
-	QModelIndex stn_index = index(row, 4);
-	stn.setId(updated_stn.id());
-	dataChanged(stn_index, stn_index);
-      }
-      if (updated_stn.ip() != stn.ip())
-      {
-	QModelIndex stn_index = index(row, 5);
-	stn.setIp(updated_stn.ip());
-	dataChanged(stn_index, stn_index);
-      }
-      row += 1;
-      updated_stations.removeFirst();
-    }
-    else if (updated_stn.callsign() < stn.callsign())
-    {
-      //cout << "### Inserting 1 row starting at row " << row << endl;
-      beginInsertRows(QModelIndex(), row, row);
-      stations.insert(row, updated_stn);
-      endInsertRows();
-      row += 1;
-      updated_stations.removeFirst();
-    }
-    else
-    {
-      removeRows(row, 1);
-    }
-  }
-  
-  if (!updated_stations.isEmpty())
-  {
-    int first = stations.count();
-    int last = stations.count()+updated_stations.count()-1;
-    //cout << "### Inserting " << last-first+1 << " rows starting at row " << row << endl;
-    beginInsertRows(QModelIndex(), first, last);
-    //stations.append(updated_stations);
-    copy(updated_stations.begin(), updated_stations.end(),
-         back_inserter(stations));
-    endInsertRows();
-  }
-  else if (row < stations.count())
+    // Sort pointers to the updated stations instead of copying them
+  vector<const StationData*> updated_stations;
+  updated_stations.reserve(stn_list.size());
+  for (vector<StationData>::const_iterator it = stn_list.begin();
+       it != stn_list.end(); ++it)
   {
-    removeRows(row, stations.count()-row);
+    updated_stations.push_back(&(*it));
   }
+  std::stable_sort(updated_stations.begin(), updated_stations.end(),
+      [](const StationData *a, const StationData *b) { return *a < *b; });
   
-  //cout << "### stations=" << rowCount() << endl;
-  
+  //cout << "### updated_stations=" << updated_stations.size() << endl;  
+
+  mergeStationList(updated_stations.size(),
+      [&](size_t pos) -> const StationData& { return *updated_stations[pos]; });
+} /* EchoLinkDirectoryModel::updateStationList */
+
+
+void EchoLinkDirectoryModel::updateStationList(
+				    const StationTable::List &stn_list)
+{
+    // The station table is already sorted on callsign
+  mergeStationList(stn_list.size(),
+      [&](size_t pos) { return stn_list[pos]; });
 } /* EchoLinkDirectoryModel::updateStationList */
 
 
@@ -362,6 +302,151 @@ bool EchoLinkDirectoryModel::removeRows(int row, int count,
  *
  ****************************************************************************/
 
+namespace {
+  const StationData& toStationData(const StationData& stn) { return stn; }
+  StationData toStationData(const StationTable::Entry& stn)
+  {
+    return stn.stationData();
+  }
+};
+
+
+template <typename GetStation>
+void EchoLinkDirectoryModel::mergeStationList(size_t cnt, GetStation get_stn)
+{
+    // Both lists are sorted on callsign so they can be merged in one pass.
+    // Consecutive rows that are inserted, removed or changed are reported
+    // to the views in one go to keep the number of repaints down.
+  int changed_first_row = -1;
+  int changed_last_row = -1;
+  int changed_first_col = 0;
+  int changed_last_col = 0;
+  auto flush_changed = [&]()
+  {
+    if (changed_first_row >= 0)
+    {
+      dataChanged(index(changed_first_row, changed_first_col),
+                  index(changed_last_row, changed_last_col));
+      changed_first_row = -1;
+    }
+  };
+
+  int row = 0;
+  size_t pos = 0;
+  while ((pos < cnt) && (row < stations.count()))
+  {
+    const auto &updated_stn = get_stn(pos);
+    StationData &stn = stations[row];
+    if (updated_stn.callsign() == stn.callsign())
+    {
+      int first_col = columnCount();
+      int last_col = -1;
+      auto mark_changed = [&](int col)
+      {
+        first_col = min(first_col, col);
+        last_col = max(last_col, col);
+      };
+      if (updated_stn.description() != stn.description())
+      {
+	stn.setDescription(updated_stn.description());
+	mark_changed(1);
+      }
+      if (updated_stn.status() != stn.status())
+      {
+	stn.setStatus(updated_stn.status());
+	mark_changed(2);
+      }
+      if (updated_stn.time() != stn.time())
+      {
+	stn.setTime(updated_stn.time());
+	mark_changed(3);
+      }
+      if (updated_stn.id() != stn.id())
+      {
+	stn.setId(updated_stn.id());
+	mark_changed(4);
+      }
+      if (updated_stn.ip() != stn.ip())
+      {
+	stn.setIp(updated_stn.ip());
+	mark_changed(5);
+      }
+
+      if (last_col >= 0)
+      {
+        if (changed_first_row < 0)
+        {
+          changed_first_row = row;
+          changed_first_col = first_col;
+          changed_last_col = last_col;
+        }
+        else
+        {
+          changed_first_col = min(changed_first_col, first_col);
+          changed_last_col = max(changed_last_col, last_col);
+        }
+        changed_last_row = row;
+      }
+      else
+      {
+        flush_changed();
+      }
+      row += 1;
+      pos += 1;
+    }
+    else if (updated_stn.callsign() < stn.callsign())
+    {
+      flush_changed();
+      size_t end = pos + 1;
+      while ((end < cnt) && (get_stn(end).callsign() < stn.callsign()))
+      {
+        ++end;
+      }
+      int count = end - pos;
+      //cout << "### Inserting " << count << " rows starting at row " << row << endl;
+      beginInsertRows(QModelIndex(), row, row+count-1);
+      for (; pos<end; ++pos)
+      {
+        stations.insert(row++, toStationData(get_stn(pos)));
+      }
+      endInsertRows();
+    }
+    else
+    {
+      flush_changed();
+      int end = row + 1;
+      while ((end < stations.count()) &&
+             (stations[end].callsign() < updated_stn.callsign()))
+      {
+        ++end;
+      }
+      removeRows(row, end-row);
+    }
+  }
+  flush_changed();
+  
+  if (pos < cnt)
+  {
+    int first = stations.count();
+    int last = first + (cnt - pos) - 1;
+    //cout << "### Inserting " << last-first+1 << " rows starting at row " << row << endl;
+    beginInsertRows(QModelIndex(), first, last);
+    stations.reserve(last + 1);
+    for (; pos<cnt; ++pos)
+    {
+      stations.append(toStationData(get_stn(pos)));
+    }
+    endInsertRows();
+  }
+  else if (row < stations.count())
+  {
+    removeRows(row, stations.count()-row);
+  }
+  
+  //cout << "### stations=" << rowCount() << endl;
+  
+} /* EchoLinkDirectoryModel::mergeStationList */
+
 
 
 /*
@@ -44,6 +44,8 @@ An example of how to use the EchoLinkDirectoryModel class
 #include <QList>
 #include <QAbstractItemModel>
 
+#include <vector>
+
 
 /****************************************************************************
  *
@@ -52,6 +54,7 @@ An example of how to use the EchoLinkDirectoryModel class
  ****************************************************************************/
 
 #include <EchoLinkStationData.h>
+#include <EchoLinkStationTable.h>
 
 
 /****************************************************************************
@@ -135,11 +138,16 @@ class EchoLinkDirectoryModel : public QAbstractItemModel
     ~EchoLinkDirectoryModel(void);
   
     /**
-     * @brief 	A_brief_member_function_description
-     * @param 	param1 Description_of_param1
-     * @return	Return_value_of_this_member_function
+     * @brief 	Update the model with a new list of stations
+     * @param 	stn_list The new list of stations, in any order
      */
-    void updateStationList(const std::list<EchoLink::StationData> &stn_list);
+    void updateStationList(const std::vector<EchoLink::StationData> &stn_list);
+
+    /**
+     * @brief 	Update the model with a new list of stations
+     * @param 	stn_list The new list of stations, sorted on callsign
+     */
+    void updateStationList(const EchoLink::StationTable::List &stn_list);
     
     QModelIndex index(int row, int column,
 			      const QModelIndex &parent = QModelIndex()) const;
@@ -159,6 +167,9 @@ class EchoLinkDirectoryModel : public QAbstractItemModel
     
   private:
     QList<EchoLink::StationData> stations;
+
+    template <typename GetStation>
+    void mergeStationList(size_t cnt, GetStation get_stn);
     
     EchoLinkDirectoryModel(const EchoLinkDirectoryModel&);
     EchoLinkDirectoryModel& operator=(const EchoLinkDirectoryModel&);
@@ -549,15 +549,15 @@ void MainWindow::initEchoLink(void)
 
 void MainWindow::updateBookmarkModel(void)
 {
-  list<StationData> bookmarks;
+  vector<StationData> bookmarks;
   QStringList callsigns = Settings::instance()->bookmarks();
   QStringList::iterator it;
   foreach (QString callsign, callsigns)
   {
-    const StationData *station = dir->findCall(callsign.toStdString());
-    if (station != 0)
+    StationTable::Entry station = dir->findCall(callsign.toStdString());
+    if (station.isValid())
     {
-      bookmarks.push_back(*station);
+      bookmarks.push_back(station.stationData());
     }
     else
     {
@@ -0,0 +1,427 @@
+/**
+@file   ddrbench.cpp
+@brief  Offline benchmark for the DDR (digital drop receiver) chain
+@author agent
+@date   2026-10-18
+
+This utility replays a recorded IQ capture (.cu8 or .cf32) through one or more
+configured DDR receivers without any radio hardware. The WBRX sections used by
+the given receivers are replaced by a file backed tuner. By default the capture
+is replayed as fast as possible and the throughput is reported in mega samples
+per second and as a multiple of real time. When profiling is enabled, the cost
+of each I/Q stage and of each audio stage is printed for every receiver.
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <popt.h>
+#include <stdint.h>
+
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <set>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncCppApplication.h>
+#include <AsyncConfig.h>
+#include <AsyncAudioProbe.h>
+#include <Rx.h>
+#include <Ddr.h>
+#include <WbRxRtlSdr.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+#define PROGRAM_NAME "DdrBench"
+
+using Clock = std::chrono::steady_clock;
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+static void parse_arguments(int argc, const char **argv);
+static void wbrx_ready_state_changed(WbRxRtlSdr *wbrx);
+static void iq_received(const vector<WbRxRtlSdr::Sample>& samples,
+                        WbRxRtlSdr *wbrx);
+static void finish(void);
+static void print_stage(const string& name, Clock::duration stage_time,
+                        Clock::duration elapsed, uint64_t samp_cnt);
+static double stream_time(void);
+static void squelch_open(bool is_open, unsigned rx_idx);
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+static string           cfgfile;
+static string           input_file;
+static vector<string>   ddr_names;
+static char             *file_format = 0;
+static int              realtime = false;
+static int              profile = false;
+static int              quiet = false;
+static Config           cfg;
+static vector<Ddr*>     ddrs;
+static vector<WbRxRtlSdr*> wbrxs;
+static set<WbRxRtlSdr*> running_wbrxs;
+static bool             started = false;
+static Clock::time_point start_time;
+static uint64_t         iq_samp_cnt = 0;
+static uint32_t         iq_samp_rate = 0;
+static unsigned         sql_open_cnt = 0;
+
+
+/****************************************************************************
+ *
+ * MAIN
+ *
+ ****************************************************************************/
+
+int main(int argc, const char *argv[])
+{
+  CppApplication app;
+
+  parse_arguments(argc, argv);
+
+  if (!cfg.open(cfgfile))
+  {
+    cerr << "*** ERROR: Could not open configuration file \""
+         << cfgfile << "\".\n";
+    exit(1);
+  }
+
+    // Replace the tuner of every WBRX used by the receivers with the capture
+  set<string> wbrx_names;
+  for (const auto& ddr_name : ddr_names)
+  {
+    string rx_type;
+    if (!cfg.getValue(ddr_name, "TYPE", rx_type) || (rx_type != "Ddr"))
+    {
+      cerr << "*** ERROR: The receiver \"" << ddr_name << "\" must be of "
+              "type Ddr\n";
+      exit(1);
+    }
+    string wbrx_name;
+    if (!cfg.getValue(ddr_name, "WBRX", wbrx_name))
+    {
+      cerr << "*** ERROR: Config variable " << ddr_name << "/WBRX not set\n";
+      exit(1);
+    }
+    if (profile)
+    {
+      cfg.setValue(ddr_name, "AUDIO_PROFILING", "1");
+    }
+    if (wbrx_names.insert(wbrx_name).second)
+    {
+      cfg.setValue(wbrx_name, "TYPE", "RtlFile");
+      cfg.setValue(wbrx_name, "FILE", input_file);
+      cfg.setValue(wbrx_name, "FILE_FORMAT",
+                   (file_format != 0) ? file_format : "auto");
+      cfg.setValue(wbrx_name, "REALTIME", realtime ? "1" : "0");
+      cfg.setValue(wbrx_name, "LOOP", "0");
+    }
+  }
+
+  for (const auto& wbrx_name : wbrx_names)
+  {
+    WbRxRtlSdr *wbrx = WbRxRtlSdr::instance(cfg, wbrx_name);
+    wbrx->readyStateChanged.connect(
+        sigc::bind(sigc::ptr_fun(wbrx_ready_state_changed), wbrx));
+    wbrx->iqReceived.connect(sigc::bind(sigc::ptr_fun(iq_received), wbrx));
+    wbrxs.push_back(wbrx);
+    running_wbrxs.insert(wbrx);
+  }
+  iq_samp_rate = wbrxs.front()->sampleRate();
+
+  cout << "--- Input file  : " << input_file << endl;
+  cout << "--- Sample rate : " << iq_samp_rate << "Hz\n";
+  cout << "--- Replay mode : " << (realtime ? "real time" : "free running")
+       << endl;
+
+  for (const auto& ddr_name : ddr_names)
+  {
+    Rx *rx = RxFactory::createNamedRx(cfg, ddr_name);
+    if ((rx == 0) || !rx->initialize())
+    {
+      cerr << "*** ERROR: Could not initialize receiver \"" << ddr_name
+           << "\"\n";
+      exit(1);
+    }
+    rx->squelchOpen.connect(
+        sigc::bind(sigc::ptr_fun(squelch_open), ddrs.size()));
+    rx->setMuteState(Rx::MUTE_NONE);
+    ddrs.push_back(static_cast<Ddr*>(rx));
+  }
+
+  cout << "\n--- Running " << ddrs.size() << " DDR receiver(s) on "
+       << wbrxs.size() << " WBRX\n";
+
+  app.exec();
+
+  for (auto ddr : ddrs)
+  {
+    delete ddr;
+  }
+
+  return 0;
+
+} /* main */
+
+
+/****************************************************************************
+ *
+ * Functions
+ *
+ ****************************************************************************/
+
+static void parse_arguments(int argc, const char **argv)
+{
+  poptContext optCon;
+  const struct poptOption optionsTable[] =
+  {
+    POPT_AUTOHELP
+    {"format", 'f', POPT_ARG_STRING, &file_format, 0,
+            "The capture file format: auto, cu8 or cf32", "<format>"},
+    {"realtime", 'R', POPT_ARG_NONE, &realtime, 0,
+            "Replay the capture at the sample rate instead of as fast "
+            "as possible", NULL},
+    {"profile", 'p', POPT_ARG_NONE, &profile, 0,
+            "Print the per stage cost for each receiver", NULL},
+    {"quiet", 'q', POPT_ARG_NONE, &quiet, 0,
+            "Do not print detected events", NULL},
+    {NULL, 0, 0, NULL, 0}
+  };
+  int err;
+
+  optCon = poptGetContext(PROGRAM_NAME, argc, argv, optionsTable, 0);
+  poptSetOtherOptionHelp(optCon,
+      "<config file> <IQ capture file> <ddr section> [<ddr section>...]");
+  poptReadDefaultConfig(optCon, 0);
+
+  err = poptGetNextOpt(optCon);
+  if (err != -1)
+  {
+    cerr << "*** ERROR: " << poptBadOption(optCon, POPT_BADOPTION_NOALIAS)
+         << ": " << poptStrerror(err) << endl;
+    poptPrintUsage(optCon, stderr, 0);
+    exit(1);
+  }
+
+  const char *arg = 0;
+  int argcnt = 0;
+  while ((arg = poptGetArg(optCon)) != NULL)
+  {
+    switch (argcnt++)
+    {
+      case 0:
+        cfgfile = arg;
+        break;
+      case 1:
+        input_file = arg;
+        break;
+      default:
+        ddr_names.push_back(arg);
+        break;
+    }
+  }
+
+  if (argcnt < 3)
+  {
+    cerr << "*** ERROR: Too few command line arguments\n";
+    poptPrintUsage(optCon, stderr, 0);
+    exit(1);
+  }
+
+  poptFreeContext(optCon);
+
+} /* parse_arguments */
+
+
+  /*
+   * The file backed tuner become ready when it start to feed samples and
+   * become not ready when the end of the capture has been reached.
+   */
+static void wbrx_ready_state_changed(WbRxRtlSdr *wbrx)
+{
+  if (wbrx->isReady())
+  {
+    if (!started)
+    {
+      started = true;
+      AudioProbe::resetAll();
+      for (auto ddr : ddrs)
+      {
+        ddr->resetIqStats();
+      }
+      start_time = Clock::now();
+    }
+    return;
+  }
+
+  if ((running_wbrxs.erase(wbrx) > 0) && running_wbrxs.empty())
+  {
+    finish();
+  }
+} /* wbrx_ready_state_changed */
+
+
+static void iq_received(const vector<WbRxRtlSdr::Sample>& samples,
+                        WbRxRtlSdr *wbrx)
+{
+  if (wbrx == wbrxs.front())
+  {
+    iq_samp_cnt += samples.size();
+  }
+} /* iq_received */
+
+
+static void finish(void)
+{
+  Clock::duration elapsed = Clock::now() - start_time;
+  double secs = std::chrono::duration<double>(elapsed).count();
+  double iq_secs = static_cast<double>(iq_samp_cnt) / iq_samp_rate;
+  cout << "--- DDR: " << iq_samp_cnt << " IQ samples ("
+       << fixed << setprecision(1) << iq_secs << "s) in "
+       << setprecision(3) << secs << "s";
+  if (secs > 0.0)
+  {
+    cout << " = " << setprecision(2) << (iq_samp_cnt / secs / 1.0e6)
+         << " MS/s (" << setprecision(1) << (iq_secs / secs)
+         << "x real time for " << ddrs.size() << " receiver(s))";
+  }
+  cout << endl;
+  cout << "--- Events: squelch_open=" << sql_open_cnt << endl;
+
+  if (profile)
+  {
+    for (auto ddr : ddrs)
+    {
+      Ddr::IqStats stats = ddr->iqStats();
+      cout << "--- " << ddr->name() << " (" << ddr->nbFq() << "Hz):\n";
+      print_stage("Translate", stats.translate, elapsed, stats.samples);
+      print_stage("Channelize", stats.channelize, elapsed, stats.samples);
+      print_stage("Demod+audio", stats.demod, elapsed, stats.samples);
+    }
+    AudioProbe::printAll(cout);
+  }
+
+  Application::app().quit();
+} /* finish */
+
+
+static void print_stage(const string& name, Clock::duration stage_time,
+                        Clock::duration elapsed, uint64_t samp_cnt)
+{
+  double ns = std::chrono::duration<double, std::nano>(stage_time).count();
+  double total_ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  cout << "      " << left << setw(12) << name << right << fixed
+       << setprecision(2) << setw(8)
+       << ((samp_cnt > 0) ? (ns / samp_cnt) : 0.0) << " ns/sample "
+       << setprecision(1) << setw(6)
+       << ((total_ns > 0.0) ? (100.0 * ns / total_ns) : 0.0) << "%\n";
+} /* print_stage */
+
+
+static double stream_time(void)
+{
+  return static_cast<double>(iq_samp_cnt) / iq_samp_rate;
+} /* stream_time */
+
+
+static void squelch_open(bool is_open, unsigned rx_idx)
+{
+  if (is_open)
+  {
+    ++sql_open_cnt;
+  }
+  if (!quiet)
+  {
+    cout << fixed << setprecision(3) << stream_time() << "s: "
+         << ddrs[rx_idx]->name() << " squelch "
+         << (is_open ? "OPEN" : "CLOSED") << endl;
+  }
+} /* squelch_open */
+
+
+
+/*
+ * This file has not been truncated
+ */
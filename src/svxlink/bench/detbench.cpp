@@ -0,0 +1,1115 @@
+/**
+@file   detbench.cpp
+@brief  Conformance and throughput benchmark for the tone detectors
+@author agent
+@date   2026-10-18
+
+This utility synthesizes standard test signals for DTMF, Sel5 and CTCSS
+detection and runs them through every software decoder of each kind. The test
+signals cover nominal levels, twist, frequency offset, signal to noise ratio
+sweeps, timing limits and talk-off using voice material. Each test case is
+scored as "accept" (all symbols must be detected and nothing else), "reject"
+(nothing may be detected) or "info" (reported but not scored). For each
+decoder the detection accuracy, the number of false detections and the
+throughput in samples per second is reported. Only the time spent inside the
+decoder is measured so the signal synthesis is not part of the figures.
+
+The built in talk-off material is synthetic, a pitch varying pulse train
+shaped by moving formant resonators. For a more realistic talk-off test,
+recorded speech can be given as a raw signed 16 bit little endian file sampled
+at the internal sample rate.
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <popt.h>
+#include <stdint.h>
+#include <endian.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncConfig.h>
+#include <AsyncAudioSink.h>
+#include <DtmfDecoder.h>
+#include <Sel5Decoder.h>
+#include <SquelchCtcss.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+#define PROGRAM_NAME "DetBench"
+
+using Clock = std::chrono::steady_clock;
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+/**
+ * @brief How a test case is scored
+ */
+enum Expect
+{
+  EXPECT_ACCEPT,  ///< All symbols must be detected and nothing else
+  EXPECT_REJECT,  ///< Nothing may be detected
+  EXPECT_INFO     ///< The result is reported but not scored
+};
+
+
+/**
+ * @brief A symbol that is expected to be detected within a sample window
+ */
+struct ExpectedSymbol
+{
+  string  symbol;
+  size_t  start;
+};
+
+
+/**
+ * @brief A symbol reported by a decoder and the position of the detection
+ */
+struct Detection
+{
+  string  symbol;
+  size_t  pos;
+};
+
+
+/**
+ * @brief A synthesized test signal and what is expected to be detected
+ */
+struct TestCase
+{
+  string                  name;
+  Expect                  expect;
+  vector<float>           signal;
+  vector<ExpectedSymbol>  symbols;
+};
+
+
+/**
+ * @brief The accumulated result for one decoder
+ */
+struct DecoderResult
+{
+  string            name;
+  uint64_t          samples = 0;
+  Clock::duration   time {};
+  unsigned          expected = 0;
+  unsigned          hits = 0;
+  unsigned          false_det = 0;
+  unsigned          scored = 0;
+  unsigned          passed = 0;
+  double            latency_sum = 0.0;
+  unsigned          latency_cnt = 0;
+};
+
+
+/**
+ * @brief Build a test signal from tones, silence, noise and voice
+ *
+ * All levels are given in dB relative to a full scale sine wave.
+ */
+class SignalBuilder
+{
+  public:
+    SignalBuilder(void) : rng(1) {}
+
+    size_t pos(void) const { return buf.size(); }
+
+    void silence(int ms)
+    {
+      buf.resize(buf.size() + msToSamples(ms), 0.0f);
+    }
+
+    void tones(const vector<pair<float, float> >& fq_db, int ms)
+    {
+      const size_t len = msToSamples(ms);
+      const size_t ramp = min(msToSamples(2), len / 2);
+      const size_t start = buf.size();
+      buf.resize(start + len, 0.0f);
+      for (const auto& tone : fq_db)
+      {
+        float amp = powf(10.0f, tone.second / 20.0f);
+        float w = 2.0f * M_PI * tone.first / INTERNAL_SAMPLE_RATE;
+        for (size_t i=0; i<len; ++i)
+        {
+          float env = 1.0f;
+          if (i < ramp)
+          {
+            env = 0.5f - 0.5f * cosf(M_PI * i / ramp);
+          }
+          else if (len - i <= ramp)
+          {
+            env = 0.5f - 0.5f * cosf(M_PI * (len - i - 1) / ramp);
+          }
+          buf[start + i] += env * amp * sinf(w * i);
+        }
+      }
+    }
+
+    void addNoise(float db)
+    {
+      normal_distribution<float> dist(0.0f, sqrtf(0.5f * powf(10.0f, db/10.0f)));
+      for (auto& sample : buf)
+      {
+        sample += dist(rng);
+      }
+    }
+
+    void addVoice(const vector<float>& voice, float db, size_t start,
+                  size_t len)
+    {
+      if (voice.empty())
+      {
+        return;
+      }
+      float gain = sqrtf(0.5f * powf(10.0f, db/10.0f));
+      len = min(len, buf.size() - start);
+      for (size_t i=0; i<len; ++i)
+      {
+        buf[start + i] += gain * voice[(voice_pos + i) % voice.size()];
+      }
+      voice_pos += len;
+    }
+
+    vector<float>& samples(void) { return buf; }
+
+    static size_t msToSamples(int ms)
+    {
+      return static_cast<size_t>(ms) * INTERNAL_SAMPLE_RATE / 1000;
+    }
+
+  private:
+    vector<float> buf;
+    mt19937       rng;
+    size_t        voice_pos = 0;
+};
+
+
+/**
+ * @brief The interface to a decoder under test
+ */
+class Detector
+{
+  public:
+    virtual ~Detector(void) {}
+    virtual const string& name(void) const = 0;
+    virtual AudioSink *sink(void) = 0;
+
+    vector<Detection>& detections(void) { return dets; }
+    void setPos(size_t pos) { cur_pos = pos; }
+
+  protected:
+    void detected(const string& symbol)
+    {
+      dets.push_back(Detection{symbol, cur_pos});
+    }
+
+  private:
+    vector<Detection> dets;
+    size_t            cur_pos = 0;
+};
+
+
+class DtmfDetector : public Detector, public sigc::trackable
+{
+  public:
+    DtmfDetector(Config& cfg, const string& type)
+      : m_name("DTMF " + type), dec(0)
+    {
+      cfg.setValue(type, "DTMF_DEC_TYPE", type);
+      dec = DtmfDecoder::create(0, cfg, type);
+      if ((dec == 0) || !dec->initialize())
+      {
+        cerr << "*** ERROR: Could not create DTMF decoder " << type << endl;
+        exit(1);
+      }
+      dec->digitActivated.connect(
+          sigc::mem_fun(*this, &DtmfDetector::digitActivated));
+    }
+    ~DtmfDetector(void) { delete dec; }
+    virtual const string& name(void) const { return m_name; }
+    virtual AudioSink *sink(void) { return dec; }
+
+  private:
+    string      m_name;
+    DtmfDecoder *dec;
+
+    void digitActivated(char digit) { detected(string(1, digit)); }
+};
+
+
+class Sel5Detector : public Detector, public sigc::trackable
+{
+  public:
+    Sel5Detector(Config& cfg, const string& type)
+      : m_name("Sel5 " + type), dec(0)
+    {
+      const string section = "Sel5" + type;
+      cfg.setValue(section, "SEL5_DEC_TYPE", "INTERNAL");
+      cfg.setValue(section, "SEL5_TYPE", type);
+      dec = Sel5Decoder::create(cfg, section);
+      if ((dec == 0) || !dec->initialize())
+      {
+        cerr << "*** ERROR: Could not create Sel5 decoder " << type << endl;
+        exit(1);
+      }
+      dec->sequenceDetected.connect(
+          sigc::mem_fun(*this, &Sel5Detector::sequenceDetected));
+    }
+    ~Sel5Detector(void) { delete dec; }
+    virtual const string& name(void) const { return m_name; }
+    virtual AudioSink *sink(void) { return dec; }
+
+  private:
+    string      m_name;
+    Sel5Decoder *dec;
+
+    void sequenceDetected(string seq) { detected(seq); }
+};
+
+
+class CtcssDetector : public Detector, public sigc::trackable
+{
+  public:
+    CtcssDetector(Config& cfg, float fq, int mode)
+    {
+      ostringstream ss;
+      ss << "CTCSS mode " << mode;
+      m_name = ss.str();
+      const string section = "Ctcss" + to_string(mode);
+      ostringstream fq_ss;
+      fq_ss << fq;
+      cfg.setValue(section, "CTCSS_FQ", fq_ss.str());
+      cfg.setValue(section, "CTCSS_MODE", to_string(mode));
+      if (!sql.initialize(cfg, section))
+      {
+        cerr << "*** ERROR: Could not create CTCSS detector mode " << mode
+             << endl;
+        exit(1);
+      }
+      sql.squelchOpen.connect(
+          sigc::mem_fun(*this, &CtcssDetector::squelchOpen));
+    }
+    virtual const string& name(void) const { return m_name; }
+    virtual AudioSink *sink(void) { return &sql; }
+
+  private:
+    string        m_name;
+    SquelchCtcss  sql;
+
+    void squelchOpen(bool is_open)
+    {
+      if (is_open)
+      {
+        detected("open");
+      }
+    }
+};
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+static void parse_arguments(int argc, const char **argv);
+static vector<string> split(const char *str);
+static bool load_voice(void);
+static void synthesize_voice(void);
+static vector<TestCase> dtmf_cases(void);
+static vector<TestCase> sel5_cases(const string& type);
+static vector<TestCase> ctcss_cases(void);
+static void run_suite(Detector& det, const vector<TestCase>& cases);
+static void score_case(const TestCase& tc, const vector<Detection>& dets,
+                       DecoderResult& res);
+static void print_summary(void);
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+static const char *dtmf_keys = "123A456B789C*0#D";
+static const float dtmf_row_fqs[] = { 697.0f, 770.0f, 852.0f, 941.0f };
+static const float dtmf_col_fqs[] = { 1209.0f, 1336.0f, 1477.0f, 1633.0f };
+
+  // Tone tables for digits 0-9, A-F. The same as in SwSel5Decoder.
+static const float sel5_zvei1_fqs[] =
+{
+  2400.0f, 1060.0f, 1160.0f, 1270.0f, 1400.0f, 1530.0f, 1670.0f, 1830.0f,
+  2000.0f, 2200.0f, 2800.0f,  810.0f,  970.0f,  885.0f, 2600.0f,  680.0f
+};
+static const float sel5_ccir_fqs[] =
+{
+  1981.0f, 1124.0f, 1197.0f, 1275.0f, 1358.0f, 1446.0f, 1540.0f, 1640.0f,
+  1747.0f, 1860.0f, 2400.0f,  930.0f, 2247.0f,  991.0f, 2110.0f, 1055.0f
+};
+
+static char           *dtmf_types_str = 0;
+static char           *sel5_types_str = 0;
+static char           *ctcss_modes_str = 0;
+static char           *voice_file = 0;
+static double         ctcss_fq = 136.5;
+static int            repeat = 2;
+static int            talkoff_secs = 60;
+static int            block_size = 256;
+static int            verbose = false;
+static Config         cfg;
+static vector<float>  voice;
+static vector<DecoderResult> results;
+
+
+/****************************************************************************
+ *
+ * MAIN
+ *
+ ****************************************************************************/
+
+int main(int argc, const char *argv[])
+{
+  parse_arguments(argc, argv);
+
+  if (voice_file != 0)
+  {
+    if (!load_voice())
+    {
+      exit(1);
+    }
+  }
+  else
+  {
+    synthesize_voice();
+  }
+
+  cout << "--- Sample rate : " << INTERNAL_SAMPLE_RATE << "Hz\n";
+  cout << "--- Block size  : " << block_size << " samples\n";
+  cout << "--- Talk-off    : " << talkoff_secs << "s of "
+       << ((voice_file != 0) ? voice_file : "synthetic voice") << endl;
+
+  vector<string> dtmf_types = split(dtmf_types_str);
+  if (!dtmf_types.empty())
+  {
+    vector<TestCase> cases = dtmf_cases();
+    for (const auto& type : dtmf_types)
+    {
+      DtmfDetector det(cfg, type);
+      run_suite(det, cases);
+    }
+  }
+
+  for (const auto& type : split(sel5_types_str))
+  {
+    vector<TestCase> cases = sel5_cases(type);
+    Sel5Detector det(cfg, type);
+    run_suite(det, cases);
+  }
+
+  vector<string> ctcss_modes = split(ctcss_modes_str);
+  if (!ctcss_modes.empty())
+  {
+    vector<TestCase> cases = ctcss_cases();
+    for (const auto& mode : ctcss_modes)
+    {
+      CtcssDetector det(cfg, ctcss_fq, atoi(mode.c_str()));
+      run_suite(det, cases);
+    }
+  }
+
+  print_summary();
+
+  return 0;
+
+} /* main */
+
+
+/****************************************************************************
+ *
+ * Functions
+ *
+ ****************************************************************************/
+
+static void parse_arguments(int argc, const char **argv)
+{
+  poptContext optCon;
+  const struct poptOption optionsTable[] =
+  {
+    POPT_AUTOHELP
+    {"dtmf", 'd', POPT_ARG_STRING, &dtmf_types_str, 0,
+            "Comma separated DTMF decoder types to test (default "
+            "INTERNAL,DH1DM)", "<types>"},
+    {"sel5", 's', POPT_ARG_STRING, &sel5_types_str, 0,
+            "Comma separated Sel5 types to test (default ZVEI1,CCIR)",
+            "<types>"},
+    {"ctcss", 'c', POPT_ARG_STRING, &ctcss_modes_str, 0,
+            "Comma separated CTCSS detector modes to test (default 0,1,2,3)",
+            "<modes>"},
+    {"ctcss-fq", 'f', POPT_ARG_DOUBLE | POPT_ARGFLAG_SHOW_DEFAULT,
+            &ctcss_fq, 0, "The CTCSS frequency to test", "<Hz>"},
+    {"repeat", 'r', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT, &repeat, 0,
+            "The number of times to repeat each symbol set", "<count>"},
+    {"talkoff", 't', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+            &talkoff_secs, 0, "The length of the talk-off test", "<seconds>"},
+    {"voice", 'v', POPT_ARG_STRING, &voice_file, 0,
+            "Raw S16_LE voice file used instead of synthetic voice",
+            "<file>"},
+    {"blocksize", 'b', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+            &block_size, 0,
+            "The number of samples to write in each block", "<samples>"},
+    {"verbose", 'V', POPT_ARG_NONE, &verbose, 0,
+            "Print the detections for each test case", NULL},
+    {NULL, 0, 0, NULL, 0}
+  };
+  int err;
+
+  optCon = poptGetContext(PROGRAM_NAME, argc, argv, optionsTable, 0);
+  poptReadDefaultConfig(optCon, 0);
+
+  err = poptGetNextOpt(optCon);
+  if (err != -1)
+  {
+    cerr << "*** ERROR: " << poptBadOption(optCon, POPT_BADOPTION_NOALIAS)
+         << ": " << poptStrerror(err) << endl;
+    poptPrintUsage(optCon, stderr, 0);
+    exit(1);
+  }
+
+  if (poptGetArg(optCon) != NULL)
+  {
+    cerr << "*** ERROR: Too many command line arguments\n";
+    poptPrintUsage(optCon, stderr, 0);
+    exit(1);
+  }
+
+    // If no suite is selected, run all of them with the default decoders
+  if ((dtmf_types_str == 0) && (sel5_types_str == 0) &&
+      (ctcss_modes_str == 0))
+  {
+    dtmf_types_str = strdup("INTERNAL,DH1DM");
+    sel5_types_str = strdup("ZVEI1,CCIR");
+    ctcss_modes_str = strdup("0,1,2,3");
+  }
+
+  if ((repeat < 1) || (talkoff_secs < 1) || (block_size < 1) ||
+      (ctcss_fq <= 0.0))
+  {
+    cerr << "*** ERROR: All numeric arguments must be larger than zero\n";
+    exit(1);
+  }
+
+  poptFreeContext(optCon);
+
+} /* parse_arguments */
+
+
+static vector<string> split(const char *str)
+{
+  vector<string> parts;
+  if (str == 0)
+  {
+    return parts;
+  }
+  stringstream ss(str);
+  string part;
+  while (getline(ss, part, ','))
+  {
+    if (!part.empty())
+    {
+      parts.push_back(part);
+    }
+  }
+  return parts;
+} /* split */
+
+
+static bool load_voice(void)
+{
+  ifstream ifs(voice_file, ios::in | ios::binary);
+  if (!ifs.good())
+  {
+    cerr << "*** ERROR: Could not open voice file \"" << voice_file
+         << "\"\n";
+    return false;
+  }
+  int16_t samp;
+  double pwr = 0.0;
+  while (ifs.read(reinterpret_cast<char*>(&samp), sizeof(samp)))
+  {
+    float val = static_cast<int16_t>(le16toh(samp)) / 32768.0f;
+    voice.push_back(val);
+    pwr += val * val;
+  }
+  if (voice.empty() || (pwr == 0.0))
+  {
+    cerr << "*** ERROR: No samples in voice file \"" << voice_file
+         << "\"\n";
+    return false;
+  }
+
+    // Normalize to the power of a full scale sine wave
+  float gain = sqrtf(0.5f * voice.size() / pwr);
+  for (auto& sample : voice)
+  {
+    sample *= gain;
+  }
+  return true;
+} /* load_voice */
+
+
+  /*
+   * Create voice like material: a glottal pulse train with a slowly varying
+   * pitch fed through three formant resonators that move between vowel
+   * positions, chopped into syllables and words. The result is normalized
+   * to the power of a full scale sine wave.
+   */
+static void synthesize_voice(void)
+{
+  static const float vowels[][3] =
+  {
+    { 730.0f, 1090.0f, 2440.0f },   // a
+    { 530.0f, 1840.0f, 2480.0f },   // e
+    { 270.0f, 2290.0f, 3010.0f },   // i
+    { 570.0f,  840.0f, 2410.0f },   // o
+    { 300.0f,  870.0f, 2240.0f },   // u
+  };
+  const float fs = INTERNAL_SAMPLE_RATE;
+  mt19937 rng(2);
+  uniform_real_distribution<float> uni(0.0f, 1.0f);
+
+  voice.resize(static_cast<size_t>(talkoff_secs) * INTERNAL_SAMPLE_RATE);
+  float pitch = 120.0f;
+  float phase = 0.0f;
+  float y1[3] = {0.0f}, y2[3] = {0.0f};
+  float cur_fq[3] = { vowels[0][0], vowels[0][1], vowels[0][2] };
+  const float *target = vowels[0];
+  size_t syllable_left = 0;
+  bool voiced = true;
+  double pwr = 0.0;
+  for (size_t i=0; i<voice.size(); ++i)
+  {
+    if (syllable_left == 0)
+    {
+      syllable_left = static_cast<size_t>((0.12f + 0.2f * uni(rng)) * fs);
+      voiced = (uni(rng) > 0.15f);
+      target = vowels[static_cast<int>(uni(rng) * 5) % 5];
+      pitch = 90.0f + 160.0f * uni(rng);
+    }
+    --syllable_left;
+
+    float src = 0.0f;
+    phase += pitch * (1.0f + 0.05f * sinf(2.0f * M_PI * 5.0f * i / fs)) / fs;
+    if (phase >= 1.0f)
+    {
+      phase -= 1.0f;
+      src = 1.0f;
+    }
+    float out = 0.0f;
+    for (int f=0; f<3; ++f)
+    {
+      cur_fq[f] += 0.002f * (target[f] - cur_fq[f]);
+      float r = 0.97f;
+      float a1 = -2.0f * r * cosf(2.0f * M_PI * cur_fq[f] / fs);
+      float a2 = r * r;
+      float y = src - a1 * y1[f] - a2 * y2[f];
+      y2[f] = y1[f];
+      y1[f] = y;
+      out += y / (f + 1);
+    }
+    if (!voiced)
+    {
+      out = 0.0f;
+    }
+    voice[i] = out;
+    pwr += out * out;
+  }
+
+  float gain = (pwr > 0.0) ? sqrtf(0.5f * voice.size() / pwr) : 0.0f;
+  for (auto& sample : voice)
+  {
+    sample *= gain;
+  }
+} /* synthesize_voice */
+
+
+  /*
+   * The DTMF cases follow the usual decoder requirements (e.g. ITU-T Q.24):
+   * accept 40ms tones with up to 4dB forward and 8dB reverse twist and a
+   * frequency offset of 1.5%, reject tones shorter than 23ms and tones off
+   * by 3.5% or more.
+   */
+static vector<TestCase> dtmf_cases(void)
+{
+  struct Params
+  {
+    string  name;
+    Expect  expect;
+    float   level;
+    float   twist;
+    float   fq_offset;
+    float   snr;
+    int     on_ms;
+    int     off_ms;
+  };
+  static const float NO_NOISE = 1000.0f;
+  const vector<Params> params =
+  {
+    { "nominal",            EXPECT_ACCEPT, -10.0f,  0.0f,  0.0f, NO_NOISE, 50, 50 },
+    { "low level -30dB",    EXPECT_ACCEPT, -30.0f,  0.0f,  0.0f, NO_NOISE, 50, 50 },
+    { "fwd twist +4dB",     EXPECT_ACCEPT, -10.0f,  4.0f,  0.0f, NO_NOISE, 50, 50 },
+    { "rev twist -8dB",     EXPECT_ACCEPT, -10.0f, -8.0f,  0.0f, NO_NOISE, 50, 50 },
+    { "fwd twist +10dB",    EXPECT_INFO,   -10.0f, 10.0f,  0.0f, NO_NOISE, 50, 50 },
+    { "rev twist -14dB",    EXPECT_INFO,   -10.0f,-14.0f,  0.0f, NO_NOISE, 50, 50 },
+    { "fq offset +1.5%",    EXPECT_ACCEPT, -10.0f,  0.0f,  1.5f, NO_NOISE, 50, 50 },
+    { "fq offset -1.5%",    EXPECT_ACCEPT, -10.0f,  0.0f, -1.5f, NO_NOISE, 50, 50 },
+    { "fq offset +3.5%",    EXPECT_REJECT, -10.0f,  0.0f,  3.5f, NO_NOISE, 50, 50 },
+    { "fq offset -3.5%",    EXPECT_REJECT, -10.0f,  0.0f, -3.5f, NO_NOISE, 50, 50 },
+    { "snr 20dB",           EXPECT_ACCEPT, -10.0f,  0.0f,  0.0f, 20.0f,    50, 50 },
+    { "snr 15dB",           EXPECT_ACCEPT, -10.0f,  0.0f,  0.0f, 15.0f,    50, 50 },
+    { "snr 10dB",           EXPECT_INFO,   -10.0f,  0.0f,  0.0f, 10.0f,    50, 50 },
+    { "snr 6dB",            EXPECT_INFO,   -10.0f,  0.0f,  0.0f,  6.0f,    50, 50 },
+    { "timing 40/40ms",     EXPECT_ACCEPT, -10.0f,  0.0f,  0.0f, NO_NOISE, 40, 40 },
+    { "timing 20ms",        EXPECT_REJECT, -10.0f,  0.0f,  0.0f, NO_NOISE, 20, 80 },
+  };
+
+  vector<TestCase> cases;
+  for (const auto& p : params)
+  {
+    TestCase tc;
+    tc.name = "DTMF " + p.name;
+    tc.expect = p.expect;
+    SignalBuilder sb;
+    sb.silence(200);
+    for (int r=0; r<repeat; ++r)
+    {
+      for (const char *key=dtmf_keys; *key != 0; ++key)
+      {
+        int idx = key - dtmf_keys;
+        float low_fq = dtmf_row_fqs[idx / 4] * (1.0f + p.fq_offset / 100.0f);
+        float high_fq = dtmf_col_fqs[idx % 4] * (1.0f + p.fq_offset / 100.0f);
+        size_t start = sb.pos();
+        sb.tones({ { low_fq, p.level - p.twist / 2.0f },
+                   { high_fq, p.level + p.twist / 2.0f } }, p.on_ms);
+        sb.silence(p.off_ms);
+        if (p.expect != EXPECT_REJECT)
+        {
+          tc.symbols.push_back(ExpectedSymbol{string(1, *key), start});
+        }
+      }
+    }
+    sb.silence(500);
+    if (p.snr < NO_NOISE)
+    {
+      sb.addNoise(p.level - p.snr);
+    }
+    tc.signal.swap(sb.samples());
+    cases.push_back(tc);
+  }
+
+  TestCase tc;
+  tc.name = "DTMF talk-off";
+  tc.expect = EXPECT_REJECT;
+  SignalBuilder sb;
+  sb.silence(talkoff_secs * 1000);
+  sb.addVoice(voice, -10.0f, 0, sb.pos());
+  sb.silence(500);
+  tc.signal.swap(sb.samples());
+  cases.push_back(tc);
+
+  return cases;
+} /* dtmf_cases */
+
+
+static vector<TestCase> sel5_cases(const string& type)
+{
+  const float *fqs = 0;
+  int tone_ms = 0;
+  if (type == "ZVEI1")
+  {
+    fqs = sel5_zvei1_fqs;
+    tone_ms = 70;
+  }
+  else if ((type == "CCIR") || (type == "CCIR1"))
+  {
+    fqs = sel5_ccir_fqs;
+    tone_ms = 100;
+  }
+  else
+  {
+    cerr << "*** ERROR: No test signal definition for Sel5 type " << type
+         << ". Valid types are ZVEI1 and CCIR\n";
+    exit(1);
+  }
+
+  struct Params
+  {
+    string  name;
+    Expect  expect;
+    float   level;
+    float   fq_offset;
+    float   snr;
+    float   duration_factor;
+  };
+  static const float NO_NOISE = 1000.0f;
+  const vector<Params> params =
+  {
+    { "nominal",          EXPECT_ACCEPT, -10.0f,  0.0f, NO_NOISE, 1.0f },
+    { "low level -30dB",  EXPECT_ACCEPT, -30.0f,  0.0f, NO_NOISE, 1.0f },
+    { "fq offset +1%",    EXPECT_ACCEPT, -10.0f,  1.0f, NO_NOISE, 1.0f },
+    { "fq offset -1%",    EXPECT_ACCEPT, -10.0f, -1.0f, NO_NOISE, 1.0f },
+    { "fq offset +3%",    EXPECT_INFO,   -10.0f,  3.0f, NO_NOISE, 1.0f },
+    { "snr 20dB",         EXPECT_ACCEPT, -10.0f,  0.0f, 20.0f,    1.0f },
+    { "snr 10dB",         EXPECT_INFO,   -10.0f,  0.0f, 10.0f,    1.0f },
+    { "snr 6dB",          EXPECT_INFO,   -10.0f,  0.0f,  6.0f,    1.0f },
+    { "timing 70%",       EXPECT_ACCEPT, -10.0f,  0.0f, NO_NOISE, 0.7f },
+    { "timing 130%",      EXPECT_ACCEPT, -10.0f,  0.0f, NO_NOISE, 1.3f },
+  };
+  const vector<string> sequences = { "12345", "11223", "90817", "55555" };
+
+  vector<TestCase> cases;
+  for (const auto& p : params)
+  {
+    TestCase tc;
+    tc.name = "Sel5 " + type + " " + p.name;
+    tc.expect = p.expect;
+    SignalBuilder sb;
+    sb.silence(200);
+    for (int r=0; r<repeat; ++r)
+    {
+      for (const auto& seq : sequences)
+      {
+        size_t start = sb.pos();
+        char prev = 0;
+        for (char digit : seq)
+        {
+            // A repeated digit is sent as the repeat tone (E)
+          char tone = (digit == prev) ? 'E' : digit;
+          prev = (digit == prev) ? 0 : digit;
+          int idx = isdigit(tone) ? (tone - '0') : (tone - 'A' + 10);
+          sb.tones({ { fqs[idx] * (1.0f + p.fq_offset / 100.0f), p.level } },
+                   static_cast<int>(tone_ms * p.duration_factor));
+        }
+        sb.silence(400);
+        tc.symbols.push_back(ExpectedSymbol{seq, start});
+      }
+    }
+    sb.silence(500);
+    if (p.snr < NO_NOISE)
+    {
+      sb.addNoise(p.level - p.snr);
+    }
+    tc.signal.swap(sb.samples());
+    cases.push_back(tc);
+  }
+
+  TestCase tc;
+  tc.name = "Sel5 " + type + " talk-off";
+  tc.expect = EXPECT_REJECT;
+  SignalBuilder sb;
+  sb.silence(talkoff_secs * 1000);
+  sb.addVoice(voice, -10.0f, 0, sb.pos());
+  sb.silence(500);
+  tc.signal.swap(sb.samples());
+  cases.push_back(tc);
+
+  return cases;
+} /* sel5_cases */
+
+
+  /*
+   * Each CTCSS case consists of bursts of one second of tone mixed with voice
+   * followed by one second of voice only. The squelch must open once for each
+   * burst. The tone level is 16dB below the voice, which roughly correspond
+   * to a 500Hz tone deviation with 3kHz voice deviation.
+   */
+static vector<TestCase> ctcss_cases(void)
+{
+  struct Params
+  {
+    string  name;
+    Expect  expect;
+    float   tone_fq;
+    float   tone_level;
+    float   snr;
+  };
+  static const float NO_NOISE = 1000.0f;
+  const float fq = ctcss_fq;
+  const vector<Params> params =
+  {
+    { "nominal",            EXPECT_ACCEPT, fq,          -26.0f, NO_NOISE },
+    { "low level -36dB",    EXPECT_ACCEPT, fq,          -36.0f, NO_NOISE },
+    { "fq offset +0.5%",    EXPECT_ACCEPT, fq * 1.005f, -26.0f, NO_NOISE },
+    { "fq offset -0.5%",    EXPECT_ACCEPT, fq * 0.995f, -26.0f, NO_NOISE },
+    { "adjacent tone +3.5%",EXPECT_REJECT, fq * 1.035f, -26.0f, NO_NOISE },
+    { "adjacent tone -3.5%",EXPECT_REJECT, fq * 0.965f, -26.0f, NO_NOISE },
+    { "snr 20dB",           EXPECT_ACCEPT, fq,          -26.0f, 20.0f },
+    { "snr 10dB",           EXPECT_INFO,   fq,          -26.0f, 10.0f },
+    { "snr 3dB",            EXPECT_INFO,   fq,          -26.0f,  3.0f },
+  };
+
+  vector<TestCase> cases;
+  for (const auto& p : params)
+  {
+    TestCase tc;
+    tc.name = "CTCSS " + p.name;
+    tc.expect = p.expect;
+    SignalBuilder sb;
+    sb.silence(500);
+    for (int r=0; r<4*repeat; ++r)
+    {
+      size_t start = sb.pos();
+      sb.tones({ { p.tone_fq, p.tone_level } }, 1000);
+      sb.addVoice(voice, -10.0f, start, sb.pos() - start);
+      size_t gap_start = sb.pos();
+      sb.silence(1000);
+      sb.addVoice(voice, -10.0f, gap_start, sb.pos() - gap_start);
+      if (p.expect != EXPECT_REJECT)
+      {
+        tc.symbols.push_back(ExpectedSymbol{"open", start});
+      }
+    }
+    sb.silence(500);
+    if (p.snr < NO_NOISE)
+    {
+        // The SNR is given for the CTCSS tone in a 300Hz wide band, which is
+        // about what the tone detector input filter let through
+      sb.addNoise(p.tone_level - p.snr +
+                  10.0f * log10f(INTERNAL_SAMPLE_RATE / 2.0f / 300.0f));
+    }
+    tc.signal.swap(sb.samples());
+    cases.push_back(tc);
+  }
+
+  TestCase tc;
+  tc.name = "CTCSS talk-off";
+  tc.expect = EXPECT_REJECT;
+  SignalBuilder sb;
+  sb.silence(talkoff_secs * 1000);
+  sb.addVoice(voice, -10.0f, 0, sb.pos());
+  sb.silence(500);
+  tc.signal.swap(sb.samples());
+  cases.push_back(tc);
+
+  return cases;
+} /* ctcss_cases */
+
+
+  /*
+   * Run all test cases through one decoder instance. Each case ends with
+   * silence that makes the decoder return to its idle state before the next
+   * case is started. Only the time spent in the decoder is measured.
+   */
+static void run_suite(Detector& det, const vector<TestCase>& cases)
+{
+  DecoderResult res;
+  res.name = det.name();
+  cout << "\n--- " << det.name() << endl;
+  for (const auto& tc : cases)
+  {
+    det.detections().clear();
+    const vector<float>& sig = tc.signal;
+    for (size_t pos=0; pos<sig.size(); pos+=block_size)
+    {
+      int cnt = min(sig.size() - pos, static_cast<size_t>(block_size));
+      det.setPos(pos);
+      Clock::time_point start = Clock::now();
+      det.sink()->writeSamples(&sig[pos], cnt);
+      res.time += Clock::now() - start;
+    }
+    res.samples += sig.size();
+    score_case(tc, det.detections(), res);
+  }
+
+  double secs = std::chrono::duration<double>(res.time).count();
+  double audio_secs = static_cast<double>(res.samples) / INTERNAL_SAMPLE_RATE;
+  cout << "    Throughput: " << fixed << setprecision(0)
+       << ((secs > 0.0) ? (res.samples / secs) : 0.0) << " samples/s ("
+       << setprecision(0) << ((secs > 0.0) ? (audio_secs / secs) : 0.0)
+       << "x real time)\n";
+  results.push_back(res);
+} /* run_suite */
+
+
+  /*
+   * Match the detections against the expected symbols. An expected symbol
+   * may be detected from its start until the start of the next expected
+   * symbol. Detections that do not match an expected symbol are counted as
+   * false detections.
+   */
+static void score_case(const TestCase& tc, const vector<Detection>& dets,
+                       DecoderResult& res)
+{
+  unsigned hits = 0;
+  unsigned false_det = 0;
+  double latency_sum = 0.0;
+  size_t exp_idx = 0;
+  string detected;
+  for (const auto& det : dets)
+  {
+    detected += (detected.empty() ? "" : " ") + det.symbol;
+    while ((exp_idx + 1 < tc.symbols.size()) &&
+           (det.pos >= tc.symbols[exp_idx + 1].start))
+    {
+      ++exp_idx;
+    }
+    if ((exp_idx < tc.symbols.size()) &&
+        (det.pos >= tc.symbols[exp_idx].start) &&
+        (det.symbol == tc.symbols[exp_idx].symbol))
+    {
+      ++hits;
+      latency_sum += det.pos - tc.symbols[exp_idx].start;
+      ++exp_idx;
+    }
+    else
+    {
+      ++false_det;
+    }
+  }
+
+  const char *verdict = "info";
+  if (tc.expect == EXPECT_ACCEPT)
+  {
+    bool ok = (hits == tc.symbols.size()) && (false_det == 0);
+    verdict = ok ? "PASS" : "FAIL";
+    res.scored += 1;
+    res.passed += ok ? 1 : 0;
+    res.expected += tc.symbols.size();
+    res.hits += hits;
+    res.false_det += false_det;
+    res.latency_sum += latency_sum;
+    res.latency_cnt += hits;
+  }
+  else if (tc.expect == EXPECT_REJECT)
+  {
+    bool ok = dets.empty();
+    verdict = ok ? "PASS" : "FAIL";
+    res.scored += 1;
+    res.passed += ok ? 1 : 0;
+    res.false_det += dets.size();
+  }
+
+  cout << "    " << left << setw(36) << tc.name << right << setw(4)
+       << verdict << "  detected " << setw(3) << hits << "/" << left
+       << setw(3) << tc.symbols.size() << right << "  false "
+       << setw(3) << false_det << endl;
+  if (verbose && !detected.empty())
+  {
+    cout << "        " << detected << endl;
+  }
+} /* score_case */
+
+
+static void print_summary(void)
+{
+  cout << "\n--- Summary (accuracy and latency over the accept cases, "
+          "latency includes the block size)\n";
+  cout << "    " << left << setw(18) << "Decoder" << right
+       << setw(8) << "Passed" << setw(10) << "Accuracy"
+       << setw(7) << "False" << setw(10) << "Latency"
+       << setw(12) << "kSamples/s" << setw(10) << "xRealtime" << endl;
+  for (const auto& res : results)
+  {
+    double secs = std::chrono::duration<double>(res.time).count();
+    double audio_secs =
+      static_cast<double>(res.samples) / INTERNAL_SAMPLE_RATE;
+    ostringstream passed;
+    passed << res.passed << "/" << res.scored;
+    cout << "    " << left << setw(18) << res.name << right
+         << setw(8) << passed.str() << fixed << setprecision(1)
+         << setw(9) << ((res.expected > 0) ?
+                        (100.0 * res.hits / res.expected) : 0.0) << "%"
+         << setw(7) << res.false_det
+         << setw(8) << ((res.latency_cnt > 0) ?
+                        (1000.0 * res.latency_sum / res.latency_cnt /
+                         INTERNAL_SAMPLE_RATE) : 0.0) << "ms"
+         << setw(12) << setprecision(0)
+         << ((secs > 0.0) ? (res.samples / secs / 1000.0) : 0.0)
+         << setw(10) << ((secs > 0.0) ? (audio_secs / secs) : 0.0)
+         << endl;
+  }
+} /* print_summary */
+
+
+
+/*
+ * This file has not been truncated
+ */
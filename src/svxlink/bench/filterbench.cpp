@@ -0,0 +1,372 @@
+/**
+@file   filterbench.cpp
+@brief  Benchmark for the two Async::AudioFilter filter engines
+@author agent
+@date   2026-10-18
+
+This utility runs noise through a number of audio filters, first using the
+generic fidlib engine and then using the second order sections engine. The time
+spent in each engine and the largest difference between the output of the two
+engines is printed. The second order sections engine is also run with several
+interleaved channels to show the gain from batching channels using the same
+filter specification.
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <popt.h>
+
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioSink.h>
+#include <AsyncAudioFilter.h>
+#include <AsyncBiquadCascade.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+#define PROGRAM_NAME "FilterBench"
+
+using Clock = std::chrono::steady_clock;
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+/**
+ * @brief An audio sink that store everything written to it
+ */
+class CaptureSink : public AudioSink
+{
+  public:
+    explicit CaptureSink(size_t size) { buf.reserve(size); }
+
+    virtual int writeSamples(const float *samples, int count)
+    {
+      buf.insert(buf.end(), samples, samples + count);
+      return count;
+    }
+
+    virtual void flushSamples(void)
+    {
+      sourceAllSamplesFlushed();
+    }
+
+    const vector<float>& samples(void) const { return buf; }
+
+  private:
+    vector<float> buf;
+};
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+static void parse_arguments(int argc, const char **argv);
+static double run_filter(const string& spec, bool use_sos,
+                         vector<float>& out);
+static double run_cascade(const string& spec, vector<float>& out);
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+  // The filters used in the LocalRx and LocalTx audio chains
+static const char *default_specs[] =
+{
+  "BpCh12/-0.1/300-3500",
+  "LpCh9/-0.05/3500",
+  "LpCh9/-0.05/5500 x HpCh12/-0.05/300",
+  "LpBu3/5500 x HpBu1/3000",
+  "LpCh10/-0.5/4500",
+  0
+};
+
+static int            sample_rate = INTERNAL_SAMPLE_RATE;
+static int            block_size = 256;
+static int            channels = 8;
+static int            seconds = 60;
+static vector<string> specs;
+static vector<float>  input;
+
+
+/****************************************************************************
+ *
+ * MAIN
+ *
+ ****************************************************************************/
+
+int main(int argc, const char *argv[])
+{
+  parse_arguments(argc, argv);
+
+  input.resize(static_cast<size_t>(sample_rate) * seconds);
+  srand(1);
+  for (auto& sample : input)
+  {
+    sample = 0.5f * (static_cast<float>(rand()) / RAND_MAX - 0.5f);
+  }
+
+  cout << "--- " << seconds << "s of noise @ " << sample_rate << "Hz in "
+       << block_size << " sample blocks, " << channels
+       << " channels in the batched test\n";
+  cout << "--- Times are in ms. The x-factors are relative to fidlib.\n\n";
+
+  cout << fixed;
+  for (const auto& spec : specs)
+  {
+    vector<float> fid_out;
+    vector<float> sos_out;
+    vector<float> batch_out;
+    double fid_ms = run_filter(spec, false, fid_out);
+    if (fid_ms < 0.0)
+    {
+      exit(1);
+    }
+    double sos_ms = run_filter(spec, true, sos_out);
+    double batch_ms = run_cascade(spec, batch_out);
+
+    cout << spec << endl;
+    cout << "  fidlib      : " << setprecision(1) << fid_ms << endl;
+    if (sos_ms < 0.0)
+    {
+      cout << "  sos         : not convertible, fidlib used\n";
+      continue;
+    }
+
+    double max_diff = 0.0;
+    double max_batch_diff = 0.0;
+    for (size_t i=0; i<input.size(); ++i)
+    {
+      max_diff = max(max_diff, static_cast<double>(
+            fabs(fid_out[i] - sos_out[i])));
+      for (int ch=0; ch<channels; ++ch)
+      {
+        max_batch_diff = max(max_batch_diff, static_cast<double>(
+              fabs(batch_out[i * channels + ch] - sos_out[i])));
+      }
+    }
+
+    cout << "  sos         : " << setprecision(1) << sos_ms
+         << " (" << setprecision(2) << (fid_ms / sos_ms) << "x, "
+         << "max diff " << scientific << setprecision(1) << max_diff
+         << fixed << ")\n";
+    cout << "  sos/channel : " << setprecision(1) << (batch_ms / channels)
+         << " (" << setprecision(2) << (fid_ms * channels / batch_ms)
+         << "x, max diff " << scientific << setprecision(1)
+         << max_batch_diff << fixed << ")\n";
+  }
+
+  return 0;
+
+} /* main */
+
+
+/****************************************************************************
+ *
+ * Functions
+ *
+ ****************************************************************************/
+
+static void parse_arguments(int argc, const char **argv)
+{
+  poptContext optCon;
+  const struct poptOption optionsTable[] =
+  {
+    POPT_AUTOHELP
+    {"rate", 'r', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT, &sample_rate, 0,
+            "The sampling rate to design the filters for", "<rate>"},
+    {"blocksize", 'b', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+            &block_size, 0,
+            "The number of samples to write in each block", "<samples>"},
+    {"channels", 'c', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT, &channels, 0,
+            "The number of channels in the batched test", "<channels>"},
+    {"seconds", 's', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT, &seconds, 0,
+            "The length of the test signal", "<seconds>"},
+    {NULL, 0, 0, NULL, 0}
+  };
+  int err;
+
+  optCon = poptGetContext(PROGRAM_NAME, argc, argv, optionsTable, 0);
+  poptSetOtherOptionHelp(optCon, "[filter spec...]");
+  poptReadDefaultConfig(optCon, 0);
+
+  err = poptGetNextOpt(optCon);
+  if (err != -1)
+  {
+    cerr << "*** ERROR: " << poptBadOption(optCon, POPT_BADOPTION_NOALIAS)
+         << ": " << poptStrerror(err) << endl;
+    poptPrintUsage(optCon, stderr, 0);
+    exit(1);
+  }
+
+  const char *arg = 0;
+  while ((arg = poptGetArg(optCon)) != NULL)
+  {
+    specs.push_back(arg);
+  }
+  if (specs.empty())
+  {
+    for (const char **spec=default_specs; *spec != 0; ++spec)
+    {
+      specs.push_back(*spec);
+    }
+  }
+
+  if ((sample_rate < 1) || (block_size < 1) || (channels < 1) ||
+      (seconds < 1))
+  {
+    cerr << "*** ERROR: All numeric arguments must be larger than zero\n";
+    exit(1);
+  }
+
+  poptFreeContext(optCon);
+
+} /* parse_arguments */
+
+
+  /*
+   * Run the input through an AudioFilter using the selected engine. The
+   * time in milliseconds is returned or -1 if the selected engine could
+   * not be used.
+   */
+static double run_filter(const string& spec, bool use_sos,
+                         vector<float>& out)
+{
+  AudioFilter::setSosBackendEnabled(use_sos);
+  AudioFilter filter(sample_rate);
+  if (!filter.parseFilterSpec(spec))
+  {
+    cerr << "*** ERROR: " << spec << ": " << filter.errorString() << endl;
+    return -1.0;
+  }
+  if (filter.usesSosBackend() != use_sos)
+  {
+    return -1.0;
+  }
+  CaptureSink sink(input.size());
+  filter.registerSink(&sink);
+
+  Clock::time_point start = Clock::now();
+  for (size_t pos=0; pos<input.size(); pos+=block_size)
+  {
+    int cnt = min(input.size() - pos, static_cast<size_t>(block_size));
+    filter.writeSamples(&input[pos], cnt);
+  }
+  Clock::duration elapsed = Clock::now() - start;
+
+  out = sink.samples();
+  return std::chrono::duration<double, std::milli>(elapsed).count();
+} /* run_filter */
+
+
+  /*
+   * Run the input through a BiquadCascade set up for the given number of
+   * interleaved channels. All channels get the same input.
+   */
+static double run_cascade(const string& spec, vector<float>& out)
+{
+  BiquadCascade cascade(channels);
+  if (!cascade.parseFilterSpec(spec, sample_rate))
+  {
+    return -1.0;
+  }
+  vector<float> in(input.size() * channels);
+  for (size_t i=0; i<input.size(); ++i)
+  {
+    fill_n(&in[i * channels], channels, input[i]);
+  }
+  out.resize(in.size());
+
+  Clock::time_point start = Clock::now();
+  for (size_t pos=0; pos<input.size(); pos+=block_size)
+  {
+    int cnt = min(input.size() - pos, static_cast<size_t>(block_size));
+    cascade.process(&out[pos * channels], &in[pos * channels], cnt);
+  }
+  Clock::duration elapsed = Clock::now() - start;
+
+  return std::chrono::duration<double, std::milli>(elapsed).count();
+} /* run_cascade */
+
+
+
+/*
+ * This file has not been truncated
+ */
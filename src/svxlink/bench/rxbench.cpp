@@ -0,0 +1,821 @@
+/**
+@file   rxbench.cpp
+@brief  Offline benchmark for the receiver and transmitter audio chains
+@author agent
+@date   2026-10-18
+
+This utility pushes audio from a file through a configured local receiver (and
+optionally a configured local transmitter) as fast as possible. No audio
+hardware is used. Instead the audio device in the configuration is replaced by
+a "bench" audio device that is fed from the file. The throughput is reported
+in samples per second and as a multiple of real time. Detected events (squelch,
+DTMF, selcall) are printed with their position in the audio stream. When
+profiling is enabled, the per stage cost is printed at the end of each pass.
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <popt.h>
+#include <stdint.h>
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <list>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncCppApplication.h>
+#include <AsyncConfig.h>
+#include <AsyncAudioIO.h>
+#include <AsyncAudioDevice.h>
+#include <AsyncAudioDeviceFactory.h>
+#include <AsyncAudioPassthrough.h>
+#include <AsyncAudioDecimator.h>
+#include <AsyncAudioProbe.h>
+#include <Rx.h>
+#include <Tx.h>
+#include <multirate_filter_coeff.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+#define PROGRAM_NAME "RxBench"
+
+using Clock = std::chrono::steady_clock;
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+/**
+ * @brief An audio device that is fed from, and written to, memory
+ *
+ * This audio device is used instead of a real sound card. Samples written to
+ * the device using the write function are distributed to all registered
+ * AudioIO objects immediately. Samples played back to the device are consumed
+ * immediately and thrown away.
+ */
+class AudioDeviceBench : public AudioDevice
+{
+  public:
+    static AudioDeviceBench* instance(const std::string& dev_name)
+    {
+      auto it = instances.find(dev_name);
+      return (it != instances.end()) ? it->second : nullptr;
+    }
+
+    explicit AudioDeviceBench(const std::string& dev_name)
+      : AudioDevice(dev_name)
+    {
+      instances[dev_name] = this;
+    }
+
+    ~AudioDeviceBench(void)
+    {
+      instances.erase(devName());
+    }
+
+    virtual size_t readBlocksize(void) { return block_size_hint; }
+    virtual size_t writeBlocksize(void) { return block_size_hint; }
+    virtual bool isFullDuplexCapable(void) { return true; }
+    virtual void audioToWriteAvailable(void) { drain(); }
+    virtual void flushSamples(void) { drain(); }
+    virtual int samplesToWrite(void) const { return 0; }
+
+    void write(const int16_t *samples, size_t frame_cnt)
+    {
+      buf.resize(frame_cnt * channels);
+      for (size_t i=0; i<frame_cnt; ++i)
+      {
+        for (size_t ch=0; ch<channels; ++ch)
+        {
+          buf[i * channels + ch] = samples[i];
+        }
+      }
+      putBlocks(buf.data(), frame_cnt);
+    }
+
+    uint64_t framesConsumed(void) const { return frames_consumed; }
+
+  protected:
+    virtual bool openDevice(Mode mode) { return true; }
+    virtual void closeDevice(void) {}
+
+  private:
+    static std::map<std::string, AudioDeviceBench*> instances;
+
+    std::vector<int16_t>  buf;
+    uint64_t              frames_consumed = 0;
+    bool                  is_draining = false;
+
+    void drain(void)
+    {
+      if (is_draining)
+      {
+        return;
+      }
+      is_draining = true;
+      std::vector<int16_t> out(writeBlocksize() * channels);
+      size_t blocks;
+      while ((blocks = getBlocks(out.data(), 1)) > 0)
+      {
+        frames_consumed += blocks * writeBlocksize();
+      }
+      is_draining = false;
+    }
+};
+
+std::map<std::string, AudioDeviceBench*> AudioDeviceBench::instances;
+
+REGISTER_AUDIO_DEVICE_TYPE("bench", AudioDeviceBench);
+
+
+/**
+ * @brief An audio sink that store all samples written to it in a vector
+ */
+class SampleCollector : public AudioSink
+{
+  public:
+    explicit SampleCollector(vector<float>& out) : out(out) {}
+
+    virtual int writeSamples(const float *samples, int count)
+    {
+      out.insert(out.end(), samples, samples + count);
+      return count;
+    }
+
+    virtual void flushSamples(void) { sourceAllSamplesFlushed(); }
+
+  private:
+    vector<float>& out;
+};
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+static void parse_arguments(int argc, const char **argv);
+static bool read_input_file(void);
+static void decimate(vector<float>& buf, AudioDecimator& dec);
+static void prepare_tx_samples(void);
+static void run_rx_pass(void);
+static void feed_rx(void);
+static void finish_rx_pass(void);
+static void run_tx_pass(void);
+static void feed_tx(void);
+static void finish_tx_pass(void);
+static void print_result(const string& what, uint64_t samp_cnt,
+                         double audio_secs, Clock::duration elapsed);
+static double stream_time(void);
+static void squelch_open(bool is_open, unsigned rx_idx);
+static void dtmf_digit_detected(char digit, int duration, unsigned rx_idx);
+static void selcall_detected(string sequence, unsigned rx_idx);
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+static const char *rx_dev_name = "bench:rx";
+static const char *tx_dev_name = "bench:tx";
+
+static string         cfgfile;
+static string         rx_name;
+static string         input_file;
+static char           *tx_name = 0;
+static int            rx_cnt = 1;
+static int            raw_rate = INTERNAL_SAMPLE_RATE;
+static int            block_size = 256;
+static int            profile = false;
+static int            quiet = false;
+static Config         cfg;
+static int            file_rate = 0;
+static vector<int16_t> samples;
+static vector<float>  tx_samples;
+static size_t         samp_pos = 0;
+static vector<Rx*>    rxs;
+static Tx             *tx = 0;
+static AudioPassthrough tx_src;
+static Clock::time_point start_time;
+static unsigned       sql_open_cnt = 0;
+static unsigned       dtmf_cnt = 0;
+static unsigned       selcall_cnt = 0;
+
+
+/****************************************************************************
+ *
+ * MAIN
+ *
+ ****************************************************************************/
+
+int main(int argc, const char *argv[])
+{
+  CppApplication app;
+
+  parse_arguments(argc, argv);
+
+  if (!cfg.open(cfgfile))
+  {
+    cerr << "*** ERROR: Could not open configuration file \""
+         << cfgfile << "\".\n";
+    exit(1);
+  }
+
+  if (!read_input_file())
+  {
+    exit(1);
+  }
+
+  if ((file_rate != 48000) && (file_rate != 16000)
+#if INTERNAL_SAMPLE_RATE <= 8000
+      && (file_rate != 8000)
+#endif
+     )
+  {
+    cerr << "*** ERROR: Unsupported sample rate " << file_rate << "Hz. "
+            "Valid rates are "
+#if INTERNAL_SAMPLE_RATE <= 8000
+            "8000, "
+#endif
+            "16000 and 48000\n";
+    exit(1);
+  }
+  AudioIO::setSampleRate(file_rate);
+  AudioIO::setBlocksize(block_size);
+
+  cout << "--- Input file  : " << input_file << " ("
+       << samples.size() << " samples @ " << file_rate << "Hz, "
+       << fixed << setprecision(1)
+       << (static_cast<double>(samples.size()) / file_rate) << "s)\n";
+  cout << "--- Block size  : " << block_size << " samples\n";
+
+  string rx_type;
+  if (!cfg.getValue(rx_name, "TYPE", rx_type) || (rx_type != "Local"))
+  {
+    cerr << "*** ERROR: The receiver \"" << rx_name << "\" must be of type "
+            "Local\n";
+    exit(1);
+  }
+  cfg.setValue(rx_name, "AUDIO_DEV", rx_dev_name);
+  cfg.setValue(rx_name, "AUDIO_CHANNEL", "0");
+  if (profile)
+  {
+    cfg.setValue(rx_name, "AUDIO_PROFILING", "1");
+  }
+
+  if (tx_name != 0)
+  {
+    string tx_type;
+    if (!cfg.getValue(tx_name, "TYPE", tx_type) || (tx_type != "Local"))
+    {
+      cerr << "*** ERROR: The transmitter \"" << tx_name << "\" must be of "
+              "type Local\n";
+      exit(1);
+    }
+    cfg.setValue(tx_name, "AUDIO_DEV", tx_dev_name);
+    cfg.setValue(tx_name, "AUDIO_CHANNEL", "0");
+    cfg.setValue(tx_name, "PTT_TYPE", "Dummy");
+    if (profile)
+    {
+      cfg.setValue(tx_name, "AUDIO_PROFILING", "1");
+    }
+  }
+
+    // Each receiver get its own copy of the configuration section so that
+    // they can be told apart in the log and in the profiling output
+  const list<string> rx_tags = cfg.listSection(rx_name);
+  for (int i=0; i<rx_cnt; ++i)
+  {
+    string section(rx_name);
+    if (i > 0)
+    {
+      section += "_" + to_string(i + 1);
+      for (const auto& tag : rx_tags)
+      {
+        string value;
+        cfg.getValue(rx_name, tag, value);
+        cfg.setValue(section, tag, value);
+      }
+    }
+    Rx *rx = RxFactory::createNamedRx(cfg, section);
+    if ((rx == 0) || !rx->initialize())
+    {
+      cerr << "*** ERROR: Could not initialize receiver \"" << section
+           << "\"\n";
+      exit(1);
+    }
+    rx->squelchOpen.connect(sigc::bind(sigc::ptr_fun(squelch_open), i));
+    rx->dtmfDigitDetected.connect(
+        sigc::bind(sigc::ptr_fun(dtmf_digit_detected), i));
+    rx->selcallSequenceDetected.connect(
+        sigc::bind(sigc::ptr_fun(selcall_detected), i));
+    rx->setMuteState(Rx::MUTE_NONE);
+    rxs.push_back(rx);
+  }
+
+  if (tx_name != 0)
+  {
+    tx = TxFactory::createNamedTx(cfg, tx_name);
+    if ((tx == 0) || !tx->initialize())
+    {
+      cerr << "*** ERROR: Could not initialize transmitter \"" << tx_name
+           << "\"\n";
+      exit(1);
+    }
+    tx_src.registerSink(tx);
+    tx->setTxCtrlMode(Tx::TX_AUTO);
+    prepare_tx_samples();
+  }
+
+  app.runTask(sigc::ptr_fun(run_rx_pass));
+  app.exec();
+
+  tx_src.unregisterSink();
+  delete tx;
+  for (auto rx : rxs)
+  {
+    delete rx;
+  }
+
+  return 0;
+
+} /* main */
+
+
+/****************************************************************************
+ *
+ * Functions
+ *
+ ****************************************************************************/
+
+static void parse_arguments(int argc, const char **argv)
+{
+  poptContext optCon;
+  const struct poptOption optionsTable[] =
+  {
+    POPT_AUTOHELP
+    {"receivers", 'n', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT, &rx_cnt, 0,
+            "The number of receivers to run in parallel. Each receiver use "
+            "a copy of the given RX section", "<count>"},
+    {"tx", 't', POPT_ARG_STRING, &tx_name, 0,
+            "Also run the input through the given transmitter",
+            "<tx section>"},
+    {"rate", 'r', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT, &raw_rate, 0,
+            "The sample rate of a raw (headerless) input file", "<rate>"},
+    {"blocksize", 'b', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+            &block_size, 0,
+            "The number of samples to write in each block", "<samples>"},
+    {"profile", 'p', POPT_ARG_NONE, &profile, 0,
+            "Print the per stage cost for the audio chains", NULL},
+    {"quiet", 'q', POPT_ARG_NONE, &quiet, 0,
+            "Do not print detected events", NULL},
+    {NULL, 0, 0, NULL, 0}
+  };
+  int err;
+
+  optCon = poptGetContext(PROGRAM_NAME, argc, argv, optionsTable, 0);
+  poptSetOtherOptionHelp(optCon,
+      "<config file> <rx section> <input file (.wav or raw S16_LE)>");
+  poptReadDefaultConfig(optCon, 0);
+
+  err = poptGetNextOpt(optCon);
+  if (err != -1)
+  {
+    cerr << "*** ERROR: " << poptBadOption(optCon, POPT_BADOPTION_NOALIAS)
+         << ": " << poptStrerror(err) << endl;
+    poptPrintUsage(optCon, stderr, 0);
+    exit(1);
+  }
+
+  const char *arg = 0;
+  int argcnt = 0;
+  while ((arg = poptGetArg(optCon)) != NULL)
+  {
+    switch (argcnt++)
+    {
+      case 0:
+        cfgfile = arg;
+        break;
+      case 1:
+        rx_name = arg;
+        break;
+      case 2:
+        input_file = arg;
+        break;
+      default:
+        cerr << "*** ERROR: Too many command line arguments\n";
+        poptPrintUsage(optCon, stderr, 0);
+        exit(1);
+    }
+  }
+
+  if (argcnt != 3)
+  {
+    cerr << "*** ERROR: Too few command line arguments\n";
+    poptPrintUsage(optCon, stderr, 0);
+    exit(1);
+  }
+
+  if ((rx_cnt < 1) || (block_size < 1))
+  {
+    cerr << "*** ERROR: The number of receivers and the block size must be "
+            "larger than zero\n";
+    exit(1);
+  }
+
+  poptFreeContext(optCon);
+
+} /* parse_arguments */
+
+
+  /*
+   * Read the whole input file into memory so that file I/O is not part of
+   * the measurement. WAV files must contain 16 bit PCM. Only the first
+   * channel is used. Files without a RIFF header are read as raw signed
+   * 16 bit little endian samples.
+   */
+static bool read_input_file(void)
+{
+  ifstream ifs(input_file.c_str(), ios::in | ios::binary);
+  if (!ifs.good())
+  {
+    cerr << "*** ERROR: Could not open input file \"" << input_file
+         << "\"\n";
+    return false;
+  }
+  vector<char> data((istreambuf_iterator<char>(ifs)),
+                    istreambuf_iterator<char>());
+
+  auto le16 = [&](size_t pos) -> uint16_t
+  {
+    return static_cast<uint8_t>(data[pos]) |
+           (static_cast<uint8_t>(data[pos+1]) << 8);
+  };
+  auto le32 = [&](size_t pos) -> uint32_t
+  {
+    return le16(pos) | (static_cast<uint32_t>(le16(pos+2)) << 16);
+  };
+
+  size_t pcm_pos = 0;
+  size_t pcm_len = data.size();
+  unsigned ch_cnt = 1;
+  file_rate = raw_rate;
+  if ((data.size() >= 12) && (memcmp(&data[0], "RIFF", 4) == 0) &&
+      (memcmp(&data[8], "WAVE", 4) == 0))
+  {
+    bool fmt_found = false;
+    pcm_len = 0;
+    size_t pos = 12;
+    while (pos + 8 <= data.size())
+    {
+      uint32_t chunk_len = le32(pos + 4);
+      size_t chunk_pos = pos + 8;
+      if (chunk_pos + chunk_len > data.size())
+      {
+        chunk_len = data.size() - chunk_pos;
+      }
+      if ((memcmp(&data[pos], "fmt ", 4) == 0) && (chunk_len >= 16))
+      {
+        if ((le16(chunk_pos) != 1) || (le16(chunk_pos + 14) != 16))
+        {
+          cerr << "*** ERROR: Only 16 bit PCM WAV files are supported\n";
+          return false;
+        }
+        ch_cnt = le16(chunk_pos + 2);
+        file_rate = le32(chunk_pos + 4);
+        fmt_found = true;
+      }
+      else if (memcmp(&data[pos], "data", 4) == 0)
+      {
+        pcm_pos = chunk_pos;
+        pcm_len = chunk_len;
+      }
+      pos = chunk_pos + chunk_len + (chunk_len & 1);
+    }
+    if (!fmt_found || (pcm_len == 0) || (ch_cnt == 0))
+    {
+      cerr << "*** ERROR: Malformed WAV file \"" << input_file << "\"\n";
+      return false;
+    }
+  }
+
+  size_t frame_cnt = pcm_len / (2 * ch_cnt);
+  samples.resize(frame_cnt);
+  for (size_t i=0; i<frame_cnt; ++i)
+  {
+    samples[i] = static_cast<int16_t>(le16(pcm_pos + 2 * i * ch_cnt));
+  }
+
+  if (samples.empty())
+  {
+    cerr << "*** ERROR: No samples in input file \"" << input_file << "\"\n";
+    return false;
+  }
+
+  return true;
+
+} /* read_input_file */
+
+
+static void decimate(vector<float>& buf, AudioDecimator& dec)
+{
+  vector<float> out;
+  SampleCollector collector(out);
+  dec.registerSink(&collector);
+  size_t pos = 0;
+  while (pos < buf.size())
+  {
+    int cnt = min(buf.size() - pos, static_cast<size_t>(block_size));
+    int ret = dec.writeSamples(&buf[pos], cnt);
+    assert(ret > 0);
+    pos += ret;
+  }
+  dec.flushSamples();
+  dec.unregisterSink();
+  buf.swap(out);
+} /* decimate */
+
+
+  /*
+   * A transmitter take audio at the internal sample rate so the input file
+   * is converted before the TX pass. This is done up front so that the
+   * conversion is not part of the measurement.
+   */
+static void prepare_tx_samples(void)
+{
+  tx_samples.resize(samples.size());
+  for (size_t i=0; i<samples.size(); ++i)
+  {
+    tx_samples[i] = static_cast<float>(samples[i]) / 32768.0f;
+  }
+  int rate = file_rate;
+  if (rate == 48000)
+  {
+    AudioDecimator d1(3, coeff_48_16, coeff_48_16_taps);
+    decimate(tx_samples, d1);
+    rate = 16000;
+  }
+#if INTERNAL_SAMPLE_RATE < 16000
+  if (rate == 16000)
+  {
+    AudioDecimator d2(2, coeff_16_8, coeff_16_8_taps);
+    decimate(tx_samples, d2);
+    rate = 8000;
+  }
+#endif
+  assert(rate == INTERNAL_SAMPLE_RATE);
+} /* prepare_tx_samples */
+
+
+static void run_rx_pass(void)
+{
+  cout << "\n--- Running " << rx_cnt << " receiver(s) \"" << rx_name
+       << "\"\n";
+  AudioProbe::resetAll();
+  samp_pos = 0;
+  start_time = Clock::now();
+  feed_rx();
+} /* run_rx_pass */
+
+
+  /*
+   * Feed one block of audio to the receivers and then let the main loop run
+   * once so that any pending tasks, timers and file descriptors are handled
+   * before the next block is fed.
+   */
+static void feed_rx(void)
+{
+  AudioDeviceBench *dev = AudioDeviceBench::instance("rx");
+  assert(dev != nullptr);
+  size_t cnt = min(samples.size() - samp_pos, static_cast<size_t>(block_size));
+  dev->write(&samples[samp_pos], cnt);
+  samp_pos += cnt;
+  if (samp_pos < samples.size())
+  {
+    Application::app().runTask(sigc::ptr_fun(feed_rx));
+  }
+  else
+  {
+    finish_rx_pass();
+  }
+} /* feed_rx */
+
+
+static void finish_rx_pass(void)
+{
+  Clock::duration elapsed = Clock::now() - start_time;
+  print_result("RX", samples.size() * rxs.size(),
+               static_cast<double>(samples.size()) / file_rate, elapsed);
+  cout << "--- Events: squelch_open=" << sql_open_cnt
+       << " dtmf_digits=" << dtmf_cnt
+       << " selcall_sequences=" << selcall_cnt << endl;
+  if (profile)
+  {
+    AudioProbe::printAll(cout);
+  }
+
+  for (auto rx : rxs)
+  {
+    rx->setMuteState(Rx::MUTE_ALL);
+  }
+
+  if (tx != 0)
+  {
+    Application::app().runTask(sigc::ptr_fun(run_tx_pass));
+  }
+  else
+  {
+    Application::app().quit();
+  }
+} /* finish_rx_pass */
+
+
+static void run_tx_pass(void)
+{
+  cout << "\n--- Running transmitter \"" << tx_name << "\"\n";
+  AudioProbe::resetAll();
+  samp_pos = 0;
+  start_time = Clock::now();
+  feed_tx();
+} /* run_tx_pass */
+
+
+static void feed_tx(void)
+{
+  size_t cnt = min(tx_samples.size() - samp_pos,
+                   static_cast<size_t>(block_size));
+  int written = tx_src.writeSamples(&tx_samples[samp_pos], cnt);
+  samp_pos += max(written, 0);
+  if (samp_pos < tx_samples.size())
+  {
+    Application::app().runTask(sigc::ptr_fun(feed_tx));
+  }
+  else
+  {
+    tx_src.flushSamples();
+    finish_tx_pass();
+  }
+} /* feed_tx */
+
+
+static void finish_tx_pass(void)
+{
+  Clock::duration elapsed = Clock::now() - start_time;
+  print_result("TX", tx_samples.size(),
+               static_cast<double>(tx_samples.size()) / INTERNAL_SAMPLE_RATE,
+               elapsed);
+  AudioDeviceBench *dev = AudioDeviceBench::instance("tx");
+  if (dev != nullptr)
+  {
+    cout << "--- Frames played back: " << dev->framesConsumed() << endl;
+  }
+  if (profile)
+  {
+    AudioProbe::printAll(cout);
+  }
+  Application::app().quit();
+} /* finish_tx_pass */
+
+
+static void print_result(const string& what, uint64_t samp_cnt,
+                         double audio_secs, Clock::duration elapsed)
+{
+  double secs = std::chrono::duration<double>(elapsed).count();
+  cout << "--- " << what << ": " << samp_cnt << " samples in "
+       << fixed << setprecision(3) << secs << "s";
+  if (secs > 0.0)
+  {
+    cout << " = " << setprecision(0) << (samp_cnt / secs) << " samples/s ("
+         << setprecision(1) << (audio_secs / secs) << "x real time";
+    if ((what == "RX") && (rxs.size() > 1))
+    {
+      cout << " per receiver";
+    }
+    cout << ")";
+  }
+  cout << endl;
+} /* print_result */
+
+
+static double stream_time(void)
+{
+  return static_cast<double>(samp_pos) / file_rate;
+} /* stream_time */
+
+
+static void squelch_open(bool is_open, unsigned rx_idx)
+{
+  if (is_open)
+  {
+    ++sql_open_cnt;
+  }
+  if (!quiet)
+  {
+    cout << fixed << setprecision(3) << stream_time() << "s: "
+         << "rx" << rx_idx << " squelch " << (is_open ? "OPEN" : "CLOSED")
+         << endl;
+  }
+} /* squelch_open */
+
+
+static void dtmf_digit_detected(char digit, int duration, unsigned rx_idx)
+{
+  ++dtmf_cnt;
+  if (!quiet)
+  {
+    cout << fixed << setprecision(3) << stream_time() << "s: "
+         << "rx" << rx_idx << " DTMF digit " << digit
+         << " (" << duration << "ms)" << endl;
+  }
+} /* dtmf_digit_detected */
+
+
+static void selcall_detected(string sequence, unsigned rx_idx)
+{
+  ++selcall_cnt;
+  if (!quiet)
+  {
+    cout << fixed << setprecision(3) << stream_time() << "s: "
+         << "rx" << rx_idx << " selcall sequence " << sequence << endl;
+  }
+} /* selcall_detected */
+
+
+
+/*
+ * This file has not been truncated
+ */
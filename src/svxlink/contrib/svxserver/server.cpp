@@ -42,6 +42,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cstring>
 #include <cstdlib>
 #include <map>
+#include <vector>
 
 
 /****************************************************************************
@@ -162,6 +163,7 @@ SvxServer::SvxServer(Async::Config &cfg)
   audio_timer->setEnable(false);
 
   master = 0;
+  purge_pending = false;
 } /* SvxServer::SvxServer */
 
 
@@ -181,19 +183,19 @@ void SvxServer::clientConnected(Async::TcpConnection *con)
 
   con->dataReceived.connect(mem_fun(*this, &SvxServer::tcpDataReceived));
 
-  pair<const string, uint16_t> key(con->remoteHost().toString(),
-                                   con->remotePort());
-  Cons clpair;
-  clpair.con = con;
-  clpair.state = STATE_VER_WAIT;
-  clpair.sql_open = false;  // set SQL close as default
-  clpair.blocked = false;   // node is not blocked as default
-  clpair.recv_exp = sizeof(Msg);
-  clpair.recv_cnt = 0;
-  gettimeofday(&clpair.last_msg, NULL);
-  gettimeofday(&clpair.sent_msg, NULL);
-
-  clients[key] = clpair;
+    // A disconnected client that has not been purged yet may have the same
+    // connection pointer so make sure to start from a clean entry
+  Cons& client = clients[con];
+  client = Cons();
+  client.con = con;
+  client.state = STATE_VER_WAIT;
+  client.sql_open = false;  // set SQL close as default
+  client.blocked = false;   // node is not blocked as default
+  client.connected = true;
+  client.recv_exp = sizeof(Msg);
+  client.recv_cnt = 0;
+  gettimeofday(&client.last_msg, NULL);
+  gettimeofday(&client.sent_msg, NULL);
 
   MsgProtoVer *ver_msg = new MsgProtoVer;
   sendMsg(con, ver_msg);
@@ -202,15 +204,14 @@ void SvxServer::clientConnected(Async::TcpConnection *con)
   {
     MsgAuthOk *auth_ok = new MsgAuthOk;
     sendMsg(con, auth_ok);
-    clpair.state = STATE_VER_WAIT;
+    client.state = STATE_VER_WAIT;
   }
   else
   {
     sendMsg(con, auth_msg);
-    clpair.state = STATE_AUTH_WAIT;
+    client.state = STATE_AUTH_WAIT;
   }
 
-  clients[key] = clpair;
   heartbeat_timer->setEnable(true);
 
 } /* SvxServer::clientConnected */
@@ -229,31 +230,35 @@ void SvxServer::clientDisconnected(Async::TcpConnection *con,
   }
   resetMaster(con);
 
-  Clients::iterator it;
-  for (it=clients.begin(); it!=clients.end(); it++)
+  Clients::iterator it = clients.find(con);
+  if ((it == clients.end()) || !(*it).second.connected)
   {
-    if ((*it).second.con == con)
-    {
-      (*it).second.state = STATE_DISC;
-      (*it).second.sql_open = false;
+    return;
+  }
 
-        // If a station lost network connection it can't be
-        // master anymore, send a SQL close command to all
-        // connected stations
-      if (isMaster(con))
-      {
-        MsgSquelch *ms = new MsgSquelch(false, 0.0, 1);
-        sendMsg(con, ms);
-      }
-      break;
-    }
+  (*it).second.state = STATE_DISC;
+  (*it).second.sql_open = false;
+
+    // If a station lost network connection it can't be
+    // master anymore, send a SQL close command to all
+    // connected stations
+  if (isMaster(con))
+  {
+    MsgSquelch *ms = new MsgSquelch(false, 0.0, 1);
+    sendMsg(con, ms);
   }
 
-  if (it != clients.end())
+  cout << "-X- removing client " << con->remoteHost() << ":"
+       << con->remotePort()  << " from client list" << endl;
+
+    // The client is removed from the list later so that this function can
+    // be called while iterating over the client list
+  (*it).second.connected = false;
+  if (!purge_pending)
   {
-    cout << "-X- removing client " << con->remoteHost() << ":"
-         << con->remotePort()  << " from client list" << endl;
-    clients.erase(it);
+    purge_pending = true;
+    Application::app().runTask(
+        mem_fun(*this, &SvxServer::purgeDisconnected));
   }
 } /* SvxServer::clientDisconnected */
 
@@ -264,29 +269,40 @@ int SvxServer::tcpDataReceived(Async::TcpConnection *con, void *data, int size)
 //  cout << "tcpDataReceived: " << con->remoteHost() << ":"
 //       << con->remotePort() << endl;
 
-  Clients::iterator it;
-  for (it=clients.begin(); it!=clients.end(); it++)
-  {
-    if (((*it).second).con == con)
-    {
-      break;
-    }
-  }
-
-  if (it == clients.end())
+  Clients::iterator it = clients.find(con);
+  if ((it == clients.end()) || !(*it).second.connected)
   {
     cout << "--- tcp data received from station out of my list "
          << con->remoteHost() << ":" << con->remotePort() << endl;
     return size;
   }
+  Cons& client = (*it).second;
 
   int orig_size = size;
   char *buf = static_cast<char*>(data);
-  while (size > 0)
+  while ((size > 0) && client.connected)
   {
-    unsigned read_cnt = min(static_cast<unsigned>(size), (*it).second.recv_exp
-                                                      - (*it).second.recv_cnt);
-    if ((*it).second.recv_cnt + read_cnt > sizeof((*it).second.recv_buf))
+      // Handle complete messages directly from the receive buffer. They
+      // only need to be copied to the client buffer if they are split over
+      // more than one read.
+    if ((client.recv_cnt == 0) && (static_cast<unsigned>(size) >= sizeof(Msg)))
+    {
+      Msg *msg = reinterpret_cast<Msg*>(buf);
+      unsigned msg_size = msg->size();
+      if ((msg_size >= sizeof(Msg)) &&
+          (msg_size <= static_cast<unsigned>(size)) &&
+          (msg_size <= sizeof(client.recv_buf)))
+      {
+        handleMsg(con, msg);
+        size -= msg_size;
+        buf += msg_size;
+        continue;
+      }
+    }
+
+    unsigned read_cnt = min(static_cast<unsigned>(size),
+                            client.recv_exp - client.recv_cnt);
+    if (client.recv_cnt + read_cnt > sizeof(client.recv_buf))
     {
       cerr << "*** ERROR: TCP receive buffer overflow " <<
               "in svxserver. Disconnecting...\n";
@@ -294,25 +310,25 @@ int SvxServer::tcpDataReceived(Async::TcpConnection *con, void *data, int size)
       clientDisconnected(con, TcpConnection::DR_ORDERED_DISCONNECT);
       return orig_size;
     }
-    memcpy((*it).second.recv_buf+(*it).second.recv_cnt, buf, read_cnt);
+    memcpy(client.recv_buf+client.recv_cnt, buf, read_cnt);
     size -= read_cnt;
-    (*it).second.recv_cnt += read_cnt;
+    client.recv_cnt += read_cnt;
     buf += read_cnt;
 
-    if ((*it).second.recv_cnt == (*it).second.recv_exp)
+    if (client.recv_cnt == client.recv_exp)
     {
-      if ((*it).second.recv_exp == sizeof(Msg))
+      if (client.recv_exp == sizeof(Msg))
       {
-        Msg *msg = reinterpret_cast<Msg*>((*it).second.recv_buf);
+        Msg *msg = reinterpret_cast<Msg*>(client.recv_buf);
         if (msg->size() == sizeof(Msg))
         {
           handleMsg(con, msg);
-          (*it).second.recv_cnt = 0;
-          (*it).second.recv_exp = sizeof(Msg);
+          client.recv_cnt = 0;
+          client.recv_exp = sizeof(Msg);
         }
         else if (msg->size() > sizeof(Msg))
         {
-          (*it).second.recv_exp = msg->size();
+          client.recv_exp = msg->size();
         }
         else
         {
@@ -325,10 +341,10 @@ int SvxServer::tcpDataReceived(Async::TcpConnection *con, void *data, int size)
       }
       else
       {
-        Msg *msg = reinterpret_cast<Msg*>((*it).second.recv_buf);
+        Msg *msg = reinterpret_cast<Msg*>(client.recv_buf);
         handleMsg(con, msg);
-        (*it).second.recv_cnt = 0;
-        (*it).second.recv_exp = sizeof(Msg);
+        client.recv_cnt = 0;
+        client.recv_exp = sizeof(Msg);
       }
     }
   }
@@ -344,26 +360,15 @@ void SvxServer::handleMsg(Async::TcpConnection *con, Msg *msg)
 //  cout << "message <---------- " << con->remoteHost() << ":" 
 //       << con->remotePort() << ", type=" << msg->type() << " received\n";
 
-  int state = STATE_READY;
-  Clients::iterator it;
-  Clients t_clients;
-
-  for (it=clients.begin(); it!=clients.end(); it++)
-  {
-    if ( ((*it).second).con == con)
-    {
-      state = (*it).second.state;
-      gettimeofday(&((*it).second).last_msg, NULL);
-      break;
-    }
-  }
-
-  if (it == clients.end())
+  Clients::iterator it = clients.find(con);
+  if ((it == clients.end()) || !(*it).second.connected)
   {
     cout << "-- message received from ip out of my list "
          << con->remoteHost() << ":" << con->remotePort() << endl;
     return;
   }
+  int state = (*it).second.state;
+  gettimeofday(&((*it).second).last_msg, NULL);
 
   switch (state)
   {
@@ -602,22 +607,16 @@ void SvxServer::audiotimeout(Timer *t)
 
 void SvxServer::sqltimeout(Timer *t)
 {
-  Clients::iterator it;
-  Clients t_clients;
-
   // find the connection handler that has a problem with
   // the SQL -> revoke the AUTH grant
-  for (it=clients.begin(); it!=clients.end(); it++)
+  Clients::iterator it = clients.find(master);
+  if (it != clients.end())
   {
-    if ( (*it).second.con == master)
-    {
-      (*it).second.state = STATE_DISC;
-      (*it).second.blocked = true;
-      cout << "*** WARNING: SQL on " << master->remoteHost() 
-           << " has been open too long, blocking station." << endl;
-      gettimeofday(&((*it).second).last_msg, NULL);
-      break;
-    }
+    (*it).second.state = STATE_DISC;
+    (*it).second.blocked = true;
+    cout << "*** WARNING: SQL on " << master->remoteHost() 
+         << " has been open too long, blocking station." << endl;
+    gettimeofday(&((*it).second).last_msg, NULL);
   }
 
   resetAll();
@@ -636,17 +635,11 @@ void SvxServer::resetAll(void)
   sendExcept(master, ms);
   sendMsg(master, ms);
 
-  Clients::iterator it;
-  Clients t_clients;
-
-  for (it=clients.begin(); it!=clients.end(); it++)
+  Clients::iterator it = clients.find(master);
+  if (it != clients.end())
   {
-    if ( (*it).second.con == master)
-    {
-      (*it).second.sql_open = false;
-      gettimeofday(&(*it).second.last_msg, NULL);
-      break;
-    }
+    (*it).second.sql_open = false;
+    gettimeofday(&(*it).second.last_msg, NULL);
   }
 
   MsgAllSamplesFlushed *o = new MsgAllSamplesFlushed;
@@ -662,12 +655,17 @@ void SvxServer::hbtimeout(Timer *t)
   struct timeval t_diff;
   int diff_ms;
 
-  Clients::iterator it;
-  Clients t_clients;
+  vector<TcpConnection*> timed_out;
   MsgHeartbeat *m = new MsgHeartbeat;
 
+  Clients::iterator it;
   for (it=clients.begin(); it!=clients.end(); it++)
   {
+    if (!(*it).second.connected)
+    {
+      continue;
+    }
+
     gettimeofday(&t_time, NULL);
     timersub(&t_time, &(*it).second.last_msg, &t_diff );
     diff_ms = int(t_diff.tv_sec * 1000 +  t_diff.tv_usec/1000);
@@ -679,7 +677,7 @@ void SvxServer::hbtimeout(Timer *t)
       cerr << "**** ERROR: Heartbeat timeout, lost connection to "
            << (*it).second.con->remoteHost() << ":"
            << (*it).second.con->remotePort() << endl;
-      t_clients.insert(*it); // storing clients to be removed later
+      timed_out.push_back((*it).second.con); // to be removed later
       (*it).second.state = STATE_DISC;
     }
     else 
@@ -689,12 +687,13 @@ void SvxServer::hbtimeout(Timer *t)
   }
 
   // removing client connection from connection pool
-  for (it = t_clients.begin(); it != t_clients.end(); it++)
+  vector<TcpConnection*>::iterator cit;
+  for (cit = timed_out.begin(); cit != timed_out.end(); ++cit)
   {
-    cout << "-X- disconnect client " << (*it).second.con->remoteHost() << ":"
-         << (*it).second.con->remotePort() << endl;
-    (*it).second.con->disconnect();
-    clientDisconnected((*it).second.con, TcpConnection::DR_ORDERED_DISCONNECT);
+    cout << "-X- disconnect client " << (*cit)->remoteHost() << ":"
+         << (*cit)->remotePort() << endl;
+    (*cit)->disconnect();
+    clientDisconnected(*cit, TcpConnection::DR_ORDERED_DISCONNECT);
   }
 
   t->reset();
@@ -704,16 +703,13 @@ void SvxServer::hbtimeout(Timer *t)
 
 void SvxServer::sendExcept(Async::TcpConnection *con, Msg *msg)
 {
-
-    // copy map to prevent a segfault by erasing a connection
-    // that exists anymore
-  Clients t_clients = clients;
+    // sending data to connected clients without the source client. Clients
+    // disconnecting while sending are only marked as disconnected so it is
+    // safe to iterate over the list without copying it.
   Clients::iterator it;
-
-    // sending data to connected clients without the source client
-  for (it = t_clients.begin(); it != t_clients.end(); it++)
+  for (it = clients.begin(); it != clients.end(); it++)
   {
-    if ((*it).second.con != con)
+    if (((*it).second.con != con) && (*it).second.connected)
     {
       sendMsg((*it).second.con, msg);
     }
@@ -777,6 +773,24 @@ void SvxServer::resetMaster(Async::TcpConnection *con)
 } /* SvxServer::resetMaster */
 
 
+void SvxServer::purgeDisconnected(void)
+{
+  purge_pending = false;
+  Clients::iterator it = clients.begin();
+  while (it != clients.end())
+  {
+    if (!(*it).second.connected)
+    {
+      it = clients.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+} /* SvxServer::purgeDisconnected */
+
+
 /*
  * This file has not been truncated
  */
@@ -34,6 +34,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <unordered_map>
 
 
 /****************************************************************************
@@ -159,10 +160,12 @@ class SvxServer : public sigc::trackable
       unsigned  recv_cnt;
       unsigned  recv_exp;
       bool  blocked;
+      bool  connected;
     };
 
-    typedef std::map<std::pair<const std::string, uint16_t>, Cons> Clients;
+    typedef std::unordered_map<Async::TcpConnection*, Cons> Clients;
     Clients clients;
+    bool    purge_pending;
 
     std::string     auth_key;
     NetTrxMsg::MsgAuthChallenge *auth_msg;
@@ -189,6 +192,7 @@ class SvxServer : public sigc::trackable
     void setMaster(Async::TcpConnection *con);
     void resetMaster(Async::TcpConnection *con);
     bool hasMaster(void);
+    void purgeDisconnected(void);
 
     SvxServer(const SvxServer&);
     SvxServer& operator=(const SvxServer&);
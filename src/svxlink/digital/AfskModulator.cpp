@@ -288,7 +288,7 @@ AfskModulator::~AfskModulator(void)
 
 
 
-void AfskModulator::sendBits(const vector<bool> &bits)
+void AfskModulator::sendBits(const BitBuffer &bits)
 {
   if (bits.empty())
   {
@@ -306,9 +306,12 @@ void AfskModulator::sendBits(const vector<bool> &bits)
   {
     fade_dir = 1;
     bitbuf.resize(FADE_SYMBOLS);
-    fill_n(bitbuf.begin(), FADE_SYMBOLS, bits.front());
+    fill_n(bitbuf.begin(), FADE_SYMBOLS, bits[0]);
+  }
+  for (size_t i=0; i<bits.size(); ++i)
+  {
+    bitbuf.push_back(bits[i]);
   }
-  bitbuf.insert(bitbuf.end(), bits.begin(), bits.end());
   writeToSink();
 } /* AfskModulator::sendBits */
 
@@ -55,6 +55,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include "BitBuffer.h"
 
 
 /****************************************************************************
@@ -137,9 +138,9 @@ class AfskModulator : public Async::AudioSource, public sigc::trackable
 
     /**
      * @brief 	Generate audio samples from the given bits
-     * @param 	bit The bit vector to send
+     * @param 	bits The bits to send
      */
-    void sendBits(const std::vector<bool> &bits);
+    void sendBits(const BitBuffer &bits);
 
   private:
     static CONSTEXPR unsigned BUFSIZE = 256;
@@ -0,0 +1,241 @@
+/**
+@file	 BitBuffer.h
+@brief   A packed buffer of bits
+@author  agent
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef BIT_BUFFER_INCLUDED
+#define BIT_BUFFER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  A packed buffer of bits
+@author agent
+@date   2026-10-18
+
+This class store a sequence of bits packed eight to a byte. The first bit in
+the sequence is stored in the least significant bit of the first byte, which
+is the same order as bits are transmitted in HDLC. Unused bits in the last
+byte are always zero.
+*/
+class BitBuffer
+{
+  public:
+    /**
+     * @brief 	Default constuctor
+     */
+    BitBuffer(void) : bit_cnt(0) {}
+
+    /**
+     * @brief   Get the number of bits in the buffer
+     * @return  Returns the number of bits
+     */
+    size_t size(void) const { return bit_cnt; }
+
+    /**
+     * @brief   Check if the buffer is empty
+     * @return  Returns \em true if there are no bits in the buffer
+     */
+    bool empty(void) const { return bit_cnt == 0; }
+
+    /**
+     * @brief   Remove all bits from the buffer
+     */
+    void clear(void)
+    {
+      bytes.clear();
+      bit_cnt = 0;
+    }
+
+    /**
+     * @brief   Reserve space for the given number of bits
+     * @param   bits The number of bits to reserve space for
+     */
+    void reserve(size_t bits) { bytes.reserve((bits + 7) / 8); }
+
+    /**
+     * @brief   Get the value of a bit
+     * @param   i The index of the bit
+     * @return  Returns the value of the bit
+     */
+    bool operator[](size_t i) const
+    {
+      return (bytes[i >> 3] >> (i & 7)) & 1;
+    }
+
+    /**
+     * @brief   Append one bit to the end of the buffer
+     * @param   bit The value of the bit
+     */
+    void push_back(bool bit) { append(bit ? 1 : 0, 1); }
+
+    /**
+     * @brief   Append a number of bits to the end of the buffer
+     * @param   bits The bits to append, least significant bit first
+     * @param   cnt The number of bits to append (max 32)
+     */
+    void append(uint32_t bits, unsigned cnt)
+    {
+      while (cnt > 0)
+      {
+        unsigned pos = bit_cnt & 7;
+        if (pos == 0)
+        {
+          bytes.push_back(0);
+        }
+        unsigned n = 8 - pos;
+        if (cnt < n)
+        {
+          n = cnt;
+        }
+        bytes.back() |= static_cast<uint8_t>((bits & ((1U << n) - 1)) << pos);
+        bits >>= n;
+        cnt -= n;
+        bit_cnt += n;
+      }
+    }
+
+    /**
+     * @brief   Append the content of another bit buffer
+     * @param   other The buffer to append
+     */
+    void append(const BitBuffer& other)
+    {
+      size_t left = other.size();
+      for (size_t i=0; left>0; ++i)
+      {
+        unsigned n = (left < 8) ? left : 8;
+        append(other.bytes[i], n);
+        left -= n;
+      }
+    }
+
+    /**
+     * @brief   Get the number of bytes used to store the bits
+     * @return  Returns the number of bytes
+     */
+    size_t byteCount(void) const { return bytes.size(); }
+
+    /**
+     * @brief   Get a pointer to the packed bits
+     * @return  Returns a pointer to the first byte
+     */
+    const uint8_t *data(void) const { return bytes.data(); }
+
+    /**
+     * @brief   Get a pointer to the packed bits
+     * @return  Returns a pointer to the first byte
+     *
+     * Bits beyond size() in the last byte must be left as zero.
+     */
+    uint8_t *data(void) { return bytes.data(); }
+
+  private:
+    std::vector<uint8_t>  bytes;
+    size_t                bit_cnt;
+
+};  /* class BitBuffer */
+
+
+//} /* namespace */
+
+#endif /* BIT_BUFFER_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,151 @@
+/**
+@file	 FskDemodulator.h
+@brief   A direct (baseband) Frequency Shift Keying demodulator
+@author  agent
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef FSK_DEMODULATOR_INCLUDED
+#define FSK_DEMODULATOR_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioSink.h>
+#include <AsyncAudioSource.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A direct (baseband) Frequency Shift Keying demodulator
+@author agent
+@date   2026-10-18
+
+Use this class to demodulate a direct FSK signal, as generated by the
+FskModulator class, from the discriminator audio of an FM receiver. Since the
+signal already consist of a high and low level for mark and space, the only
+thing needed is to low pass filter the signal to remove out of band noise. The
+output should be fed to a Synchronizer with descrambling enabled.
+*/
+class FskDemodulator : public Async::AudioSink, public Async::AudioSource
+{
+  public:
+    /**
+     * @brief 	Constuctor
+     * @param   baudrate    The baudrate of the datastream
+     * @param   sample_rate The sample rate of the audio stream
+     */
+    FskDemodulator(unsigned baudrate,
+                   unsigned sample_rate=INTERNAL_SAMPLE_RATE);
+
+    /**
+     * @brief 	Destructor
+     */
+    ~FskDemodulator(void);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    FskDemodulator(const FskDemodulator&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    FskDemodulator& operator=(const FskDemodulator&) = delete;
+
+};  /* class FskDemodulator */
+
+
+//} /* namespace */
+
+#endif /* FSK_DEMODULATOR_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,279 @@
+/**
+@file	 FskModulator.cpp
+@brief   A direct (baseband) Gaussian Frequency Shift Keying modulator
+@author  agent
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <cmath>
+#include <cstring>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncSigCAudioSource.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "FskModulator.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+FskModulator::FskModulator(unsigned baudrate, float level, float bt,
+                           unsigned sample_rate)
+  : baudrate(baudrate), sample_rate(sample_rate), delay_pos(0), bitpos(0),
+    sym_valid(false), sym_level(0.0f), bitclock(0), scrambler(0),
+    tail_left(0), buf_pos(BUFSIZE), sigc_src(0)
+{
+  ampl = powf(10.0f, level/20.0f);
+
+    // Create a Gaussian pulse shaping filter spanning FILTER_SYMBOLS
+    // symbols. The standard deviation, expressed in samples, is given by
+    // the bandwidth-time product.
+  float sps = static_cast<float>(sample_rate) / baudrate;
+  float sigma = sqrtf(logf(2.0f)) / (2.0f * M_PI * bt) * sps;
+  int half_len = static_cast<int>(FILTER_SYMBOLS * sps / 2.0f);
+  float sum = 0.0f;
+  for (int n=-half_len; n<=half_len; ++n)
+  {
+    float h = expf(-static_cast<float>(n * n) / (2.0f * sigma * sigma));
+    taps.push_back(h);
+    sum += h;
+  }
+  for (size_t i=0; i<taps.size(); ++i)
+  {
+    taps[i] /= sum;
+  }
+  delay.assign(taps.size(), 0.0f);
+
+  sigc_src = new SigCAudioSource;
+  sigc_src->sigResumeOutput.connect(
+      mem_fun(*this, &FskModulator::onResumeOutput));
+  AudioSource::setHandler(sigc_src);
+} /* FskModulator::FskModulator */
+
+
+FskModulator::~FskModulator(void)
+{
+  AudioSource::clearHandler();
+  delete sigc_src;
+} /* FskModulator::~FskModulator */
+
+
+void FskModulator::sendBits(const BitBuffer &bits)
+{
+  if (bits.empty())
+  {
+    return;
+  }
+
+  if (bitpos >= bitbuf.size())
+  {
+    bitbuf.clear();
+    bitpos = 0;
+  }
+  bitbuf.append(bits);
+  tail_left = 0;
+  writeToSink();
+} /* FskModulator::sendBits */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+float FskModulator::nextSymbolLevel(void)
+{
+  bool is_mark = bitbuf[bitpos];
+  bool tap = ((scrambler >> 11) ^ (scrambler >> 16)) & 1;
+  bool out_is_mark = (is_mark != tap);
+  scrambler = (scrambler << 1) | (out_is_mark ? 1 : 0);
+  return out_is_mark ? 1.0f : -1.0f;
+} /* FskModulator::nextSymbolLevel */
+
+
+float FskModulator::filter(float level)
+{
+  delay[delay_pos] = level;
+  float out = 0.0f;
+  size_t pos = delay_pos;
+  for (size_t i=0; i<taps.size(); ++i)
+  {
+    out += taps[i] * delay[pos];
+    pos = (pos > 0) ? pos - 1 : delay.size() - 1;
+  }
+  delay_pos = (delay_pos + 1) % delay.size();
+  return ampl * out;
+} /* FskModulator::filter */
+
+
+void FskModulator::writeToSink(void)
+{
+  for (;;)
+  {
+    if (buf_pos >= BUFSIZE)
+    {
+      if ((bitpos >= bitbuf.size()) && (tail_left == 0))
+      {
+        sigc_src->flushSamples();
+        return;
+      }
+      size_t i;
+      for (i=0; i<BUFSIZE; ++i)
+      {
+        float level = 0.0f;
+        if (bitpos < bitbuf.size())
+        {
+          if (!sym_valid)
+          {
+            sym_level = nextSymbolLevel();
+            sym_valid = true;
+          }
+          level = sym_level;
+          bitclock += baudrate;
+          if (bitclock >= sample_rate)
+          {
+            bitclock -= sample_rate;
+            sym_valid = false;
+            if (++bitpos >= bitbuf.size())
+            {
+                // Let the filter ring out after the last symbol
+              tail_left = taps.size();
+            }
+          }
+        }
+        else if (tail_left > 0)
+        {
+          --tail_left;
+        }
+        else
+        {
+          break;
+        }
+        buf[i] = filter(level);
+      }
+      memset(buf+i, 0, sizeof(*buf)*(BUFSIZE-i));
+      buf_pos = 0;
+    }
+
+    int to_write = BUFSIZE-buf_pos;
+    int written = sigc_src->writeSamples(buf+buf_pos, to_write);
+    buf_pos += written;
+    if (written == 0)
+    {
+      break;
+    }
+  }
+} /* FskModulator::writeToSink */
+
+
+void FskModulator::onResumeOutput(void)
+{
+  writeToSink();
+} /* FskModulator::onResumeOutput */
+
+
+
+/*
+ * This file has not been truncated
+ */
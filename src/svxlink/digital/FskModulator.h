@@ -0,0 +1,202 @@
+/**
+@file	 FskModulator.h
+@brief   A direct (baseband) Gaussian Frequency Shift Keying modulator
+@author  agent
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef FSK_MODULATOR_INCLUDED
+#define FSK_MODULATOR_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <vector>
+#include <stdint.h>
+#include <sigc++/sigc++.h>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioSource.h>
+#include <CppStdCompat.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "BitBuffer.h"
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+  class SigCAudioSource;
+};
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	A direct (baseband) Gaussian Frequency Shift Keying modulator
+@author agent
+@date   2026-10-18
+
+This class implement a modulator for direct FSK, where the generated audio
+signal is used to directly shift the frequency of an FM transmitter. Each bit
+is sent as a positive (mark) or negative (space) level. The level signal is
+shaped using a Gaussian filter to limit the occupied bandwidth, which makes it
+a GFSK signal when put through an FM transmitter. This mode can use a much
+higher baudrate than AFSK, up to about a third of the sample rate.
+
+The line state is scrambled before being sent, using the same self
+synchronizing scrambler as 9600Bd packet radio (G3RUH), polynomial
+1 + x^12 + x^17. That keep the signal free of DC and long runs without
+transitions so that the receiver can keep its bit clock. Enable descrambling
+in the receiving Synchronizer to undo the scrambling.
+*/
+class FskModulator : public Async::AudioSource, public sigc::trackable
+{
+  public:
+    static CONSTEXPR float DEFAULT_BT = 0.5f;
+
+    /**
+     * @brief 	Constuctor
+     * @param   baudrate    The baudrate of the bitstream
+     * @param   level       The peak level of the signal in dBFS
+     * @param   bt          The bandwidth-time product of the Gaussian filter
+     * @param   sample_rate The sample rate of the audio stream
+     */
+    FskModulator(unsigned baudrate, float level, float bt=DEFAULT_BT,
+                 unsigned sample_rate=INTERNAL_SAMPLE_RATE);
+
+    /**
+     * @brief 	Destructor
+     */
+    ~FskModulator(void);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    FskModulator(const FskModulator&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    FskModulator& operator=(const FskModulator&) = delete;
+
+    /**
+     * @brief 	Generate audio samples from the given bits
+     * @param 	bits The bits to send, each representing the line state
+     */
+    void sendBits(const BitBuffer &bits);
+
+  private:
+    static CONSTEXPR unsigned BUFSIZE = 256;
+    static CONSTEXPR unsigned FILTER_SYMBOLS = 3;
+
+    const unsigned          baudrate;
+    const unsigned          sample_rate;
+    float                   ampl;
+    std::vector<float>      taps;
+    std::vector<float>      delay;
+    unsigned                delay_pos;
+    BitBuffer               bitbuf;
+    size_t                  bitpos;
+    bool                    sym_valid;
+    float                   sym_level;
+    unsigned                bitclock;
+    uint32_t                scrambler;
+    unsigned                tail_left;
+    float                   buf[BUFSIZE];
+    unsigned                buf_pos;
+    Async::SigCAudioSource  *sigc_src;
+
+    float nextSymbolLevel(void);
+    float filter(float level);
+    void writeToSink(void);
+    void onResumeOutput(void);
+
+};  /* class FskModulator */
+
+
+//} /* namespace */
+
+#endif /* FSK_MODULATOR_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
@@ -75,6 +75,65 @@ using namespace std;
  *
  ****************************************************************************/
 
+namespace {
+    /*
+     * Destuffing information for one byte given the number of consecutive
+     * ones that preceded it. A byte is special if it contain a stuffed zero
+     * or the end of a flag, in which case it have to be handled bit by bit.
+     * All other bytes are plain data and can be handled in one go. Runs of
+     * seven or more ones are handled in the same way so the count is
+     * saturated at seven.
+     */
+  struct DestuffEntry
+  {
+    uint8_t ones;
+    bool    special;
+  };
+
+  class DestuffTable
+  {
+    public:
+      static const unsigned MAX_ONES = 7;
+
+      DestuffTable(void)
+      {
+        for (unsigned ones_in=0; ones_in<=MAX_ONES; ++ones_in)
+        {
+          for (unsigned byte=0; byte<256; ++byte)
+          {
+            DestuffEntry &e = tab[ones_in][byte];
+            e.special = false;
+            unsigned ones = ones_in;
+            for (unsigned bit=0; bit<8; ++bit)
+            {
+              if ((byte >> bit) & 0x01)
+              {
+                ones = (ones < MAX_ONES) ? ones + 1 : MAX_ONES;
+              }
+              else
+              {
+                if ((ones == 5) || (ones == 6))
+                {
+                  e.special = true;
+                }
+                ones = 0;
+              }
+            }
+            e.ones = ones;
+          }
+        }
+      }
+
+      const DestuffEntry& operator()(unsigned ones, uint8_t byte) const
+      {
+        return tab[(ones < MAX_ONES) ? ones : MAX_ONES][byte];
+      }
+
+    private:
+      DestuffEntry tab[MAX_ONES+1][256];
+  };
+};
+
 
 
 /****************************************************************************
@@ -99,6 +158,10 @@ using namespace std;
  *
  ****************************************************************************/
 
+namespace {
+  const DestuffTable destuff_table;
+};
+
 
 
 /****************************************************************************
@@ -118,131 +181,193 @@ HdlcDeframer::~HdlcDeframer(void)
 } /* HdlcDeframer::~HdlcDeframer */
 
 
-void HdlcDeframer::bitsReceived(vector<bool> &bits)
+void HdlcDeframer::bitsReceived(const BitBuffer &bits)
 {
-  for (size_t i=0; i<bits.size(); ++i)
+  const uint8_t *buf = bits.data();
+  size_t left = bits.size();
+  for (size_t i=0; left>0; ++i)
   {
-    bool flag_detected = false;
-
-      // Undo bitstuffing. If we receive a zero and the previous five bits
-      // have been ones, the zero should be thrown away.
-    if (bits[i])
+    uint8_t byte = buf[i];
+    unsigned cnt = (left < 8) ? left : 8;
+    const DestuffEntry &e = destuff_table(ones, byte);
+    if ((cnt == 8) && !e.special)
     {
-      ones += 1;
+      dataByteReceived(byte);
+      ones = e.ones;
     }
     else
     {
-      if (ones == 5)
-      {
-        ones = 0;
-        continue;
-      }
-      else if (ones == 6)
+      for (unsigned bit=0; bit<cnt; ++bit)
       {
-        flag_detected = true;
+        bitReceived(byte & 0x01);
+        byte >>= 1;
       }
-      ones = 0;
     }
+    left -= cnt;
+  }
+} /* HdlcDeframer::bitsReceived */
 
-    next_byte >>= 1;
-    next_byte |= (bits[i] << 7);
-    switch (state)
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void HdlcDeframer::bitReceived(bool bit)
+{
+  bool flag_detected = false;
+
+    // Undo bitstuffing. If we receive a zero and the previous five bits
+    // have been ones, the zero should be thrown away.
+  if (bit)
+  {
+    ones += 1;
+  }
+  else
+  {
+    if (ones == 5)
     {
-      case STATE_SYNCHRONIZING:
-        if (next_byte == 0x7e)
-        {
-          state = STATE_FRAME_START_WAIT;
-          bit_cnt = 0;
-        }
-        break;
+      ones = 0;
+      return;
+    }
+    else if (ones == 6)
+    {
+      flag_detected = true;
+    }
+    ones = 0;
+  }
 
-      case STATE_FRAME_START_WAIT:
-        if (++bit_cnt >= 8)
-        {
-          if (next_byte != 0x7e)
-          {
-            state = STATE_RECEIVING;
-            frame.clear();
-            frame.push_back(next_byte);
-          }
-          //frame.push_back(next_byte);
-          bit_cnt = 0;
-        }
-        else if (next_byte == 0x7e)
+  next_byte >>= 1;
+  next_byte |= (bit << 7);
+  switch (state)
+  {
+      // Flags are detected using the count of consecutive ones rather than
+      // by looking at next_byte since a destuffed data bit sequence may
+      // look like a flag.
+    case STATE_SYNCHRONIZING:
+      if (flag_detected)
+      {
+        state = STATE_FRAME_START_WAIT;
+        bit_cnt = 0;
+      }
+      break;
+
+    case STATE_FRAME_START_WAIT:
+      if (++bit_cnt >= 8)
+      {
+        if (!flag_detected)
         {
-          bit_cnt = 0;
-          //frame.clear();
-          //frame.push_back(next_byte);
+          state = STATE_RECEIVING;
+          frame.clear();
+          frame.push_back(next_byte);
         }
-        break;
+        //frame.push_back(next_byte);
+        bit_cnt = 0;
+      }
+      else if (flag_detected)
+      {
+        bit_cnt = 0;
+        //frame.clear();
+        //frame.push_back(next_byte);
+      }
+      break;
 
-      case STATE_RECEIVING:
-        if (++bit_cnt >= 8)
+    case STATE_RECEIVING:
+      if (++bit_cnt >= 8)
+      {
+        if (flag_detected)
         {
-          if (flag_detected)
+          state = STATE_FRAME_START_WAIT;
+          /*
+          for (size_t i=0; i<frame.size(); ++i)
           {
-            state = STATE_FRAME_START_WAIT;
-            /*
-            for (size_t i=0; i<frame.size(); ++i)
+            if (isprint(frame[i]))
             {
-              if (isprint(frame[i]))
-              {
-                cout << setw(2) << setfill(' ') << (char)frame[i];
-              }
-              else
-              {
-                cout << hex << setw(2) << setfill('0')
-                     << (int)frame[i] << " ";
-              }
+              cout << setw(2) << setfill(' ') << (char)frame[i];
             }
-            cout << endl << endl;
-            */
-            if ((frame.size() > 2) && fcsOk(frame))
+            else
             {
-                // Remove CRC from frame
-              frame.pop_back();
-              frame.pop_back();
-              frameReceived(frame);
+              cout << hex << setw(2) << setfill('0')
+                   << (int)frame[i] << " ";
             }
           }
-          else
+          cout << endl << endl;
+          */
+          if ((frame.size() > 2) && fcsOk(frame))
           {
-            if(frame.size() < 330)
-            {
-              frame.push_back(next_byte);
-              next_byte = 0;
-            }
-            else
-            {
-              state = STATE_SYNCHRONIZING;
-            }
+              // Remove CRC from frame
+            frame.pop_back();
+            frame.pop_back();
+            frameReceived(frame);
           }
-          bit_cnt = 0;
         }
-        else if (flag_detected)
+        else
         {
-          state = STATE_FRAME_START_WAIT;
-          bit_cnt = 0;
+          if(frame.size() < 330)
+          {
+            frame.push_back(next_byte);
+            next_byte = 0;
+          }
+          else
+          {
+            state = STATE_SYNCHRONIZING;
+          }
         }
-        break;
-    }
+        bit_cnt = 0;
+      }
+      else if (flag_detected)
+      {
+        state = STATE_FRAME_START_WAIT;
+        bit_cnt = 0;
+      }
+      break;
   }
-} /* HdlcDeframer::bitsReceived */
+} /* HdlcDeframer::bitReceived */
 
 
-/****************************************************************************
- *
- * Protected member functions
- *
- ****************************************************************************/
+  /*
+   * Handle eight data bits that contain no stuffed zero and no flag. This
+   * give the same result as calling bitReceived for each bit.
+   */
+void HdlcDeframer::dataByteReceived(uint8_t bits)
+{
+  if (state == STATE_SYNCHRONIZING)
+  {
+    return;
+  }
 
+    // Exactly one byte is completed. The last bit_cnt bits of the input
+    // are left over for the next byte.
+  uint8_t byte = (bit_cnt > 0)
+    ? static_cast<uint8_t>((next_byte >> (8 - bit_cnt)) | (bits << bit_cnt))
+    : bits;
+  next_byte = bits;
 
+  if (state == STATE_FRAME_START_WAIT)
+  {
+    state = STATE_RECEIVING;
+    frame.clear();
+    frame.push_back(byte);
+  }
+  else if (frame.size() < 330)
+  {
+    frame.push_back(byte);
+  }
+  else
+  {
+    state = STATE_SYNCHRONIZING;
+  }
+} /* HdlcDeframer::dataByteReceived */
 
-/****************************************************************************
- *
- * Private member functions
- *
- ****************************************************************************/
 
 
 
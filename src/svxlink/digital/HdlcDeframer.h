@@ -52,6 +52,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include "BitBuffer.h"
 
 
 /****************************************************************************
@@ -112,6 +113,10 @@ bitstream. An HDLC frame will start and end with one or more flag bytes,
 01111110. The content must be one or more data bytes followed by two CRC bytes
 (Frame Check Sequence). The deframed data bytes will be emitted without the CRC
 bytes.
+
+The bitstream is processed a byte at a time. A lookup table is used to find
+bytes that contain a stuffed zero or a flag. Only those bytes are handled bit
+by bit.
 */
 class HdlcDeframer : public sigc::trackable
 {
@@ -130,7 +135,7 @@ class HdlcDeframer : public sigc::trackable
      * @brief 	Process bitstream
      * @param 	bits The bitstream to process
      */
-    void bitsReceived(std::vector<bool> &bits);
+    void bitsReceived(const BitBuffer &bits);
 
     /**
      * @brief 	Signal that is emitted when a complete frame have been received
@@ -151,6 +156,8 @@ class HdlcDeframer : public sigc::trackable
 
     HdlcDeframer(const HdlcDeframer&);
     HdlcDeframer& operator=(const HdlcDeframer&);
+    void bitReceived(bool bit);
+    void dataByteReceived(uint8_t bits);
 
 };  /* class HdlcDeframer */
 
@@ -73,6 +73,93 @@ using namespace std;
  *
  ****************************************************************************/
 
+namespace {
+    /*
+     * The result of bit stuffing one byte given the number of consecutive
+     * ones that preceded it. A byte can grow to at most ten bits.
+     */
+  struct StuffEntry
+  {
+    uint16_t  bits;
+    uint8_t   cnt;
+    uint8_t   ones;
+  };
+
+  class StuffTable
+  {
+    public:
+      StuffTable(void)
+      {
+        for (unsigned ones_in=0; ones_in<5; ++ones_in)
+        {
+          for (unsigned byte=0; byte<256; ++byte)
+          {
+            StuffEntry &e = tab[ones_in][byte];
+            e.bits = 0;
+            e.cnt = 0;
+            unsigned ones = ones_in;
+            for (unsigned bit=0; bit<8; ++bit)
+            {
+              bool is_one = (byte >> bit) & 0x01;
+              e.bits |= (is_one ? 1 : 0) << e.cnt++;
+              ones = is_one ? ones + 1 : 0;
+              if (ones == 5)
+              {
+                e.cnt++;
+                ones = 0;
+              }
+            }
+            e.ones = ones;
+          }
+        }
+      }
+
+      const StuffEntry& operator()(unsigned ones, uint8_t byte) const
+      {
+        return tab[ones][byte];
+      }
+
+    private:
+      StuffEntry tab[5][256];
+  };
+
+    /*
+     * NRZI encoding of one byte for both start line states. A zero bit is
+     * encoded as a change of line state and a one bit as no change.
+     */
+  class NrziTable
+  {
+    public:
+      NrziTable(void)
+      {
+        for (unsigned start=0; start<2; ++start)
+        {
+          for (unsigned byte=0; byte<256; ++byte)
+          {
+            bool is_mark = (start != 0);
+            uint8_t out = 0;
+            for (unsigned bit=0; bit<8; ++bit)
+            {
+              if (((byte >> bit) & 0x01) == 0)
+              {
+                is_mark = !is_mark;
+              }
+              out |= (is_mark ? 1 : 0) << bit;
+            }
+            tab[start][byte] = out;
+          }
+        }
+      }
+
+      uint8_t operator()(bool start_is_mark, uint8_t byte) const
+      {
+        return tab[start_is_mark ? 1 : 0][byte];
+      }
+
+    private:
+      uint8_t tab[2][256];
+  };
+};
 
 
 /****************************************************************************
@@ -97,6 +184,13 @@ using namespace std;
  *
  ****************************************************************************/
 
+namespace {
+  const uint8_t HDLC_FLAG = 0x7e;
+
+  const StuffTable stuff_table;
+  const NrziTable nrzi_table;
+};
+
 
 
 /****************************************************************************
@@ -118,22 +212,17 @@ HdlcFramer::~HdlcFramer(void)
 
 void HdlcFramer::sendBytes(const vector<uint8_t> &frame)
 {
-  vector<bool> bitbuf;
+  BitBuffer bitbuf;
+  bitbuf.reserve(8 * (start_flag_cnt + 1) + 10 * (frame.size() + 2));
 
     // Store frame start flags
   for (size_t i=0; i<start_flag_cnt; ++i)
   {
-    bitbuf.push_back(!prev_was_mark);
-    bitbuf.push_back(!prev_was_mark);
-    bitbuf.push_back(!prev_was_mark);
-    bitbuf.push_back(!prev_was_mark);
-    bitbuf.push_back(!prev_was_mark);
-    bitbuf.push_back(!prev_was_mark);
-    bitbuf.push_back(!prev_was_mark);
-    bitbuf.push_back(prev_was_mark);
+    bitbuf.append(HDLC_FLAG, 8);
   }
 
     // Store frame data
+  ones = 0;
   for (size_t i=0; i<frame.size(); ++i)
   {
     encodeByte(bitbuf, frame[i]);
@@ -145,15 +234,9 @@ void HdlcFramer::sendBytes(const vector<uint8_t> &frame)
   encodeByte(bitbuf, crc >> 8);
 
     // Store frame end flag
-  bitbuf.push_back(!prev_was_mark);
-  bitbuf.push_back(!prev_was_mark);
-  bitbuf.push_back(!prev_was_mark);
-  bitbuf.push_back(!prev_was_mark);
-  bitbuf.push_back(!prev_was_mark);
-  bitbuf.push_back(!prev_was_mark);
-  bitbuf.push_back(!prev_was_mark);
-  bitbuf.push_back(prev_was_mark);
+  bitbuf.append(HDLC_FLAG, 8);
 
+  nrziEncode(bitbuf);
   sendBits(bitbuf);
 } /* HdlcFramer::sendBytes */
 
@@ -172,33 +255,33 @@ void HdlcFramer::sendBytes(const vector<uint8_t> &frame)
  *
  ****************************************************************************/
 
-void HdlcFramer::encodeByte(vector<bool> &bitbuf, uint8_t data)
+void HdlcFramer::encodeByte(BitBuffer &bitbuf, uint8_t data)
 {
-  for (size_t bit=0; bit<8; ++bit)
-  {
-    bool is_one = (data & 0x01);
-    data >>= 1;
+  const StuffEntry &e = stuff_table(ones, data);
+  bitbuf.append(e.bits, e.cnt);
+  ones = e.ones;
+} /* HdlcFramer::encodeByte */
 
-    bool is_mark = is_one ? prev_was_mark : !prev_was_mark;
-    bitbuf.push_back(is_mark);
 
-    if (is_one)
-    {
-      if (++ones == 5)
-      {
-        bitbuf.push_back(!prev_was_mark);
-        is_mark = !prev_was_mark;
-        ones = 0;
-      }
-    }
-    else
-    {
-      ones = 0;
-    }
+void HdlcFramer::nrziEncode(BitBuffer &bitbuf)
+{
+  uint8_t *buf = bitbuf.data();
+  size_t full_bytes = bitbuf.size() / 8;
+  for (size_t i=0; i<full_bytes; ++i)
+  {
+    buf[i] = nrzi_table(prev_was_mark, buf[i]);
+    prev_was_mark = (buf[i] & 0x80) != 0;
+  }
 
-    prev_was_mark = is_mark;
+    // The last byte may be partially filled. Unused bits must be kept zero.
+  unsigned rest = bitbuf.size() & 7;
+  if (rest > 0)
+  {
+    uint8_t mask = (1 << rest) - 1;
+    buf[full_bytes] = nrzi_table(prev_was_mark, buf[full_bytes]) & mask;
+    prev_was_mark = ((buf[full_bytes] >> (rest - 1)) & 0x01) != 0;
   }
-} /* HdlcFramer::encodeByte */
+} /* HdlcFramer::nrziEncode */
 
 
 /*
@@ -53,6 +53,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include "BitBuffer.h"
 
 
 /****************************************************************************
@@ -115,6 +116,10 @@ The generated frames will look like:
 
 Where flag is 01111110 and FCS is the 16 bit Frame Check Sequence (CRC). The
 should be at least one data byte in each frame.
+
+The emitted bitstream is bit stuffed and NRZI encoded, where a set bit
+represent the mark line state. Both bit stuffing and NRZI encoding is done a
+byte at a time using lookup tables.
 */
 class HdlcFramer : public sigc::trackable
 {
@@ -151,7 +156,7 @@ class HdlcFramer : public sigc::trackable
      * @brief   A signal emitted when there are bits to transmit
      * @param   bits The bits to transmit
      */
-    sigc::signal<void, const std::vector<bool>&> sendBits;
+    sigc::signal<void, const BitBuffer&> sendBits;
 
   private:
     static const size_t DEFAULT_START_FLAG_CNT = 4;
@@ -162,7 +167,8 @@ class HdlcFramer : public sigc::trackable
 
     HdlcFramer(const HdlcFramer&);
     HdlcFramer& operator=(const HdlcFramer&);
-    void encodeByte(std::vector<bool> &bitbuf, uint8_t data);
+    void encodeByte(BitBuffer &bitbuf, uint8_t data);
+    void nrziEncode(BitBuffer &bitbuf);
 
 };  /* class HdlcFramer */
 
@@ -108,7 +108,7 @@ using namespace std;
 Synchronizer::Synchronizer(unsigned baudrate, unsigned sample_rate)
   : baudrate(baudrate), sample_rate(sample_rate),
     shift_pos(sample_rate / 2), pos(0), was_mark(false),
-    last_stored_was_mark(false)
+    last_stored_was_mark(false), err(0), descramble(false), descrambler(0)
 {
   bitbuf.reserve(8);
 } /* Synchronizer::Synchronizer */
@@ -145,8 +145,15 @@ int Synchronizer::writeSamples(const float *samples, int len)
       // Extract bit if pos >= sample_rate
     if (pos >= sample_rate)
     {
-      bitbuf.push_back(is_mark == last_stored_was_mark);
-      last_stored_was_mark = is_mark;
+      bool line_is_mark = is_mark;
+      if (descramble)
+      {
+        bool tap = ((descrambler >> 11) ^ (descrambler >> 16)) & 1;
+        line_is_mark = (is_mark != tap);
+        descrambler = (descrambler << 1) | (is_mark ? 1 : 0);
+      }
+      bitbuf.push_back(line_is_mark == last_stored_was_mark);
+      last_stored_was_mark = line_is_mark;
       if (bitbuf.size() >= 8)
       {
         /*
@@ -35,6 +35,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <vector>
+#include <stdint.h>
 #include <sigc++/sigc++.h>
 
 
@@ -53,6 +54,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include "BitBuffer.h"
 
 
 /****************************************************************************
@@ -111,6 +113,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 Find the optimal sampling point in the incoming stream of samples to extract
 the embedded bitstream. The method used is to track zero crossings and adjust
 the sampling point if the zero crossing is too eary or late.
+
+The received line state is NRZI decoded before being emitted. If the sender
+have scrambled the line state, as is done for direct FSK, descrambling can be
+enabled using setDescrambling().
 */
 class Synchronizer : public Async::AudioSink, public sigc::trackable
 {
@@ -150,21 +156,32 @@ class Synchronizer : public Async::AudioSink, public sigc::trackable
      */
     void flushSamples(void);
 
+    /**
+     * @brief   Enable or disable descrambling of the line state
+     * @param   enable Set to \em true to enable descrambling
+     *
+     * The descrambler is self synchronizing and use the polynomial
+     * 1 + x^12 + x^17, the same as is used for 9600Bd packet radio (G3RUH).
+     */
+    void setDescrambling(bool enable) { descramble = enable; }
+
     /**
      * @brief   A signal emitted when new bits have been received
-     * @param   A vector of received bits
+     * @param   bits The received bits
      */
-    sigc::signal<void, std::vector<bool>&> bitsReceived;
+    sigc::signal<void, const BitBuffer&> bitsReceived;
 
   private:
     const unsigned    baudrate;
     const unsigned    sample_rate;
     const unsigned    shift_pos;
     unsigned          pos;
-    std::vector<bool> bitbuf;
+    BitBuffer         bitbuf;
     bool              was_mark;
     bool              last_stored_was_mark;
     int               err;
+    bool              descramble;
+    uint32_t          descrambler;
 
     Synchronizer(const Synchronizer&);
     Synchronizer& operator=(const Synchronizer&);
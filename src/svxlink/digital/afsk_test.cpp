@@ -515,7 +515,7 @@ int main(int argc, const char **argv)
   //}
 
   /*
-  vector<bool> bits;
+  BitBuffer bits;
   for (int i=0; i<12000/2; ++i)
   {
     bits.push_back(false);
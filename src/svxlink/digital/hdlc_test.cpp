@@ -0,0 +1,135 @@
+/*
+ * Round trip test for the HDLC framer and deframer. Frames are run through
+ * the framer, NRZI decoded and then fed to the deframer in chunks of
+ * different sizes. The deframed frames must be equal to the original
+ * frames. Noise between the frames and chunks that are not a multiple of
+ * eight bits exercise both the byte wise and the bit wise deframing paths.
+ */
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+#include "BitBuffer.h"
+#include "HdlcFramer.h"
+#include "HdlcDeframer.h"
+
+
+using namespace std;
+
+
+typedef vector<uint8_t> Frame;
+
+
+static BitBuffer nrziDecode(const BitBuffer& line, bool& prev_is_mark)
+{
+  BitBuffer bits;
+  bits.reserve(line.size());
+  for (size_t i=0; i<line.size(); ++i)
+  {
+    bits.push_back(line[i] == prev_is_mark);
+    prev_is_mark = line[i];
+  }
+  return bits;
+}
+
+
+static vector<Frame> deframe(const BitBuffer& bits, size_t max_chunk)
+{
+  vector<Frame> frames;
+  HdlcDeframer deframer;
+  deframer.frameReceived.connect(
+      [&](vector<uint8_t>& frame) { frames.push_back(frame); });
+  size_t pos = 0;
+  while (pos < bits.size())
+  {
+    size_t cnt = (max_chunk > 1) ? 1 + rand() % max_chunk : 1;
+    BitBuffer chunk;
+    for (size_t i=0; (i<cnt) && (pos<bits.size()); ++i)
+    {
+      chunk.push_back(bits[pos++]);
+    }
+    deframer.bitsReceived(chunk);
+  }
+  return frames;
+}
+
+
+int main(void)
+{
+  srand(4711);
+
+  vector<Frame> sent;
+  sent.push_back(Frame{0x42});
+  sent.push_back(Frame{0x7e});
+  sent.push_back(Frame{0x7e, 0x7e, 0x7e, 0x7e});
+  sent.push_back(Frame{0x1f, 0x1f, 0xf8, 0x3e, 0x7c});
+  sent.push_back(Frame(16, 0xff));
+  sent.push_back(Frame{0xfe, 0x01, 0x7f, 0x80, 0xbf, 0xfd});
+  for (int i=0; i<50; ++i)
+  {
+    Frame frame(1 + rand() % 300);
+    for (auto& byte : frame)
+    {
+      byte = (rand() % 4 == 0) ? 0xff : rand() & 0xff;
+    }
+    sent.push_back(frame);
+  }
+
+  HdlcFramer framer;
+  BitBuffer line;
+  framer.sendBits.connect([&](const BitBuffer& bits) { line.append(bits); });
+  for (const auto& frame : sent)
+  {
+    framer.sendBytes(frame);
+      // Some noise between the frames, not a multiple of eight bits
+    unsigned noise_cnt = rand() % 37;
+    for (unsigned i=0; i<noise_cnt; ++i)
+    {
+      line.push_back(rand() & 1);
+    }
+  }
+    // Make sure that the last frame is terminated after any noise
+  framer.sendBytes(Frame{0x00});
+  sent.push_back(Frame{0x00});
+
+  bool prev_is_mark = false;
+  BitBuffer bits = nrziDecode(line, prev_is_mark);
+
+  int errors = 0;
+  const size_t chunk_sizes[] = { 1, 7, 8, 64, bits.size() };
+  for (size_t max_chunk : chunk_sizes)
+  {
+    vector<Frame> received = deframe(bits, max_chunk);
+
+      // Noise may occasionally form a valid frame so only require that all
+      // sent frames are received in order
+    size_t idx = 0;
+    for (const auto& frame : received)
+    {
+      if ((idx < sent.size()) && (frame == sent[idx]))
+      {
+        ++idx;
+      }
+    }
+    if (idx != sent.size())
+    {
+      cout << "*** ERROR: max_chunk=" << max_chunk << ": Only " << idx
+           << " of " << sent.size() << " frames received correctly" << endl;
+      ++errors;
+    }
+
+    if (received != deframe(bits, 1))
+    {
+      cout << "*** ERROR: max_chunk=" << max_chunk << ": Byte wise and bit "
+              "wise deframing differ" << endl;
+      ++errors;
+    }
+  }
+
+  if (errors == 0)
+  {
+    cout << "OK: " << sent.size() << " frames" << endl;
+  }
+  return (errors == 0) ? 0 : 1;
+}
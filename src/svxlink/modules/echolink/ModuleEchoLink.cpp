@@ -750,8 +750,8 @@ void ModuleEchoLink::dtmfCmdReceivedWhenIdle(const std::string &cmd)
   {
     stringstream ss;
     ss << "play_node_id ";
-    const StationData *station = dir->findCall(dir->callsign());
-    ss << (station ? station->id() : 0);
+    StationTable::Entry station = dir->findCall(dir->callsign());
+    ss << (station.isValid() ? station.id() : 0);
     processEvent(ss.str());
   }
   else
@@ -879,10 +879,10 @@ void ModuleEchoLink::onStationListUpdated(void)
 {
   if (pending_connect_id > 0)
   {
-    const StationData *station = dir->findStation(pending_connect_id);
-    if (station != 0)
+    StationTable::Entry station = dir->findStation(pending_connect_id);
+    if (station.isValid())
     {
-      createOutgoingConnection(*station);
+      createOutgoingConnection(station.stationData());
     }
     else
     {
@@ -996,37 +996,36 @@ void ModuleEchoLink::onIncomingConnection(const IpAddress& ip,
     return;
   }
   
-  const StationData *station;
-  StationData tmp_stn_data;
+  StationData station;
   if (ip.isWithinSubet(allow_ip))
   {
-    tmp_stn_data.setIp(ip);
-    tmp_stn_data.setCallsign(callsign);
-    station = &tmp_stn_data;
+    station.setIp(ip);
+    station.setCallsign(callsign);
   }
   else
   {
       // Check if the incoming callsign is valid
-    station = dir->findCall(callsign);
-    if (station == 0)
+    StationTable::Entry entry = dir->findCall(callsign);
+    if (!entry.isValid())
     {
       getDirectoryList();
       return;
     }
+    station = entry.stationData();
   }
   
-  if (station->ip() != ip)
+  if (station.ip() != ip)
   {
     cerr << "*** WARNING: Ignoring incoming connection from " << callsign
       	 << " since the IP address registered in the directory server "
-	 << "(" << station->ip() << ") is not the same as the remote IP "
+	 << "(" << station.ip() << ") is not the same as the remote IP "
 	 << "address (" << ip << ") of the incoming connection\n";
     getDirectoryList();
     return;
   }
 
     // Create a new Qso object to accept the connection
-  QsoImpl *qso = new QsoImpl(*station, this);
+  QsoImpl *qso = new QsoImpl(station, this);
   if (!qso->initOk())
   {
     delete qso;
@@ -1876,8 +1875,8 @@ void ModuleEchoLink::handleCommand(const string& cmd)
     
     stringstream ss;
     ss << "play_node_id ";
-    const StationData *station = dir->findCall(dir->callsign());
-    ss << (station ? station->id() : 0);
+    StationTable::Entry station = dir->findCall(dir->callsign());
+    ss << (station.isValid() ? station.id() : 0);
     processEvent(ss.str());
   }
   else if (cmd[0] == '3')   // Random connect
@@ -1890,30 +1889,17 @@ void ModuleEchoLink::handleCommand(const string& cmd)
       return;
     }
     
-    vector<StationData> nodes;
-    
+      // Pick a random index over the selected lists without copying them
+    StationTable::List first;
+    StationTable::List second;
     if (cmd[1] == '1')	// Random connect to link or repeater
     {
-      const list<StationData>& links = dir->links();
-      const list<StationData>& repeaters = dir->repeaters();
-      list<StationData>::const_iterator it;
-      for (it=links.begin(); it!=links.end(); it++)
-      {
-	nodes.push_back(*it);
-      }
-      for (it=repeaters.begin(); it!=repeaters.end(); it++)
-      {
-	nodes.push_back(*it);
-      }
+      first = dir->links();
+      second = dir->repeaters();
     }
     else if (cmd[1] == '2') // Random connect to conference
     {
-      const list<StationData>& conferences = dir->conferences();
-      list<StationData>::const_iterator it;
-      for (it=conferences.begin(); it!=conferences.end(); it++)
-      {
-	nodes.push_back(*it);
-      }
+      first = dir->conferences();
     }
     else
     {
@@ -1921,13 +1907,15 @@ void ModuleEchoLink::handleCommand(const string& cmd)
       return;
     }
 
-    double count = nodes.size();
+    double count = first.size() + second.size();
     if (count > 0)
     {
       srand(time(NULL));
         // coverity[dont_call]
       size_t random_idx = (size_t)(count * ((double)rand() / (1.0 + RAND_MAX)));
-      StationData station = nodes[random_idx];
+      StationData station = (random_idx < first.size())
+        ? first[random_idx].stationData()
+        : second[random_idx - first.size()].stationData();
       
       cout << "Creating random connection to node:\n";
       cout << station << endl;
@@ -2011,10 +1999,10 @@ void ModuleEchoLink::connectByNodeId(int node_id)
     return;
   }
   
-  const StationData *station = dir->findStation(node_id);
-  if (station != 0)
+  StationTable::Entry station = dir->findStation(node_id);
+  if (station.isValid())
   {
-    createOutgoingConnection(*station);
+    createOutgoingConnection(station.stationData());
   }
   else
   {
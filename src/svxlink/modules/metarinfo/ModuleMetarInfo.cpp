@@ -40,7 +40,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sstream>
 #include <time.h>
 #include <algorithm>
-#include <queue>
 #include <regex.h>
 
 
@@ -51,8 +50,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <AsyncConfig.h>
-#include <AsyncTimer.h>
-#include <AsyncFdWatch.h>
 
 
 
@@ -152,196 +149,6 @@ using namespace SvxLink;
  *
  ****************************************************************************/
 
-class ModuleMetarInfo::Http : public sigc::trackable
-{
-   struct WatchSet
-   {
-     ~WatchSet(void)
-     {
-       rd.activity.clear();
-       wr.activity.clear();
-     }
-     Async::FdWatch rd;
-     Async::FdWatch wr;
-   };
-   typedef std::map<int, WatchSet> WatchMap;
-   CURLM* multi_handle; 
-   Async::Timer update_timer;
-   WatchMap watch_map;
-   std::queue<CURL*> url_queue;
-   CURL* pending_curl;
-
-  public:
-
-   Http() : multi_handle(0), pending_curl(0)
-   {
-     multi_handle = curl_multi_init();
-     long curl_timeout = -1;
-     curl_multi_timeout(multi_handle, &curl_timeout);
-     update_timer.setTimeout((curl_timeout >= 0) ? curl_timeout : 100);
-     update_timer.setEnable(false);
-     update_timer.expired.connect(mem_fun(*this, &Http::onTimeout));
-   } /* Http */
-
-   ~Http()
-   {
-     if (pending_curl)
-       curl_easy_cleanup(pending_curl);
-     while (!url_queue.empty())
-     {
-       curl_easy_cleanup(url_queue.front());
-       url_queue.pop();
-     }
-     disableAllWatches();
-     curl_multi_cleanup(multi_handle);
-   } /* ~Http */
-
-   // a signal when a metar has been available
-   sigc::signal<void, std::string, size_t> metarInfo;
-
-   // a signal when a metar has a timeout
-   sigc::signal<void> metarTimeout;
-
-
-   // update the html handler periodically
-   void onTimeout(Async::Timer *timer)
-   {
-     int handle_count;
-     curl_multi_perform(multi_handle, &handle_count);
-     if (handle_count == 0) 
-     {
-       disableAllWatches();
-       curl_easy_cleanup(pending_curl);
-       if (url_queue.empty())
-       {
-         pending_curl = 0;
-         update_timer.setEnable(false);
-       }
-       else
-       {
-         pending_curl = url_queue.front();
-         url_queue.pop();
-         curl_multi_add_handle(multi_handle, pending_curl);
-         update_timer.setEnable(true);
-       }
-     }
-     updateWatchMap();
-     update_timer.reset();
-   } /* Update */
-
-   void onActivity(Async::FdWatch *watch)
-   {
-     int handle_count;
-     curl_multi_perform(multi_handle, &handle_count);
-     if (handle_count == 0)
-     {
-       disableAllWatches();
-       curl_easy_cleanup(pending_curl);
-       if (url_queue.empty())
-       {
-         pending_curl = 0;
-         update_timer.setEnable(false);
-       }
-       else
-       {
-         pending_curl = url_queue.front();
-         url_queue.pop();
-         curl_multi_add_handle(multi_handle, pending_curl);
-         updateWatchMap();
-         update_timer.setEnable(true);
-       }
-     }
-     update_timer.reset();
-   } /* onActivity */
-
-   static size_t callback(char *contents, size_t size, size_t nmemb,
-                                       void *userp)
-   {
-     if (userp == NULL) return 0;
-     size_t written = size * nmemb;
-     std::string html((const char *)contents, written);
-     static_cast<Http*>(userp)->metarInfo(html, html.size());
-     return written;
-   } /* callback */
-
-   void AddRequest(const char* uri)
-   {
-     CURL* curl = curl_easy_init();
-     curl_easy_setopt(curl, CURLOPT_URL, uri);
-     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &Http::callback);
-     curl_easy_setopt(curl, CURLOPT_WRITEDATA, this);
-
-     if (!pending_curl)
-     {
-       pending_curl = curl;
-       curl_multi_add_handle(multi_handle, pending_curl);
-       updateWatchMap();
-       update_timer.reset();
-       update_timer.setEnable(true);
-     }
-     else
-     {
-       url_queue.push(curl);
-     }
-   } /* AddRequest */
-
-  private:
-
-   void updateWatchMap()
-   {
-     fd_set fdread;
-     fd_set fdwrite;
-     fd_set fdexcep;
-     int maxfd = -1;
-
-     FD_ZERO(&fdread);
-     FD_ZERO(&fdwrite);
-     FD_ZERO(&fdexcep);
-     curl_multi_fdset(multi_handle, &fdread, &fdwrite, &fdexcep, &maxfd);
-
-     for (int fd = 0; fd <= maxfd; fd++) 
-     {
-       bool read_isset = FD_ISSET(fd, &fdread);
-       bool write_isset = FD_ISSET(fd, &fdwrite);
-       WatchSet *ws = 0;
-       WatchMap::iterator it = watch_map.find(fd);
-       if (it != watch_map.end())
-       {
-         ws = &(it->second);
-       }
-       else
-       {
-         if (!(read_isset || write_isset))
-         {
-           continue;
-         }
-         ws = &(watch_map[fd]);
-       }
-       if (read_isset && !ws->rd.isEnabled())
-       {
-         ws->rd.setFd(fd, Async::FdWatch::FD_WATCH_RD);
-         ws->rd.activity.connect(mem_fun(*this, &Http::onActivity));
-         ws->rd.setEnabled(true);
-       }
-       if (write_isset && !ws->wr.isEnabled())
-       {
-         ws->wr.setFd(fd, Async::FdWatch::FD_WATCH_WR);
-         ws->wr.activity.connect(mem_fun(*this, &Http::onActivity));
-         ws->wr.setEnabled(true);
-       }
-     }
-   } /* updateWatchMap */
-
-   void disableAllWatches(void)
-   {
-     WatchMap::iterator it;
-     for (it = watch_map.begin(); it != watch_map.end(); ++it)
-     {
-       it->second.rd.setEnabled(false);
-       it->second.wr.setEnabled(false);
-     }
-   } /* disableAllWatches */
-};
 
 
 /****************************************************************************
@@ -410,7 +217,7 @@ extern "C" {
 
 ModuleMetarInfo::ModuleMetarInfo(void *dl_handle, Logic *logic,
                                  const string& cfg_name)
-  : Module(dl_handle, logic, cfg_name), remarks(false), debug(false), http(0)
+  : Module(dl_handle, logic, cfg_name), remarks(false), debug(false), metar_req(0)
 {
   cout << "\tModule MetarInfo v" MODULE_METAR_INFO_VERSION " starting...\n";
 
@@ -527,6 +334,12 @@ bool ModuleMetarInfo::initialize(void)
     return false;
   }
 
+    // METAR reports are issued at most a couple of times per hour so a
+    // short lived cache save a roundtrip when several stations are asked for
+    // in a row, or when the same report is requested again.
+  http.setTimeout(30000);
+  http.setCacheMaxAge(60);
+
   if (!cfg().getValue(cfgName(), "AIRPORTS", value))
   {
       cout << "*** ERROR: Config variable " << cfgName()
@@ -857,25 +670,24 @@ void ModuleMetarInfo::openConnection(void)
 {
   closeConnection();
 
-  http = new Http();
-
   html = "";
   std::string path = server;
               path += link;
               path += icao;
 
-  http->AddRequest(path.c_str());
   cout << path << endl;
-  http->metarInfo.connect(mem_fun(*this, &ModuleMetarInfo::onData));
-  http->metarTimeout.connect(mem_fun(*this, &ModuleMetarInfo::onTimeout));
+  metar_req = http.get(path, [this](const HttpClient::Response& resp)
+      {
+        onResponse(resp);
+      });
 
 } /* openConnection */
 
 
 void ModuleMetarInfo::closeConnection(void)
 {
-  delete http;
-  http = 0;
+  http.cancel(metar_req);
+  metar_req = 0;
 } /* ModuleMetarInfo::closeConnection */
 
 
@@ -887,6 +699,24 @@ void ModuleMetarInfo::onTimeout(void)
 } /* ModuleMetarInfo::onTimeout */
 
 
+void ModuleMetarInfo::onResponse(const HttpClient::Response& resp)
+{
+  metar_req = 0;
+  if (!resp.error.empty())
+  {
+    cout << "*** WARNING: Could not fetch METAR from " << resp.url << ": "
+         << resp.error << endl;
+    onTimeout();
+    return;
+  }
+  if (debug && resp.from_cache)
+  {
+    cout << "Using cached METAR for " << icao << endl;
+  }
+  onData(resp.body, resp.body.size());
+} /* ModuleMetarInfo::onResponse */
+
+
 void ModuleMetarInfo::onData(std::string metarinput, size_t count)
 {
   std::string metar = "";
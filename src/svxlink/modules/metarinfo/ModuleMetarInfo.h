@@ -43,7 +43,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <list>
 #include <map>
 #include <iostream>
-#include <curl/curl.h>
 
 
 /****************************************************************************
@@ -54,6 +53,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <Module.h>
 #include <AsyncConfig.h>
+#include <AsyncHttpClient.h>
 
 
 
@@ -136,8 +136,6 @@ class ModuleMetarInfo : public Module
     virtual void flushSamples(void);
 
   private:
-    class Http;
-
     std::string icao;
     std::string icao_default;
     std::string longmsg;
@@ -158,7 +156,8 @@ class ModuleMetarInfo : public Module
     std::string type;
     std::string server;
     std::string link;
-    Http* http;
+    Async::HttpClient http;
+    Async::HttpClient::RequestId metar_req;
 
     bool initialize(void);
     void activateInit(void);
@@ -181,6 +180,7 @@ class ModuleMetarInfo : public Module
     std::string getPrecipitation(std::string token);
     std::string getCloudType(std::string token);
     void isRwyState(std::string &retval, std::string token);
+    void onResponse(const Async::HttpClient::Response& resp);
     void onData(std::string metarinput, size_t count);
     int  splitEmptyStr(StrList& L, const std::string& seq);
     bool isWind(std::string &retval, std::string token);
@@ -30,7 +30,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <unistd.h>
+
 #include <cassert>
+#include <cmath>
+#include <algorithm>
 #include <json/json.h>
 
 
@@ -44,6 +48,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncTcpServer.h>
 #include <AsyncUdpSocket.h>
 #include <AsyncApplication.h>
+#include <AsyncAudioEncoder.h>
+#include <AsyncAudioDecoder.h>
 #include <common.h>
 
 
@@ -56,6 +62,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Reflector.h"
 #include "ReflectorClient.h"
 #include "TGHandler.h"
+#include "UdpWorkerPool.h"
+#include "TGRecorder.h"
+#include "TGTranscoder.h"
+#include "TrunkLink.h"
 
 
 /****************************************************************************
@@ -123,12 +133,27 @@ namespace {
 
 Reflector::Reflector(void)
   : m_srv(0), m_udp_sock(0), m_tg_for_v1_clients(1), m_random_qsy_lo(0),
-    m_random_qsy_hi(0), m_random_qsy_tg(0), m_http_server(0)
+    m_random_qsy_hi(0), m_random_qsy_tg(0), m_http_server(0),
+    m_udp_workers(0), m_udp_snapshot_dirty(false),
+    m_tg_recorder(0), m_transcoder(0), m_trunk_srv(0), m_login_rate(0),
+    m_login_burst(0), m_login_queue_max(0), m_login_tokens(0.0),
+    m_login_queue_timer(0, Timer::TYPE_ONESHOT, false),
+    m_login_batch_timer(0, Timer::TYPE_ONESHOT, false)
 {
   TGHandler::instance()->talkerUpdated.connect(
       mem_fun(*this, &Reflector::onTalkerUpdated));
   TGHandler::instance()->requestAutoQsy.connect(
       mem_fun(*this, &Reflector::onRequestAutoQsy));
+  TGHandler::instance()->clientsUpdated.connect(
+      mem_fun(*this, &Reflector::udpRoutingChanged));
+  TGHandler::instance()->clientsUpdated.connect(
+      mem_fun(*this, &Reflector::trunkInterestChanged));
+  TGHandler::instance()->trunkTalkerUpdated.connect(
+      mem_fun(*this, &Reflector::onTrunkTalkerUpdated));
+  m_login_queue_timer.expired.connect(
+      sigc::hide(mem_fun(*this, &Reflector::processLoginQueue)));
+  m_login_batch_timer.expired.connect(
+      sigc::hide(mem_fun(*this, &Reflector::flushLoginBatch)));
 } /* Reflector::Reflector */
 
 
@@ -138,6 +163,19 @@ Reflector::~Reflector(void)
   m_http_server = 0;
   delete m_udp_sock;
   m_udp_sock = 0;
+  delete m_udp_workers;
+  m_udp_workers = 0;
+  delete m_tg_recorder;
+  m_tg_recorder = 0;
+  delete m_transcoder;
+  m_transcoder = 0;
+  for (auto link : m_trunks)
+  {
+    delete link;
+  }
+  m_trunks.clear();
+  delete m_trunk_srv;
+  m_trunk_srv = 0;
   delete m_srv;
   m_srv = 0;
 
@@ -152,7 +190,7 @@ Reflector::~Reflector(void)
 } /* Reflector::~Reflector */
 
 
-bool Reflector::initialize(Async::Config &cfg)
+bool Reflector::initialize(Async::Config &cfg, bool takeover)
 {
   m_cfg = &cfg;
   TGHandler::instance()->setConfig(m_cfg);
@@ -179,24 +217,49 @@ bool Reflector::initialize(Async::Config &cfg)
     }
   }
 
-  std::string listen_port("5300");
-  cfg.getValue("GLOBAL", "LISTEN_PORT", listen_port);
-  m_srv = new TcpServer<FramedTcpConnection>(listen_port);
-  m_srv->clientConnected.connect(
-      mem_fun(*this, &Reflector::clientConnected));
-  m_srv->clientDisconnected.connect(
-      mem_fun(*this, &Reflector::clientDisconnected));
+  if (!initCodecs())
+  {
+    return false;
+  }
 
-  uint16_t udp_listen_port = 5300;
-  cfg.getValue("GLOBAL", "LISTEN_PORT", udp_listen_port);
-  m_udp_sock = new UdpSocket(udp_listen_port);
-  if ((m_udp_sock == 0) || !m_udp_sock->initOk())
+  std::string handover_socket;
+  cfg.getValue("GLOBAL", "HANDOVER_SOCKET", handover_socket);
+  if (takeover)
+  {
+    if (handover_socket.empty())
+    {
+      cerr << "*** ERROR: GLOBAL/HANDOVER_SOCKET must be set to be able to "
+              "take over from a running reflector" << endl;
+      return false;
+    }
+    if (!m_handover.takeOver(handover_socket, m_handover_state,
+                             m_handover_fds))
+    {
+      cerr << "*** ERROR: Could not take over from the reflector listening "
+              "on " << handover_socket << endl;
+      return false;
+    }
+  }
+
+  if (!initListenSockets())
+  {
+    return false;
+  }
+
+  std::string record_dir;
+  if (cfg.getValue("GLOBAL", "RECORD_DIR", record_dir))
+  {
+    m_tg_recorder = new TGRecorder;
+    if (!m_tg_recorder->initialize(cfg))
+    {
+      return false;
+    }
+  }
+
+  if (!initTrunks())
   {
-    cerr << "*** ERROR: Could not initialize UDP socket" << endl;
     return false;
   }
-  m_udp_sock->dataReceived.connect(
-      mem_fun(*this, &Reflector::udpDatagramReceived));
 
   unsigned sql_timeout = 0;
   cfg.getValue("GLOBAL", "SQL_TIMEOUT", sql_timeout);
@@ -208,6 +271,22 @@ bool Reflector::initialize(Async::Config &cfg)
 
   m_cfg->getValue("GLOBAL", "TG_FOR_V1_CLIENTS", m_tg_for_v1_clients);
 
+  m_login_rate = 20;
+  m_cfg->getValue("GLOBAL", "LOGIN_RATE", m_login_rate);
+  m_login_burst = std::max(m_login_rate, 1U);
+  m_cfg->getValue("GLOBAL", "LOGIN_BURST", m_login_burst);
+  if (m_login_burst < 1)
+  {
+    m_login_burst = 1;
+  }
+  m_login_tokens = m_login_burst;
+  m_login_tokens_updated = LoginClock::now();
+  m_login_queue_max = 1000;
+  m_cfg->getValue("GLOBAL", "LOGIN_QUEUE_MAX", m_login_queue_max);
+  unsigned login_batch_time = 250;
+  m_cfg->getValue("GLOBAL", "LOGIN_BATCH_TIME", login_batch_time);
+  m_login_batch_timer.setTimeout(login_batch_time);
+
   SvxLink::SepPair<uint32_t, uint32_t> random_qsy_range;
   if (m_cfg->getValue("GLOBAL", "RANDOM_QSY_RANGE", random_qsy_range))
   {
@@ -222,14 +301,63 @@ bool Reflector::initialize(Async::Config &cfg)
     m_random_qsy_tg = m_random_qsy_hi;
   }
 
-  std::string http_srv_port;
-  if (m_cfg->getValue("GLOBAL", "HTTP_SRV_PORT", http_srv_port))
+  if (takeover)
   {
-    m_http_server = new Async::TcpServer<Async::HttpServerConnection>(http_srv_port);
-    m_http_server->clientConnected.connect(
-        sigc::mem_fun(*this, &Reflector::httpClientConnected));
-    m_http_server->clientDisconnected.connect(
-        sigc::mem_fun(*this, &Reflector::httpClientDisconnected));
+    restoreClients();
+    for (auto sock : m_handover_fds)
+    {
+      if (sock >= 0)
+      {
+        close(sock);
+      }
+    }
+    m_handover_fds.clear();
+    m_handover_state = Json::Value();
+    if (m_handover.confirmTakeOver())
+    {
+      cout << "Took over " << m_client_map.size()
+           << " clients from the old reflector process" << endl;
+    }
+    else
+    {
+      cerr << "*** WARNING: The old reflector process did not let us go "
+              "ahead with the takeover. Starting from scratch." << endl;
+      releaseListenSockets();
+      if (!initListenSockets())
+      {
+        return false;
+      }
+    }
+  }
+
+    // The UDP workers start receiving at once so they must not be started
+    // before the takeover has been committed
+  if (m_udp_workers != 0)
+  {
+    uint16_t udp_listen_port = 5300;
+    cfg.getValue("GLOBAL", "LISTEN_PORT", udp_listen_port);
+    unsigned udp_workers = 0;
+    cfg.getValue("GLOBAL", "UDP_WORKERS", udp_workers);
+    if (m_udp_worker_socks.empty()
+          ? !m_udp_workers->start(udp_listen_port, udp_workers)
+          : !m_udp_workers->start(m_udp_worker_socks))
+    {
+      cerr << "*** ERROR: Could not start the UDP worker threads" << endl;
+      m_udp_worker_socks.clear();
+      return false;
+    }
+    m_udp_worker_socks.clear();
+    udpRoutingChanged();
+  }
+
+  if (!handover_socket.empty())
+  {
+    if (!m_handover.listen(handover_socket))
+    {
+      return false;
+    }
+    m_handover.handOverRequested.connect(
+        mem_fun(*this, &Reflector::onHandOverRequested));
   }
 
   return true;
@@ -270,6 +398,11 @@ void Reflector::broadcastMsg(const ReflectorMsg& msg,
 bool Reflector::sendUdpDatagram(ReflectorClient *client, const void *buf,
                                 size_t count)
 {
+  if (m_udp_workers != 0)
+  {
+    return m_udp_workers->send(client->remoteHost(), client->remoteUdpPort(),
+                               buf, count);
+  }
   return m_udp_sock->write(client->remoteHost(), client->remoteUdpPort(), buf,
                            count);
 } /* Reflector::sendUdpDatagram */
@@ -317,6 +450,51 @@ void Reflector::requestQsy(ReflectorClient *client, uint32_t tg)
 } /* Reflector::requestQsy */
 
 
+bool Reflector::requestLogin(ReflectorClient *client)
+{
+  if (m_login_queue.empty() && takeLoginToken())
+  {
+    ++m_login_stats.admitted;
+    client->admitLogin();
+    return true;
+  }
+
+  if ((m_login_queue_max > 0) && (m_login_queue.size() >= m_login_queue_max))
+  {
+    ++m_login_stats.rejected;
+    return false;
+  }
+
+  m_login_queue.push_back({client, LoginClock::now()});
+  ++m_login_stats.queued;
+  m_login_stats.max_queued =
+    std::max(m_login_stats.max_queued, m_login_queue.size());
+  processLoginQueue();
+  return true;
+} /* Reflector::requestLogin */
+
+
+void Reflector::loginAuthenticated(ReflectorClient *client)
+{
+  m_login_batch.push_back(client);
+  if (m_login_batch_timer.timeout() <= 0)
+  {
+    flushLoginBatch();
+  }
+  else if (!m_login_batch_timer.isEnabled())
+  {
+    m_login_batch_timer.setEnable(true);
+  }
+} /* Reflector::loginAuthenticated */
+
+
+void Reflector::clientCodecChanged(ReflectorClient *client)
+{
+    // The UDP workers cannot transcode so the routing may have to change
+  udpRoutingChanged();
+} /* Reflector::clientCodecChanged */
+
+
 /****************************************************************************
  *
  * Protected member functions
@@ -363,8 +541,12 @@ void Reflector::clientDisconnected(Async::FramedTcpConnection *con,
 
   m_client_map.erase(client->clientId());
   m_client_con_map.erase(it);
+    // Publish at once so that the workers stop relaying to the client
+  udpRoutingChanged();
+  publishUdpSnapshot();
 
-  if (!client->callsign().empty())
+    // Nodes that have not yet been announced should not be announced as gone
+  if (!removePendingLogin(client) && !client->callsign().empty())
   {
     broadcastMsg(MsgNodeLeft(client->callsign()),
         ReflectorClient::ExceptFilter(client));
@@ -406,6 +588,7 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
   {
     client->setRemoteUdpPort(port);
     client->sendUdpMsg(MsgUdpHeartbeat());
+    udpRoutingChanged();
   }
   else if (port != client->remoteUdpPort())
   {
@@ -455,7 +638,8 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
         if (!msg.audioData().empty() && (tg > 0))
         {
           ReflectorClient* talker = TGHandler::instance()->talkerForTG(tg);
-          if (talker == 0)
+          if ((talker == 0) &&
+              TGHandler::instance()->trunkTalkerForTG(tg).empty())
           {
             TGHandler::instance()->setTalkerForTG(tg, client);
             talker = TGHandler::instance()->talkerForTG(tg);
@@ -463,10 +647,13 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
           if (talker == client)
           {
             TGHandler::instance()->setTalkerForTG(tg, client);
-            broadcastUdpMsg(msg,
-                ReflectorClient::mkAndFilter(
-                  ReflectorClient::ExceptFilter(client),
-                  ReflectorClient::TgFilter(tg)));
+              // Audio in another codec reach the recorder and the trunks
+              // after being transcoded
+            if (client->codec() == m_codecs.front())
+            {
+              writePrimaryAudio(tg, msg.audioData());
+            }
+            relayAudio(tg, client, client->codec(), msg.audioData());
             //broadcastUdpMsgExcept(tg, client, msg,
             //    ProtoVerRange(ProtoVer(0, 6),
             //                  ProtoVer(1, ProtoVer::max().minor())));
@@ -581,9 +768,22 @@ void Reflector::udpDatagramReceived(const IpAddress& addr, uint16_t port,
 void Reflector::onTalkerUpdated(uint32_t tg, ReflectorClient* old_talker,
                                 ReflectorClient *new_talker)
 {
+  udpRoutingChanged();
+
   if (old_talker != 0)
   {
     cout << old_talker->callsign() << ": Talker stop on TG #" << tg << endl;
+    if ((m_transcoder != 0) && (old_talker->codec() != m_codecs.front()) &&
+        primaryAudioWanted(tg))
+    {
+        // The recorder and the trunks are stopped when the tail of the
+        // transcoded audio has been written to them
+      m_pending_talker_stops[tg] = {old_talker->callsign(), false};
+    }
+    else
+    {
+      primaryTalkerStop(tg, {old_talker->callsign(), false});
+    }
     broadcastMsg(MsgTalkerStop(tg, old_talker->callsign()),
         ReflectorClient::mkAndFilter(
           v2_client_filter,
@@ -594,14 +794,38 @@ void Reflector::onTalkerUpdated(uint32_t tg, ReflectorClient* old_talker,
     {
       broadcastMsg(MsgTalkerStopV1(old_talker->callsign()), v1_client_filter);
     }
-    broadcastUdpMsg(MsgUdpFlushSamples(),
-          ReflectorClient::mkAndFilter(
-            ReflectorClient::TgFilter(tg),
-            ReflectorClient::ExceptFilter(old_talker)));
+    if (m_transcoder != 0)
+    {
+        // Clients using another codec are flushed when the transcoder is
+        // done with the talk group
+      m_transcoder->flush(tg);
+      broadcastUdpMsg(MsgUdpFlushSamples(),
+            ReflectorClient::mkAndFilter(
+              ReflectorClient::mkAndFilter(
+                ReflectorClient::TgFilter(tg),
+                ReflectorClient::CodecFilter(old_talker->codec())),
+              ReflectorClient::ExceptFilter(old_talker)));
+    }
+    else
+    {
+      broadcastUdpMsg(MsgUdpFlushSamples(),
+            ReflectorClient::mkAndFilter(
+              ReflectorClient::TgFilter(tg),
+              ReflectorClient::ExceptFilter(old_talker)));
+    }
   }
   if (new_talker != 0)
   {
     cout << new_talker->callsign() << ": Talker start on TG #" << tg << endl;
+    completePendingTalkerStop(tg);
+    if ((m_tg_recorder != 0) && m_tg_recorder->isRecorded(tg))
+    {
+      m_tg_recorder->talkerStart(tg, new_talker->callsign());
+    }
+    for (auto link : m_trunks)
+    {
+      link->sendTalkerStart(tg, new_talker->callsign(), m_codecs.front());
+    }
     broadcastMsg(MsgTalkerStart(tg, new_talker->callsign()),
         ReflectorClient::mkAndFilter(
           v2_client_filter,
@@ -641,6 +865,17 @@ void Reflector::httpRequestReceived(Async::HttpServerConnection *con,
   }
 
   Json::Value status;
+  Json::Value& logins(status["logins"]);
+  logins["queueLength"] = static_cast<Json::UInt64>(m_login_queue.size());
+  logins["pendingNodeList"] =
+    static_cast<Json::UInt64>(m_login_batch.size());
+  logins["admitted"] = static_cast<Json::UInt64>(m_login_stats.admitted);
+  logins["queued"] = static_cast<Json::UInt64>(m_login_stats.queued);
+  logins["rejected"] = static_cast<Json::UInt64>(m_login_stats.rejected);
+  logins["batches"] = static_cast<Json::UInt64>(m_login_stats.batches);
+  logins["maxQueueLength"] =
+    static_cast<Json::UInt64>(m_login_stats.max_queued);
+  logins["maxWaitMs"] = m_login_stats.max_wait_ms;
   status["nodes"] = Json::Value(Json::objectValue);
   ReflectorClientMap::const_iterator client_it;
   for (client_it = m_client_map.begin(); client_it != m_client_map.end(); ++client_it)
@@ -770,31 +1005,1101 @@ void Reflector::onRequestAutoQsy(uint32_t from_tg)
 } /* Reflector::onRequestAutoQsy */
 
 
-uint32_t Reflector::nextRandomQsyTg(void)
+  /*
+   * Must be called on every change to the state that the UDP workers use for
+   * routing: login, logout, UDP port, talk group selection, talker start and
+   * stop, codec changes and trunk interest. The snapshot is published from
+   * a task run on the next main loop iteration so that many changes made
+   * while handling one event only cause one snapshot to be published.
+   */
+void Reflector::udpRoutingChanged(void)
 {
-  if (m_random_qsy_tg == 0)
+  if ((m_udp_workers == 0) || m_udp_snapshot_dirty)
   {
-    std::cout << "*** WARNING: QSY request for random TG "
-              << "requested but RANDOM_QSY_RANGE is empty" << std::endl;
-    return 0;
+    return;
   }
+  m_udp_snapshot_dirty = true;
+  Application::app().runTask(mem_fun(*this, &Reflector::publishUdpSnapshot));
+} /* Reflector::udpRoutingChanged */
 
-  assert (m_random_qsy_tg != 0);
-  uint32_t range_size = m_random_qsy_hi-m_random_qsy_lo+1;
-  uint32_t i;
-  for (i=0; i<range_size; ++i)
+
+void Reflector::publishUdpSnapshot(void)
+{
+  if ((m_udp_workers == 0) || !m_udp_snapshot_dirty)
   {
-    m_random_qsy_tg = (m_random_qsy_tg < m_random_qsy_hi) ?
-      m_random_qsy_tg+1 : m_random_qsy_lo;
-    if (TGHandler::instance()->clientsForTG(m_random_qsy_tg).empty())
+    return;
+  }
+  m_udp_snapshot_dirty = false;
+
+  auto snapshot = std::make_shared<UdpWorkerPool::Snapshot>();
+  for (const auto& item : m_client_map)
+  {
+    ReflectorClient *client = item.second;
+    if ((client->conState() != ReflectorClient::STATE_CONNECTED) ||
+        (client->remoteUdpPort() == 0))
     {
-      return m_random_qsy_tg;
+      continue;
+    }
+    UdpWorkerPool::Client& c = snapshot->clients[client->clientId()];
+    c.id = client->clientId();
+    c.ip = client->remoteHost();
+    c.port = client->remoteUdpPort();
+    c.tg = TGHandler::instance()->TGForClient(client);
+    c.tx_seq = client->udpTxSeqCounter();
+  }
+  for (const auto& item : snapshot->clients)
+  {
+    const UdpWorkerPool::Client& c = item.second;
+    if (c.tg != 0)
+    {
+      snapshot->tg_clients[c.tg].push_back(&c);
+    }
+  }
+    // Checking if a talk group is relayed in the main thread walk through
+    // all clients on the talk group so only do it once per talk group
+  for (const auto& item : snapshot->tg_clients)
+  {
+    uint32_t tg = item.first;
+    if (relayInMainThread(tg))
+    {
+      continue;
+    }
+    ReflectorClient *talker = TGHandler::instance()->talkerForTG(tg);
+    if ((talker != 0) && !talker->isBlocked())
+    {
+      snapshot->tg_talker[tg] = talker->clientId();
     }
   }
+  m_udp_workers->publish(snapshot);
+} /* Reflector::publishUdpSnapshot */
 
-  std::cout << "*** WARNING: No random TG available for QSY" << std::endl;
-  return 0;
-} /* Reflector::nextRandomQsyTg */
+
+void Reflector::udpWorkerDatagramReceived(const IpAddress& addr,
+                                          uint16_t port, void *buf, int count)
+{
+  udpDatagramReceived(addr, port, buf, count);
+
+    // The workers must see any routing change caused by this datagram
+    // before the datagram is marked as handled
+  publishUdpSnapshot();
+} /* Reflector::udpWorkerDatagramReceived */
+
+
+void Reflector::udpWorkerAudioRelayed(uint32_t client_id, uint16_t seq)
+{
+  ReflectorClientMap::iterator it = m_client_map.find(client_id);
+  if (it == m_client_map.end())
+  {
+    return;
+  }
+  ReflectorClient *client = (*it).second;
+  client->udpMsgReceived(ReflectorUdpMsg(MsgUdpAudio::TYPE, client_id, seq));
+
+  uint32_t tg = TGHandler::instance()->TGForClient(client);
+  if ((tg > 0) && (TGHandler::instance()->talkerForTG(tg) == client))
+  {
+    TGHandler::instance()->setTalkerForTG(tg, client);
+  }
+  publishUdpSnapshot();
+} /* Reflector::udpWorkerAudioRelayed */
+
+
+  /*
+   * Audio on talk groups that are recorded or trunked is relayed by the main
+   * thread so that it can be handed over to the recorder and the trunks. The
+   * same goes for talk groups where clients use different codecs since the
+   * audio then need to be transcoded.
+   */
+bool Reflector::relayInMainThread(uint32_t tg)
+{
+  if ((m_tg_recorder != 0) && m_tg_recorder->isRecorded(tg))
+  {
+    return true;
+  }
+  for (auto link : m_trunks)
+  {
+    if (link->wantsTG(tg))
+    {
+      return true;
+    }
+  }
+  if (m_transcoder != 0)
+  {
+    for (auto client : TGHandler::instance()->clientsForTG(tg))
+    {
+      if (client->codec() != m_codecs.front())
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+} /* Reflector::relayInMainThread */
+
+
+bool Reflector::initListenSockets(void)
+{
+  int listen_sock = takeHandoverFd(m_handover_state["listen"]["tcp"]);
+  if (listen_sock >= 0)
+  {
+    m_srv = new FramedTcpServer(listen_sock);
+  }
+  else
+  {
+    std::string listen_port("5300");
+    m_cfg->getValue("GLOBAL", "LISTEN_PORT", listen_port);
+    m_srv = new FramedTcpServer(listen_port);
+  }
+  if (m_srv->socket() < 0)
+  {
+    cerr << "*** ERROR: Could not set up the client listen socket" << endl;
+    return false;
+  }
+  m_srv->clientConnected.connect(
+      mem_fun(*this, &Reflector::clientConnected));
+  m_srv->clientDisconnected.connect(
+      mem_fun(*this, &Reflector::clientDisconnected));
+
+  uint16_t udp_listen_port = 5300;
+  m_cfg->getValue("GLOBAL", "LISTEN_PORT", udp_listen_port);
+  unsigned udp_workers = 0;
+  m_cfg->getValue("GLOBAL", "UDP_WORKERS", udp_workers);
+  std::vector<int> udp_socks;
+  for (const auto& idx : m_handover_state["udp"])
+  {
+    int sock = takeHandoverFd(idx);
+    if (sock >= 0)
+    {
+      udp_socks.push_back(sock);
+    }
+  }
+  if (udp_workers > 0)
+  {
+    if (!udp_socks.empty() && (udp_socks.size() != udp_workers))
+    {
+      cout << "*** WARNING: Got " << udp_socks.size() << " UDP sockets "
+              "from the old reflector process but UDP_WORKERS is set to "
+           << udp_workers << ". Using " << udp_socks.size()
+           << " UDP worker threads until the next restart." << endl;
+      udp_workers = udp_socks.size();
+    }
+      // The worker threads are started when the initialization is done
+    m_udp_worker_socks = udp_socks;
+    m_udp_workers = new UdpWorkerPool;
+    m_udp_workers->datagramReceived.connect(
+        mem_fun(*this, &Reflector::udpWorkerDatagramReceived));
+    m_udp_workers->talkerAudioRelayed.connect(
+        mem_fun(*this, &Reflector::udpWorkerAudioRelayed));
+    cout << "Using " << udp_workers << " UDP worker threads" << endl;
+  }
+  else if (!udp_socks.empty())
+  {
+      // More than one socket is handed over if the old process used UDP
+      // worker threads. Closing the extra sockets make the kernel direct all
+      // datagrams to the remaining one.
+    for (auto it = udp_socks.begin()+1; it != udp_socks.end(); ++it)
+    {
+      close(*it);
+    }
+    m_udp_sock = new UdpSocket;
+    if (!m_udp_sock->setFd(udp_socks.front()))
+    {
+      cerr << "*** ERROR: Could not use the UDP socket handed over from the "
+              "old reflector process" << endl;
+      return false;
+    }
+    m_udp_sock->dataReceived.connect(
+        mem_fun(*this, &Reflector::udpDatagramReceived));
+  }
+  else
+  {
+    m_udp_sock = new UdpSocket(udp_listen_port);
+    if ((m_udp_sock == 0) || !m_udp_sock->initOk())
+    {
+      cerr << "*** ERROR: Could not initialize UDP socket" << endl;
+      return false;
+    }
+    m_udp_sock->dataReceived.connect(
+        mem_fun(*this, &Reflector::udpDatagramReceived));
+  }
+
+  std::string http_srv_port;
+  if (m_cfg->getValue("GLOBAL", "HTTP_SRV_PORT", http_srv_port))
+  {
+    int http_sock = takeHandoverFd(m_handover_state["listen"]["http"]);
+    if (http_sock >= 0)
+    {
+      m_http_server =
+        new Async::TcpServer<Async::HttpServerConnection>(http_sock);
+    }
+    else
+    {
+      m_http_server =
+        new Async::TcpServer<Async::HttpServerConnection>(http_srv_port);
+    }
+    m_http_server->clientConnected.connect(
+        sigc::mem_fun(*this, &Reflector::httpClientConnected));
+    m_http_server->clientDisconnected.connect(
+        sigc::mem_fun(*this, &Reflector::httpClientDisconnected));
+  }
+
+  std::vector<std::string> trunks;
+  if (m_cfg->getValue("GLOBAL", "TRUNKS", trunks) && !trunks.empty())
+  {
+    std::string trunk_port("5302");
+    m_cfg->getValue("GLOBAL", "TRUNK_LISTEN_PORT", trunk_port);
+    int trunk_sock = takeHandoverFd(m_handover_state["listen"]["trunk"]);
+    if (trunk_sock >= 0)
+    {
+      m_trunk_srv = new FramedTcpServer(trunk_sock);
+    }
+    else
+    {
+      m_trunk_srv = new FramedTcpServer(trunk_port);
+    }
+    m_trunk_srv->clientConnected.connect(
+        mem_fun(*this, &Reflector::trunkConnected));
+    m_trunk_srv->clientDisconnected.connect(
+        mem_fun(*this, &Reflector::trunkDisconnected));
+  }
+
+  return true;
+} /* Reflector::initListenSockets */
+
+
+  /*
+   * Close the sockets handed over from the old reflector process without
+   * having used them so that the old process can continue undisturbed.
+   * The clients restored from the handover state are thrown away.
+   */
+void Reflector::releaseListenSockets(void)
+{
+  ReflectorClientMap clients;
+  clients.swap(m_client_map);
+  m_client_con_map.clear();
+  for (const auto& item : clients)
+  {
+    delete item.second;
+  }
+  delete m_srv;
+  m_srv = 0;
+  delete m_http_server;
+  m_http_server = 0;
+  delete m_trunk_srv;
+  m_trunk_srv = 0;
+  delete m_udp_sock;
+  m_udp_sock = 0;
+  delete m_udp_workers;
+  m_udp_workers = 0;
+  for (int sock : m_udp_worker_socks)
+  {
+    close(sock);
+  }
+  m_udp_worker_socks.clear();
+} /* Reflector::releaseListenSockets */
+
+
+bool Reflector::initCodecs(void)
+{
+  std::string codecs;
+  if (m_cfg->getValue("GLOBAL", "CODECS", codecs))
+  {
+    SvxLink::splitStr(m_codecs, codecs, ",");
+  }
+  if (m_codecs.empty())
+  {
+    std::string codec = "GSM";
+    if (AudioDecoder::isAvailable("OPUS") &&
+        AudioEncoder::isAvailable("OPUS"))
+    {
+      codec = "OPUS";
+    }
+    else if (AudioDecoder::isAvailable("SPEEX") &&
+             AudioEncoder::isAvailable("SPEEX"))
+    {
+      codec = "SPEEX";
+    }
+    m_codecs.push_back(codec);
+  }
+
+  if (m_codecs.size() < 2)
+  {
+    return true;
+  }
+
+    // The reflector need to be able to transcode between all codecs
+  for (auto it = m_codecs.begin(); it != m_codecs.end(); )
+  {
+    if (!AudioDecoder::isAvailable(*it) || !AudioEncoder::isAvailable(*it))
+    {
+      cerr << "*** WARNING: The \"" << *it << "\" codec in GLOBAL/CODECS "
+              "is not available. Ignoring it." << endl;
+      it = m_codecs.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+  if (m_codecs.empty())
+  {
+    cerr << "*** ERROR: None of the codecs in GLOBAL/CODECS are available"
+         << endl;
+    return false;
+  }
+  if (m_codecs.size() > 1)
+  {
+    m_transcoder = new TGTranscoder;
+    if (!m_transcoder->initOk())
+    {
+      cerr << "*** ERROR: Could not start the transcoder" << endl;
+      return false;
+    }
+    m_transcoder->audioTranscoded.connect(
+        mem_fun(*this, &Reflector::onAudioTranscoded));
+    m_transcoder->audioFlushed.connect(
+        mem_fun(*this, &Reflector::onTranscodedAudioFlushed));
+    cout << "Transcoding between codecs: ";
+    for (auto it = m_codecs.begin(); it != m_codecs.end(); ++it)
+    {
+      cout << (it != m_codecs.begin() ? "," : "") << *it;
+    }
+    cout << endl;
+  }
+
+  return true;
+} /* Reflector::initCodecs */
+
+
+void Reflector::relayAudio(uint32_t tg, ReflectorClient *talker,
+                           const std::string& codec,
+                           const std::vector<uint8_t>& data)
+{
+  MsgUdpAudio msg(data);
+  if (m_transcoder == 0)
+  {
+    broadcastUdpMsg(msg,
+        ReflectorClient::mkAndFilter(
+          ReflectorClient::ExceptFilter(talker),
+          ReflectorClient::TgFilter(tg)));
+    return;
+  }
+
+  broadcastUdpMsg(msg,
+      ReflectorClient::mkAndFilter(
+        ReflectorClient::ExceptFilter(talker),
+        ReflectorClient::mkAndFilter(
+          ReflectorClient::TgFilter(tg),
+          ReflectorClient::CodecFilter(codec))));
+
+    // Each codec is only encoded once, no matter how many clients use it
+  TGTranscoder::CodecSet dst_codecs;
+  for (auto client : TGHandler::instance()->clientsForTG(tg))
+  {
+    if ((client != talker) && (client->codec() != codec) &&
+        (client->conState() == ReflectorClient::STATE_CONNECTED))
+    {
+      dst_codecs.insert(client->codec());
+    }
+  }
+    // Audio from a trunk is never sent back to the trunks but may need to
+    // be recorded
+  const std::string& primary = m_codecs.front();
+  if ((codec != primary) &&
+      ((talker != 0) ? primaryAudioWanted(tg) :
+       ((m_tg_recorder != 0) && m_tg_recorder->isRecorded(tg))))
+  {
+    dst_codecs.insert(primary);
+  }
+  m_transcoder->writeAudio(tg,
+      (talker != 0) ? talker->clientId() : TGTranscoder::NO_CLIENT,
+      codec, dst_codecs, data);
+} /* Reflector::relayAudio */
+
+
+  /*
+   * The talker may have changed since the audio was handed to the
+   * transcoder so the source client and codec given with the job is used.
+   */
+void Reflector::onAudioTranscoded(uint32_t tg, uint32_t src_client_id,
+                                  const std::string& src_codec,
+                                  const std::string& codec,
+                                  const std::vector<uint8_t>& data)
+{
+  broadcastUdpMsg(MsgUdpAudio(data),
+      ReflectorClient::mkAndFilter(
+        ReflectorClient::ExceptIdFilter(src_client_id),
+        ReflectorClient::mkAndFilter(
+          ReflectorClient::TgFilter(tg),
+          ReflectorClient::CodecFilter(codec))));
+  if ((codec == m_codecs.front()) && (src_codec != codec))
+  {
+    if (src_client_id != TGTranscoder::NO_CLIENT)
+    {
+      writePrimaryAudio(tg, data);
+    }
+    else if ((m_tg_recorder != 0) && m_tg_recorder->isRecorded(tg))
+    {
+      m_tg_recorder->writeAudio(tg, data);
+    }
+  }
+} /* Reflector::onAudioTranscoded */
+
+
+void Reflector::onTranscodedAudioFlushed(uint32_t tg, uint32_t src_client_id,
+                                         const std::string& codec)
+{
+  broadcastUdpMsg(MsgUdpFlushSamples(),
+      ReflectorClient::mkAndFilter(
+        ReflectorClient::ExceptIdFilter(src_client_id),
+        ReflectorClient::mkAndFilter(
+          ReflectorClient::TgFilter(tg),
+          ReflectorClient::CodecFilter(codec))));
+  if (codec == m_codecs.front())
+  {
+    completePendingTalkerStop(tg);
+  }
+} /* Reflector::onTranscodedAudioFlushed */
+
+
+bool Reflector::primaryAudioWanted(uint32_t tg)
+{
+  return ((m_tg_recorder != 0) && m_tg_recorder->isRecorded(tg)) ||
+         std::any_of(m_trunks.begin(), m_trunks.end(),
+                     [tg](TrunkLink *link) { return link->wantsTG(tg); });
+} /* Reflector::primaryAudioWanted */
+
+
+void Reflector::writePrimaryAudio(uint32_t tg,
+                                  const std::vector<uint8_t>& data)
+{
+  if ((m_tg_recorder != 0) && m_tg_recorder->isRecorded(tg))
+  {
+    m_tg_recorder->writeAudio(tg, data);
+  }
+  for (auto link : m_trunks)
+  {
+    if (link->wantsTG(tg))
+    {
+      link->sendAudio(tg, data);
+    }
+  }
+} /* Reflector::writePrimaryAudio */
+
+
+void Reflector::primaryTalkerStop(uint32_t tg, const PendingTalkerStop& stop)
+{
+  if ((m_tg_recorder != 0) && m_tg_recorder->isRecorded(tg))
+  {
+    m_tg_recorder->talkerStop(tg);
+  }
+  if (stop.trunk_talker)
+  {
+    return;
+  }
+  for (auto link : m_trunks)
+  {
+    link->sendTalkerStop(tg, stop.callsign);
+  }
+} /* Reflector::primaryTalkerStop */
+
+
+  /*
+   * A new talker on the talk group must not wait for the transcoder so any
+   * talker stop still pending is completed before the talker start.
+   */
+void Reflector::completePendingTalkerStop(uint32_t tg)
+{
+  auto it = m_pending_talker_stops.find(tg);
+  if (it != m_pending_talker_stops.end())
+  {
+    PendingTalkerStop stop(std::move(it->second));
+    m_pending_talker_stops.erase(it);
+    primaryTalkerStop(tg, stop);
+  }
+} /* Reflector::completePendingTalkerStop */
+
+
+bool Reflector::initTrunks(void)
+{
+  std::vector<std::string> trunks;
+  if (!m_cfg->getValue("GLOBAL", "TRUNKS", trunks) || trunks.empty())
+  {
+    return true;
+  }
+
+  if (!m_cfg->getValue("GLOBAL", "TRUNK_ID", m_trunk_id) ||
+      m_trunk_id.empty())
+  {
+    cerr << "*** ERROR: GLOBAL/TRUNK_ID must be set when using trunks"
+         << endl;
+    return false;
+  }
+
+  for (const auto& section : trunks)
+  {
+    TrunkLink *link = new TrunkLink;
+    m_trunks.push_back(link);
+    if (!link->initialize(*m_cfg, section, m_trunk_id))
+    {
+      return false;
+    }
+    link->linkUp.connect(mem_fun(*this, &Reflector::onTrunkUp));
+    link->linkDown.connect(mem_fun(*this, &Reflector::onTrunkDown));
+    link->interestUpdated.connect(
+        sigc::hide(mem_fun(*this, &Reflector::udpRoutingChanged)));
+    link->talkerStartReceived.connect(
+        mem_fun(*this, &Reflector::onTrunkTalkerStart));
+    link->talkerStopReceived.connect(
+        mem_fun(*this, &Reflector::onTrunkTalkerStop));
+    link->audioReceived.connect(mem_fun(*this, &Reflector::onTrunkAudio));
+  }
+
+  return true;
+} /* Reflector::initTrunks */
+
+
+void Reflector::trunkConnected(Async::FramedTcpConnection *con)
+{
+  cout << "Trunk peer " << con->remoteHost() << ":" << con->remotePort()
+       << " connected" << endl;
+  con->setMaxFrameSize(ReflectorMsg::MAX_PREAUTH_FRAME_SIZE);
+  MsgAuthChallenge challenge;
+  PendingTrunk& pending = m_pending_trunks[con];
+  pending.challenge.assign(challenge.challenge(),
+      challenge.challenge() + MsgAuthChallenge::CHALLENGE_LEN);
+  pending.frame_con = con->frameReceived.connect(
+      mem_fun(*this, &Reflector::trunkFrameReceived));
+  pending.auth_timer.reset(new Timer(TRUNK_AUTH_TIMEOUT));
+  pending.auth_timer->expired.connect(sigc::hide(
+      sigc::bind(mem_fun(*this, &Reflector::trunkAuthTimeout), con)));
+  TrunkLink::sendMsg(con, challenge);
+} /* Reflector::trunkConnected */
+
+
+void Reflector::trunkDisconnected(Async::FramedTcpConnection *con,
+                          Async::FramedTcpConnection::DisconnectReason reason)
+{
+  auto pending_it = m_pending_trunks.find(con);
+  if (pending_it != m_pending_trunks.end())
+  {
+    cout << "Trunk peer " << con->remoteHost() << ":" << con->remotePort()
+         << " disconnected: " << TcpConnection::disconnectReasonStr(reason)
+         << endl;
+    pending_it->second.frame_con.disconnect();
+    m_pending_trunks.erase(pending_it);
+    return;
+  }
+  for (auto link : m_trunks)
+  {
+    if (link->inboundConnection() == con)
+    {
+      link->inboundDisconnected();
+      return;
+    }
+  }
+} /* Reflector::trunkDisconnected */
+
+
+void Reflector::trunkFrameReceived(Async::FramedTcpConnection *con,
+                                   std::vector<uint8_t>& data)
+{
+  auto pending_it = m_pending_trunks.find(con);
+  assert(pending_it != m_pending_trunks.end());
+
+  stringstream ss;
+  ss.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+  ReflectorMsg header;
+  MsgAuthResponse msg;
+  TrunkLink *link = 0;
+  if (header.unpack(ss) && (header.type() == MsgAuthResponse::TYPE) &&
+      msg.unpack(ss))
+  {
+    for (auto l : m_trunks)
+    {
+      if ((l->peerId() == msg.callsign()) &&
+          msg.verify(l->secret(), pending_it->second.challenge.data()))
+      {
+        link = l;
+        break;
+      }
+    }
+  }
+
+  if (link == 0)
+  {
+    cerr << "*** WARNING: Trunk authentication failed for "
+         << con->remoteHost() << ":" << con->remotePort() << endl;
+    TrunkLink::sendMsg(con, MsgError("Access denied"));
+    con->disconnect();
+    con->disconnected(con, TcpConnection::DR_ORDERED_DISCONNECT);
+    return;
+  }
+
+  pending_it->second.frame_con.disconnect();
+  m_pending_trunks.erase(pending_it);
+  TrunkLink::sendMsg(con, MsgAuthOk());
+  con->setMaxFrameSize(ReflectorMsg::MAX_POSTAUTH_FRAME_SIZE);
+  link->setInboundConnection(con);
+} /* Reflector::trunkFrameReceived */
+
+
+void Reflector::trunkAuthTimeout(Async::FramedTcpConnection *con)
+{
+  cerr << "*** WARNING: Trunk authentication timeout for "
+       << con->remoteHost() << ":" << con->remotePort() << endl;
+    // The timer is deleted when the disconnected signal is handled
+  con->disconnect();
+  con->disconnected(con, TcpConnection::DR_ORDERED_DISCONNECT);
+} /* Reflector::trunkAuthTimeout */
+
+
+void Reflector::trunkInterestChanged(void)
+{
+  if (m_trunks.empty())
+  {
+    return;
+  }
+  std::set<uint32_t> tgs = TGHandler::instance()->activeTGs();
+  if (tgs == m_trunk_tgs)
+  {
+    return;
+  }
+  m_trunk_tgs.swap(tgs);
+  for (auto link : m_trunks)
+  {
+    link->sendTgInterest(m_trunk_tgs);
+  }
+} /* Reflector::trunkInterestChanged */
+
+
+void Reflector::onTrunkUp(TrunkLink *link)
+{
+  m_trunk_tgs = TGHandler::instance()->activeTGs();
+  link->sendTgInterest(m_trunk_tgs);
+  for (uint32_t tg : m_trunk_tgs)
+  {
+    ReflectorClient *talker = TGHandler::instance()->talkerForTG(tg);
+    if (talker != 0)
+    {
+      link->sendTalkerStart(tg, talker->callsign(), m_codecs.front());
+    }
+  }
+} /* Reflector::onTrunkUp */
+
+
+void Reflector::onTrunkDown(TrunkLink *link)
+{
+  TGHandler::instance()->clearTrunkTalkers(link->peerId());
+} /* Reflector::onTrunkDown */
+
+
+  /*
+   * If two reflectors get a talker at the same time, the reflector with the
+   * lowest trunk id win. Both sides use the same rule so they will agree
+   * without any further message exchange.
+   */
+void Reflector::onTrunkTalkerStart(TrunkLink *link, uint32_t tg,
+                                   const std::string& callsign,
+                                   const std::string& codec)
+{
+  if (std::find(m_codecs.begin(), m_codecs.end(), codec) == m_codecs.end())
+  {
+    cerr << "*** WARNING: Ignoring talker " << callsign << " on trunk "
+         << link->peerId() << " since the codec \"" << codec
+         << "\" is not available" << endl;
+    return;
+  }
+  ReflectorClient *talker = TGHandler::instance()->talkerForTG(tg);
+  if ((talker != 0) && (m_trunk_id < link->peerId()))
+  {
+    return;
+  }
+  const std::string& peer = TGHandler::instance()->trunkPeerForTG(tg);
+  if (!peer.empty() && (peer != link->peerId()) && (peer < link->peerId()))
+  {
+    return;
+  }
+  if (talker != 0)
+  {
+    cout << talker->callsign() << ": Talker on TG #" << tg
+         << " overridden by " << callsign << " on trunk " << link->peerId()
+         << endl;
+    TGHandler::instance()->setTalkerForTG(tg, 0);
+  }
+  TGHandler::instance()->setTrunkTalkerForTG(tg, link->peerId(), callsign);
+  m_trunk_talker_codecs[tg] = codec;
+} /* Reflector::onTrunkTalkerStart */
+
+
+void Reflector::onTrunkTalkerStop(TrunkLink *link, uint32_t tg,
+                                  const std::string& callsign)
+{
+  if (TGHandler::instance()->trunkTalkerForTG(tg) == callsign)
+  {
+    TGHandler::instance()->setTrunkTalkerForTG(tg, link->peerId(), "");
+  }
+} /* Reflector::onTrunkTalkerStop */
+
+
+void Reflector::onTrunkAudio(TrunkLink *link, uint32_t tg,
+                             const std::string& codec,
+                             const std::vector<uint8_t>& data)
+{
+  if (TGHandler::instance()->trunkPeerForTG(tg) != link->peerId())
+  {
+    return;
+  }
+  TGHandler::instance()->setTrunkTalkerForTG(tg, link->peerId(),
+      TGHandler::instance()->trunkTalkerForTG(tg));
+  if ((codec == m_codecs.front()) &&
+      (m_tg_recorder != 0) && m_tg_recorder->isRecorded(tg))
+  {
+    m_tg_recorder->writeAudio(tg, data);
+  }
+  relayAudio(tg, 0, codec, data);
+} /* Reflector::onTrunkAudio */
+
+
+void Reflector::onTrunkTalkerUpdated(uint32_t tg,
+                                     const std::string& old_callsign,
+                                     const std::string& new_callsign)
+{
+  const auto tg_filter = ReflectorClient::mkAndFilter(
+      v2_client_filter,
+      ReflectorClient::mkOrFilter(
+        ReflectorClient::TgFilter(tg),
+        ReflectorClient::TgMonitorFilter(tg)));
+  if (!old_callsign.empty())
+  {
+    cout << old_callsign << ": Trunk talker stop on TG #" << tg << endl;
+    broadcastMsg(MsgTalkerStop(tg, old_callsign), tg_filter);
+    if (tg == tgForV1Clients())
+    {
+      broadcastMsg(MsgTalkerStopV1(old_callsign), v1_client_filter);
+    }
+    std::string codec(m_codecs.front());
+    auto codec_it = m_trunk_talker_codecs.find(tg);
+    if (codec_it != m_trunk_talker_codecs.end())
+    {
+      codec = codec_it->second;
+      m_trunk_talker_codecs.erase(codec_it);
+    }
+    if (m_transcoder != 0)
+    {
+      m_transcoder->flush(tg);
+      broadcastUdpMsg(MsgUdpFlushSamples(),
+          ReflectorClient::mkAndFilter(
+            ReflectorClient::TgFilter(tg),
+            ReflectorClient::CodecFilter(codec)));
+    }
+    else
+    {
+      broadcastUdpMsg(MsgUdpFlushSamples(), ReflectorClient::TgFilter(tg));
+    }
+    if ((m_transcoder != 0) && (codec != m_codecs.front()) &&
+        (m_tg_recorder != 0) && m_tg_recorder->isRecorded(tg))
+    {
+        // The recorder is stopped when the transcoded tail has been written
+      m_pending_talker_stops[tg] = {old_callsign, true};
+    }
+    else
+    {
+      primaryTalkerStop(tg, {old_callsign, true});
+    }
+  }
+  if (!new_callsign.empty())
+  {
+    cout << new_callsign << ": Trunk talker start on TG #" << tg << endl;
+    completePendingTalkerStop(tg);
+    broadcastMsg(MsgTalkerStart(tg, new_callsign), tg_filter);
+    if (tg == tgForV1Clients())
+    {
+      broadcastMsg(MsgTalkerStartV1(new_callsign), v1_client_filter);
+    }
+    if ((m_tg_recorder != 0) && m_tg_recorder->isRecorded(tg))
+    {
+      m_tg_recorder->talkerStart(tg, new_callsign);
+    }
+  }
+} /* Reflector::onTrunkTalkerUpdated */
+
+
+uint32_t Reflector::nextRandomQsyTg(void)
+{
+  if (m_random_qsy_tg == 0)
+  {
+    std::cout << "*** WARNING: QSY request for random TG "
+              << "requested but RANDOM_QSY_RANGE is empty" << std::endl;
+    return 0;
+  }
+
+  assert (m_random_qsy_tg != 0);
+  uint32_t range_size = m_random_qsy_hi-m_random_qsy_lo+1;
+  uint32_t i;
+  for (i=0; i<range_size; ++i)
+  {
+    m_random_qsy_tg = (m_random_qsy_tg < m_random_qsy_hi) ?
+      m_random_qsy_tg+1 : m_random_qsy_lo;
+    if (TGHandler::instance()->clientsForTG(m_random_qsy_tg).empty())
+    {
+      return m_random_qsy_tg;
+    }
+  }
+
+  std::cout << "*** WARNING: No random TG available for QSY" << std::endl;
+  return 0;
+} /* Reflector::nextRandomQsyTg */
+
+
+bool Reflector::takeLoginToken(void)
+{
+  if (m_login_rate == 0)
+  {
+    return true;
+  }
+
+  auto now = LoginClock::now();
+  std::chrono::duration<double> elapsed = now - m_login_tokens_updated;
+  m_login_tokens_updated = now;
+  m_login_tokens = std::min(static_cast<double>(m_login_burst),
+                            m_login_tokens + elapsed.count() * m_login_rate);
+  if (m_login_tokens < 1.0)
+  {
+    return false;
+  }
+  m_login_tokens -= 1.0;
+  return true;
+} /* Reflector::takeLoginToken */
+
+
+void Reflector::processLoginQueue(void)
+{
+  m_login_queue_timer.setEnable(false);
+  while (!m_login_queue.empty() && takeLoginToken())
+  {
+    QueuedLogin login = m_login_queue.front();
+    m_login_queue.pop_front();
+    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+        LoginClock::now() - login.queued_at);
+    m_login_stats.max_wait_ms = std::max(m_login_stats.max_wait_ms,
+                                         static_cast<unsigned>(wait.count()));
+    ++m_login_stats.admitted;
+    login.client->admitLogin();
+  }
+
+  if (!m_login_queue.empty())
+  {
+      // Wake up when the next token is available
+    int wait_ms = static_cast<int>(
+        std::ceil((1.0 - m_login_tokens) * 1000.0 / m_login_rate));
+    m_login_queue_timer.setTimeout(std::max(wait_ms, 1));
+    m_login_queue_timer.setEnable(true);
+  }
+} /* Reflector::processLoginQueue */
+
+
+void Reflector::flushLoginBatch(void)
+{
+  m_login_batch_timer.setEnable(false);
+  if (m_login_batch.empty())
+  {
+    return;
+  }
+
+  std::vector<ReflectorClient*> batch;
+  batch.swap(m_login_batch);
+  ++m_login_stats.batches;
+  if (batch.size() > 1)
+  {
+    cout << "Announcing " << batch.size() << " new nodes" << endl;
+  }
+
+    // The nodes in the batch are not in the connected state yet so they will
+    // not receive the announcements. They get the full node list instead.
+    // Clients that are too old for the aggregated message get one message
+    // per node.
+  std::vector<std::string> callsigns;
+  for (auto client : batch)
+  {
+    callsigns.push_back(client->callsign());
+  }
+  broadcastMsg(MsgNodesJoined(callsigns),
+      ReflectorClient::ProtoVerRangeFilter(ProtoVer(2, 2), ProtoVer::max()));
+  for (const auto& callsign : callsigns)
+  {
+    broadcastMsg(MsgNodeJoined(callsign),
+        ReflectorClient::ProtoVerRangeFilter(ProtoVer(0, 0), ProtoVer(2, 1)));
+  }
+  for (auto client : batch)
+  {
+    client->completeLogin();
+  }
+  udpRoutingChanged();
+} /* Reflector::flushLoginBatch */
+
+
+bool Reflector::removePendingLogin(ReflectorClient *client)
+{
+  auto qit = std::find_if(m_login_queue.begin(), m_login_queue.end(),
+      [client](const QueuedLogin& login) { return login.client == client; });
+  if (qit != m_login_queue.end())
+  {
+    m_login_queue.erase(qit);
+    return true;
+  }
+
+  auto bit = std::find(m_login_batch.begin(), m_login_batch.end(), client);
+  if (bit != m_login_batch.end())
+  {
+    m_login_batch.erase(bit);
+    return true;
+  }
+
+  return false;
+} /* Reflector::removePendingLogin */
+
+
+int Reflector::takeHandoverFd(const Json::Value& idx)
+{
+  if (!idx.isUInt() || (idx.asUInt() >= m_handover_fds.size()))
+  {
+    return -1;
+  }
+  int sock = m_handover_fds[idx.asUInt()];
+  m_handover_fds[idx.asUInt()] = -1;
+  return sock;
+} /* Reflector::takeHandoverFd */
+
+
+void Reflector::restoreClients(void)
+{
+  for (const auto& state : m_handover_state["clients"])
+  {
+    int sock = takeHandoverFd(state["fd"]);
+    if (sock < 0)
+    {
+      cerr << "*** WARNING: No socket handed over for client "
+           << state["callsign"].asString() << endl;
+      continue;
+    }
+    FramedTcpConnection *con = m_srv->adoptConnection(sock,
+        IpAddress(state["remoteHost"].asString()),
+        state["remotePort"].asUInt());
+    ReflectorClient *client = new ReflectorClient(this, con, m_cfg);
+    client->restoreState(state);
+    m_client_map[client->clientId()] = client;
+    m_client_con_map[con] = client;
+  }
+  udpRoutingChanged();
+} /* Reflector::restoreClients */
+
+
+void Reflector::onHandOverRequested(void)
+{
+  cout << "Handing over to a new reflector process" << endl;
+
+    // Clients that are logging in or that are in the middle of a frame
+    // transfer cannot be handed over. They will have to reconnect.
+  std::vector<ReflectorClient*> clients;
+  for (const auto& item : m_client_map)
+  {
+    clients.push_back(item.second);
+  }
+  for (auto client : clients)
+  {
+    if (!client->canBeHandedOver())
+    {
+      client->disconnect();
+    }
+  }
+
+    // The UDP workers update the client state, like the UDP sequence
+    // numbers, so they must not run while the state is saved
+  if (m_udp_workers != 0)
+  {
+    m_udp_workers->pause();
+  }
+
+  ReflectorHandover::FdList fds;
+  auto add_fd = [&fds](int sock) -> Json::Value
+    {
+      if (sock < 0)
+      {
+        return Json::Value();
+      }
+      fds.push_back(sock);
+      return Json::Value(static_cast<Json::UInt>(fds.size()-1));
+    };
+
+  Json::Value state(Json::objectValue);
+  state["listen"]["tcp"] = add_fd(m_srv->socket());
+  if (m_http_server != 0)
+  {
+    state["listen"]["http"] = add_fd(m_http_server->socket());
+  }
+  if (m_trunk_srv != 0)
+  {
+    state["listen"]["trunk"] = add_fd(m_trunk_srv->socket());
+  }
+  state["udp"] = Json::Value(Json::arrayValue);
+  if (m_udp_workers != 0)
+  {
+    for (auto sock : m_udp_workers->sockets())
+    {
+      state["udp"].append(add_fd(sock));
+    }
+  }
+  else if (m_udp_sock != 0)
+  {
+    state["udp"].append(add_fd(m_udp_sock->fd()));
+  }
+  state["clients"] = Json::Value(Json::arrayValue);
+  for (const auto& item : m_client_con_map)
+  {
+    Json::Value client_state(Json::objectValue);
+    item.second->saveState(client_state);
+    client_state["fd"] = add_fd(item.first->socket());
+    state["clients"].append(client_state);
+  }
+
+  if (!m_handover.handOver(state, fds))
+  {
+    cerr << "*** ERROR: Handover failed. Continuing operation." << endl;
+    if (m_udp_workers != 0)
+    {
+      m_udp_workers->resume();
+    }
+    return;
+  }
+
+    // The new process now own the sockets. Make sure that nothing more is
+    // read from or written to them by this process.
+  for (const auto& item : m_client_con_map)
+  {
+    close(item.first->releaseSocket());
+  }
+  close(m_srv->releaseSocket());
+  if (m_http_server != 0)
+  {
+    close(m_http_server->releaseSocket());
+  }
+  if (m_trunk_srv != 0)
+  {
+    close(m_trunk_srv->releaseSocket());
+  }
+  delete m_udp_sock;
+  m_udp_sock = 0;
+  if (m_udp_workers != 0)
+  {
+    m_udp_workers->stop();
+  }
+
+  cout << "Handed over " << m_client_con_map.size()
+       << " clients to the new reflector process. Exiting." << endl;
+  Application::app().quit();
+} /* Reflector::onHandOverRequested */
 
 
 /*
@@ -38,6 +38,11 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sys/time.h>
 #include <vector>
 #include <string>
+#include <map>
+#include <set>
+#include <deque>
+#include <chrono>
+#include <memory>
 
 
 /****************************************************************************
@@ -60,6 +65,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "ProtoVer.h"
 #include "ReflectorClient.h"
+#include "ReflectorHandover.h"
 
 
 /****************************************************************************
@@ -76,6 +82,10 @@ namespace Async
 
 class ReflectorMsg;
 class ReflectorUdpMsg;
+class UdpWorkerPool;
+class TGRecorder;
+class TGTranscoder;
+class TrunkLink;
 
 
 /****************************************************************************
@@ -132,9 +142,10 @@ class Reflector : public sigc::trackable
     /**
      * @brief 	Initialize the reflector
      * @param 	cfg A previously initialized configuration object
+     * @param   takeover Set to \em true to take over from a running reflector
      * @return	Return \em true on success or else \em false
      */
-    bool initialize(Async::Config &cfg);
+    bool initialize(Async::Config &cfg, bool takeover=false);
 
     /**
      * @brief   Return a list of all connected nodes
@@ -181,12 +192,84 @@ class Reflector : public sigc::trackable
      */
     void requestQsy(ReflectorClient *client, uint32_t tg);
 
+    /**
+     * @brief   Ask for permission to start authenticating a client
+     * @param   client The client that want to log in
+     * @return  Returns \em false if the login queue is full
+     *
+     * Logins are admitted at the rate set by GLOBAL/LOGIN_RATE. If there is
+     * room for the login right away, ReflectorClient::admitLogin is called
+     * before this function returns. Otherwise the client is put in a queue
+     * and admitted later.
+     */
+    bool requestLogin(ReflectorClient *client);
+
+    /**
+     * @brief   Tell the reflector that a client has been authenticated
+     * @param   client The client that has been authenticated
+     *
+     * The node list is not sent to the client right away. Instead, logins
+     * are collected for GLOBAL/LOGIN_BATCH_TIME milliseconds so that all
+     * nodes logging in at about the same time can be announced to the
+     * already connected nodes in one go. ReflectorClient::completeLogin is
+     * called for each client when the batch is flushed.
+     */
+    void loginAuthenticated(ReflectorClient *client);
+
+    /**
+     * @brief   Get the audio codecs supported by the reflector
+     * @return  Returns the codecs in order of preference
+     *
+     * The first codec is the primary codec. It is used by clients that do
+     * not select a codec, by the talk group recorder and on trunks.
+     */
+    const std::vector<std::string>& codecs(void) const { return m_codecs; }
+
+    /**
+     * @brief   Tell the reflector that a client has selected another codec
+     * @param   client The client that has changed codec
+     */
+    void clientCodecChanged(ReflectorClient *client);
+
   private:
     typedef std::map<uint32_t, ReflectorClient*> ReflectorClientMap;
     typedef std::map<Async::FramedTcpConnection*,
                      ReflectorClient*> ReflectorClientConMap;
     typedef Async::TcpServer<Async::FramedTcpConnection> FramedTcpServer;
 
+    static const unsigned TRUNK_AUTH_TIMEOUT = 15000;
+
+    struct PendingTalkerStop
+    {
+      std::string                     callsign;
+      bool                            trunk_talker;
+    };
+
+    struct PendingTrunk
+    {
+      std::vector<uint8_t>            challenge;
+      sigc::connection                frame_con;
+      std::unique_ptr<Async::Timer>   auth_timer;
+    };
+
+    using LoginClock = std::chrono::steady_clock;
+
+    struct QueuedLogin
+    {
+      ReflectorClient*        client;
+      LoginClock::time_point  queued_at;
+    };
+
+    struct LoginStats
+    {
+      unsigned long admitted    = 0;
+      unsigned long queued      = 0;
+      unsigned long rejected    = 0;
+      unsigned long batches     = 0;
+      size_t        max_queued  = 0;
+      unsigned      max_wait_ms = 0;
+    };
+
     FramedTcpServer*                                m_srv;
     Async::UdpSocket*                               m_udp_sock;
     ReflectorClientMap                              m_client_map;
@@ -197,6 +280,33 @@ class Reflector : public sigc::trackable
     uint32_t                                        m_random_qsy_hi;
     uint32_t                                        m_random_qsy_tg;
     Async::TcpServer<Async::HttpServerConnection>*  m_http_server;
+    UdpWorkerPool*                                  m_udp_workers;
+    bool                                            m_udp_snapshot_dirty;
+    TGRecorder*                                     m_tg_recorder;
+    std::vector<std::string>                        m_codecs;
+    TGTranscoder*                                   m_transcoder;
+    std::map<uint32_t, PendingTalkerStop>           m_pending_talker_stops;
+    std::map<uint32_t, std::string>                 m_trunk_talker_codecs;
+    std::string                                     m_trunk_id;
+    FramedTcpServer*                                m_trunk_srv;
+    std::vector<TrunkLink*>                         m_trunks;
+    std::map<Async::FramedTcpConnection*,
+             PendingTrunk>                          m_pending_trunks;
+    std::set<uint32_t>                              m_trunk_tgs;
+    unsigned                                        m_login_rate;
+    unsigned                                        m_login_burst;
+    size_t                                          m_login_queue_max;
+    double                                          m_login_tokens;
+    LoginClock::time_point                          m_login_tokens_updated;
+    std::deque<QueuedLogin>                         m_login_queue;
+    Async::Timer                                    m_login_queue_timer;
+    std::vector<ReflectorClient*>                   m_login_batch;
+    Async::Timer                                    m_login_batch_timer;
+    LoginStats                                      m_login_stats;
+    ReflectorHandover                               m_handover;
+    Json::Value                                     m_handover_state;
+    ReflectorHandover::FdList                       m_handover_fds;
+    std::vector<int>                                m_udp_worker_socks;
 
     Reflector(const Reflector&);
     Reflector& operator=(const Reflector&);
@@ -213,7 +323,55 @@ class Reflector : public sigc::trackable
     void httpClientDisconnected(Async::HttpServerConnection *con,
         Async::HttpServerConnection::DisconnectReason reason);
     void onRequestAutoQsy(uint32_t from_tg);
+    void udpRoutingChanged(void);
+    void publishUdpSnapshot(void);
+    void udpWorkerDatagramReceived(const Async::IpAddress& addr,
+                                   uint16_t port, void *buf, int count);
+    void udpWorkerAudioRelayed(uint32_t client_id, uint16_t seq);
+    bool relayInMainThread(uint32_t tg);
+    bool initListenSockets(void);
+    void releaseListenSockets(void);
+    bool initCodecs(void);
+    void relayAudio(uint32_t tg, ReflectorClient *talker,
+                    const std::string& codec,
+                    const std::vector<uint8_t>& data);
+    void onAudioTranscoded(uint32_t tg, uint32_t src_client_id,
+                           const std::string& src_codec,
+                           const std::string& codec,
+                           const std::vector<uint8_t>& data);
+    void onTranscodedAudioFlushed(uint32_t tg, uint32_t src_client_id,
+                                  const std::string& codec);
+    bool primaryAudioWanted(uint32_t tg);
+    void writePrimaryAudio(uint32_t tg, const std::vector<uint8_t>& data);
+    void primaryTalkerStop(uint32_t tg, const PendingTalkerStop& stop);
+    void completePendingTalkerStop(uint32_t tg);
+    bool initTrunks(void);
+    void trunkConnected(Async::FramedTcpConnection *con);
+    void trunkDisconnected(Async::FramedTcpConnection *con,
+                           Async::FramedTcpConnection::DisconnectReason reason);
+    void trunkFrameReceived(Async::FramedTcpConnection *con,
+                            std::vector<uint8_t>& data);
+    void trunkInterestChanged(void);
+    void trunkAuthTimeout(Async::FramedTcpConnection *con);
+    void onTrunkUp(TrunkLink *link);
+    void onTrunkDown(TrunkLink *link);
+    void onTrunkTalkerStart(TrunkLink *link, uint32_t tg,
+                            const std::string& callsign,
+                            const std::string& codec);
+    void onTrunkTalkerStop(TrunkLink *link, uint32_t tg,
+                           const std::string& callsign);
+    void onTrunkAudio(TrunkLink *link, uint32_t tg, const std::string& codec,
+                      const std::vector<uint8_t>& data);
+    void onTrunkTalkerUpdated(uint32_t tg, const std::string& old_callsign,
+                              const std::string& new_callsign);
     uint32_t nextRandomQsyTg(void);
+    bool takeLoginToken(void);
+    void processLoginQueue(void);
+    void flushLoginBatch(void);
+    bool removePendingLogin(ReflectorClient *client);
+    int takeHandoverFd(const Json::Value& idx);
+    void restoreClients(void);
+    void onHandOverRequested(void);
 
 };  /* class Reflector */
 
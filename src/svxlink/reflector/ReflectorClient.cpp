@@ -45,8 +45,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <AsyncTimer.h>
-#include <AsyncAudioEncoder.h>
-#include <AsyncAudioDecoder.h>
 #include <common.h>
 
 
@@ -133,7 +131,8 @@ ReflectorClient::ReflectorClient(Reflector *ref, Async::FramedTcpConnection *con
   : m_con(con), m_con_state(STATE_EXPECT_PROTO_VER),
     m_disc_timer(10000, Timer::TYPE_ONESHOT, false),
     m_client_id(next_client_id++), m_remote_udp_port(0), m_cfg(cfg),
-    m_next_udp_tx_seq(0), m_next_udp_rx_seq(0),
+    m_next_udp_tx_seq(std::make_shared<std::atomic<uint16_t>>(0)),
+    m_next_udp_rx_seq(0),
     m_heartbeat_timer(1000, Timer::TYPE_PERIODIC),
     m_heartbeat_tx_cnt(HEARTBEAT_TX_CNT_RESET),
     m_heartbeat_rx_cnt(HEARTBEAT_RX_CNT_RESET),
@@ -150,33 +149,9 @@ ReflectorClient::ReflectorClient(Reflector *ref, Async::FramedTcpConnection *con
   m_heartbeat_timer.expired.connect(
       mem_fun(*this, &ReflectorClient::handleHeartbeat));
 
-  string codecs;
-  if (m_cfg->getValue("GLOBAL", "CODECS", codecs))
+  if (!m_reflector->codecs().empty())
   {
-    SvxLink::splitStr(m_supported_codecs, codecs, ",");
-  }
-  if (m_supported_codecs.size() > 1)
-  {
-    m_supported_codecs.erase(m_supported_codecs.begin()+1,
-                             m_supported_codecs.end());
-    cout << "*** WARNING: The GLOBAL/CODECS configuration "
-            "variable can only take one codec at the moment. Using the first "
-            "one: \"" << m_supported_codecs.front() << "\"" << endl;
-  }
-  else if (m_supported_codecs.empty())
-  {
-    string codec = "GSM";
-    if (AudioDecoder::isAvailable("OPUS") &&
-        AudioEncoder::isAvailable("OPUS"))
-    {
-      codec = "OPUS";
-    }
-    else if (AudioDecoder::isAvailable("SPEEX") &&
-             AudioEncoder::isAvailable("SPEEX"))
-    {
-      codec = "SPEEX";
-    }
-    m_supported_codecs.push_back(codec);
+    m_codec = m_reflector->codecs().front();
   }
 } /* ReflectorClient::ReflectorClient */
 
@@ -335,6 +310,9 @@ void ReflectorClient::onFrameReceived(FramedTcpConnection *con,
     case MsgError::TYPE:
       handleMsgError(ss);
       break;
+    case MsgSelectCodec::TYPE:
+      handleSelectCodec(ss);
+      break;
     default:
       // Better just ignoring unknown protocol messages for making it easier to
       // add messages to the protocol and still be backwards compatible.
@@ -390,11 +368,18 @@ void ReflectorClient::handleMsgProtoVer(std::istream& is)
     return;
   }
 
-  MsgAuthChallenge challenge_msg;
-  memcpy(m_auth_challenge, challenge_msg.challenge(),
-         MsgAuthChallenge::CHALLENGE_LEN);
-  sendMsg(challenge_msg);
-  m_con_state = STATE_EXPECT_AUTH_RESPONSE;
+  m_con_state = STATE_LOGIN_QUEUED;
+  if (!m_reflector->requestLogin(this))
+  {
+    std::cout << "Client " << m_con->remoteHost() << ":" << m_con->remotePort()
+              << " login rejected since the login queue is full" << std::endl;
+    sendError("Server busy");
+  }
+  else if (m_con_state == STATE_LOGIN_QUEUED)
+  {
+    std::cout << "Client " << m_con->remoteHost() << ":" << m_con->remotePort()
+              << " login queued" << std::endl;
+  }
 } /* ReflectorClient::handleMsgProtoVer */
 
 
@@ -433,31 +418,8 @@ void ReflectorClient::handleMsgAuthResponse(std::istream& is)
            << " with protocol version " << m_client_proto_ver.majorVer()
            << "." << m_client_proto_ver.minorVer()
            << endl;
-      m_con_state = STATE_CONNECTED;
-      MsgServerInfo msg_srv_info(m_client_id, m_supported_codecs);
-      m_reflector->nodeList(msg_srv_info.nodes());
-      sendMsg(msg_srv_info);
-      if (m_client_proto_ver < ProtoVer(0, 7))
-      {
-        MsgNodeList msg_node_list(msg_srv_info.nodes());
-        sendMsg(msg_node_list);
-      }
-      if (m_client_proto_ver < ProtoVer(2, 0))
-      {
-        if (TGHandler::instance()->switchTo(this, m_reflector->tgForV1Clients()))
-        {
-          std::cout << m_callsign << ": Select TG #"
-                    << m_reflector->tgForV1Clients() << std::endl;
-          m_current_tg = m_reflector->tgForV1Clients();
-        }
-        else
-        {
-          std::cout << m_callsign
-                    << ": V1 client not allowed to use default TG #"
-                    << m_reflector->tgForV1Clients() << std::endl;
-        }
-      }
-      m_reflector->broadcastMsg(MsgNodeJoined(m_callsign), ExceptFilter(this));
+      m_con_state = STATE_LOGIN_PENDING;
+      m_reflector->loginAuthenticated(this);
     }
     else
     {
@@ -475,6 +437,126 @@ void ReflectorClient::handleMsgAuthResponse(std::istream& is)
 } /* ReflectorClient::handleMsgAuthResponse */
 
 
+void ReflectorClient::admitLogin(void)
+{
+  if (m_con_state != STATE_LOGIN_QUEUED)
+  {
+    return;
+  }
+
+  MsgAuthChallenge challenge_msg;
+  memcpy(m_auth_challenge, challenge_msg.challenge(),
+         MsgAuthChallenge::CHALLENGE_LEN);
+  sendMsg(challenge_msg);
+  m_con_state = STATE_EXPECT_AUTH_RESPONSE;
+} /* ReflectorClient::admitLogin */
+
+
+void ReflectorClient::completeLogin(void)
+{
+  if (m_con_state != STATE_LOGIN_PENDING)
+  {
+    return;
+  }
+
+  m_con_state = STATE_CONNECTED;
+
+    // Older clients cannot tell us which codec they choose so they are only
+    // offered the primary codec
+  std::vector<std::string> codecs(m_reflector->codecs());
+  if ((m_client_proto_ver < ProtoVer(2, 1)) && (codecs.size() > 1))
+  {
+    codecs.erase(codecs.begin()+1, codecs.end());
+  }
+  MsgServerInfo msg_srv_info(m_client_id, codecs);
+  m_reflector->nodeList(msg_srv_info.nodes());
+  sendMsg(msg_srv_info);
+  if (m_client_proto_ver < ProtoVer(0, 7))
+  {
+    MsgNodeList msg_node_list(msg_srv_info.nodes());
+    sendMsg(msg_node_list);
+  }
+  if (m_client_proto_ver < ProtoVer(2, 0))
+  {
+    if (TGHandler::instance()->switchTo(this, m_reflector->tgForV1Clients()))
+    {
+      std::cout << m_callsign << ": Select TG #"
+                << m_reflector->tgForV1Clients() << std::endl;
+      m_current_tg = m_reflector->tgForV1Clients();
+    }
+    else
+    {
+      std::cout << m_callsign
+                << ": V1 client not allowed to use default TG #"
+                << m_reflector->tgForV1Clients() << std::endl;
+    }
+  }
+} /* ReflectorClient::completeLogin */
+
+
+void ReflectorClient::disconnect(void)
+{
+  m_heartbeat_timer.setEnable(false);
+  m_remote_udp_port = 0;
+  m_con->disconnect();
+  m_con_state = STATE_DISCONNECTED;
+  m_con->disconnected(m_con, FramedTcpConnection::DR_ORDERED_DISCONNECT);
+} /* ReflectorClient::disconnect */
+
+
+void ReflectorClient::saveState(Json::Value& state) const
+{
+  state["id"] = m_client_id;
+  state["callsign"] = m_callsign;
+  state["remoteHost"] = m_con->remoteHost().toString();
+  state["remotePort"] = m_con->remotePort();
+  state["udpPort"] = m_remote_udp_port;
+  state["protoVer"]["majorVer"] = m_client_proto_ver.majorVer();
+  state["protoVer"]["minorVer"] = m_client_proto_ver.minorVer();
+  state["tg"] = m_current_tg;
+  state["monitoredTgs"] = Json::Value(Json::arrayValue);
+  for (auto tg : m_monitored_tgs)
+  {
+    state["monitoredTgs"].append(tg);
+  }
+  state["udpTxSeq"] = m_next_udp_tx_seq->load();
+  state["udpRxSeq"] = m_next_udp_rx_seq;
+  state["nodeInfo"] = m_node_info;
+  state["codec"] = m_codec;
+} /* ReflectorClient::saveState */
+
+
+void ReflectorClient::restoreState(const Json::Value& state)
+{
+  m_client_id = state["id"].asUInt();
+  next_client_id = std::max(next_client_id, m_client_id + 1);
+  m_callsign = state["callsign"].asString();
+  m_remote_udp_port = state["udpPort"].asUInt();
+  m_client_proto_ver.set(state["protoVer"]["majorVer"].asUInt(),
+                         state["protoVer"]["minorVer"].asUInt());
+  m_monitored_tgs.clear();
+  for (const auto& tg : state["monitoredTgs"])
+  {
+    m_monitored_tgs.insert(tg.asUInt());
+  }
+  m_next_udp_tx_seq->store(state["udpTxSeq"].asUInt());
+  m_next_udp_rx_seq = state["udpRxSeq"].asUInt();
+  m_node_info = state["nodeInfo"];
+  if (state.isMember("codec"))
+  {
+    m_codec = state["codec"].asString();
+  }
+  m_con->setMaxFrameSize(ReflectorMsg::MAX_POSTAUTH_FRAME_SIZE);
+  m_con_state = STATE_CONNECTED;
+
+  uint32_t tg = state["tg"].asUInt();
+  if ((tg > 0) && TGHandler::instance()->switchTo(this, tg))
+  {
+    m_current_tg = tg;
+  }
+} /* ReflectorClient::restoreState */
+
+
 void ReflectorClient::handleSelectTG(std::istream& is)
 {
   MsgSelectTG msg;
@@ -547,6 +629,40 @@ void ReflectorClient::handleTgMonitor(std::istream& is)
 } /* ReflectorClient::handleTgMonitor */
 
 
+void ReflectorClient::handleSelectCodec(std::istream& is)
+{
+  if (m_con_state != STATE_CONNECTED)
+  {
+    return;
+  }
+
+  MsgSelectCodec msg;
+  if (!msg.unpack(is))
+  {
+    cout << "Client " << m_con->remoteHost() << ":" << m_con->remotePort()
+         << " ERROR: Could not unpack MsgSelectCodec" << endl;
+    sendError("Illegal MsgSelectCodec protocol message received");
+    return;
+  }
+
+  const std::vector<std::string>& codecs = m_reflector->codecs();
+  if (std::find(codecs.begin(), codecs.end(), msg.codec()) == codecs.end())
+  {
+    cout << m_callsign << ": Unsupported codec \"" << msg.codec()
+         << "\" selected" << endl;
+    sendError("Unsupported codec");
+    return;
+  }
+  if (msg.codec() != m_codec)
+  {
+    cout << m_callsign << ": Using audio codec \"" << msg.codec() << "\""
+         << endl;
+    m_codec = msg.codec();
+    m_reflector->clientCodecChanged(this);
+  }
+} /* ReflectorClient::handleSelectCodec */
+
+
 void ReflectorClient::handleNodeInfo(std::istream& is)
 {
   MsgNodeInfo msg;
@@ -775,16 +891,6 @@ void ReflectorClient::onDiscTimeout(Timer *t)
 } /* ReflectorClient::onDiscTimeout */
 
 
-void ReflectorClient::disconnect(void)
-{
-  m_heartbeat_timer.setEnable(false);
-  m_remote_udp_port = 0;
-  m_con->disconnect();
-  m_con_state = STATE_DISCONNECTED;
-  m_con->disconnected(m_con, FramedTcpConnection::DR_ORDERED_DISCONNECT);
-} /* ReflectorClient::disconnect */
-
-
 void ReflectorClient::handleHeartbeat(Async::Timer *t)
 {
   if (--m_heartbeat_tx_cnt == 0)
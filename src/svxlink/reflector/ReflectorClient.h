@@ -35,6 +35,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include <string>
+#include <memory>
+#include <atomic>
 #include <json/json.h>
 
 
@@ -112,8 +114,9 @@ class ReflectorClient
   public:
     typedef enum
     {
-      STATE_DISCONNECTED, STATE_EXPECT_PROTO_VER, STATE_EXPECT_AUTH_RESPONSE,
-      STATE_CONNECTED, STATE_EXPECT_DISCONNECT
+      STATE_DISCONNECTED, STATE_EXPECT_PROTO_VER, STATE_LOGIN_QUEUED,
+      STATE_EXPECT_AUTH_RESPONSE, STATE_LOGIN_PENDING, STATE_CONNECTED,
+      STATE_EXPECT_DISCONNECT
     } ConState;
 
     struct Rx
@@ -159,6 +162,18 @@ class ReflectorClient
         const ReflectorClient* m_except;
     };
 
+    class ExceptIdFilter : public Filter
+    {
+      public:
+        ExceptIdFilter(uint32_t client_id) : m_client_id(client_id) {}
+        virtual bool operator ()(ReflectorClient *client) const
+        {
+          return client->clientId() != m_client_id;
+        }
+      private:
+        uint32_t m_client_id;
+    };
+
     class ProtoVerRangeFilter : public Filter
     {
       public:
@@ -195,6 +210,18 @@ class ReflectorClient
         uint32_t m_tg;
     };
 
+    class CodecFilter : public Filter
+    {
+      public:
+        CodecFilter(const std::string& codec) : m_codec(codec) {}
+        virtual bool operator ()(ReflectorClient *client) const
+        {
+          return client->m_codec == m_codec;
+        }
+      private:
+        std::string m_codec;
+    };
+
     template <class F1, class F2>
     class AndFilter : public Filter
     {
@@ -300,7 +327,19 @@ class ReflectorClient
      * used by the receiver to find out if a packet is out of order or if a
      * packet has been lost in transit.
      */
-    uint16_t nextUdpTxSeq(void) { return m_next_udp_tx_seq++; }
+    uint16_t nextUdpTxSeq(void) { return (*m_next_udp_tx_seq)++; }
+
+    /**
+     * @brief   Get the UDP transmit sequence number counter
+     * @return  Returns a shared pointer to the sequence number counter
+     *
+     * The counter is shared with the UDP worker threads that relay audio
+     * directly to this client.
+     */
+    std::shared_ptr<std::atomic<uint16_t>> udpTxSeqCounter(void) const
+    {
+      return m_next_udp_tx_seq;
+    }
 
     /**
      * @brief   Get the next expected UDP packet sequence number
@@ -355,12 +394,67 @@ class ReflectorClient
      */
     ConState conState(void) const { return m_con_state; }
 
+    /**
+     * @brief   Start authenticating a client that waits for admission
+     *
+     * This function is called by the reflector when a queued login is
+     * admitted. The authentication challenge is sent to the client.
+     */
+    void admitLogin(void);
+
+    /**
+     * @brief   Finish the login of an authenticated client
+     *
+     * This function is called by the reflector when the node list is to be
+     * sent to a newly authenticated client.
+     */
+    void completeLogin(void);
+
+    /**
+     * @brief   Disconnect the client
+     *
+     * The connection is closed and the disconnected signal is emitted.
+     */
+    void disconnect(void);
+
+    /**
+     * @brief   Check if the client can be handed over to another process
+     * @return  Returns \em true if the client can be handed over
+     *
+     * Only logged in clients that are not in the middle of a TCP frame
+     * transfer can be handed over.
+     */
+    bool canBeHandedOver(void) const
+    {
+      return (m_con_state == STATE_CONNECTED) && !m_con->hasPendingData();
+    }
+
+    /**
+     * @brief   Save the client state for handing it over to another process
+     * @param   state The JSON object to save the state to
+     */
+    void saveState(Json::Value& state) const;
+
+    /**
+     * @brief   Restore the state of a client handed over from another process
+     * @param   state The JSON object previously filled in by saveState
+     *
+     * The client is put directly into the connected state.
+     */
+    void restoreState(const Json::Value& state);
+
     /**
      * @brief   Get the protocol version of the client
      * @return  Returns the protocol version of the client
      */
     const ProtoVer& protoVer(void) const { return m_client_proto_ver; }
 
+    /**
+     * @brief   Get the audio codec used by the client
+     * @return  Returns the name of the audio codec
+     */
+    const std::string& codec(void) const { return m_codec; }
+
     /**
      * @brief   Get the current talk group
      * @return  Returns the currently selected talk group
@@ -429,7 +523,7 @@ class ReflectorClient
     uint32_t                    m_client_id;
     uint16_t                    m_remote_udp_port;
     Async::Config*              m_cfg;
-    uint16_t                    m_next_udp_tx_seq;
+    std::shared_ptr<std::atomic<uint16_t>> m_next_udp_tx_seq;
     uint16_t                    m_next_udp_rx_seq;
     Async::Timer                m_heartbeat_timer;
     unsigned                    m_heartbeat_tx_cnt;
@@ -440,7 +534,7 @@ class ReflectorClient
     unsigned                    m_blocktime;
     unsigned                    m_remaining_blocktime;
     ProtoVer                    m_client_proto_ver;
-    std::vector<std::string>    m_supported_codecs;
+    std::string                 m_codec;
     uint32_t                    m_current_tg;
     std::set<uint32_t>          m_monitored_tgs;
     RxMap                       m_rx_map;
@@ -461,9 +555,9 @@ class ReflectorClient
     void handleRequestQsy(std::istream& is);
     void handleStateEvent(std::istream& is);
     void handleMsgError(std::istream& is);
+    void handleSelectCodec(std::istream& is);
     void sendError(const std::string& msg);
     void onDiscTimeout(Async::Timer *t);
-    void disconnect(void);
     void handleHeartbeat(Async::Timer *t);
     std::string lookupUserKey(const std::string& callsign);
 
@@ -0,0 +1,542 @@
+/**
+@file   ReflectorHandover.cpp
+@brief  Hand over sockets and client state to a new reflector process
+@author agent
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "ReflectorHandover.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+const char ReflectorHandover::MAGIC[8] = {'S','V','X','R','H','O','V','1'};
+const char ReflectorHandover::READY[4] = {'R','D','Y','!'};
+const char ReflectorHandover::GO[4] = {'G','O','G','O'};
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+namespace {
+  bool setUnixAddr(struct sockaddr_un& addr, const std::string& path)
+  {
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || (path.size() >= sizeof(addr.sun_path)))
+    {
+      cerr << "*** ERROR: Illegal handover socket path \"" << path << "\""
+           << endl;
+      return false;
+    }
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path)-1);
+    return true;
+  } /* setUnixAddr */
+};
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+ReflectorHandover::ReflectorHandover(void)
+  : m_listen_sock(-1), m_peer_sock(-1)
+{
+  m_listen_watch.activity.connect(
+      mem_fun(*this, &ReflectorHandover::onConnection));
+} /* ReflectorHandover::ReflectorHandover */
+
+
+ReflectorHandover::~ReflectorHandover(void)
+{
+  closePeer();
+  m_listen_watch.setFd(-1, FdWatch::FD_WATCH_RD);
+  if (m_listen_sock >= 0)
+  {
+    close(m_listen_sock);
+    m_listen_sock = -1;
+    unlink(m_path.c_str());
+  }
+} /* ReflectorHandover::~ReflectorHandover */
+
+
+bool ReflectorHandover::listen(const std::string& path)
+{
+  struct sockaddr_un addr;
+  if (!setUnixAddr(addr, path))
+  {
+    return false;
+  }
+
+  m_listen_sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (m_listen_sock < 0)
+  {
+    perror("socket(AF_UNIX)");
+    return false;
+  }
+
+    // A stale socket may be left behind by a previous reflector process
+  unlink(path.c_str());
+  if ((::bind(m_listen_sock, reinterpret_cast<struct sockaddr*>(&addr),
+              sizeof(addr)) != 0) ||
+      (chmod(path.c_str(), S_IRUSR | S_IWUSR) != 0) ||
+      (::listen(m_listen_sock, 1) != 0))
+  {
+    cerr << "*** ERROR: Could not set up handover socket \"" << path
+         << "\": " << strerror(errno) << endl;
+    close(m_listen_sock);
+    m_listen_sock = -1;
+    return false;
+  }
+
+  m_path = path;
+  m_listen_watch.setFd(m_listen_sock, FdWatch::FD_WATCH_RD);
+  m_listen_watch.setEnabled(true);
+
+  return true;
+} /* ReflectorHandover::listen */
+
+
+bool ReflectorHandover::handOver(const Json::Value& state, const FdList& fds)
+{
+  if (m_peer_sock < 0)
+  {
+    return false;
+  }
+
+  Json::StreamWriterBuilder builder;
+  builder["commentStyle"] = "None";
+  builder["indentation"] = "";
+  const std::string json = Json::writeString(builder, state);
+
+  char hdr[sizeof(MAGIC) + 2 * sizeof(uint32_t)];
+  uint32_t fd_cnt = htonl(fds.size());
+  uint32_t json_len = htonl(json.size());
+  memcpy(hdr, MAGIC, sizeof(MAGIC));
+  memcpy(hdr + sizeof(MAGIC), &fd_cnt, sizeof(fd_cnt));
+  memcpy(hdr + sizeof(MAGIC) + sizeof(fd_cnt), &json_len, sizeof(json_len));
+  bool ok = sendMsg(hdr, sizeof(hdr));
+
+  for (size_t i=0; ok && (i<fds.size()); i+=FDS_PER_MSG)
+  {
+    size_t cnt = std::min(static_cast<size_t>(FDS_PER_MSG), fds.size()-i);
+    uint32_t msg_cnt = htonl(cnt);
+    ok = sendMsg(&msg_cnt, sizeof(msg_cnt), &fds[i], cnt);
+  }
+
+  for (size_t pos=0; ok && (pos<json.size()); pos+=JSON_CHUNK_SIZE)
+  {
+    ok = sendMsg(json.data()+pos,
+        std::min(static_cast<size_t>(JSON_CHUNK_SIZE), json.size()-pos));
+  }
+
+    // The new process must not start serving before it has received the
+    // go message. Until that message has been sent this process can safely
+    // continue if anything fail. Once it has been sent, this process must
+    // never touch the handed over sockets again.
+  if (ok)
+  {
+    char ready[sizeof(READY)];
+    ok = (recvMsg(ready, sizeof(ready)) == sizeof(READY)) &&
+         (memcmp(ready, READY, sizeof(READY)) == 0) &&
+         sendMsg(GO, sizeof(GO));
+  }
+  closePeer();
+
+  if (ok)
+  {
+      // The socket file now belong to the new process so it must not be
+      // removed when this object is destroyed
+    m_listen_watch.setFd(-1, FdWatch::FD_WATCH_RD);
+    close(m_listen_sock);
+    m_listen_sock = -1;
+    m_path.clear();
+  }
+
+  return ok;
+} /* ReflectorHandover::handOver */
+
+
+bool ReflectorHandover::takeOver(const std::string& path, Json::Value& state,
+                                 FdList& fds)
+{
+  closePeer();
+  fds.clear();
+
+  struct sockaddr_un addr;
+  if (!setUnixAddr(addr, path))
+  {
+    return false;
+  }
+
+  m_peer_sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (m_peer_sock < 0)
+  {
+    perror("socket(AF_UNIX)");
+    return false;
+  }
+  if (connect(m_peer_sock, reinterpret_cast<struct sockaddr*>(&addr),
+              sizeof(addr)) != 0)
+  {
+    cerr << "*** ERROR: Could not connect to handover socket \"" << path
+         << "\": " << strerror(errno) << endl;
+    closePeer();
+    return false;
+  }
+  setTimeout(HANDOVER_TIMEOUT);
+
+  char hdr[sizeof(MAGIC) + 2 * sizeof(uint32_t)];
+  bool ok = sendMsg(MAGIC, sizeof(MAGIC)) &&
+            (recvMsg(hdr, sizeof(hdr)) == sizeof(hdr)) &&
+            (memcmp(hdr, MAGIC, sizeof(MAGIC)) == 0);
+  uint32_t fd_cnt = 0;
+  uint32_t json_len = 0;
+  if (ok)
+  {
+    memcpy(&fd_cnt, hdr + sizeof(MAGIC), sizeof(fd_cnt));
+    memcpy(&json_len, hdr + sizeof(MAGIC) + sizeof(fd_cnt), sizeof(json_len));
+    fd_cnt = ntohl(fd_cnt);
+    json_len = ntohl(json_len);
+  }
+
+  while (ok && (fds.size() < fd_cnt))
+  {
+    uint32_t msg_cnt = 0;
+    size_t prev_size = fds.size();
+    ok = (recvMsg(&msg_cnt, sizeof(msg_cnt), &fds) == sizeof(msg_cnt)) &&
+         (fds.size() - prev_size == ntohl(msg_cnt));
+  }
+
+  std::string json;
+  std::vector<char> buf(JSON_CHUNK_SIZE);
+  while (ok && (json.size() < json_len))
+  {
+    ssize_t len = recvMsg(buf.data(), buf.size());
+    ok = (len > 0);
+    if (ok)
+    {
+      json.append(buf.data(), len);
+    }
+  }
+
+  if (ok)
+  {
+    try
+    {
+      std::istringstream is(json);
+      is >> state;
+    }
+    catch (const Json::Exception& e)
+    {
+      cerr << "*** ERROR: Failed to parse handover state: " << e.what()
+           << endl;
+      ok = false;
+    }
+  }
+
+  if (!ok)
+  {
+    cerr << "*** ERROR: Failed to receive state from the running reflector"
+         << endl;
+    for (int fd : fds)
+    {
+      close(fd);
+    }
+    fds.clear();
+    closePeer();
+  }
+
+  return ok;
+} /* ReflectorHandover::takeOver */
+
+
+bool ReflectorHandover::confirmTakeOver(void)
+{
+    // The old process answer at once when it receive the ready message.
+    // Its own timeout expire before ours so if no go message has arrived
+    // in time, the old process has given up the handover or is hung.
+  char go[sizeof(GO)];
+  bool ok = sendMsg(READY, sizeof(READY)) &&
+            (recvMsg(go, sizeof(go)) == sizeof(GO)) &&
+            (memcmp(go, GO, sizeof(GO)) == 0);
+  closePeer();
+  return ok;
+} /* ReflectorHandover::confirmTakeOver */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void ReflectorHandover::onConnection(FdWatch *w)
+{
+  int sock = accept4(m_listen_sock, 0, 0, SOCK_CLOEXEC);
+  if (sock < 0)
+  {
+    perror("accept4");
+    return;
+  }
+  if (m_peer_sock >= 0)
+  {
+    close(sock);
+    return;
+  }
+  m_peer_sock = sock;
+
+    // Only allow the same user, or root, to take over the sockets
+  struct ucred cred;
+  socklen_t cred_len = sizeof(cred);
+  if ((getsockopt(m_peer_sock, SOL_SOCKET, SO_PEERCRED, &cred,
+                  &cred_len) != 0) ||
+      ((cred.uid != 0) && (cred.uid != getuid())))
+  {
+    cerr << "*** WARNING: Rejected takeover request from another user"
+         << endl;
+    closePeer();
+    return;
+  }
+
+  setTimeout(REQUEST_TIMEOUT);
+  char magic[sizeof(MAGIC)];
+  if ((recvMsg(magic, sizeof(magic)) != sizeof(MAGIC)) ||
+      (memcmp(magic, MAGIC, sizeof(MAGIC)) != 0))
+  {
+    cerr << "*** WARNING: Illegal takeover request received" << endl;
+    closePeer();
+    return;
+  }
+  setTimeout(HANDOVER_TIMEOUT);
+
+  handOverRequested();
+  closePeer();
+} /* ReflectorHandover::onConnection */
+
+
+bool ReflectorHandover::sendMsg(const void *buf, size_t len, const int *fds,
+                                size_t fd_cnt)
+{
+  struct iovec iov;
+  iov.iov_base = const_cast<void*>(buf);
+  iov.iov_len = len;
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+
+  std::vector<char> cbuf;
+  if (fd_cnt > 0)
+  {
+    cbuf.resize(CMSG_SPACE(fd_cnt * sizeof(int)));
+    msg.msg_control = cbuf.data();
+    msg.msg_controllen = cbuf.size();
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(fd_cnt * sizeof(int));
+    memcpy(CMSG_DATA(cmsg), fds, fd_cnt * sizeof(int));
+  }
+
+  ssize_t ret = sendmsg(m_peer_sock, &msg, MSG_NOSIGNAL);
+  if (ret < 0)
+  {
+    cerr << "*** ERROR: Handover send failed: " << strerror(errno) << endl;
+    return false;
+  }
+  return static_cast<size_t>(ret) == len;
+} /* ReflectorHandover::sendMsg */
+
+
+ssize_t ReflectorHandover::recvMsg(void *buf, size_t len, FdList *fds)
+{
+  struct iovec iov;
+  iov.iov_base = buf;
+  iov.iov_len = len;
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+
+  std::vector<char> cbuf(CMSG_SPACE(FDS_PER_MSG * sizeof(int)));
+  msg.msg_control = cbuf.data();
+  msg.msg_controllen = cbuf.size();
+
+  ssize_t ret = recvmsg(m_peer_sock, &msg, MSG_CMSG_CLOEXEC);
+  if (ret < 0)
+  {
+    cerr << "*** ERROR: Handover receive failed: " << strerror(errno) << endl;
+    return -1;
+  }
+
+  for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != 0;
+       cmsg = CMSG_NXTHDR(&msg, cmsg))
+  {
+    if ((cmsg->cmsg_level != SOL_SOCKET) || (cmsg->cmsg_type != SCM_RIGHTS))
+    {
+      continue;
+    }
+    size_t cnt = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    const int *rfds = reinterpret_cast<const int*>(CMSG_DATA(cmsg));
+    for (size_t i=0; i<cnt; ++i)
+    {
+      if (fds != 0)
+      {
+        fds->push_back(rfds[i]);
+      }
+      else
+      {
+        close(rfds[i]);
+      }
+    }
+  }
+
+  if ((msg.msg_flags & (MSG_CTRUNC | MSG_TRUNC)) != 0)
+  {
+    cerr << "*** ERROR: Truncated handover message received" << endl;
+    return -1;
+  }
+
+  return ret;
+} /* ReflectorHandover::recvMsg */
+
+
+void ReflectorHandover::setTimeout(unsigned timeout_ms)
+{
+  struct timeval tv;
+  tv.tv_sec = timeout_ms / 1000;
+  tv.tv_usec = (timeout_ms % 1000) * 1000;
+  setsockopt(m_peer_sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  setsockopt(m_peer_sock, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+} /* ReflectorHandover::setTimeout */
+
+
+void ReflectorHandover::closePeer(void)
+{
+  if (m_peer_sock >= 0)
+  {
+    close(m_peer_sock);
+    m_peer_sock = -1;
+  }
+} /* ReflectorHandover::closePeer */
+
+
+/*
+ * This file has not been truncated
+ */
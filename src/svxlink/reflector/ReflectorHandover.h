@@ -0,0 +1,247 @@
+/**
+@file   ReflectorHandover.h
+@brief  Hand over sockets and client state to a new reflector process
+@author agent
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef REFLECTOR_HANDOVER_INCLUDED
+#define REFLECTOR_HANDOVER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+#include <json/json.h>
+
+#include <string>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncFdWatch.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  Hand over sockets and client state to a new reflector process
+@author agent
+@date   2026-10-18
+
+This class is used to restart the reflector without dropping the client
+connections. The running reflector listen for takeover requests on a Unix
+domain socket. A newly started reflector connect to that socket and receive
+the listening sockets, the UDP sockets and the client connections from the
+running reflector, together with a JSON document describing the state. The
+file descriptors are passed using SCM_RIGHTS ancillary data so the kernel
+socket objects, and thereby all established TCP connections and queued UDP
+datagrams, are kept intact.
+
+The running reflector do not process any events while the handover is in
+progress. When the new reflector has set everything up it tell the old
+reflector that it is ready and then wait for a go message. The old reflector
+send the go message and exit. The new reflector must not start serving
+before the go message has been received. If anything fail before the go
+message has been sent, the old reflector just continue where it left off and
+the new reflector close the received sockets without using them. The new
+reflector stop waiting for the go message after a timeout so a crashed old
+reflector cannot block it forever.
+*/
+class ReflectorHandover : public sigc::trackable
+{
+  public:
+    typedef std::vector<int> FdList;
+
+    /**
+     * @brief   Default constructor
+     */
+    ReflectorHandover(void);
+
+    /**
+     * @brief   Destructor
+     */
+    ~ReflectorHandover(void);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    ReflectorHandover(const ReflectorHandover&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    ReflectorHandover& operator=(const ReflectorHandover&) = delete;
+
+    /**
+     * @brief   Start listening for takeover requests
+     * @param   path The path of the Unix domain socket
+     * @return  Returns \em true on success or else \em false
+     */
+    bool listen(const std::string& path);
+
+    /**
+     * @brief   Hand over to the process that requested a takeover
+     * @param   state The state to hand over
+     * @param   fds   The file descriptors referred to by the state
+     * @return  Returns \em true if the new process has been told to go
+     *
+     * This function must only be called from a handler connected to the
+     * handOverRequested signal. It blocks until the new process is ready to
+     * take over or a timeout occurs. On success, the new process has been
+     * told to start serving so the caller must release all handed over file
+     * descriptors and exit without using them again. On failure, the new
+     * process will give up and the caller may continue. The listening Unix
+     * domain socket is closed on success. The file descriptors are still
+     * owned by the caller when this function returns.
+     */
+    bool handOver(const Json::Value& state, const FdList& fds);
+
+    /**
+     * @brief   Take over from a running reflector process
+     * @param   path  The path of the Unix domain socket
+     * @param   state The received state is returned in this variable
+     * @param   fds   The received file descriptors is returned in this list
+     * @return  Returns \em true on success or else \em false
+     *
+     * The running reflector is blocked until confirmTakeOver is called or
+     * this object is destroyed. Call this function as late as possible
+     * during startup.
+     */
+    bool takeOver(const std::string& path, Json::Value& state, FdList& fds);
+
+    /**
+     * @brief   Tell the old reflector process that the takeover is ready
+     * @return  Returns \em true if the old process told us to go
+     *
+     * This function blocks until the old process has answered or a timeout
+     * occurs. On success, the old process is exiting and the caller must
+     * start serving. On failure, the old process may still be running so the
+     * caller must close the received file descriptors without using them.
+     * If this function is not called, the old reflector continue running.
+     */
+    bool confirmTakeOver(void);
+
+    /**
+     * @brief   A signal emitted when another process request a takeover
+     *
+     * The handler should call handOver to hand over to the new process. If
+     * not, the request is rejected.
+     */
+    sigc::signal<void> handOverRequested;
+
+  private:
+    static const char     MAGIC[8];
+    static const char     READY[4];
+    static const char     GO[4];
+    static const size_t   FDS_PER_MSG         = 128;
+    static const size_t   JSON_CHUNK_SIZE     = 32768;
+    static const unsigned REQUEST_TIMEOUT     = 2000;
+    static const unsigned HANDOVER_TIMEOUT    = 10000;
+
+    std::string     m_path;
+    int             m_listen_sock;
+    int             m_peer_sock;
+    Async::FdWatch  m_listen_watch;
+
+    void onConnection(Async::FdWatch *w);
+    bool sendMsg(const void *buf, size_t len, const int *fds=0,
+                 size_t fd_cnt=0);
+    ssize_t recvMsg(void *buf, size_t len, FdList *fds=0);
+    void setTimeout(unsigned timeout_ms);
+    void closePeer(void);
+
+};  /* class ReflectorHandover */
+
+
+//} /* namespace */
+
+#endif /* REFLECTOR_HANDOVER_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
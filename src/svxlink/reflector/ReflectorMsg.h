@@ -256,7 +256,7 @@ class MsgProtoVer : public ReflectorMsgBase<5>
 {
   public:
     static const uint16_t MAJOR = 2;
-    static const uint16_t MINOR = 0;
+    static const uint16_t MINOR = 2;
     MsgProtoVer(void) : m_major(MAJOR), m_minor(MINOR) {}
     MsgProtoVer(uint16_t major, uint16_t minor)
       : m_major(major), m_minor(minor) {}
@@ -471,6 +471,11 @@ class MsgError : public ReflectorMsgBase<13>
 
 This message is sent by the server to the client to inform about server and
 connection properties.
+
+The codecs list contain the audio codecs supported by the server, in order of
+preference. Clients using protocol version 2.0 or older are only given the
+first codec in the list. Newer clients choose one of the codecs and tell the
+server which one using the MsgSelectCodec message.
 */
 class MsgServerInfo : public ReflectorMsgBase<100>
 {
@@ -1106,6 +1111,163 @@ class MsgTxStatus : public ReflectorMsgBase<113>
 }; /* class MsgTxStatus */
 
 
+/**
+@brief   Select audio codec
+@author  agent
+@date    2026-10-18
+
+This message is sent by a client, using protocol version 2.1 or later, to tell
+the server which of the codecs in the MsgServerInfo message that it use. Audio
+sent by the client must be encoded using that codec and audio sent to the
+client will be transcoded to that codec if needed. A client that do not send
+this message is assumed to use the first codec in the list.
+*/
+class MsgSelectCodec : public ReflectorMsgBase<114>
+{
+  public:
+    MsgSelectCodec(const std::string& codec="") : m_codec(codec) {}
+
+    const std::string& codec(void) const { return m_codec; }
+
+    ASYNC_MSG_MEMBERS(m_codec)
+
+  private:
+    std::string m_codec;
+}; /* class MsgSelectCodec */
+
+
+/**
+@brief   Nodes joined TCP network message
+@author  agent
+@date    2026-10-18
+
+This message is sent by the server to clients using protocol version 2.2 or
+later instead of one MsgNodeJoined message per node, when a number of nodes
+have connected to the reflector at about the same time.
+*/
+class MsgNodesJoined : public ReflectorMsgBase<115>
+{
+  public:
+    MsgNodesJoined(void) {}
+    MsgNodesJoined(const std::vector<std::string>& nodes) : m_nodes(nodes) {}
+
+    const std::vector<std::string>& nodes(void) const { return m_nodes; }
+
+    ASYNC_MSG_MEMBERS(m_nodes)
+
+  private:
+    std::vector<std::string> m_nodes;
+}; /* class MsgNodesJoined */
+
+
+/**************************** Trunk Messages ****************************/
+
+/**
+@brief   Talk groups wanted by a trunked reflector
+@author  agent
+@date    2026-10-18
+
+This message is sent between reflectors connected using a trunk. It contain the
+complete set of talk groups that have local clients on the sending reflector.
+Audio is only sent over the trunk for talk groups in this set. The message is
+resent each time the set change.
+*/
+class MsgTrunkTgInterest : public ReflectorMsgBase<200>
+{
+  public:
+    MsgTrunkTgInterest(void) {}
+    MsgTrunkTgInterest(const std::set<uint32_t>& tgs) : m_tgs(tgs) {}
+
+    const std::set<uint32_t>& tgs(void) const { return m_tgs; }
+
+    ASYNC_MSG_MEMBERS(m_tgs);
+
+  private:
+    std::set<uint32_t> m_tgs;
+}; /* MsgTrunkTgInterest */
+
+
+/**
+@brief   Talker start on a trunked reflector
+@author  agent
+@date    2026-10-18
+
+This message is sent between reflectors connected using a trunk when a local
+client on the sending reflector become the talker on a talk group. The codec
+is the one used for the audio that follow in MsgTrunkAudio messages.
+*/
+class MsgTrunkTalkerStart : public ReflectorMsgBase<201>
+{
+  public:
+    MsgTrunkTalkerStart(uint32_t tg=0, const std::string& callsign="",
+                        const std::string& codec="")
+      : m_tg(tg), m_callsign(callsign), m_codec(codec) {}
+
+    uint32_t tg(void) const { return m_tg; }
+    const std::string& callsign(void) const { return m_callsign; }
+    const std::string& codec(void) const { return m_codec; }
+
+    ASYNC_MSG_MEMBERS(m_tg, m_callsign, m_codec);
+
+  private:
+    uint32_t    m_tg;
+    std::string m_callsign;
+    std::string m_codec;
+}; /* MsgTrunkTalkerStart */
+
+
+/**
+@brief   Talker stop on a trunked reflector
+@author  agent
+@date    2026-10-18
+
+This message is sent between reflectors connected using a trunk when a local
+client on the sending reflector stop being the talker on a talk group.
+*/
+class MsgTrunkTalkerStop : public ReflectorMsgBase<202>
+{
+  public:
+    MsgTrunkTalkerStop(uint32_t tg=0, const std::string& callsign="")
+      : m_tg(tg), m_callsign(callsign) {}
+
+    uint32_t tg(void) const { return m_tg; }
+    const std::string& callsign(void) const { return m_callsign; }
+
+    ASYNC_MSG_MEMBERS(m_tg, m_callsign);
+
+  private:
+    uint32_t    m_tg;
+    std::string m_callsign;
+}; /* MsgTrunkTalkerStop */
+
+
+/**
+@brief   Audio sent over a trunk
+@author  agent
+@date    2026-10-18
+
+This message carry the encoded audio from the current local talker on a talk
+group to a trunked reflector. The audio data is the same as in a MsgUdpAudio
+message, encoded using the codec given in the preceding MsgTrunkTalkerStart.
+*/
+class MsgTrunkAudio : public ReflectorMsgBase<203>
+{
+  public:
+    MsgTrunkAudio(uint32_t tg=0,
+                  const std::vector<uint8_t>& audio_data=std::vector<uint8_t>())
+      : m_tg(tg), m_audio_data(audio_data) {}
+
+    uint32_t tg(void) const { return m_tg; }
+    const std::vector<uint8_t>& audioData(void) const { return m_audio_data; }
+
+    ASYNC_MSG_MEMBERS(m_tg, m_audio_data);
+
+  private:
+    uint32_t              m_tg;
+    std::vector<uint8_t>  m_audio_data;
+}; /* MsgTrunkAudio */
+
+
 /***************************** UDP Messages *****************************/
 
 /**
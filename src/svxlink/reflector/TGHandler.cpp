@@ -35,6 +35,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <algorithm>
 #include <sstream>
 #include <regex>
+#include <vector>
 
 
 /****************************************************************************
@@ -153,6 +154,7 @@ bool TGHandler::switchTo(ReflectorClient *client, uint32_t tg)
   {
     if (!allowTgSelection(client, tg))
     {
+      clientsUpdated();
       return false;
     }
     IdMap::iterator id_map_it = m_id_map.find(tg);
@@ -178,6 +180,8 @@ bool TGHandler::switchTo(ReflectorClient *client, uint32_t tg)
 
   //printTGStatus();
 
+  clientsUpdated();
+
   return true;
 } /* TGHandler::switchTo */
 
@@ -194,6 +198,7 @@ void TGHandler::removeClient(ReflectorClient* client)
     }
     removeClientP(tg_info, client);
     //printTGStatus();
+    clientsUpdated();
   }
 } /* TGHandler::removeClient */
 
@@ -306,6 +311,85 @@ bool TGHandler::isRestricted(uint32_t tg) const
 } /* TGHandler::isRestricted */
 
 
+std::set<uint32_t> TGHandler::activeTGs(void) const
+{
+  std::set<uint32_t> tgs;
+  for (const auto& item : m_id_map)
+  {
+    tgs.insert(tgs.end(), item.first);
+  }
+  return tgs;
+} /* TGHandler::activeTGs */
+
+
+void TGHandler::setTrunkTalkerForTG(uint32_t tg, const std::string& peer,
+                                    const std::string& callsign)
+{
+  TrunkTalkerMap::iterator it = m_trunk_talkers.find(tg);
+  if (callsign.empty())
+  {
+    if ((it == m_trunk_talkers.end()) || (it->second.peer != peer))
+    {
+      return;
+    }
+    std::string old_callsign(it->second.callsign);
+    m_trunk_talkers.erase(it);
+    trunkTalkerUpdated(tg, old_callsign, "");
+    return;
+  }
+
+  std::string old_callsign;
+  if (it != m_trunk_talkers.end())
+  {
+    TrunkTalker& talker = it->second;
+    if ((talker.peer == peer) && (talker.callsign == callsign))
+    {
+      gettimeofday(&talker.last_talker_timestamp, NULL);
+      return;
+    }
+    old_callsign = talker.callsign;
+  }
+  TrunkTalker& talker = m_trunk_talkers[tg];
+  talker.peer = peer;
+  talker.callsign = callsign;
+  gettimeofday(&talker.last_talker_timestamp, NULL);
+  trunkTalkerUpdated(tg, old_callsign, callsign);
+} /* TGHandler::setTrunkTalkerForTG */
+
+
+const std::string& TGHandler::trunkTalkerForTG(uint32_t tg) const
+{
+  static const std::string empty;
+  TrunkTalkerMap::const_iterator it = m_trunk_talkers.find(tg);
+  return (it != m_trunk_talkers.end()) ? it->second.callsign : empty;
+} /* TGHandler::trunkTalkerForTG */
+
+
+const std::string& TGHandler::trunkPeerForTG(uint32_t tg) const
+{
+  static const std::string empty;
+  TrunkTalkerMap::const_iterator it = m_trunk_talkers.find(tg);
+  return (it != m_trunk_talkers.end()) ? it->second.peer : empty;
+} /* TGHandler::trunkPeerForTG */
+
+
+void TGHandler::clearTrunkTalkers(const std::string& peer)
+{
+  std::vector<uint32_t> tgs;
+  for (const auto& item : m_trunk_talkers)
+  {
+    if (item.second.peer == peer)
+    {
+      tgs.push_back(item.first);
+    }
+  }
+  for (uint32_t tg : tgs)
+  {
+    setTrunkTalkerForTG(tg, peer, "");
+  }
+} /* TGHandler::clearTrunkTalkers */
+
+
 /****************************************************************************
  *
  * Protected member functions
@@ -356,6 +440,25 @@ void TGHandler::checkTimers(Async::Timer *t)
     //  tg_info->auto_qsy_time = time(NULL) + tg_info->auto_qsy_after_s;
     //}
   }
+
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  std::vector<TrunkTalkerMap::value_type> timed_out;
+  for (const auto& item : m_trunk_talkers)
+  {
+    struct timeval diff;
+    timersub(&now, &item.second.last_talker_timestamp, &diff);
+    if (diff.tv_sec > TALKER_AUDIO_TIMEOUT)
+    {
+      timed_out.push_back(item);
+    }
+  }
+  for (const auto& item : timed_out)
+  {
+    cout << item.second.callsign << ": Trunk talker audio timeout on TG #"
+         << item.first << endl;
+    setTrunkTalkerForTG(item.first, item.second.peer, "");
+  }
 } /* TGHandler::checkTimers */
 
 
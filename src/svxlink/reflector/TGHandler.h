@@ -36,6 +36,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <map>
 #include <set>
+#include <string>
 #include <sigc++/sigc++.h>
 #include <sys/time.h>
 
@@ -164,11 +165,63 @@ class TGHandler : public sigc::trackable
 
     bool isRestricted(uint32_t tg) const;
 
+    /**
+     * @brief   Get all talk groups that have local clients
+     * @return  Returns the set of active talk groups
+     */
+    std::set<uint32_t> activeTGs(void) const;
+
+    /**
+     * @brief   Set the talker on a talk group that is located on a trunk
+     * @param   tg The talk group id
+     * @param   peer The id of the trunked reflector where the talker is
+     * @param   callsign The callsign of the talker, empty to clear
+     *
+     * A trunk talker is only cleared if it was set by the same peer. Setting
+     * the same talker again just update the audio timestamp.
+     */
+    void setTrunkTalkerForTG(uint32_t tg, const std::string& peer,
+                             const std::string& callsign);
+
+    /**
+     * @brief   Get the callsign of the trunk talker on a talk group
+     * @param   tg The talk group id
+     * @return  Returns the callsign or an empty string if there is none
+     */
+    const std::string& trunkTalkerForTG(uint32_t tg) const;
+
+    /**
+     * @brief   Get the peer id for the trunk talker on a talk group
+     * @param   tg The talk group id
+     * @return  Returns the peer id or an empty string if there is no talker
+     */
+    const std::string& trunkPeerForTG(uint32_t tg) const;
+
+    /**
+     * @brief   Clear all trunk talkers set by the given peer
+     * @param   peer The id of the trunked reflector
+     */
+    void clearTrunkTalkers(const std::string& peer);
+
     sigc::signal<void, uint32_t,
       ReflectorClient*, ReflectorClient*> talkerUpdated;
 
     sigc::signal<void, uint32_t> requestAutoQsy;
 
+    /**
+     * @brief   A signal emitted when the trunk talker on a talk group change
+     * @param   tg The talk group id
+     * @param   old_callsign The previous trunk talker, empty if none
+     * @param   new_callsign The new trunk talker, empty if none
+     */
+    sigc::signal<void, uint32_t, const std::string&,
+                 const std::string&> trunkTalkerUpdated;
+
+    /**
+     * @brief   A signal emitted when a client has joined or left a talk group
+     */
+    sigc::signal<void> clientsUpdated;
+
   private:
     static const time_t TALKER_AUDIO_TIMEOUT = 3; // Max three seconds gap
 
@@ -189,12 +242,20 @@ class TGHandler : public sigc::trackable
         timerclear(&last_talker_timestamp);
       }
     };
+    struct TrunkTalker
+    {
+      std::string     peer;
+      std::string     callsign;
+      struct timeval  last_talker_timestamp;
+    };
     typedef std::map<uint32_t, TGInfo*>               IdMap;
     typedef std::map<const ReflectorClient*, TGInfo*> ClientMap;
+    typedef std::map<uint32_t, TrunkTalker>           TrunkTalkerMap;
 
     const Async::Config*  m_cfg;
     IdMap                 m_id_map;
     ClientMap             m_client_map;
+    TrunkTalkerMap        m_trunk_talkers;
     Async::Timer          m_timeout_timer;
     unsigned              m_sql_timeout;
     unsigned              m_sql_timeout_blocktime;
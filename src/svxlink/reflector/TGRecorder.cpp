@@ -0,0 +1,404 @@
+/**
+@file   TGRecorder.cpp
+@brief  Record talk group audio to Ogg/Opus files without transcoding
+@author agent
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncConfig.h>
+#include <AsyncAudioContainer.h>
+#include <AsyncAudioDecoder.h>
+#include <common.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "TGRecorder.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+TGRecorder::TGRecorder(void)
+  : m_cfg(0), m_stop(false), m_queue_full(false)
+{
+} /* TGRecorder::TGRecorder */
+
+
+TGRecorder::~TGRecorder(void)
+{
+  if (m_thread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lk(m_mutex);
+      m_stop = true;
+    }
+    m_cond.notify_one();
+    m_thread.join();
+  }
+} /* TGRecorder::~TGRecorder */
+
+
+bool TGRecorder::initialize(const Async::Config& cfg)
+{
+  m_cfg = &cfg;
+
+  if (!cfg.getValue("GLOBAL", "RECORD_DIR", m_dir) || m_dir.empty())
+  {
+    cerr << "*** ERROR: Config variable GLOBAL/RECORD_DIR not set" << endl;
+    return false;
+  }
+
+  struct stat st;
+  if ((stat(m_dir.c_str(), &st) != 0) || !S_ISDIR(st.st_mode))
+  {
+    cerr << "*** ERROR: The talk group recorder directory \"" << m_dir
+         << "\" does not exist" << endl;
+    return false;
+  }
+
+    // The audio is stored as received so the reflector codec must be Opus
+  std::vector<std::string> codecs;
+  std::string codecs_str;
+  if (cfg.getValue("GLOBAL", "CODECS", codecs_str))
+  {
+    SvxLink::splitStr(codecs, codecs_str, ",");
+  }
+  if ((!codecs.empty() && (codecs.front() != "OPUS")) ||
+      (codecs.empty() && !AudioDecoder::isAvailable("OPUS")))
+  {
+    cerr << "*** ERROR: The talk group recorder require the OPUS codec"
+         << endl;
+    return false;
+  }
+
+  AudioContainer *container = createAudioContainer("opus");
+  if (container == nullptr)
+  {
+    cerr << "*** ERROR: Ogg/Opus support not available. The talk group "
+            "recorder cannot be used." << endl;
+    return false;
+  }
+  delete container;
+
+  m_thread = std::thread(&TGRecorder::threadFunc, this);
+
+  return true;
+} /* TGRecorder::initialize */
+
+
+bool TGRecorder::isRecorded(uint32_t tg)
+{
+  if (tg == 0)
+  {
+    return false;
+  }
+  auto it = m_tg_recorded.find(tg);
+  if (it == m_tg_recorded.end())
+  {
+    std::ostringstream ss;
+    ss << "TG#" << tg;
+    bool record = false;
+    m_cfg->getValue(ss.str(), "RECORD", record);
+    it = m_tg_recorded.emplace(tg, record).first;
+  }
+  return it->second;
+} /* TGRecorder::isRecorded */
+
+
+void TGRecorder::talkerStart(uint32_t tg, const std::string& callsign)
+{
+  postJob(Job{Job::START, tg, callsign, {}});
+} /* TGRecorder::talkerStart */
+
+
+void TGRecorder::talkerStop(uint32_t tg)
+{
+  postJob(Job{Job::STOP, tg, "", {}});
+} /* TGRecorder::talkerStop */
+
+
+void TGRecorder::writeAudio(uint32_t tg, const std::vector<uint8_t>& data)
+{
+  postJob(Job{Job::AUDIO, tg, "", data});
+} /* TGRecorder::writeAudio */
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void TGRecorder::postJob(Job&& job)
+{
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+      // Start and stop jobs are always queued so that files get closed
+    if ((job.type == Job::AUDIO) && (m_jobs.size() >= MAX_QUEUED_JOBS))
+    {
+      if (!m_queue_full)
+      {
+        cerr << "*** WARNING: The talk group recorder queue is full. "
+                "Dropping audio." << endl;
+        m_queue_full = true;
+      }
+      return;
+    }
+    m_queue_full = false;
+    m_jobs.push_back(std::move(job));
+  }
+  m_cond.notify_one();
+} /* TGRecorder::postJob */
+
+
+void TGRecorder::threadFunc(void)
+{
+  for (;;)
+  {
+    std::deque<Job> jobs;
+    {
+      std::unique_lock<std::mutex> lk(m_mutex);
+      m_cond.wait(lk, [this]{ return m_stop || !m_jobs.empty(); });
+      if (m_jobs.empty())
+      {
+        break;
+      }
+      jobs.swap(m_jobs);
+    }
+    for (auto& job : jobs)
+    {
+      handleJob(job);
+    }
+  }
+
+  while (!m_recordings.empty())
+  {
+    closeFile(m_recordings.begin()->first);
+  }
+} /* TGRecorder::threadFunc */
+
+
+void TGRecorder::handleJob(Job& job)
+{
+  switch (job.type)
+  {
+    case Job::START:
+      closeFile(job.tg);
+      openFile(job.tg, job.callsign);
+      break;
+
+    case Job::AUDIO:
+    {
+      auto it = m_recordings.find(job.tg);
+      if ((it == m_recordings.end()) || it->second.failed)
+      {
+        break;
+      }
+      Recording& rec = it->second;
+      if (!job.data.empty() &&
+          !rec.container->writeEncodedPacket(job.data.data(),
+                                             job.data.size()))
+      {
+        cerr << "*** WARNING: Could not add audio packet to talk group "
+                "recording \"" << rec.tmp_path << "\"" << endl;
+      }
+      break;
+    }
+
+    case Job::STOP:
+      closeFile(job.tg);
+      break;
+  }
+} /* TGRecorder::handleJob */
+
+
+void TGRecorder::openFile(uint32_t tg, const std::string& callsign)
+{
+  std::string name(callsign);
+  std::replace(name.begin(), name.end(), '/', '-');
+
+  time_t now = time(NULL);
+  struct tm tm;
+  localtime_r(&now, &tm);
+  char timestamp[64];
+  strftime(timestamp, sizeof(timestamp), "%Y-%m-%d_%H%M%S", &tm);
+
+  std::ostringstream ss;
+  ss << "tgrec_" << tg << "_" << name << "_" << timestamp << ".opus";
+
+  Recording& rec = m_recordings[tg];
+  rec.path = m_dir + "/" + ss.str();
+  rec.tmp_path = m_dir + "/." + ss.str();
+  rec.container = createAudioContainer("opus");
+  rec.file = fopen(rec.tmp_path.c_str(), "w");
+  if ((rec.container == nullptr) || (rec.file == nullptr))
+  {
+    cerr << "*** ERROR: Could not open talk group recording \""
+         << rec.tmp_path << "\": " << strerror(errno) << endl;
+    rec.failed = true;
+    return;
+  }
+  rec.container->writeBlock.connect(
+      sigc::bind<0>(sigc::mem_fun(*this, &TGRecorder::writeBlock), &rec));
+  writeBlock(&rec, rec.container->header(), rec.container->headerSize());
+} /* TGRecorder::openFile */
+
+
+void TGRecorder::closeFile(uint32_t tg)
+{
+  auto it = m_recordings.find(tg);
+  if (it == m_recordings.end())
+  {
+    return;
+  }
+  Recording& rec = it->second;
+  if (rec.container != nullptr)
+  {
+    if (rec.file != nullptr)
+    {
+      rec.container->endStream();
+    }
+    delete rec.container;
+  }
+  if (rec.file != nullptr)
+  {
+    if (fclose(rec.file) != 0)
+    {
+      rec.failed = true;
+    }
+    if (rec.failed)
+    {
+      unlink(rec.tmp_path.c_str());
+    }
+    else if (rename(rec.tmp_path.c_str(), rec.path.c_str()) != 0)
+    {
+      cerr << "*** ERROR: Could not rename talk group recording \""
+           << rec.tmp_path << "\" to \"" << rec.path << "\": "
+           << strerror(errno) << endl;
+    }
+  }
+  m_recordings.erase(it);
+} /* TGRecorder::closeFile */
+
+
+void TGRecorder::writeBlock(Recording *rec, const char *buf, size_t len)
+{
+  if (rec->failed || (len == 0))
+  {
+    return;
+  }
+  if (fwrite(buf, 1, len, rec->file) != len)
+  {
+    cerr << "*** ERROR: Could not write to talk group recording \""
+         << rec->tmp_path << "\": " << strerror(errno) << endl;
+    rec->failed = true;
+  }
+} /* TGRecorder::writeBlock */
+
+
+
+/*
+ * This file has not been truncated
+ */
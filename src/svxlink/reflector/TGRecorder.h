@@ -0,0 +1,241 @@
+/**
+@file   TGRecorder.h
+@brief  Record talk group audio to Ogg/Opus files without transcoding
+@author agent
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef TG_RECORDER_INCLUDED
+#define TG_RECORDER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <cstdio>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+  class Config;
+  class AudioContainer;
+};
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  Record talk group audio to Ogg/Opus files without transcoding
+@author agent
+@date   2026-10-18
+
+This class is used by the reflector to archive the traffic on selected talk
+groups. Since the audio received from the clients already is encoded using
+Opus, the packets are written straight into an Ogg/Opus container without
+being decoded and encoded again. One file is written for each talker
+transmission.
+
+All file handling is done in a background thread. The functions called from
+the main thread only put a job on a queue so that the audio relaying is never
+blocked on disk access. If the disk cannot keep up, audio is dropped when the
+queue is full.
+*/
+class TGRecorder
+{
+  public:
+    /**
+     * @brief   Default constructor
+     */
+    TGRecorder(void);
+
+    /**
+     * @brief   Destructor
+     *
+     * Open files are closed and the background thread is stopped.
+     */
+    ~TGRecorder(void);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    TGRecorder(const TGRecorder&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    TGRecorder& operator=(const TGRecorder&) = delete;
+
+    /**
+     * @brief   Initialize the recorder
+     * @param   cfg The reflector configuration
+     * @return  Returns \em true on success or else \em false
+     */
+    bool initialize(const Async::Config& cfg);
+
+    /**
+     * @brief   Check if the given talk group should be recorded
+     * @param   tg The talk group id
+     * @return  Returns \em true if the talk group is recorded
+     */
+    bool isRecorded(uint32_t tg);
+
+    /**
+     * @brief   Indicate that a talker have started on a talk group
+     * @param   tg The talk group id
+     * @param   callsign The callsign of the talker
+     */
+    void talkerStart(uint32_t tg, const std::string& callsign);
+
+    /**
+     * @brief   Indicate that the talker on a talk group have stopped
+     * @param   tg The talk group id
+     */
+    void talkerStop(uint32_t tg);
+
+    /**
+     * @brief   Write a received audio packet
+     * @param   tg The talk group id
+     * @param   data The Opus encoded audio packet
+     */
+    void writeAudio(uint32_t tg, const std::vector<uint8_t>& data);
+
+  private:
+    static const size_t MAX_QUEUED_JOBS = 5000;
+
+    struct Job
+    {
+      enum Type { START, AUDIO, STOP };
+      Type                  type;
+      uint32_t              tg;
+      std::string           callsign;
+      std::vector<uint8_t>  data;
+    };
+
+    struct Recording
+    {
+      FILE*                   file      = nullptr;
+      Async::AudioContainer*  container = nullptr;
+      std::string             tmp_path;
+      std::string             path;
+      bool                    failed    = false;
+    };
+
+    const Async::Config*            m_cfg;
+    std::string                     m_dir;
+    std::map<uint32_t, bool>        m_tg_recorded;
+    std::thread                     m_thread;
+    std::mutex                      m_mutex;
+    std::condition_variable         m_cond;
+    std::deque<Job>                 m_jobs;
+    bool                            m_stop;
+    bool                            m_queue_full;
+    std::map<uint32_t, Recording>   m_recordings;
+
+    void postJob(Job&& job);
+    void threadFunc(void);
+    void handleJob(Job& job);
+    void openFile(uint32_t tg, const std::string& callsign);
+    void closeFile(uint32_t tg);
+    void writeBlock(Recording *rec, const char *buf, size_t len);
+
+};  /* class TGRecorder */
+
+
+//} /* namespace */
+
+#endif /* TG_RECORDER_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
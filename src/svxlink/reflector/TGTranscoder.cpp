@@ -0,0 +1,470 @@
+/**
+@file   TGTranscoder.cpp
+@brief  Transcode talk group audio for clients using another codec
+@author agent
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <iostream>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncAudioSink.h>
+#include <AsyncAudioDecoder.h>
+#include <AsyncAudioEncoder.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "TGTranscoder.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+  /*
+   * The codecs used for one talk group. Only used by the background thread.
+   * The decoded audio is written to one encoder for each destination codec.
+   */
+class TGTranscoder::Transcoder : public AudioSink
+{
+  public:
+    Transcoder(TGTranscoder *owner, uint32_t tg)
+      : m_owner(owner), m_tg(tg), m_src_client_id(NO_CLIENT), m_dec(0)
+    {
+    }
+
+    ~Transcoder(void)
+    {
+      delete m_dec;
+      m_dec = 0;
+      for (auto& item : m_encoders)
+      {
+        delete item.second;
+      }
+      m_encoders.clear();
+    }
+
+    Transcoder(const Transcoder&) = delete;
+    Transcoder& operator=(const Transcoder&) = delete;
+
+    void setSourceClient(uint32_t client_id)
+    {
+      m_src_client_id = client_id;
+    }
+
+    bool setSourceCodec(const std::string& codec)
+    {
+      if ((m_dec != 0) && (m_src_codec == codec))
+      {
+        return true;
+      }
+      delete m_dec;
+      m_src_codec = codec;
+      m_dec = AudioDecoder::create(codec);
+      if (m_dec == 0)
+      {
+        return false;
+      }
+      m_dec->registerSink(this);
+      return true;
+    }
+
+    bool addDestinationCodec(const std::string& codec)
+    {
+      if (m_encoders.count(codec) > 0)
+      {
+        return true;
+      }
+      AudioEncoder *enc = AudioEncoder::create(codec);
+      if (enc == 0)
+      {
+        return false;
+      }
+      enc->writeEncodedSamples.connect(
+          [this, codec](const void *buf, int size)
+          {
+            m_owner->postResult(m_tg, m_src_client_id, m_src_codec, codec,
+                                buf, size);
+          });
+      enc->flushEncodedSamples.connect(
+          [enc]() { enc->allEncodedSamplesFlushed(); });
+      m_encoders[codec] = enc;
+      return true;
+    }
+
+    void writeEncodedSamples(std::vector<uint8_t>& data)
+    {
+      if (m_dec != 0)
+      {
+        m_dec->writeEncodedSamples(data.data(), data.size());
+      }
+    }
+
+    void flushEncodedSamples(void)
+    {
+      if (m_dec != 0)
+      {
+        m_dec->flushEncodedSamples();
+      }
+      for (auto& item : m_encoders)
+      {
+        m_owner->postResult(m_tg, m_src_client_id, m_src_codec, item.first,
+                            0, 0);
+      }
+    }
+
+    virtual int writeSamples(const float *samples, int count)
+    {
+      for (auto& item : m_encoders)
+      {
+        item.second->writeSamples(samples, count);
+      }
+      return count;
+    }
+
+    virtual void flushSamples(void)
+    {
+      for (auto& item : m_encoders)
+      {
+        item.second->flushSamples();
+      }
+      sourceAllSamplesFlushed();
+    }
+
+  private:
+    TGTranscoder*                         m_owner;
+    uint32_t                              m_tg;
+    uint32_t                              m_src_client_id;
+    std::string                           m_src_codec;
+    AudioDecoder*                         m_dec;
+    std::map<std::string, AudioEncoder*>  m_encoders;
+
+};  /* class TGTranscoder::Transcoder */
+
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+TGTranscoder::TGTranscoder(void)
+  : m_stop(false), m_queue_full(false), m_results_full(false),
+    m_results(RESULT_CHANNEL_SIZE), m_results_queued(0)
+{
+  if (!m_results.initOk())
+  {
+    cerr << "*** ERROR: Could not create the transcoder result channel"
+         << endl;
+    return;
+  }
+  m_results.messagesAvailable.connect(
+      sigc::mem_fun(*this, &TGTranscoder::onResultsAvailable));
+  m_thread = std::thread(&TGTranscoder::threadFunc, this);
+} /* TGTranscoder::TGTranscoder */
+
+
+TGTranscoder::~TGTranscoder(void)
+{
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_stop = true;
+    m_jobs.clear();
+  }
+  m_cond.notify_one();
+  if (m_thread.joinable())
+  {
+    m_thread.join();
+  }
+} /* TGTranscoder::~TGTranscoder */
+
+
+void TGTranscoder::writeAudio(uint32_t tg, uint32_t src_client_id,
+                              const std::string& src_codec,
+                              const CodecSet& dst_codecs,
+                              const std::vector<uint8_t>& data)
+{
+  if (dst_codecs.empty())
+  {
+    return;
+  }
+  postJob(Job{Job::AUDIO, tg, src_client_id, src_codec, dst_codecs, data});
+} /* TGTranscoder::writeAudio */
+
+
+void TGTranscoder::flush(uint32_t tg)
+{
+  postJob(Job{Job::FLUSH, tg, NO_CLIENT, "", CodecSet(),
+              std::vector<uint8_t>()});
+} /* TGTranscoder::flush */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void TGTranscoder::postJob(Job&& job)
+{
+  if (!initOk())
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+      // Flush jobs are always queued so that the codecs get released
+    if ((job.type == Job::AUDIO) && (m_jobs.size() >= MAX_QUEUED_JOBS))
+    {
+      if (!m_queue_full)
+      {
+        cerr << "*** WARNING: The transcoder queue is full. "
+                "Dropping audio." << endl;
+        m_queue_full = true;
+      }
+      return;
+    }
+    m_queue_full = false;
+    m_jobs.push_back(std::move(job));
+  }
+  m_cond.notify_one();
+} /* TGTranscoder::postJob */
+
+
+void TGTranscoder::threadFunc(void)
+{
+  for (;;)
+  {
+    std::deque<Job> jobs;
+    {
+      std::unique_lock<std::mutex> lk(m_mutex);
+      m_cond.wait(lk, [this]{ return m_stop || !m_jobs.empty(); });
+      if (m_stop)
+      {
+        break;
+      }
+      jobs.swap(m_jobs);
+    }
+    for (auto& job : jobs)
+    {
+      handleJob(job);
+    }
+  }
+
+  m_transcoders.clear();
+} /* TGTranscoder::threadFunc */
+
+
+void TGTranscoder::handleJob(Job& job)
+{
+  switch (job.type)
+  {
+    case Job::AUDIO:
+    {
+      std::unique_ptr<Transcoder>& tc = m_transcoders[job.tg];
+      if (tc == nullptr)
+      {
+        tc.reset(new Transcoder(this, job.tg));
+      }
+      if (!tc->setSourceCodec(job.src_codec))
+      {
+        cerr << "*** WARNING: Could not create a " << job.src_codec
+             << " decoder for transcoding TG #" << job.tg << endl;
+        m_transcoders.erase(job.tg);
+        break;
+      }
+      for (const auto& codec : job.dst_codecs)
+      {
+        if (!tc->addDestinationCodec(codec))
+        {
+          cerr << "*** WARNING: Could not create a " << codec
+               << " encoder for transcoding TG #" << job.tg << endl;
+        }
+      }
+      tc->setSourceClient(job.src_client_id);
+      tc->writeEncodedSamples(job.data);
+      break;
+    }
+
+    case Job::FLUSH:
+    {
+      auto it = m_transcoders.find(job.tg);
+      if (it != m_transcoders.end())
+      {
+        it->second->flushEncodedSamples();
+        m_transcoders.erase(it);
+      }
+      break;
+    }
+  }
+} /* TGTranscoder::handleJob */
+
+
+void TGTranscoder::postResult(uint32_t tg, uint32_t src_client_id,
+                              const std::string& src_codec,
+                              const std::string& codec,
+                              const void *buf, int size)
+{
+  const uint8_t *ptr = reinterpret_cast<const uint8_t*>(buf);
+  ResultPtr result(new Result{tg, src_client_id, src_codec, codec,
+                              std::vector<uint8_t>(ptr, ptr+size)});
+  if (size == 0)
+  {
+      // A flush result must never be lost. It normally fits in the reserved
+      // part of the channel. If not, it is handed over through a list.
+    ++m_results_queued;
+    if (!m_results.post(std::move(result)))
+    {
+      --m_results_queued;
+      {
+        std::lock_guard<std::mutex> lk(m_overflow_mutex);
+        m_overflow.push_back(std::move(result));
+      }
+      m_results.notify();
+    }
+    return;
+  }
+
+  bool posted = false;
+  if (m_results_queued < RESULT_CHANNEL_SIZE - RESERVED_RESULTS)
+  {
+    ++m_results_queued;
+    posted = m_results.post(std::move(result));
+    if (!posted)
+    {
+      --m_results_queued;
+    }
+  }
+  if (!posted)
+  {
+    if (!m_results_full)
+    {
+      cerr << "*** WARNING: The transcoder result queue is full. "
+              "Dropping audio." << endl;
+      m_results_full = true;
+    }
+    return;
+  }
+  m_results_full = false;
+} /* TGTranscoder::postResult */
+
+
+void TGTranscoder::onResultsAvailable(void)
+{
+  std::deque<ResultPtr> overflow;
+  {
+    std::lock_guard<std::mutex> lk(m_overflow_mutex);
+    overflow.swap(m_overflow);
+  }
+
+  ResultPtr result;
+  while (m_results.receive(result))
+  {
+    --m_results_queued;
+    if (result->data.empty())
+    {
+      audioFlushed(result->tg, result->src_client_id, result->codec);
+    }
+    else
+    {
+      audioTranscoded(result->tg, result->src_client_id, result->src_codec,
+                      result->codec, result->data);
+    }
+  }
+
+    // The overflow list is taken before the channel is emptied so that all
+    // audio posted before a flush result has been delivered
+  for (const auto& flushed : overflow)
+  {
+    audioFlushed(flushed->tg, flushed->src_client_id, flushed->codec);
+  }
+} /* TGTranscoder::onResultsAvailable */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,289 @@
+/**
+@file   TGTranscoder.h
+@brief  Transcode talk group audio for clients using another codec
+@author agent
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef TG_TRANSCODER_INCLUDED
+#define TG_TRANSCODER_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <deque>
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncThreadChannel.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  Transcode talk group audio for clients using another codec
+@author agent
+@date   2026-10-18
+
+This class is used by the reflector when clients on the same talk group use
+different codecs. The audio from the talker is decoded once and then encoded
+once for each codec that is used by the receiving clients. The encoded packets
+are shared by all clients using the same codec. Decoders and encoders are
+created when first needed and are kept until the talker stop.
+
+All decoding and encoding is done in a background thread so that the
+relaying of audio is never blocked by the codecs. The transcoded packets are
+handed back to the main thread where the audioTranscoded signal is emitted.
+If the background thread cannot keep up, audio is dropped.
+*/
+class TGTranscoder : public sigc::trackable
+{
+  public:
+    typedef std::set<std::string> CodecSet;
+
+    /**
+     * @brief   The source client id used for audio not coming from a client
+     */
+    static const uint32_t NO_CLIENT = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief   Default constructor
+     *
+     * The background thread is started by the constructor.
+     */
+    TGTranscoder(void);
+
+    /**
+     * @brief   Destructor
+     *
+     * The background thread is stopped and all queued audio is thrown away.
+     */
+    ~TGTranscoder(void);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    TGTranscoder(const TGTranscoder&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    TGTranscoder& operator=(const TGTranscoder&) = delete;
+
+    /**
+     * @brief   Check if the initialization was successful
+     * @return  Returns \em true if the background thread is running
+     */
+    bool initOk(void) const { return m_thread.joinable(); }
+
+    /**
+     * @brief   Transcode an audio packet
+     * @param   tg The talk group id
+     * @param   src_client_id The id of the talker or NO_CLIENT
+     * @param   src_codec The codec used to encode the packet
+     * @param   dst_codecs The codecs to transcode the packet to
+     * @param   data The encoded audio packet
+     *
+     * The source client id and codec are handed back with the transcoded
+     * audio since the talker may have changed when the result is delivered.
+     */
+    void writeAudio(uint32_t tg, uint32_t src_client_id,
+                    const std::string& src_codec, const CodecSet& dst_codecs,
+                    const std::vector<uint8_t>& data);
+
+    /**
+     * @brief   Indicate that the talker on a talk group have stopped
+     * @param   tg The talk group id
+     *
+     * Buffered audio is flushed and the codecs used for the talk group are
+     * released. The audioFlushed signal is emitted for each codec that was
+     * used when all transcoded audio have been delivered.
+     */
+    void flush(uint32_t tg);
+
+    /**
+     * @brief   A signal emitted when a transcoded packet is available
+     * @param   tg The talk group id
+     * @param   src_client_id The source client id given to writeAudio
+     * @param   src_codec The codec the packet was transcoded from
+     * @param   codec The codec used to encode the packet
+     * @param   data The encoded audio packet
+     *
+     * This signal is emitted in the main thread.
+     */
+    sigc::signal<void, uint32_t, uint32_t, const std::string&,
+                 const std::string&,
+                 const std::vector<uint8_t>&> audioTranscoded;
+
+    /**
+     * @brief   A signal emitted when all transcoded audio have been delivered
+     * @param   tg The talk group id
+     * @param   src_client_id The source client id of the last audio packet
+     * @param   codec The codec that was used
+     *
+     * This signal is emitted in the main thread after a call to flush.
+     */
+    sigc::signal<void, uint32_t, uint32_t,
+                 const std::string&> audioFlushed;
+
+  private:
+    static const size_t MAX_QUEUED_JOBS     = 1000;
+    static const size_t RESULT_CHANNEL_SIZE = 1024;
+    static const size_t RESERVED_RESULTS    = 256;
+
+    struct Job
+    {
+      enum Type { AUDIO, FLUSH };
+      Type                  type;
+      uint32_t              tg;
+      uint32_t              src_client_id;
+      std::string           src_codec;
+      CodecSet              dst_codecs;
+      std::vector<uint8_t>  data;
+    };
+
+      // A result without data mark that a talk group has been flushed.
+      // Part of the result channel is reserved for these so that they are
+      // not lost when audio is dropped.
+    struct Result
+    {
+      uint32_t              tg;
+      uint32_t              src_client_id;
+      std::string           src_codec;
+      std::string           codec;
+      std::vector<uint8_t>  data;
+    };
+
+    class Transcoder;
+    typedef std::unique_ptr<Result>                 ResultPtr;
+    typedef std::map<uint32_t,
+                     std::unique_ptr<Transcoder>>   TranscoderMap;
+
+    std::thread                       m_thread;
+    std::mutex                        m_mutex;
+    std::condition_variable           m_cond;
+    std::deque<Job>                   m_jobs;
+    bool                              m_stop;
+    bool                              m_queue_full;
+    bool                              m_results_full;
+    Async::ThreadChannel<ResultPtr>   m_results;
+    std::atomic<size_t>               m_results_queued;
+    std::mutex                        m_overflow_mutex;
+    std::deque<ResultPtr>             m_overflow;
+    TranscoderMap                     m_transcoders;
+
+    void postJob(Job&& job);
+    void threadFunc(void);
+    void handleJob(Job& job);
+    void postResult(uint32_t tg, uint32_t src_client_id,
+                    const std::string& src_codec, const std::string& codec,
+                    const void *buf, int size);
+    void onResultsAvailable(void);
+
+};  /* class TGTranscoder */
+
+
+//} /* namespace */
+
+#endif /* TG_TRANSCODER_INCLUDED */
+
+
+
+/*
+ * This file has not been truncated
+ */
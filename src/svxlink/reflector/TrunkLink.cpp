@@ -0,0 +1,515 @@
+/**
+@file   TrunkLink.cpp
+@brief  A link to another reflector for trunking talk groups
+@author agent
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sstream>
+#include <iostream>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncConfig.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "TrunkLink.h"
+#include "ReflectorMsg.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+bool TrunkLink::sendMsg(Async::FramedTcpConnection *con,
+                        const ReflectorMsg& msg)
+{
+  ReflectorMsg header(msg.type());
+  ostringstream ss;
+  if (!header.pack(ss) || !msg.pack(ss))
+  {
+    cerr << "*** ERROR: Failed to pack trunk TCP message\n";
+    return false;
+  }
+  return con->write(ss.str().data(), ss.str().size()) != -1;
+} /* TrunkLink::sendMsg */
+
+
+TrunkLink::TrunkLink(void)
+  : m_out_state(STATE_DISCONNECTED), m_in_con(0),
+    m_reconnect_timer(RECONNECT_INTERVAL, Timer::TYPE_ONESHOT, false),
+    m_heartbeat_timer(1000, Timer::TYPE_PERIODIC, false),
+    m_heartbeat_tx_cnt(HEARTBEAT_TX_CNT_RESET),
+    m_heartbeat_rx_cnt(HEARTBEAT_RX_CNT_RESET), m_auth_cnt(AUTH_CNT_RESET)
+{
+  m_out_con.connected.connect(
+      mem_fun(*this, &TrunkLink::onOutConnected));
+  m_out_con.disconnected.connect(
+      mem_fun(*this, &TrunkLink::onOutDisconnected));
+  m_out_con.frameReceived.connect(
+      mem_fun(*this, &TrunkLink::onOutFrameReceived));
+  m_reconnect_timer.expired.connect(
+      sigc::hide(mem_fun(*this, &TrunkLink::reconnect)));
+  m_heartbeat_timer.expired.connect(
+      mem_fun(*this, &TrunkLink::handleHeartbeat));
+} /* TrunkLink::TrunkLink */
+
+
+TrunkLink::~TrunkLink(void)
+{
+  m_in_frame_con.disconnect();
+  m_out_con.disconnect();
+} /* TrunkLink::~TrunkLink */
+
+
+bool TrunkLink::initialize(const Async::Config& cfg,
+                           const std::string& section,
+                           const std::string& local_id)
+{
+  m_section = section;
+  m_local_id = local_id;
+
+  std::string host;
+  if (!cfg.getValue(section, "HOST", host) || host.empty())
+  {
+    cerr << "*** ERROR: " << section << "/HOST not set" << endl;
+    return false;
+  }
+
+  uint16_t port = 5302;
+  cfg.getValue(section, "PORT", port);
+
+  if (!cfg.getValue(section, "PEER_ID", m_peer_id) || m_peer_id.empty())
+  {
+    cerr << "*** ERROR: " << section << "/PEER_ID not set" << endl;
+    return false;
+  }
+  if (m_peer_id == m_local_id)
+  {
+    cerr << "*** ERROR: " << section << "/PEER_ID must not be the same as "
+            "GLOBAL/TRUNK_ID" << endl;
+    return false;
+  }
+
+  if (!cfg.getValue(section, "SECRET", m_secret) || m_secret.empty())
+  {
+    cerr << "*** ERROR: " << section << "/SECRET not set" << endl;
+    return false;
+  }
+
+  m_out_con.setMaxFrameSize(ReflectorMsg::MAX_PREAUTH_FRAME_SIZE);
+  m_out_con.connect(host, port);
+  m_heartbeat_timer.setEnable(true);
+
+  return true;
+} /* TrunkLink::initialize */
+
+
+void TrunkLink::setInboundConnection(Async::FramedTcpConnection *con)
+{
+  FramedTcpConnection *old_con = m_in_con;
+  m_in_frame_con.disconnect();
+  m_in_con = con;
+  m_in_frame_con = m_in_con->frameReceived.connect(
+      mem_fun(*this, &TrunkLink::onInFrameReceived));
+  m_heartbeat_rx_cnt = HEARTBEAT_RX_CNT_RESET;
+  cout << m_section << ": Incoming trunk connection from " << m_peer_id
+       << " at " << con->remoteHost() << ":" << con->remotePort() << endl;
+
+  if (old_con != 0)
+  {
+    old_con->disconnect();
+    old_con->disconnected(old_con, TcpConnection::DR_ORDERED_DISCONNECT);
+  }
+} /* TrunkLink::setInboundConnection */
+
+
+void TrunkLink::inboundDisconnected(void)
+{
+  cout << m_section << ": Incoming trunk connection from " << m_peer_id
+       << " lost" << endl;
+  m_in_frame_con.disconnect();
+  m_in_con = 0;
+  m_peer_tgs.clear();
+  m_peer_talker_codecs.clear();
+  interestUpdated(this);
+  linkDown(this);
+} /* TrunkLink::inboundDisconnected */
+
+
+void TrunkLink::sendTgInterest(const std::set<uint32_t>& tgs)
+{
+  sendOutMsg(MsgTrunkTgInterest(tgs));
+} /* TrunkLink::sendTgInterest */
+
+
+void TrunkLink::sendTalkerStart(uint32_t tg, const std::string& callsign,
+                                const std::string& codec)
+{
+  sendOutMsg(MsgTrunkTalkerStart(tg, callsign, codec));
+} /* TrunkLink::sendTalkerStart */
+
+
+void TrunkLink::sendTalkerStop(uint32_t tg, const std::string& callsign)
+{
+  sendOutMsg(MsgTrunkTalkerStop(tg, callsign));
+} /* TrunkLink::sendTalkerStop */
+
+
+void TrunkLink::sendAudio(uint32_t tg, const std::vector<uint8_t>& data)
+{
+  sendOutMsg(MsgTrunkAudio(tg, data));
+} /* TrunkLink::sendAudio */
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void TrunkLink::sendOutMsg(const ReflectorMsg& msg)
+{
+  if (!isUp())
+  {
+    return;
+  }
+  m_heartbeat_tx_cnt = HEARTBEAT_TX_CNT_RESET;
+  sendMsg(&m_out_con, msg);
+} /* TrunkLink::sendOutMsg */
+
+
+void TrunkLink::onOutConnected(void)
+{
+  cout << m_section << ": Trunk connection established to "
+       << m_out_con.remoteHost() << ":" << m_out_con.remotePort() << endl;
+  m_out_state = STATE_EXPECT_AUTH_CHALLENGE;
+  m_auth_cnt = AUTH_CNT_RESET;
+} /* TrunkLink::onOutConnected */
+
+
+void TrunkLink::onOutDisconnected(Async::TcpConnection *con,
+                                  Async::TcpConnection::DisconnectReason reason)
+{
+  cout << m_section << ": Trunk connection to " << m_peer_id
+       << " closed: " << TcpConnection::disconnectReasonStr(reason) << endl;
+  m_out_state = STATE_DISCONNECTED;
+  m_peer_challenge.clear();
+  m_out_con.setMaxFrameSize(ReflectorMsg::MAX_PREAUTH_FRAME_SIZE);
+  m_reconnect_timer.setEnable(true);
+} /* TrunkLink::onOutDisconnected */
+
+
+void TrunkLink::onOutFrameReceived(Async::FramedTcpConnection *con,
+                                   std::vector<uint8_t>& data)
+{
+  stringstream ss;
+  ss.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+  ReflectorMsg header;
+  if (!header.unpack(ss))
+  {
+    cerr << "*** ERROR[" << m_section
+         << "]: Unpacking failed for trunk message header" << endl;
+    m_out_con.disconnect();
+    onOutDisconnected(&m_out_con, TcpConnection::DR_PROTOCOL_ERROR);
+    return;
+  }
+
+  switch (header.type())
+  {
+    case MsgHeartbeat::TYPE:
+      break;
+
+    case MsgAuthChallenge::TYPE:
+    {
+      MsgAuthChallenge msg;
+      if ((m_out_state != STATE_EXPECT_AUTH_CHALLENGE) || !msg.unpack(ss) ||
+          (msg.challenge() == 0))
+      {
+        break;
+      }
+      MsgAuthResponse response(m_local_id, m_secret, msg.challenge());
+      sendMsg(&m_out_con, response);
+      m_out_state = STATE_EXPECT_AUTH_OK;
+      return;
+    }
+
+    case MsgAuthOk::TYPE:
+    {
+      if (m_out_state != STATE_EXPECT_AUTH_OK)
+      {
+        break;
+      }
+        // The peer must also prove that it know the secret before anything
+        // is sent to it
+      MsgAuthChallenge challenge;
+      m_peer_challenge.assign(challenge.challenge(),
+          challenge.challenge() + MsgAuthChallenge::CHALLENGE_LEN);
+      sendMsg(&m_out_con, challenge);
+      m_out_state = STATE_EXPECT_PEER_AUTH;
+      return;
+    }
+
+    case MsgAuthResponse::TYPE:
+    {
+      if (m_out_state != STATE_EXPECT_PEER_AUTH)
+      {
+        break;
+      }
+      MsgAuthResponse msg;
+      if (!msg.unpack(ss) || (msg.callsign() != m_peer_id) ||
+          !msg.verify(m_secret, m_peer_challenge.data()))
+      {
+        cerr << "*** ERROR[" << m_section << "]: Trunk peer " << m_peer_id
+             << " failed to authenticate" << endl;
+        m_out_con.disconnect();
+        onOutDisconnected(&m_out_con, TcpConnection::DR_ORDERED_DISCONNECT);
+        return;
+      }
+      m_peer_challenge.clear();
+      cout << m_section << ": Trunk to " << m_peer_id << " is up" << endl;
+      m_out_state = STATE_CONNECTED;
+      m_out_con.setMaxFrameSize(ReflectorMsg::MAX_POSTAUTH_FRAME_SIZE);
+      m_heartbeat_tx_cnt = HEARTBEAT_TX_CNT_RESET;
+      linkUp(this);
+      return;
+    }
+
+    case MsgError::TYPE:
+    {
+      MsgError msg;
+      msg.unpack(ss);
+      cerr << "*** ERROR[" << m_section << "]: Trunk peer " << m_peer_id
+           << " returned error: " << msg.message() << endl;
+      m_out_con.disconnect();
+      onOutDisconnected(&m_out_con, TcpConnection::DR_ORDERED_DISCONNECT);
+      return;
+    }
+
+    default:
+      return;
+  }
+
+  if (m_out_state != STATE_CONNECTED)
+  {
+    cerr << "*** ERROR[" << m_section
+         << "]: Unexpected trunk message type " << header.type()
+         << " received during authentication" << endl;
+    m_out_con.disconnect();
+    onOutDisconnected(&m_out_con, TcpConnection::DR_PROTOCOL_ERROR);
+  }
+} /* TrunkLink::onOutFrameReceived */
+
+
+void TrunkLink::onInFrameReceived(Async::FramedTcpConnection *con,
+                                  std::vector<uint8_t>& data)
+{
+  m_heartbeat_rx_cnt = HEARTBEAT_RX_CNT_RESET;
+
+  stringstream ss;
+  ss.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+  ReflectorMsg header;
+  if (!header.unpack(ss))
+  {
+    cerr << "*** WARNING[" << m_section
+         << "]: Unpacking failed for trunk message header" << endl;
+    return;
+  }
+
+  switch (header.type())
+  {
+    case MsgAuthChallenge::TYPE:
+    {
+      MsgAuthChallenge msg;
+      if (msg.unpack(ss) && (msg.challenge() != 0))
+      {
+        sendMsg(m_in_con, MsgAuthResponse(m_local_id, m_secret,
+                                          msg.challenge()));
+      }
+      break;
+    }
+
+    case MsgTrunkTgInterest::TYPE:
+    {
+      MsgTrunkTgInterest msg;
+      if (msg.unpack(ss))
+      {
+        m_peer_tgs = msg.tgs();
+        interestUpdated(this);
+      }
+      break;
+    }
+
+    case MsgTrunkTalkerStart::TYPE:
+    {
+      MsgTrunkTalkerStart msg;
+      if (msg.unpack(ss))
+      {
+        m_peer_talker_codecs[msg.tg()] = msg.codec();
+        talkerStartReceived(this, msg.tg(), msg.callsign(), msg.codec());
+      }
+      break;
+    }
+
+    case MsgTrunkTalkerStop::TYPE:
+    {
+      MsgTrunkTalkerStop msg;
+      if (msg.unpack(ss))
+      {
+        m_peer_talker_codecs.erase(msg.tg());
+        talkerStopReceived(this, msg.tg(), msg.callsign());
+      }
+      break;
+    }
+
+    case MsgTrunkAudio::TYPE:
+    {
+      MsgTrunkAudio msg;
+      if (msg.unpack(ss))
+      {
+        auto it = m_peer_talker_codecs.find(msg.tg());
+        if (it != m_peer_talker_codecs.end())
+        {
+          audioReceived(this, msg.tg(), it->second, msg.audioData());
+        }
+      }
+      break;
+    }
+
+    default:
+      // Ignore unknown messages to make it easier to extend the protocol
+      break;
+  }
+} /* TrunkLink::onInFrameReceived */
+
+
+void TrunkLink::reconnect(void)
+{
+  if (m_out_con.isIdle())
+  {
+    cout << m_section << ": Reconnecting trunk to " << m_peer_id << endl;
+    m_out_con.connect();
+  }
+} /* TrunkLink::reconnect */
+
+
+void TrunkLink::handleHeartbeat(Async::Timer *t)
+{
+  if (isUp() && (--m_heartbeat_tx_cnt == 0))
+  {
+    sendOutMsg(MsgHeartbeat());
+  }
+
+  if ((m_out_state != STATE_DISCONNECTED) && !isUp() && (--m_auth_cnt == 0))
+  {
+    cerr << "*** ERROR[" << m_section << "]: Trunk authentication timeout"
+         << endl;
+    m_out_con.disconnect();
+    onOutDisconnected(&m_out_con, TcpConnection::DR_ORDERED_DISCONNECT);
+  }
+
+  if ((m_in_con != 0) && (--m_heartbeat_rx_cnt == 0))
+  {
+    cout << m_section << ": Trunk heartbeat timeout" << endl;
+    FramedTcpConnection *con = m_in_con;
+    con->disconnect();
+    con->disconnected(con, TcpConnection::DR_ORDERED_DISCONNECT);
+  }
+} /* TrunkLink::handleHeartbeat */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,364 @@
+/**
+@file   TrunkLink.h
+@brief  A link to another reflector for trunking talk groups
+@author agent
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef TRUNK_LINK_INCLUDED
+#define TRUNK_LINK_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+#include <stdint.h>
+
+#include <set>
+#include <map>
+#include <string>
+#include <vector>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncTcpClient.h>
+#include <AsyncFramedTcpConnection.h>
+#include <AsyncTimer.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+namespace Async
+{
+  class Config;
+};
+
+class ReflectorMsg;
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  A link to another reflector for trunking talk groups
+@author agent
+@date   2026-10-18
+
+This class represent a trunk to another reflector, a peer. Trunked reflectors
+share talk group membership, talker arbitration and audio so that nodes
+connected to different reflectors can talk to each other.
+
+Each side of a trunk connect to the trunk port of the other side. The outgoing
+connection is only used for sending and the incoming connection, accepted by
+the reflector and handed over to this class after authentication, is only used
+for receiving. That way the trunk is completely symmetric and no arbitration is
+needed to decide which connection to use.
+
+Both sides authenticate each other using the shared secret. The peer accepting
+a connection send a challenge that the connecting side must answer. When that
+succeeds, the connecting side send its own challenge that the peer must answer
+on the same connection before anything else is sent to it.
+
+Messages received from a trunk are never forwarded to other trunks so the
+reflectors in a cluster must form a full mesh.
+*/
+class TrunkLink : public sigc::trackable
+{
+  public:
+    /**
+     * @brief   Send a message on a connection
+     * @param   con The connection to send the message on
+     * @param   msg The message to send
+     * @return  Returns \em true on success or else \em false
+     */
+    static bool sendMsg(Async::FramedTcpConnection *con,
+                        const ReflectorMsg& msg);
+
+    /**
+     * @brief   Default constructor
+     */
+    TrunkLink(void);
+
+    /**
+     * @brief   Destructor
+     */
+    ~TrunkLink(void);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    TrunkLink(const TrunkLink&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    TrunkLink& operator=(const TrunkLink&) = delete;
+
+    /**
+     * @brief   Initialize the trunk and connect to the peer
+     * @param   cfg The reflector configuration
+     * @param   section The configuration section for this trunk
+     * @param   local_id The trunk id of this reflector
+     * @return  Returns \em true on success or else \em false
+     */
+    bool initialize(const Async::Config& cfg, const std::string& section,
+                    const std::string& local_id);
+
+    /**
+     * @brief   Get the trunk id of the peer
+     * @return  Returns the peer id
+     */
+    const std::string& peerId(void) const { return m_peer_id; }
+
+    /**
+     * @brief   Get the shared secret used to authenticate the peer
+     * @return  Returns the shared secret
+     */
+    const std::string& secret(void) const { return m_secret; }
+
+    /**
+     * @brief   Check if the outgoing connection is ready for use
+     * @return  Returns \em true if messages can be sent to the peer
+     */
+    bool isUp(void) const { return m_out_state == STATE_CONNECTED; }
+
+    /**
+     * @brief   Hand over an authenticated incoming connection from the peer
+     * @param   con The incoming connection
+     *
+     * If there already is an incoming connection, it will be disconnected.
+     */
+    void setInboundConnection(Async::FramedTcpConnection *con);
+
+    /**
+     * @brief   Get the incoming connection
+     * @return  Returns the incoming connection or 0 if there is none
+     */
+    Async::FramedTcpConnection* inboundConnection(void) const
+    {
+      return m_in_con;
+    }
+
+    /**
+     * @brief   Tell the link that the incoming connection has been closed
+     */
+    void inboundDisconnected(void);
+
+    /**
+     * @brief   Check if the peer want audio for the given talk group
+     * @param   tg The talk group id
+     * @return  Returns \em true if the peer have local clients on the TG
+     */
+    bool wantsTG(uint32_t tg) const { return m_peer_tgs.count(tg) > 0; }
+
+    /**
+     * @brief   Send the set of talk groups that have local clients
+     * @param   tgs The active talk groups
+     */
+    void sendTgInterest(const std::set<uint32_t>& tgs);
+
+    /**
+     * @brief   Send a talker start to the peer
+     * @param   tg The talk group id
+     * @param   callsign The callsign of the local talker
+     * @param   codec The codec used for the audio sent for the talker
+     */
+    void sendTalkerStart(uint32_t tg, const std::string& callsign,
+                         const std::string& codec);
+
+    /**
+     * @brief   Send a talker stop to the peer
+     * @param   tg The talk group id
+     * @param   callsign The callsign of the local talker
+     */
+    void sendTalkerStop(uint32_t tg, const std::string& callsign);
+
+    /**
+     * @brief   Send audio from a local talker to the peer
+     * @param   tg The talk group id
+     * @param   data The encoded audio
+     */
+    void sendAudio(uint32_t tg, const std::vector<uint8_t>& data);
+
+    /**
+     * @brief   A signal emitted when the outgoing connection is ready
+     * @param   link This object
+     *
+     * The current state (talk group interest and local talkers) should be
+     * sent to the peer when this signal is emitted.
+     */
+    sigc::signal<void, TrunkLink*> linkUp;
+
+    /**
+     * @brief   A signal emitted when the incoming connection is lost
+     * @param   link This object
+     */
+    sigc::signal<void, TrunkLink*> linkDown;
+
+    /**
+     * @brief   A signal emitted when the peer talk group interest change
+     * @param   link This object
+     */
+    sigc::signal<void, TrunkLink*> interestUpdated;
+
+    /**
+     * @brief   A signal emitted when a talker start is received
+     * @param   link This object
+     * @param   tg The talk group id
+     * @param   callsign The callsign of the talker
+     * @param   codec The codec used for the audio from the talker
+     */
+    sigc::signal<void, TrunkLink*, uint32_t, const std::string&,
+                 const std::string&> talkerStartReceived;
+
+    /**
+     * @brief   A signal emitted when a talker stop is received
+     * @param   link This object
+     * @param   tg The talk group id
+     * @param   callsign The callsign of the talker
+     */
+    sigc::signal<void, TrunkLink*, uint32_t,
+                 const std::string&> talkerStopReceived;
+
+    /**
+     * @brief   A signal emitted when audio is received
+     * @param   link This object
+     * @param   tg The talk group id
+     * @param   codec The codec used to encode the audio
+     * @param   data The encoded audio
+     *
+     * Audio on a talk group where no talker start has been received is
+     * ignored since the codec is not known.
+     */
+    sigc::signal<void, TrunkLink*, uint32_t, const std::string&,
+                 const std::vector<uint8_t>&> audioReceived;
+
+  private:
+    typedef Async::TcpClient<Async::FramedTcpConnection> FramedTcpClient;
+
+    static const unsigned HEARTBEAT_TX_CNT_RESET  = 10;
+    static const unsigned HEARTBEAT_RX_CNT_RESET  = 15;
+    static const unsigned RECONNECT_INTERVAL      = 10000;
+    static const unsigned AUTH_CNT_RESET          = 15;
+
+    typedef enum
+    {
+      STATE_DISCONNECTED, STATE_EXPECT_AUTH_CHALLENGE, STATE_EXPECT_AUTH_OK,
+      STATE_EXPECT_PEER_AUTH, STATE_CONNECTED
+    } OutState;
+
+    std::string                   m_section;
+    std::string                   m_local_id;
+    std::string                   m_peer_id;
+    std::string                   m_secret;
+    FramedTcpClient               m_out_con;
+    OutState                      m_out_state;
+    Async::FramedTcpConnection*   m_in_con;
+    sigc::connection              m_in_frame_con;
+    std::set<uint32_t>            m_peer_tgs;
+    std::map<uint32_t, std::string> m_peer_talker_codecs;
+    Async::Timer                  m_reconnect_timer;
+    Async::Timer                  m_heartbeat_timer;
+    unsigned                      m_heartbeat_tx_cnt;
+    unsigned                      m_heartbeat_rx_cnt;
+    unsigned                      m_auth_cnt;
+    std::vector<uint8_t>          m_peer_challenge;
+
+    void sendOutMsg(const ReflectorMsg& msg);
+    void onOutConnected(void);
+    void onOutDisconnected(Async::TcpConnection *con,
+                           Async::TcpConnection::DisconnectReason reason);
+    void onOutFrameReceived(Async::FramedTcpConnection *con,
+                            std::vector<uint8_t>& data);
+    void onInFrameReceived(Async::FramedTcpConnection *con,
+                           std::vector<uint8_t>& data);
+    void reconnect(void);
+    void handleHeartbeat(Async::Timer *t);
+
+};  /* class TrunkLink */
+
+
+//} /* namespace */
+
+#endif /* TRUNK_LINK_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,621 @@
+/**
+@file   UdpWorkerPool.cpp
+@brief  A pool of threads receiving and relaying reflector UDP traffic
+@author agent
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <endian.h>
+#include <errno.h>
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "UdpWorkerPool.h"
+#include "ReflectorMsg.h"
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+  // The UDP header is three 16 bit big endian values: type, client id and
+  // sequence number
+#define UDP_HEADER_SIZE   6
+
+
+/****************************************************************************
+ *
+ * Static class variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+namespace {
+
+
+/****************************************************************************
+ *
+ * Local functions
+ *
+ ****************************************************************************/
+
+uint16_t getBe16(const uint8_t *buf)
+{
+  uint16_t val;
+  memcpy(&val, buf, sizeof(val));
+  return be16toh(val);
+} /* getBe16 */
+
+
+void putBe16(uint8_t *buf, uint16_t val)
+{
+  val = htobe16(val);
+  memcpy(buf, &val, sizeof(val));
+} /* putBe16 */
+
+
+}; /* End of anonymous namespace */
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+UdpWorkerPool::UdpWorkerPool(void)
+  : m_stop(false), m_stop_pipe{-1, -1}, m_notify_pipe{-1, -1}
+{
+  m_notify_watch.activity.connect(
+      sigc::mem_fun(*this, &UdpWorkerPool::notificationReceived));
+} /* UdpWorkerPool::UdpWorkerPool */
+
+
+UdpWorkerPool::~UdpWorkerPool(void)
+{
+  stop();
+} /* UdpWorkerPool::~UdpWorkerPool */
+
+
+bool UdpWorkerPool::start(uint16_t port, unsigned worker_cnt)
+{
+  std::vector<int> socks;
+  for (unsigned i=0; i<worker_cnt; ++i)
+  {
+    int sock = createSocket(port);
+    if (sock < 0)
+    {
+      for (int s : socks)
+      {
+        close(s);
+      }
+      return false;
+    }
+    socks.push_back(sock);
+  }
+  return start(socks);
+} /* UdpWorkerPool::start */
+
+
+bool UdpWorkerPool::start(const std::vector<int>& socks)
+{
+  assert(m_workers.empty());
+
+  for (int sock : socks)
+  {
+    m_workers.emplace_back(new Worker);
+    m_workers.back()->sock = sock;
+  }
+
+  if (socks.empty() || (pipe(m_stop_pipe) != 0) ||
+      (pipe(m_notify_pipe) != 0))
+  {
+    cerr << "*** ERROR: Could not create UDP worker pipes: "
+         << strerror(errno) << endl;
+    stop();
+    return false;
+  }
+  fcntl(m_notify_pipe[0], F_SETFL, O_NONBLOCK);
+  fcntl(m_notify_pipe[1], F_SETFL, O_NONBLOCK);
+  m_notify_watch.setFd(m_notify_pipe[0], FdWatch::FD_WATCH_RD);
+  m_notify_watch.setEnabled(true);
+
+  m_stop = false;
+  for (size_t i=0; i<m_workers.size(); ++i)
+  {
+    m_workers[i]->thread = std::thread(&UdpWorkerPool::workerFunc, this, i);
+  }
+
+  return true;
+} /* UdpWorkerPool::start */
+
+
+void UdpWorkerPool::stop(void)
+{
+  m_stop = true;
+  if (m_stop_pipe[1] >= 0)
+  {
+    char ch = 0;
+    ssize_t ret = write(m_stop_pipe[1], &ch, 1);
+    (void)ret;
+  }
+  for (auto& worker : m_workers)
+  {
+    if (worker->thread.joinable())
+    {
+      worker->thread.join();
+    }
+    close(worker->sock);
+  }
+  m_workers.clear();
+
+  m_notify_watch.setFd(-1, FdWatch::FD_WATCH_RD);
+  for (int *fds : {m_stop_pipe, m_notify_pipe})
+  {
+    for (int i=0; i<2; ++i)
+    {
+      if (fds[i] >= 0)
+      {
+        close(fds[i]);
+        fds[i] = -1;
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lk(m_event_mutex);
+  m_events.clear();
+} /* UdpWorkerPool::stop */
+
+
+void UdpWorkerPool::pause(void)
+{
+  if (m_stop_pipe[1] < 0)
+  {
+    return;
+  }
+  m_stop = true;
+  char ch = 0;
+  ssize_t ret = write(m_stop_pipe[1], &ch, 1);
+  (void)ret;
+  for (auto& worker : m_workers)
+  {
+    if (worker->thread.joinable())
+    {
+      worker->thread.join();
+    }
+  }
+    // Remove the stop indication so that resumed workers do not exit at once
+  ret = read(m_stop_pipe[0], &ch, 1);
+  (void)ret;
+} /* UdpWorkerPool::pause */
+
+
+void UdpWorkerPool::resume(void)
+{
+  if ((m_stop_pipe[0] < 0) || !m_stop)
+  {
+    return;
+  }
+  m_stop = false;
+  for (size_t i=0; i<m_workers.size(); ++i)
+  {
+    if (!m_workers[i]->thread.joinable())
+    {
+      m_workers[i]->thread = std::thread(&UdpWorkerPool::workerFunc, this, i);
+    }
+  }
+} /* UdpWorkerPool::resume */
+
+
+std::vector<int> UdpWorkerPool::sockets(void) const
+{
+  std::vector<int> socks;
+  for (const auto& worker : m_workers)
+  {
+    socks.push_back(worker->sock);
+  }
+  return socks;
+} /* UdpWorkerPool::sockets */
+
+
+void UdpWorkerPool::publish(SnapshotPtr snapshot)
+{
+  std::atomic_store(&m_snapshot, snapshot);
+} /* UdpWorkerPool::publish */
+
+
+bool UdpWorkerPool::send(const IpAddress& ip, uint16_t port, const void *buf,
+                         size_t count)
+{
+  if (m_workers.empty())
+  {
+    return false;
+  }
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr = ip.ip4Addr();
+  ssize_t ret = sendto(m_workers[0]->sock, buf, count, MSG_DONTWAIT,
+                       reinterpret_cast<struct sockaddr *>(&addr),
+                       sizeof(addr));
+  if (ret < 0)
+  {
+    if (errno != EAGAIN)
+    {
+      perror("sendto in UdpWorkerPool::send");
+    }
+    return false;
+  }
+  return true;
+} /* UdpWorkerPool::send */
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+int UdpWorkerPool::createSocket(uint16_t port)
+{
+  int sock = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sock < 0)
+  {
+    perror("socket");
+    return -1;
+  }
+
+#ifdef SO_REUSEPORT
+  int on = 1;
+  if (setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0)
+  {
+    perror("setsockopt(SO_REUSEPORT)");
+    close(sock);
+    return -1;
+  }
+#else
+  cerr << "*** ERROR: SO_REUSEPORT is not supported on this platform" << endl;
+  close(sock);
+  return -1;
+#endif
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = INADDR_ANY;
+  if (::bind(sock, reinterpret_cast<struct sockaddr *>(&addr),
+             sizeof(addr)) != 0)
+  {
+    perror("bind");
+    close(sock);
+    return -1;
+  }
+
+  return sock;
+} /* UdpWorkerPool::createSocket */
+
+
+void UdpWorkerPool::workerFunc(size_t idx)
+{
+  Worker& w = *m_workers[idx];
+  struct pollfd fds[2];
+  fds[0].fd = w.sock;
+  fds[0].events = POLLIN;
+  fds[1].fd = m_stop_pipe[0];
+  fds[1].events = POLLIN;
+
+  uint8_t buf[65536];
+  while (!m_stop)
+  {
+    if (poll(fds, 2, -1) < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      break;
+    }
+    if (fds[1].revents != 0)
+    {
+      break;
+    }
+    if ((fds[0].revents & POLLIN) == 0)
+    {
+      continue;
+    }
+
+      // Read all queued datagrams before going back to poll
+    for (;;)
+    {
+      struct sockaddr_in addr;
+      socklen_t addr_len = sizeof(addr);
+      ssize_t len = recvfrom(w.sock, buf, sizeof(buf), MSG_DONTWAIT,
+                             reinterpret_cast<struct sockaddr *>(&addr),
+                             &addr_len);
+      if (len < 0)
+      {
+        break;
+      }
+      handleDatagram(idx, IpAddress(addr.sin_addr), ntohs(addr.sin_port),
+                     buf, len);
+    }
+  }
+} /* UdpWorkerPool::workerFunc */
+
+
+void UdpWorkerPool::handleDatagram(size_t idx, const IpAddress& addr,
+                                   uint16_t port, uint8_t *buf, size_t count)
+{
+  Worker& w = *m_workers[idx];
+  SnapshotPtr snapshot = std::atomic_load(&m_snapshot);
+
+    // Forget about clients that are no longer connected
+  if ((snapshot != nullptr) && (snapshot.get() != w.pruned_for))
+  {
+    for (auto it = w.clients.begin(); it != w.clients.end(); )
+    {
+      if (snapshot->clients.count(it->first) == 0)
+      {
+        it = w.clients.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+    w.pruned_for = snapshot.get();
+  }
+
+  Event ev;
+  ev.relayed = false;
+  ev.worker = idx;
+  ev.idx = 0;
+  ev.addr = addr;
+  ev.port = port;
+  ev.client_id = 0;
+  ev.seq = 0;
+
+  if (count >= UDP_HEADER_SIZE)
+  {
+    uint16_t type = getBe16(buf);
+    uint32_t client_id = getBe16(buf + 2);
+    uint16_t seq = getBe16(buf + 4);
+
+      // Track the sequence number the same way as the main thread does.
+      // Only frames that arrive in sequence are relayed directly.
+    ClientState& cs = w.clients[client_id];
+    uint16_t seq_diff = seq - cs.next_rx_seq;
+    bool in_seq = cs.seq_valid && (seq_diff == 0);
+    if (!cs.seq_valid || (seq_diff <= 0x7fff))
+    {
+      cs.next_rx_seq = seq + 1;
+      cs.seq_valid = true;
+    }
+
+    if ((type == MsgUdpAudio::TYPE) && in_seq && (snapshot != nullptr) &&
+        (w.processed_cnt.load(std::memory_order_acquire) >=
+         cs.last_forwarded) &&
+        relayAudio(w, *snapshot, client_id, addr, port, buf, count))
+    {
+      ev.relayed = true;
+      ev.client_id = client_id;
+      ev.seq = seq;
+      postEvent(std::move(ev));
+      return;
+    }
+
+    cs.last_forwarded = ++w.forwarded_cnt;
+    ev.idx = cs.last_forwarded;
+  }
+
+  ev.data.assign(buf, buf + count);
+  postEvent(std::move(ev));
+} /* UdpWorkerPool::handleDatagram */
+
+
+bool UdpWorkerPool::relayAudio(Worker& w, const Snapshot& snapshot,
+                               uint32_t client_id, const IpAddress& addr,
+                               uint16_t port, const uint8_t *buf,
+                               size_t count)
+{
+  auto client_it = snapshot.clients.find(client_id);
+  if (client_it == snapshot.clients.end())
+  {
+    return false;
+  }
+  const Client& client = client_it->second;
+  if ((client.port == 0) || (client.port != port) || !(client.ip == addr) ||
+      (client.tg == 0))
+  {
+    return false;
+  }
+
+  auto talker_it = snapshot.tg_talker.find(client.tg);
+  if ((talker_it == snapshot.tg_talker.end()) ||
+      (talker_it->second != client_id))
+  {
+    return false;
+  }
+
+    // The payload is the audio vector which starts with a 16 bit length.
+    // Empty audio frames are handled by the main thread.
+  if ((count < UDP_HEADER_SIZE + 2) ||
+      (getBe16(buf + UDP_HEADER_SIZE) == 0))
+  {
+    return false;
+  }
+
+  auto tg_it = snapshot.tg_clients.find(client.tg);
+  if (tg_it == snapshot.tg_clients.end())
+  {
+    return true;
+  }
+
+    // Send the payload unchanged to all other clients in the talk group. Only
+    // the header is rewritten for each receiver.
+  uint8_t header[UDP_HEADER_SIZE];
+  struct iovec iov[2];
+  iov[0].iov_base = header;
+  iov[0].iov_len = sizeof(header);
+  iov[1].iov_base = const_cast<uint8_t*>(buf + UDP_HEADER_SIZE);
+  iov[1].iov_len = count - UDP_HEADER_SIZE;
+  struct sockaddr_in dest;
+  memset(&dest, 0, sizeof(dest));
+  dest.sin_family = AF_INET;
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_name = &dest;
+  msg.msg_namelen = sizeof(dest);
+  msg.msg_iov = iov;
+  msg.msg_iovlen = 2;
+  for (const Client* receiver : tg_it->second)
+  {
+    if ((receiver->id == client_id) || (receiver->port == 0))
+    {
+      continue;
+    }
+    putBe16(header, MsgUdpAudio::TYPE);
+    putBe16(header + 2, receiver->id);
+    putBe16(header + 4, receiver->tx_seq->fetch_add(1));
+    dest.sin_port = htons(receiver->port);
+    dest.sin_addr = receiver->ip.ip4Addr();
+      // UDP is best effort. A failed send is just a lost frame.
+    (void)sendmsg(w.sock, &msg, 0);
+  }
+
+  return true;
+} /* UdpWorkerPool::relayAudio */
+
+
+void UdpWorkerPool::postEvent(Event&& ev)
+{
+  bool was_empty;
+  {
+    std::lock_guard<std::mutex> lk(m_event_mutex);
+    was_empty = m_events.empty();
+    m_events.push_back(std::move(ev));
+  }
+  if (was_empty)
+  {
+    char ch = 0;
+    ssize_t ret = write(m_notify_pipe[1], &ch, 1);
+    (void)ret;
+  }
+} /* UdpWorkerPool::postEvent */
+
+
+void UdpWorkerPool::notificationReceived(FdWatch *w)
+{
+  char buf[64];
+  while (read(w->fd(), buf, sizeof(buf)) > 0);
+
+  std::deque<Event> events;
+  {
+    std::lock_guard<std::mutex> lk(m_event_mutex);
+    events.swap(m_events);
+  }
+
+  for (auto& ev : events)
+  {
+    if (ev.relayed)
+    {
+      talkerAudioRelayed(ev.client_id, ev.seq);
+    }
+    else
+    {
+      datagramReceived(ev.addr, ev.port, ev.data.data(), ev.data.size());
+    }
+
+      // Tell the worker that all datagrams up to this one have been handled
+      // by the main thread. Any routing changes caused by the datagram must
+      // have been published before this point.
+    if ((ev.idx > 0) && (ev.worker < m_workers.size()))
+    {
+      m_workers[ev.worker]->processed_cnt.store(ev.idx,
+                                                std::memory_order_release);
+    }
+  }
+} /* UdpWorkerPool::notificationReceived */
+
+
+/*
+ * This file has not been truncated
+ */
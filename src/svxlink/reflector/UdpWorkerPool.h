@@ -0,0 +1,331 @@
+/**
+@file   UdpWorkerPool.h
+@brief  A pool of threads receiving and relaying reflector UDP traffic
+@author agent
+@date   2026-10-18
+
+\verbatim
+SvxReflector - An audio reflector for connecting SvxLink Servers
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef UDP_WORKER_POOL_INCLUDED
+#define UDP_WORKER_POOL_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <sigc++/sigc++.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncIpAddress.h>
+#include <AsyncFdWatch.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief  A pool of threads receiving and relaying reflector UDP traffic
+@author agent
+@date   2026-10-18
+
+This class is used by the reflector to spread the UDP load over multiple CPU
+cores. Each worker thread has its own UDP socket bound to the reflector port
+using the SO_REUSEPORT socket option. The kernel will then distribute incoming
+datagrams over the sockets based on the source address so that all datagrams
+from a client always end up in the same worker.
+
+The workers only handle the hot path, which is relaying audio from the current
+talker in a talk group to all other clients in that talk group. To do that, the
+workers use a read only snapshot of the routing state which is published by the
+main thread using the publish function. Everything else, like heartbeats, audio
+from clients that are not the current talker, out of sequence datagrams or
+datagrams from unknown clients, is handed over to the main thread using the
+datagramReceived signal. Each relayed audio frame is reported to the main
+thread using the talkerAudioRelayed signal so that timeouts, sequence number
+tracking and talker timestamps can be kept up to date.
+
+To keep frames from a client in order, a worker will not relay audio from a
+client directly as long as the main thread has not yet handled all datagrams
+previously handed over for that client.
+*/
+class UdpWorkerPool : public sigc::trackable
+{
+  public:
+    /**
+     * @brief   Routing information for a client
+     */
+    struct Client
+    {
+      uint32_t                                id;
+      Async::IpAddress                        ip;
+      uint16_t                                port;
+      uint32_t                                tg;
+      std::shared_ptr<std::atomic<uint16_t>>  tx_seq;
+    };
+
+    /**
+     * @brief   A read only snapshot of the UDP routing state
+     */
+    struct Snapshot
+    {
+      std::unordered_map<uint32_t, Client>                      clients;
+      std::unordered_map<uint32_t, std::vector<const Client*>>  tg_clients;
+      std::unordered_map<uint32_t, uint32_t>                    tg_talker;
+    };
+    typedef std::shared_ptr<const Snapshot> SnapshotPtr;
+
+    /**
+     * @brief   Default constructor
+     */
+    UdpWorkerPool(void);
+
+    /**
+     * @brief   Destructor
+     */
+    ~UdpWorkerPool(void);
+
+    /**
+     * @brief   Disallow copy construction
+     */
+    UdpWorkerPool(const UdpWorkerPool&) = delete;
+
+    /**
+     * @brief   Disallow copy assignment
+     */
+    UdpWorkerPool& operator=(const UdpWorkerPool&) = delete;
+
+    /**
+     * @brief   Start the worker threads
+     * @param   port The UDP port to listen to
+     * @param   worker_cnt The number of worker threads to start
+     * @return  Returns \em true on success or else \em false
+     */
+    bool start(uint16_t port, unsigned worker_cnt);
+
+    /**
+     * @brief   Start the worker threads using already bound sockets
+     * @param   socks The sockets to use, one worker is started per socket
+     * @return  Returns \em true on success or else \em false
+     *
+     * The worker pool take over the ownership of the sockets. This is used
+     * for sockets handed over from another reflector process.
+     */
+    bool start(const std::vector<int>& socks);
+
+    /**
+     * @brief   Get the sockets used by the workers
+     * @return  Returns a list of the sockets, one per worker
+     */
+    std::vector<int> sockets(void) const;
+
+    /**
+     * @brief   Stop all worker threads
+     */
+    void stop(void);
+
+    /**
+     * @brief   Temporarily stop all worker threads
+     *
+     * The sockets are kept open. When this function returns, no worker
+     * thread is running so no datagram is received or relayed until resume
+     * is called.
+     */
+    void pause(void);
+
+    /**
+     * @brief   Restart the worker threads after a call to pause
+     */
+    void resume(void);
+
+    /**
+     * @brief   Publish a new routing snapshot to the workers
+     * @param   snapshot The new snapshot
+     */
+    void publish(SnapshotPtr snapshot);
+
+    /**
+     * @brief   Send a UDP datagram from the reflector port
+     * @param   ip The destination IP address
+     * @param   port The destination UDP port
+     * @param   buf The payload to send
+     * @param   count The number of bytes in the payload
+     * @return  Returns \em true on success or else \em false
+     *
+     * This function is used by the main thread to send datagrams. It use the
+     * socket of the first worker so that the source port is the reflector
+     * port.
+     */
+    bool send(const Async::IpAddress& ip, uint16_t port, const void *buf,
+              size_t count);
+
+    /**
+     * @brief   A signal emitted when a datagram need main thread handling
+     * @param   addr The source IP address
+     * @param   port The source UDP port
+     * @param   buf The datagram payload
+     * @param   count The number of bytes in the payload
+     *
+     * This signal has the same signature as the Async::UdpSocket dataReceived
+     * signal.
+     */
+    sigc::signal<void, const Async::IpAddress&, uint16_t,
+                 void*, int> datagramReceived;
+
+    /**
+     * @brief   A signal emitted when a worker have relayed an audio frame
+     * @param   client_id The id of the client that sent the audio
+     * @param   seq The sequence number of the relayed frame
+     */
+    sigc::signal<void, uint32_t, uint16_t> talkerAudioRelayed;
+
+  private:
+    struct ClientState
+    {
+      uint16_t  next_rx_seq     = 0;
+      bool      seq_valid       = false;
+      uint64_t  last_forwarded  = 0;
+    };
+    typedef std::unordered_map<uint32_t, ClientState> ClientStateMap;
+
+    struct Worker
+    {
+      int                   sock            = -1;
+      std::thread           thread;
+      std::atomic<uint64_t> processed_cnt;
+      uint64_t              forwarded_cnt   = 0;
+      ClientStateMap        clients;
+      const Snapshot*       pruned_for      = nullptr;
+
+      Worker(void) : processed_cnt(0) {}
+    };
+
+    struct Event
+    {
+      bool                  relayed;
+      size_t                worker;
+      uint64_t              idx;
+      Async::IpAddress      addr;
+      uint16_t              port;
+      std::vector<uint8_t>  data;
+      uint32_t              client_id;
+      uint16_t              seq;
+    };
+
+    std::vector<std::unique_ptr<Worker>>  m_workers;
+    std::atomic<bool>                     m_stop;
+    int                                   m_stop_pipe[2];
+    int                                   m_notify_pipe[2];
+    Async::FdWatch                        m_notify_watch;
+    std::mutex                            m_event_mutex;
+    std::deque<Event>                     m_events;
+    SnapshotPtr                           m_snapshot;
+
+    static int createSocket(uint16_t port);
+    void workerFunc(size_t idx);
+    void handleDatagram(size_t idx, const Async::IpAddress& addr,
+                        uint16_t port, uint8_t *buf, size_t count);
+    bool relayAudio(Worker& w, const Snapshot& snapshot, uint32_t client_id,
+                    const Async::IpAddress& addr, uint16_t port,
+                    const uint8_t *buf, size_t count);
+    void postEvent(Event&& ev);
+    void notificationReceived(Async::FdWatch *w);
+
+};  /* class UdpWorkerPool */
+
+
+//} /* namespace */
+
+#endif /* UDP_WORKER_POOL_INCLUDED */
+
+/*
+ * This file has not been truncated
+ */
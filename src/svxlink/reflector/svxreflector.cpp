@@ -143,6 +143,7 @@ static char             *logfile_name = NULL;
 static char             *runasuser = NULL;
 static char   	      	*config = NULL;
 static int    	      	daemonize = 0;
+static int              takeover = 0;
 static int    	      	logfd = -1;
 static FdWatch	      	*stdin_watch = 0;
 static FdWatch	      	*stdout_watch = 0;
@@ -435,7 +436,7 @@ int main(int argc, const char *argv[])
   }
 
   Reflector ref;
-  if (ref.initialize(cfg))
+  if (ref.initialize(cfg, takeover))
   {
     app.exec();
   }
@@ -507,6 +508,8 @@ static void parse_arguments(int argc, const char **argv)
     */
     {"daemon", 0, POPT_ARG_NONE, &daemonize, 0,
 	    "Start " PROGRAM_NAME " as a daemon", NULL},
+    {"takeover", 0, POPT_ARG_NONE, &takeover, 0,
+            "Take over from a running " PROGRAM_NAME " process", NULL},
     {NULL, 0, 0, NULL, 0}
   };
   int err;
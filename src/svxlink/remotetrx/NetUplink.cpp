@@ -125,10 +125,9 @@ using namespace NetTrxMsg;
 
 NetUplink::NetUplink(Config &cfg, const string &name, Rx *rx, Tx *tx,
       	      	     const string& port_str)
-  : server(0), con(0), recv_cnt(0), recv_exp(0), rx(rx), tx(tx), fifo(0),
-    cfg(cfg), name(name), last_msg_timestamp(), heartbeat_timer(0),
-    audio_enc(0), audio_dec(0), loopback_con(0), rx_splitter(0),
-    tx_selector(0), state(STATE_DISC), mute_tx_timer(0), tx_muted(false),
+  : server(0), max_clients(1), tx_owner(0), rx(rx), tx(tx), fifo(0),
+    cfg(cfg), name(name), heartbeat_timer(0), loopback_con(0),
+    rx_splitter(0), tx_selector(0), mute_tx_timer(0), tx_muted(false),
     fallback_enabled(false), tx_ctrl_mode(Tx::TX_OFF)
 {
   heartbeat_timer = new Timer(10000);
@@ -146,8 +145,25 @@ NetUplink::NetUplink(Config &cfg, const string &name, Rx *rx, Tx *tx,
 
 NetUplink::~NetUplink(void)
 {
-  delete audio_enc;
-  delete audio_dec;
+  for (ClientMap::iterator it=clients.begin(); it!=clients.end(); ++it)
+  {
+    delete (*it).second->audio_dec;
+    delete (*it).second;
+  }
+  clients.clear();
+  for (std::vector<Client*>::iterator it=disc_clients.begin();
+       it!=disc_clients.end(); ++it)
+  {
+    delete (*it)->audio_dec;
+    delete *it;
+  }
+  disc_clients.clear();
+  for (RxEncoderMap::iterator it=rx_encoders.begin(); it!=rx_encoders.end();
+       ++it)
+  {
+    delete (*it).second.audio_enc;
+  }
+  rx_encoders.clear();
   delete fifo;
   delete tx_selector;
   delete rx_splitter;
@@ -193,6 +209,13 @@ bool NetUplink::initialize(void)
   
   cfg.getValue(name, "FALLBACK_REPEATER", fallback_enabled, true);
   cfg.getValue(name, "AUTH_KEY", auth_key, true);
+
+  if (!cfg.getValue(name, "MAX_CLIENTS", 1U, 100U, max_clients, true))
+  {
+    cerr << "*** ERROR: Illegal value for configuration variable " << name
+         << "/MAX_CLIENTS. Valid range is 1 to 100.\n";
+    return false;
+  }
   
   int mute_tx_on_rx = -1;
   cfg.getValue(name, "MUTE_TX_ON_RX", mute_tx_on_rx, true);
@@ -268,47 +291,38 @@ bool NetUplink::initialize(void)
 
 void NetUplink::handleIncomingConnection(TcpConnection *incoming_con)
 {
-  assert(con == 0);
-  rx->reset();
-  if (fallback_enabled) // Deactivate fallback repeater mode
+  if (clients.empty())
   {
-    setFallbackActive(false);
-  }
-  
-  if (audio_enc != 0)
-  {
-    rx_splitter->removeSink(audio_enc);
-    delete audio_enc;
-    audio_enc = 0;
+    rx->reset();
+    if (fallback_enabled) // Deactivate fallback repeater mode
+    {
+      setFallbackActive(false);
+    }
+    heartbeat_timer->setEnable(true);
   }
   
-  delete audio_dec;
-  audio_dec = 0;
-  
-  con = incoming_con;
-  con->dataReceived.connect(mem_fun(*this, &NetUplink::tcpDataReceived));
-  recv_exp = sizeof(Msg);
-  recv_cnt = 0;
-  heartbeat_timer->setEnable(true);
-  gettimeofday(&last_msg_timestamp, NULL);
+  Client *client = new Client(incoming_con);
+  clients[incoming_con] = client;
+  incoming_con->dataReceived.connect(
+      mem_fun(*this, &NetUplink::tcpDataReceived));
+  client->recv_exp = sizeof(Msg);
+  gettimeofday(&client->last_msg_timestamp, NULL);
   
-  setState(STATE_CON_SETUP);
-
-  MsgProtoVer *ver_msg = new MsgProtoVer;
-  sendMsg(ver_msg);
+  MsgProtoVer ver_msg;
+  sendMsg(client, ver_msg);
   
   if (auth_key.empty())
   {
-    MsgAuthOk *auth_msg = new MsgAuthOk;
-    sendMsg(auth_msg);
-    setState(STATE_READY);
+    MsgAuthOk auth_msg;
+    sendMsg(client, auth_msg);
+    client->state = STATE_READY;
   }
   else
   {
-    MsgAuthChallenge *auth_msg = new MsgAuthChallenge;
-    memcpy(auth_challenge, auth_msg->challenge(),
+    MsgAuthChallenge auth_msg;
+    memcpy(client->auth_challenge, auth_msg.challenge(),
            MsgAuthChallenge::CHALLENGE_LEN);
-    sendMsg(auth_msg);
+    sendMsg(client, auth_msg);
   }
 } /* NetUplink::handleIncomingConnection */
 
@@ -318,35 +332,41 @@ void NetUplink::clientConnected(TcpConnection *incoming_con)
   cout << name << ": Client connected: " << incoming_con->remoteHost() << ":"
        << incoming_con->remotePort() << endl;
   
-  switch (state)
+  if (clients.size() >= max_clients)
   {
-    case STATE_DISC:
-      handleIncomingConnection(incoming_con);
-      break;
-    case STATE_CON_SETUP:
-    case STATE_READY:
-      cout << name << ": Only one client allowed. Disconnecting...\n";
-      // Fall through
-    case STATE_DISC_CLEANUP:
-      incoming_con->disconnect();
-      break;
+    cout << name << ": Only " << max_clients
+         << " client(s) allowed. Disconnecting...\n";
+    incoming_con->disconnect();
+    return;
   }
+
+  handleIncomingConnection(incoming_con);
 } /* NetUplink::clientConnected */
 
 
 void NetUplink::disconnectCleanup(void)
 {
-  con = 0;
-  recv_exp = 0;
-  setState(STATE_DISC);
+  if (disc_clients.empty())
+  {
+    return;
+  }
+
+  std::vector<Client*> cleanup_clients;
+  cleanup_clients.swap(disc_clients);
+  for (std::vector<Client*>::iterator it=cleanup_clients.begin();
+       it!=cleanup_clients.end(); ++it)
+  {
+    removeClient(*it);
+  }
+
+  if (!clients.empty())
+  {
+    return;
+  }
 
   rx->reset();
   tx->enableCtcss(false);
   fifo->clear();
-  if (audio_dec != 0)
-  {
-    audio_dec->flushEncodedSamples();
-  }
   tx->setTxCtrlMode(Tx::TX_OFF);
   heartbeat_timer->setEnable(false);
 
@@ -369,13 +389,50 @@ void NetUplink::disconnectCleanup(void)
 } /* NetUplink::disconnectCleanup */
 
 
+void NetUplink::removeClient(Client *client)
+{
+  releaseRxCodec(client);
+  if (tx_owner == client)
+  {
+    fifo->clear();
+    if (client->audio_dec != 0)
+    {
+      client->audio_dec->flushEncodedSamples();
+    }
+    releaseTx(client);
+  }
+  delete client->audio_dec;
+  delete client;
+
+  if (!clients.empty())
+  {
+    updateTxCtrlMode();
+    updateMuteState();
+  }
+} /* NetUplink::removeClient */
+
+
 void NetUplink::clientDisconnected(TcpConnection *the_con,
                                    TcpConnection::DisconnectReason reason)
 {
   cout << name << ": Client disconnected: " << the_con->remoteHost() << ":"
        << the_con->remotePort() << endl;
-  con = 0;
-  setState(STATE_DISC_CLEANUP);
+
+  ClientMap::iterator it = clients.find(the_con);
+  if (it == clients.end())
+  {
+    return;
+  }
+
+    // The client is removed from the map right away since the connection
+    // object will be deleted. The rest of the cleanup is done later since
+    // we may have been called from deep down in a message handler.
+  Client *client = (*it).second;
+  clients.erase(it);
+  client->con = 0;
+  client->recv_exp = 0;
+  client->state = STATE_DISC_CLEANUP;
+  disc_clients.push_back(client);
   Application::app().runTask(mem_fun(*this, &NetUplink::disconnectCleanup));
 } /* NetUplink::clientDisconnected */
 
@@ -388,13 +445,20 @@ int NetUplink::tcpDataReceived(TcpConnection *con, void *data, int size)
   //cout << "Received a TCP message with type " << msg->type()
   //     << " and size " << msg->size() << endl;
   
+  ClientMap::iterator it = clients.find(con);
+  if (it == clients.end())
+  {
+    return size;
+  }
+  Client *client = (*it).second;
+
     // Discard data if we are not in one of the "connected" states
-  if ((state != STATE_CON_SETUP) && (state != STATE_READY))
+  if ((client->state != STATE_CON_SETUP) && (client->state != STATE_READY))
   {
     return size;
   }
 
-  if (recv_exp == 0)
+  if (client->recv_exp == 0)
   {
     cerr << "*** ERROR: Unexpected TCP data received in NetUplink "
          << name << ". Throwing it away...\n";
@@ -406,49 +470,50 @@ int NetUplink::tcpDataReceived(TcpConnection *con, void *data, int size)
   char *buf = static_cast<char*>(data);
   while (size > 0)
   {
-    unsigned read_cnt = min(static_cast<unsigned>(size), recv_exp-recv_cnt);
-    if (recv_cnt+read_cnt > sizeof(recv_buf))
+    unsigned read_cnt = min(static_cast<unsigned>(size),
+                            client->recv_exp-client->recv_cnt);
+    if (client->recv_cnt+read_cnt > sizeof(client->recv_buf))
     {
       cerr << "*** ERROR: TCP receive buffer overflow in NetUplink "
            << name << ". Disconnecting...\n";
-      forceDisconnect();
+      forceDisconnect(client);
       return orig_size;
     }
-    memcpy(recv_buf+recv_cnt, buf, read_cnt);
+    memcpy(client->recv_buf+client->recv_cnt, buf, read_cnt);
     size -= read_cnt;
-    recv_cnt += read_cnt;
+    client->recv_cnt += read_cnt;
     buf += read_cnt;
     
-    if (recv_cnt == recv_exp)
+    if (client->recv_cnt == client->recv_exp)
     {
-      if (recv_exp == sizeof(Msg))
+      if (client->recv_exp == sizeof(Msg))
       {
-      	Msg *msg = reinterpret_cast<Msg*>(recv_buf);
+      	Msg *msg = reinterpret_cast<Msg*>(client->recv_buf);
 	if (msg->size() == sizeof(Msg))
 	{
-	  handleMsg(msg);
-	  recv_cnt = 0;
-	  recv_exp = sizeof(Msg);
+	  handleMsg(client, msg);
+	  client->recv_cnt = 0;
+	  client->recv_exp = sizeof(Msg);
 	}
 	else if (msg->size() > sizeof(Msg))
 	{
-      	  recv_exp = msg->size();
+      	  client->recv_exp = msg->size();
 	}
 	else
 	{
 	  cerr << "*** ERROR: Illegal message header received in NetUplink "
                << name << ". Header length too small (" << msg->size()
                << ")\n";
-          forceDisconnect();
+          forceDisconnect(client);
 	  return orig_size;
 	}
       }
       else
       {
-      	Msg *msg = reinterpret_cast<Msg*>(recv_buf);
-      	handleMsg(msg);
-	recv_cnt = 0;
-	recv_exp = sizeof(Msg);
+      	Msg *msg = reinterpret_cast<Msg*>(client->recv_buf);
+      	handleMsg(client, msg);
+	client->recv_cnt = 0;
+	client->recv_exp = sizeof(Msg);
       }
     }
   }
@@ -458,9 +523,9 @@ int NetUplink::tcpDataReceived(TcpConnection *con, void *data, int size)
 } /* NetUplink::tcpDataReceived */
 
 
-void NetUplink::handleMsg(Msg *msg)
+void NetUplink::handleMsg(Client *client, Msg *msg)
 {
-  switch (state)
+  switch (client->state)
   {
     case STATE_DISC:
     case STATE_DISC_CLEANUP:
@@ -471,24 +536,24 @@ void NetUplink::handleMsg(Msg *msg)
           msg->size() == sizeof(MsgAuthResponse))
       {
         MsgAuthResponse *resp_msg = reinterpret_cast<MsgAuthResponse *>(msg);
-        if (!resp_msg->verify(auth_key, auth_challenge))
+        if (!resp_msg->verify(auth_key, client->auth_challenge))
         {
           cerr << "*** ERROR: Authentication error in NetUplink "
                << name << ".\n";
-          forceDisconnect();
+          forceDisconnect(client);
           return;
         }
         else
         {
-          MsgAuthOk *ok_msg = new MsgAuthOk;
-          sendMsg(ok_msg);
+          MsgAuthOk ok_msg;
+          sendMsg(client, ok_msg);
         }
-        setState(STATE_READY);
+        client->state = STATE_READY;
       }
       else
       {
         cerr << "*** ERROR: Protocol error in NetUplink " << name << ".\n";
-        forceDisconnect();
+        forceDisconnect(client);
       }
       return;
     
@@ -496,7 +561,7 @@ void NetUplink::handleMsg(Msg *msg)
       break;
   }
   
-  gettimeofday(&last_msg_timestamp, NULL);
+  gettimeofday(&client->last_msg_timestamp, NULL);
   
   switch (msg->type())
   {
@@ -534,7 +599,8 @@ void NetUplink::handleMsg(Msg *msg)
       cout << rx->name() << ": SetMuteState("
            << Rx::muteStateToString(mute_msg->muteState())
       	   << ")\n";
-      rx->setMuteState(mute_msg->muteState());
+      client->mute_state = mute_msg->muteState();
+      updateMuteState();
       break;
     }
     
@@ -552,11 +618,16 @@ void NetUplink::handleMsg(Msg *msg)
     case MsgSetTxCtrlMode::TYPE:
     {
       MsgSetTxCtrlMode *mode_msg = reinterpret_cast<MsgSetTxCtrlMode *>(msg);
-      tx_ctrl_mode = mode_msg->mode();
-      if (!tx_muted)
+      client->tx_ctrl_mode = mode_msg->mode();
+      if (client->tx_ctrl_mode == Tx::TX_ON)
       {
-	tx->setTxCtrlMode(tx_ctrl_mode);
+        claimTx(client);
       }
+      else if ((tx_owner == client) && !client->tx_audio_active)
+      {
+        releaseTx(client);
+      }
+      updateTxCtrlMode();
       break;
     }
      
@@ -578,37 +649,7 @@ void NetUplink::handleMsg(Msg *msg)
     {
       MsgRxAudioCodecSelect *codec_msg = 
           reinterpret_cast<MsgRxAudioCodecSelect *>(msg);
-      if (audio_enc != 0)
-      {
-	rx_splitter->removeSink(audio_enc);
-	delete audio_enc;
-      }
-      audio_enc = AudioEncoder::create(codec_msg->name());
-      if (audio_enc != 0)
-      {
-        audio_enc->writeEncodedSamples.connect(
-                mem_fun(*this, &NetUplink::writeEncodedSamples));
-        audio_enc->flushEncodedSamples.connect(
-                mem_fun(*audio_enc, &AudioEncoder::allEncodedSamplesFlushed));
-        //audio_enc->registerSource(rx);
-	rx_splitter->addSink(audio_enc);
-        cout << name << ": Using CODEC \"" << audio_enc->name()
-             << "\" to encode RX audio\n";
-	
-	MsgRxAudioCodecSelect::Opts opts;
-	codec_msg->options(opts);
-	MsgRxAudioCodecSelect::Opts::const_iterator it;
-	for (it=opts.begin(); it!=opts.end(); ++it)
-	{
-	  audio_enc->setOption((*it).first, (*it).second);
-	}
-	audio_enc->printCodecParams();
-      }
-      else
-      {
-        cerr << "*** ERROR: Received request for unknown RX audio codec ("
-             << codec_msg->name() << ") in NetUplink " << name << "\n";
-      }
+      selectRxCodec(client, codec_msg);
       break;
     }
     
@@ -616,49 +657,38 @@ void NetUplink::handleMsg(Msg *msg)
     {
       MsgTxAudioCodecSelect *codec_msg = 
           reinterpret_cast<MsgTxAudioCodecSelect *>(msg);
-      delete audio_dec;
-      audio_dec = AudioDecoder::create(codec_msg->name());
-      if (audio_dec != 0)
-      {
-        audio_dec->registerSink(fifo);
-        audio_dec->allEncodedSamplesFlushed.connect(
-            mem_fun(*this, &NetUplink::allEncodedSamplesFlushed));
-        cout << name << ": Using CODEC \"" << audio_dec->name()
-             << "\" to decode TX audio\n";
-	
-	MsgRxAudioCodecSelect::Opts opts;
-	codec_msg->options(opts);
-	MsgTxAudioCodecSelect::Opts::const_iterator it;
-	for (it=opts.begin(); it!=opts.end(); ++it)
-	{
-	  audio_dec->setOption((*it).first, (*it).second);
-	}
-	audio_dec->printCodecParams();
-      }
-      else
-      {
-        cerr << "*** ERROR: Received request for unknown TX audio codec ("
-             << codec_msg->name() << ") in NetUplink " << name << "\n";
-      }
+      selectTxCodec(client, codec_msg);
       break;
     }
     
     case MsgAudio::TYPE:
     {
       //cout << "NetUplink [MsgAudio]\n";
-      if (!tx_muted && (audio_dec != 0))
+      if (!tx_muted && (client->audio_dec != 0) && claimTx(client))
       {
         MsgAudio *audio_msg = reinterpret_cast<MsgAudio*>(msg);
-        audio_dec->writeEncodedSamples(audio_msg->buf(), audio_msg->size());
+        client->tx_audio_active = true;
+        client->audio_dec->writeEncodedSamples(audio_msg->buf(),
+                                               audio_msg->size());
       }
       break;
     }
     
     case MsgFlush::TYPE:
     {
-      if (audio_dec != 0)
+      if (client->audio_dec != 0)
       {
-        audio_dec->flushEncodedSamples();
+        if (tx_owner == client)
+        {
+          client->audio_dec->flushEncodedSamples();
+        }
+        else
+        {
+            // The audio from this client was discarded so there is
+            // nothing to wait for
+          MsgAllSamplesFlushed flushed_msg;
+          sendMsg(client, flushed_msg);
+        }
       }
       break;
     } 
@@ -699,30 +729,247 @@ void NetUplink::handleMsg(Msg *msg)
 } /* NetUplink::handleMsg */
 
 
-void NetUplink::sendMsg(Msg *msg)
+void NetUplink::selectRxCodec(Client *client,
+                              MsgRxAudioCodecSelect *codec_msg)
 {
-  if ((state == STATE_CON_SETUP) || (state == STATE_READY))
+  releaseRxCodec(client);
+
+    // Clients asking for the same codec with the same options share one
+    // encoder so that the audio is only encoded once
+  MsgRxAudioCodecSelect::Opts opts;
+  codec_msg->options(opts);
+  string codec(codec_msg->name());
+  MsgRxAudioCodecSelect::Opts::const_iterator oit;
+  for (oit=opts.begin(); oit!=opts.end(); ++oit)
+  {
+    codec += ";" + (*oit).first + "=" + (*oit).second;
+  }
+
+  RxEncoderMap::iterator it = rx_encoders.find(codec);
+  if (it == rx_encoders.end())
   {
-    int written = con->write(msg, msg->size());
-    if (written == -1)
+    AudioEncoder *audio_enc = AudioEncoder::create(codec_msg->name());
+    if (audio_enc == 0)
     {
-      cerr << "*** ERROR: TCP transmit error in NetUplink \"" << name
-           << "\": " << strerror(errno) << ".\n";
-      forceDisconnect();
+      cerr << "*** ERROR: Received request for unknown RX audio codec ("
+           << codec_msg->name() << ") in NetUplink " << name << "\n";
+      return;
     }
-    else if (written != static_cast<int>(msg->size()))
+    audio_enc->writeEncodedSamples.connect(
+            sigc::bind(mem_fun(*this, &NetUplink::writeEncodedSamples),
+                       codec));
+    audio_enc->flushEncodedSamples.connect(
+            mem_fun(*audio_enc, &AudioEncoder::allEncodedSamplesFlushed));
+    rx_splitter->addSink(audio_enc);
+    cout << name << ": Using CODEC \"" << audio_enc->name()
+         << "\" to encode RX audio\n";
+    for (oit=opts.begin(); oit!=opts.end(); ++oit)
     {
-      cerr << "*** ERROR: TCP transmit buffer overflow in NetUplink "
-           << name << ".\n";
-      forceDisconnect();
+      audio_enc->setOption((*oit).first, (*oit).second);
     }
+    audio_enc->printCodecParams();
+    it = rx_encoders.insert(make_pair(codec, RxEncoder())).first;
+    (*it).second.audio_enc = audio_enc;
+  }
+  else
+  {
+    cout << name << ": Sharing CODEC \"" << (*it).second.audio_enc->name()
+         << "\" for RX audio with " << (*it).second.clients.size()
+         << " other client(s)\n";
+  }
+  (*it).second.clients.insert(client);
+  client->rx_codec = codec;
+} /* NetUplink::selectRxCodec */
+
+
+void NetUplink::releaseRxCodec(Client *client)
+{
+  if (client->rx_codec.empty())
+  {
+    return;
+  }
+
+  RxEncoderMap::iterator it = rx_encoders.find(client->rx_codec);
+  client->rx_codec.clear();
+  if (it == rx_encoders.end())
+  {
+    return;
+  }
+  (*it).second.clients.erase(client);
+  if ((*it).second.clients.empty())
+  {
+    rx_splitter->removeSink((*it).second.audio_enc);
+    delete (*it).second.audio_enc;
+    rx_encoders.erase(it);
+  }
+} /* NetUplink::releaseRxCodec */
+
+
+void NetUplink::selectTxCodec(Client *client,
+                              MsgTxAudioCodecSelect *codec_msg)
+{
+  delete client->audio_dec;
+  client->audio_dec = AudioDecoder::create(codec_msg->name());
+  if (client->audio_dec == 0)
+  {
+    cerr << "*** ERROR: Received request for unknown TX audio codec ("
+         << codec_msg->name() << ") in NetUplink " << name << "\n";
+    return;
+  }
+
+  if (tx_owner == client)
+  {
+    client->audio_dec->registerSink(fifo);
+  }
+  client->audio_dec->allEncodedSamplesFlushed.connect(
+      sigc::bind(mem_fun(*this, &NetUplink::allEncodedSamplesFlushed),
+                 client));
+  cout << name << ": Using CODEC \"" << client->audio_dec->name()
+       << "\" to decode TX audio\n";
+
+  MsgTxAudioCodecSelect::Opts opts;
+  codec_msg->options(opts);
+  MsgTxAudioCodecSelect::Opts::const_iterator it;
+  for (it=opts.begin(); it!=opts.end(); ++it)
+  {
+    client->audio_dec->setOption((*it).first, (*it).second);
+  }
+  client->audio_dec->printCodecParams();
+} /* NetUplink::selectTxCodec */
+
+
+bool NetUplink::claimTx(Client *client)
+{
+  if (tx_owner == 0)
+  {
+    tx_owner = client;
+    if (client->audio_dec != 0)
+    {
+      client->audio_dec->registerSink(fifo);
+    }
+    if (clients.size() > 1)
+    {
+      cout << name << ": Transmitter taken by client "
+           << client->con->remoteHost() << ":" << client->con->remotePort()
+           << endl;
+    }
+  }
+  return (tx_owner == client);
+} /* NetUplink::claimTx */
+
+
+void NetUplink::releaseTx(Client *client)
+{
+  if (tx_owner != client)
+  {
+    return;
+  }
+  if (client->audio_dec != 0)
+  {
+    client->audio_dec->unregisterSink();
+  }
+  client->tx_audio_active = false;
+  tx_owner = 0;
+  updateTxCtrlMode();
+} /* NetUplink::releaseTx */
+
+
+void NetUplink::updateTxCtrlMode(void)
+{
+    // A client that have forced the transmitter on get it as soon as it is
+    // released by the previous owner
+  if (tx_owner == 0)
+  {
+    for (ClientMap::iterator it=clients.begin(); it!=clients.end(); ++it)
+    {
+      Client *client = (*it).second;
+      if ((client->state == STATE_READY) &&
+          (client->tx_ctrl_mode == Tx::TX_ON))
+      {
+        claimTx(client);
+        break;
+      }
+    }
+  }
+
+  Tx::TxCtrlMode mode = Tx::TX_OFF;
+  if (tx_owner != 0)
+  {
+    mode = tx_owner->tx_ctrl_mode;
+  }
+  else
+  {
+    for (ClientMap::iterator it=clients.begin(); it!=clients.end(); ++it)
+    {
+      if ((*it).second->tx_ctrl_mode == Tx::TX_AUTO)
+      {
+        mode = Tx::TX_AUTO;
+        break;
+      }
+    }
+  }
+
+  tx_ctrl_mode = mode;
+  if (!tx_muted)
+  {
+    tx->setTxCtrlMode(tx_ctrl_mode);
+  }
+} /* NetUplink::updateTxCtrlMode */
+
+
+void NetUplink::updateMuteState(void)
+{
+    // The receiver is muted no more than the least muted client want it
+  Rx::MuteState mute_state = Rx::MUTE_ALL;
+  for (ClientMap::iterator it=clients.begin(); it!=clients.end(); ++it)
+  {
+    mute_state = min(mute_state, (*it).second->mute_state);
+  }
+  rx->setMuteState(mute_state);
+} /* NetUplink::updateMuteState */
+
+
+bool NetUplink::sendMsg(Client *client, Msg &msg)
+{
+  if ((client->state != STATE_CON_SETUP) && (client->state != STATE_READY))
+  {
+    return false;
+  }
+
+  int written = client->con->write(&msg, msg.size());
+  if (written == -1)
+  {
+    cerr << "*** ERROR: TCP transmit error in NetUplink \"" << name
+         << "\": " << strerror(errno) << ".\n";
+    forceDisconnect(client);
+    return false;
+  }
+  else if (written != static_cast<int>(msg.size()))
+  {
+    cerr << "*** ERROR: TCP transmit buffer overflow in NetUplink "
+         << name << ".\n";
+    forceDisconnect(client);
+    return false;
   }
   
-  delete msg;
+  return true;
   
 } /* NetUplink::sendMsg */
 
 
+void NetUplink::broadcastMsg(Msg &msg)
+{
+    // A client may be removed from the map if the send fail so the
+    // iterator is advanced before sending
+  ClientMap::iterator it = clients.begin();
+  while (it != clients.end())
+  {
+    Client *client = (*it++).second;
+    sendMsg(client, msg);
+  }
+} /* NetUplink::broadcastMsg */
+
+
 void NetUplink::squelchOpen(bool is_open)
 {
   if (mute_tx_timer != 0)
@@ -738,9 +985,9 @@ void NetUplink::squelchOpen(bool is_open)
     }
   }
 
-  MsgSquelch *msg = new MsgSquelch(is_open, rx->signalStrength(),
-                                   rx->sqlRxId(), rx->squelchActivityInfo());
-  sendMsg(msg);
+  MsgSquelch msg(is_open, rx->signalStrength(), rx->sqlRxId(),
+                 rx->squelchActivityInfo());
+  broadcastMsg(msg);
 } /* NetUplink::squelchOpen */
 
 
@@ -748,37 +995,50 @@ void NetUplink::dtmfDigitDetected(char digit, int duration)
 {
   cout << name << ": DTMF digit detected: " << digit << " with duration " << duration
        << " milliseconds" << endl;
-  MsgDtmf *msg = new MsgDtmf(digit, duration);
-  sendMsg(msg);
+  MsgDtmf msg(digit, duration);
+  broadcastMsg(msg);
 } /* NetUplink::dtmfDigitDetected */
 
 
 void NetUplink::toneDetected(float tone_fq)
 {
   cout << name << ": Tone detected: " << tone_fq << endl;
-  MsgTone *msg = new MsgTone(tone_fq);
-  sendMsg(msg);
+  MsgTone msg(tone_fq);
+  broadcastMsg(msg);
 } /* NetUplink::toneDetected */
 
 
 void NetUplink::selcallSequenceDetected(std::string sequence)
 {
   // cout "Sel5 sequence detected: " << sequence << endl;
-  MsgSel5 *msg = new MsgSel5(sequence);
-  sendMsg(msg);
+  MsgSel5 msg(sequence);
+  broadcastMsg(msg);
 } /* NetUplink::selcallSequenceDetected */
 
 
-void NetUplink::writeEncodedSamples(const void *buf, int size)
+void NetUplink::writeEncodedSamples(const void *buf, int size,
+                                    std::string codec)
 {
   //cout << "NetUplink::writeEncodedSamples: size=" << size << endl;
+  RxEncoderMap::iterator it = rx_encoders.find(codec);
+  if (it == rx_encoders.end())
+  {
+    return;
+  }
+
+    // Each message is built once and sent to all clients using this codec
+  const std::set<Client*>& enc_clients = (*it).second.clients;
   const char *ptr = reinterpret_cast<const char *>(buf);
   while (size > 0)
   {
     const int bufsize = MsgAudio::BUFSIZE;
     int len = min(size, bufsize);
-    MsgAudio *msg = new MsgAudio(ptr, len);
-    sendMsg(msg);
+    MsgAudio msg(ptr, len);
+    std::set<Client*>::const_iterator cit;
+    for (cit=enc_clients.begin(); cit!=enc_clients.end(); ++cit)
+    {
+      sendMsg(*cit, msg);
+    }
     size -= len;
     ptr += len;
   }
@@ -787,41 +1047,49 @@ void NetUplink::writeEncodedSamples(const void *buf, int size)
 
 void NetUplink::txTimeout(void)
 {
-  MsgTxTimeout *msg = new MsgTxTimeout;
-  sendMsg(msg);
+  MsgTxTimeout msg;
+  broadcastMsg(msg);
 } /* NetUplink::txTimeout */
 
 
 void NetUplink::transmitterStateChange(bool is_transmitting)
 {
-  MsgTransmitterStateChange *msg =
-      new MsgTransmitterStateChange(is_transmitting);
-  sendMsg(msg);
+  MsgTransmitterStateChange msg(is_transmitting);
+  broadcastMsg(msg);
 } /* NetUplink::transmitterStateChange */
 
 
-void NetUplink::allEncodedSamplesFlushed(void)
+void NetUplink::allEncodedSamplesFlushed(Client *client)
 {
-  MsgAllSamplesFlushed *msg = new MsgAllSamplesFlushed;
-  sendMsg(msg);
+  MsgAllSamplesFlushed msg;
+  sendMsg(client, msg);
+  client->tx_audio_active = false;
+  if (client->tx_ctrl_mode != Tx::TX_ON)
+  {
+    releaseTx(client);
+  }
 } /* NetUplink::allEncodedSamplesFlushed */
 
 
 void NetUplink::heartbeat(Timer *t)
 {
-  MsgHeartbeat *msg = new MsgHeartbeat;
-  sendMsg(msg);
+  MsgHeartbeat msg;
+  broadcastMsg(msg);
   
-  struct timeval diff_tv;
   struct timeval now;
   gettimeofday(&now, NULL);
-  timersub(&now, &last_msg_timestamp, &diff_tv);
-  int diff_ms = diff_tv.tv_sec * 1000 + diff_tv.tv_usec / 1000;
-  
-  if (diff_ms > 15000)
+  ClientMap::iterator it = clients.begin();
+  while (it != clients.end())
   {
-    cerr << "*** ERROR: Heartbeat timeout in NetUplink " << name << "\n";
-    forceDisconnect();
+    Client *client = (*it++).second;
+    struct timeval diff_tv;
+    timersub(&now, &client->last_msg_timestamp, &diff_tv);
+    int diff_ms = diff_tv.tv_sec * 1000 + diff_tv.tv_usec / 1000;
+    if (diff_ms > 15000)
+    {
+      cerr << "*** ERROR: Heartbeat timeout in NetUplink " << name << "\n";
+      forceDisconnect(client);
+    }
   }
   
   t->reset();
@@ -866,14 +1134,18 @@ void NetUplink::setFallbackActive(bool activate)
 
 void NetUplink::signalLevelUpdated(float siglev)
 {
-  MsgSiglevUpdate *msg = new MsgSiglevUpdate(rx->signalStrength(),
-					     rx->sqlRxId());
-  sendMsg(msg);  
+  MsgSiglevUpdate msg(rx->signalStrength(), rx->sqlRxId());
+  broadcastMsg(msg);
 } /* NetUplink::signalLevelUpdated */
 
 
-void NetUplink::forceDisconnect(void)
+void NetUplink::forceDisconnect(Client *client)
 {
+  if (client->state == STATE_DISC_CLEANUP)
+  {
+    return;
+  }
+  TcpConnection *con = client->con;
   con->disconnect();
   clientDisconnected(con, TcpConnection::DR_ORDERED_DISCONNECT);
 } /* NetUplink::forceDisconnect */
@@ -38,6 +38,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sys/time.h>
 
 #include <string>
+#include <map>
+#include <set>
+#include <vector>
 
 
 /****************************************************************************
@@ -130,6 +133,16 @@ namespace NetTrxMsg
 @date   2006-04-14
 
 This class implements a remote transceiver uplink via an IP network.
+
+More than one client may be connected at the same time, up to the number
+given by the MAX_CLIENTS configuration variable. This makes it possible to
+feed the same remote receiver to redundant SvxLink cores. Received audio is
+encoded once for each distinct codec configuration requested by the clients
+and the same audio packets are sent to all clients using that configuration.
+Only one client at a time may use the transmitter. The first client that
+start sending audio, or set the transmitter to TX_ON, will own the
+transmitter until it is turned off or all audio has been flushed. Audio from
+other clients is discarded in the meantime.
 */
 class NetUplink : public Uplink
 {
@@ -164,27 +177,55 @@ class NetUplink : public Uplink
     {
       STATE_DISC, STATE_CON_SETUP, STATE_READY, STATE_DISC_CLEANUP
     } State;
+
+    struct Client
+    {
+      Async::TcpConnection  *con;
+      char      	    recv_buf[4096];
+      unsigned       	    recv_cnt;
+      unsigned       	    recv_exp;
+      State                 state;
+      unsigned char         auth_challenge[
+                              NetTrxMsg::MsgAuthChallenge::CHALLENGE_LEN];
+      struct timeval        last_msg_timestamp;
+      std::string           rx_codec;
+      Async::AudioDecoder   *audio_dec;
+      Rx::MuteState         mute_state;
+      Tx::TxCtrlMode        tx_ctrl_mode;
+      bool                  tx_audio_active;
+
+      Client(Async::TcpConnection *con)
+        : con(con), recv_cnt(0), recv_exp(0), state(STATE_CON_SETUP),
+          last_msg_timestamp(), audio_dec(0), mute_state(Rx::MUTE_CONTENT),
+          tx_ctrl_mode(Tx::TX_OFF), tx_audio_active(false)
+      {
+      }
+    };
+    typedef std::map<Async::TcpConnection*, Client*> ClientMap;
+
+    struct RxEncoder
+    {
+      Async::AudioEncoder *audio_enc;
+      std::set<Client*>   clients;
+    };
+    typedef std::map<std::string, RxEncoder> RxEncoderMap;
     
     Async::TcpServer<Async::TcpConnection>*  server;
-    Async::TcpConnection    *con;
-    char      	      	    recv_buf[4096];
-    unsigned       	    recv_cnt;
-    unsigned       	    recv_exp;
+    ClientMap               clients;
+    std::vector<Client*>    disc_clients;
+    unsigned                max_clients;
+    RxEncoderMap            rx_encoders;
+    Client                  *tx_owner;
     Rx	      	      	    *rx;
     Tx	      	      	    *tx;
     Async::AudioFifo  	    *fifo;
     Async::Config     	    &cfg;
     std::string       	    name;
-    struct timeval    	    last_msg_timestamp;
     Async::Timer      	    *heartbeat_timer;
-    Async::AudioEncoder     *audio_enc;
-    Async::AudioDecoder     *audio_dec;
     Async::AudioPassthrough *loopback_con;
     Async::AudioSplitter    *rx_splitter;
     Async::AudioSelector    *tx_selector;
-    State                   state;
     std::string             auth_key;
-    unsigned char           auth_challenge[NetTrxMsg::MsgAuthChallenge::CHALLENGE_LEN];
     //Async::Timer      	    *siglev_check_timer;
     Async::Timer	    *mute_tx_timer;
     bool		    tx_muted;
@@ -196,11 +237,22 @@ class NetUplink : public Uplink
     void handleIncomingConnection(Async::TcpConnection *incoming_con);
     void clientConnected(Async::TcpConnection *con);
     void disconnectCleanup(void);
+    void removeClient(Client *client);
     void clientDisconnected(Async::TcpConnection *con,
       	      	      	    Async::TcpConnection::DisconnectReason reason);
     int tcpDataReceived(Async::TcpConnection *con, void *data, int size);
-    void handleMsg(NetTrxMsg::Msg *msg);
-    void sendMsg(NetTrxMsg::Msg *msg);
+    void handleMsg(Client *client, NetTrxMsg::Msg *msg);
+    void selectRxCodec(Client *client,
+                       NetTrxMsg::MsgRxAudioCodecSelect *codec_msg);
+    void releaseRxCodec(Client *client);
+    void selectTxCodec(Client *client,
+                       NetTrxMsg::MsgTxAudioCodecSelect *codec_msg);
+    bool claimTx(Client *client);
+    void releaseTx(Client *client);
+    void updateTxCtrlMode(void);
+    void updateMuteState(void);
+    bool sendMsg(Client *client, NetTrxMsg::Msg &msg);
+    void broadcastMsg(NetTrxMsg::Msg &msg);
 
     /**
      * @brief 	Set squelch state to open/closed
@@ -227,17 +279,16 @@ class NetUplink : public Uplink
     void selcallSequenceDetected(std::string sequence);
 
 
-    void writeEncodedSamples(const void *buf, int size);
+    void writeEncodedSamples(const void *buf, int size, std::string codec);
     void txTimeout(void);
     void transmitterStateChange(bool is_transmitting);
-    void allEncodedSamplesFlushed(void);
+    void allEncodedSamplesFlushed(Client *client);
     void heartbeat(Async::Timer *t);
     //void checkSiglev(Async::Timer *t);
     void unmuteTx(Async::Timer *t);
     void setFallbackActive(bool activate);
     void signalLevelUpdated(float siglev);
-    void forceDisconnect(void);
-    void setState(State new_state) { state = new_state; }
+    void forceDisconnect(Client *client);
 
 };  /* class NetUplink */
 
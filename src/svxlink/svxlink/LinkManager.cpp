@@ -255,9 +255,15 @@ bool LinkManager::initialize(Async::Config &cfg,
   if(!init_ok)
   {
     deleteInstance();
+    return false;
   }
 
-  return init_ok;
+    // Find out which logic connections that can ever be established so that
+    // audio connectors only are created where they may be needed
+  LinkManager::instance()->possibleConnections(
+      LinkManager::instance()->possible_cons);
+
+  return true;
 
 } /* LinkManager::initialize */
 
@@ -271,17 +277,20 @@ void LinkManager::addLogic(LogicBase *logic)
   assert(logic->logicConOut() != 0);
   assert(logic->logicConIn() != 0);
 
-    // Create a splitter to split the source audio from the logic being added
-    // to all other logics.
-  AudioSplitter *splitter = new AudioSplitter;
-  logic->logicConOut()->registerSink(splitter);
-
-    // Register the new logic source
-  sources[logic->name()].source = logic->logicConOut();
-  sources[logic->name()].splitter = splitter;
+    // Register the new logic source. A splitter is only needed if the
+    // logic may send audio to more than one other logic. If there is only
+    // one possible sink, the logic source is connected directly to it.
+  SourceInfo &source_info = sources[logic->name()];
+  source_info.source = logic->logicConOut();
+  source_info.splitter = 0;
+  if (possibleSinkCount(logic->name()) > 1)
+  {
+    source_info.splitter = new AudioSplitter;
+    source_info.source->registerSink(source_info.splitter);
+  }
 
-    // Create a selector for the logic being added to receive audio from all
-    // other sinks.
+    // Create a selector for the logic being added to receive audio from
+    // other logics.
   AudioSelector *selector = new AudioSelector;
   selector->registerSink(logic->logicConIn());
 
@@ -289,23 +298,18 @@ void LinkManager::addLogic(LogicBase *logic)
   sinks[logic->name()].sink = logic->logicConIn();
   sinks[logic->name()].selector = selector;
 
-    // Now create a connection from the new logic source to each sink.
-  for (SinkMap::iterator it=sinks.begin(); it != sinks.end(); ++it)
+    // Create connectors to and from the already added logics that the new
+    // logic may be connected to by the configured links
+  for (const auto& con : possible_cons)
   {
-    AudioPassthrough *connector = new AudioPassthrough;
-    splitter->addSink(connector, true);
-    AudioSelector *other_selector = (*it).second.selector;
-    other_selector->addSource(connector);
-    (*it).second.connectors[logic->name()] = connector;
-  }
-
-    // Now create a connection from each existing logic source to the new sink.
-  for (SourceMap::iterator it=sources.begin(); it!=sources.end(); ++it)
-  {
-    AudioPassthrough *connector = new AudioPassthrough;
-    (*it).second.splitter->addSink(connector, true);
-    selector->addSource(connector);
-    sinks[logic->name()].connectors[(*it).first] = connector;
+    if ((con.first == logic->name()) && (sinks.count(con.second) > 0))
+    {
+      addConnector(con.first, con.second);
+    }
+    else if ((con.second == logic->name()) && (sources.count(con.first) > 0))
+    {
+      addConnector(con.first, con.second);
+    }
   }
 
     // Create new object containing metadata for this logic core
@@ -377,34 +381,38 @@ void LinkManager::deleteLogic(LogicBase *logic)
   assert(logic_info.received_publish_state_event_con.connected());
   logic_info.received_publish_state_event_con.disconnect();
 
-    // Delete the logic source splitter and all connections associated with it
-  AudioSplitter *splitter = sources[logic->name()].splitter;
+    // Forget about established connections to and from the logic
+  LogicConSet::iterator ccit = current_cons.begin();
+  while (ccit != current_cons.end())
+  {
+    if ((ccit->first == logic->name()) || (ccit->second == logic->name()))
+    {
+      ccit = current_cons.erase(ccit);
+    }
+    else
+    {
+      ++ccit;
+    }
+  }
+
+    // Delete all connections from the logic source and then the splitter
   for (SinkMap::iterator smit=sinks.begin(); smit!=sinks.end(); ++smit)
   {
-    SinkInfo &sink_info = (*smit).second;
-    ConMap::iterator cmit = sink_info.connectors.find(logic->name());
-    assert(cmit != sink_info.connectors.end());
-    AudioPassthrough *connector = (*cmit).second;
-    sink_info.selector->removeSource(connector);
-    sink_info.connectors.erase(logic->name());
-    splitter->removeSink(connector);
-    //delete connector;
+    if ((*smit).second.connectors.count(logic->name()) > 0)
+    {
+      removeConnector(logic->name(), (*smit).first);
+    }
   }
-  delete splitter;
+  delete sources[logic->name()].splitter;
   sources.erase(logic->name());
-  
-    // Delete the logic sink and all connections associated with it
-  AudioSelector *selector = sinks[logic->name()].selector;
-  ConMap &cons = sinks[logic->name()].connectors;
+
+    // Delete all connections to the logic sink and then the selector
+  ConMap cons = sinks[logic->name()].connectors;
   for (ConMap::iterator cmit = cons.begin(); cmit != cons.end(); ++cmit)
   {
-    AudioPassthrough *connector = (*cmit).second;
-    selector->removeSource(connector);
-    const string &source_name = (*cmit).first;
-    sources[source_name].splitter->removeSink(connector);
-    //delete connector;
+    removeConnector((*cmit).first, logic->name());
   }
-  delete selector;
+  delete sinks[logic->name()].selector;
   sinks.erase(logic->name());
 
     // Finally remove the logic from the logic_map
@@ -672,7 +680,45 @@ void LinkManager::wantedConnections(LogicConSet &want)
     // Now we need to complete the graph with connections between logics that
     // are implicitly connected. That is, logics that are connected to each
     // other via other logics.
-    //
+  addImplicitConnections(want);
+} /* LinkManager::wantedConnections */
+
+/**
+ * @brief Find out which logics that may be connected by the configured links
+ * @param possible The connections that may be established
+ *
+ * This function will calculate the set of logic connections that would be
+ * established if all configured links were activated at the same time. No
+ * other connections can ever be wanted so audio connectors are only needed
+ * for the connections in this set.
+ */
+void LinkManager::possibleConnections(LogicConSet &possible)
+{
+  for (LinkMap::iterator lit = links.begin(); lit != links.end(); ++lit)
+  {
+    const LogicPropMap &logic_props = (*lit).second.logic_props;
+    for (LogicPropMap::const_iterator oit = logic_props.begin();
+         oit != logic_props.end();
+         ++oit)
+    {
+      LogicPropMap::const_iterator iit = oit;
+      for (++iit; iit != logic_props.end(); ++iit)
+      {
+        possible.insert(make_pair((*oit).first, (*iit).first));
+        possible.insert(make_pair((*iit).first, (*oit).first));
+      }
+    }
+  }
+  addImplicitConnections(possible);
+} /* LinkManager::possibleConnections */
+
+
+/**
+ * @brief Add connections between logics that are connected via other logics
+ * @param cons The connection set to complete
+ */
+void LinkManager::addImplicitConnections(LogicConSet &cons)
+{
     // The algoritm below is not very optimized but that should not be needed
     // since SvxLink most often just have a few logics defined. If a lot of
     // logics is used, the code below may have to be optimized.
@@ -686,16 +732,16 @@ void LinkManager::wantedConnections(LogicConSet &want)
   {
       // Store the current size of the connection set so that we can check
       // later if new connections have been added.
-    prev_size = want.size();
+    prev_size = cons.size();
 
       // Now compare all connections to each other. This requires two loops,
       // an outer (oit=outer iterator) and an inner (iit=inner iterator).
-    for (LogicConSet::iterator oit = want.begin();
-         oit != want.end();
+    for (LogicConSet::iterator oit = cons.begin();
+         oit != cons.end();
          ++oit)
     {
-      for (LogicConSet::iterator iit = want.begin();
-           iit != want.end();
+      for (LogicConSet::iterator iit = cons.begin();
+           iit != cons.end();
            ++iit)
       {
           // If the sink of the outer connection belongs to the same logic
@@ -710,12 +756,63 @@ void LinkManager::wantedConnections(LogicConSet &want)
           // not connect <L1,L1>.
         if ((oit->second == iit->first) && (oit->first != iit->second))
         {
-          want.insert(make_pair(oit->first, iit->second));
+          cons.insert(make_pair(oit->first, iit->second));
         }
       }
     }
-  } while (want.size() > prev_size);
-} /* LinkManager::wantedConnections */
+  } while (cons.size() > prev_size);
+} /* LinkManager::addImplicitConnections */
+
+
+unsigned LinkManager::possibleSinkCount(const std::string& src_name) const
+{
+  unsigned cnt = 0;
+  for (const auto& con : possible_cons)
+  {
+    cnt += (con.first == src_name) ? 1 : 0;
+  }
+  return cnt;
+} /* LinkManager::possibleSinkCount */
+
+
+void LinkManager::addConnector(const std::string& src_name,
+                               const std::string& sink_name)
+{
+  SourceInfo &source_info = sources.at(src_name);
+  SinkInfo &sink_info = sinks.at(sink_name);
+  assert(sink_info.connectors.count(src_name) == 0);
+
+  AudioSource *connector = source_info.source;
+  if (source_info.splitter != 0)
+  {
+    AudioPassthrough *branch = new AudioPassthrough;
+    source_info.splitter->addSink(branch, true);
+    connector = branch;
+  }
+  sink_info.selector->addSource(connector);
+  sink_info.connectors[src_name] = connector;
+} /* LinkManager::addConnector */
+
+
+void LinkManager::removeConnector(const std::string& src_name,
+                                  const std::string& sink_name)
+{
+  SinkInfo &sink_info = sinks.at(sink_name);
+  ConMap::iterator cmit = sink_info.connectors.find(src_name);
+  assert(cmit != sink_info.connectors.end());
+  AudioSource *connector = (*cmit).second;
+  sink_info.connectors.erase(cmit);
+  sink_info.selector->removeSource(connector);
+
+    // A connector that is not the logic source itself is a managed splitter
+    // branch which is deleted by the splitter.
+  SourceInfo &source_info = sources.at(src_name);
+  if (source_info.splitter != 0)
+  {
+    source_info.splitter->removeSink(
+        static_cast<AudioPassthrough *>(connector));
+  }
+} /* LinkManager::removeConnector */
 
 
 void LinkManager::updateConnections(void)
@@ -816,7 +913,7 @@ bool LinkManager::isConnected(const string& source_name,
   assert(sinks.count(sink_name) == 1);
   assert(sinks[sink_name].connectors.count(source_name) == 1);
 
-  AudioPassthrough *connector = sinks[sink_name].connectors[source_name];
+  AudioSource *connector = sinks[sink_name].connectors[source_name];
   AudioSelector *selector = sinks[sink_name].selector;
   return selector->autoSelectEnabled(connector);
 } /* LinkManager::isConnected */
@@ -71,10 +71,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
-namespace Async
-{
-  class AudioPassthrough;
-};
 class LogicBase;
 
 
@@ -138,6 +134,12 @@ class LogicBase;
  * manually connected again using DTMF command 941 from the RepeaterLogic side.
  * It is not possible to control the link from the SimplexLogic side since no
  * command has been specified.
+ *
+ * Audio connectors are only created between logic cores that can be
+ * connected by the configured links, directly or via other logic cores. A
+ * logic core that is not part of any link is not connected to the switching
+ * matrix at all. A logic core that can only send audio to one other logic
+ * core feed the selector of that logic core directly, without a splitter.
  */
 class LinkManager : public sigc::trackable
 {
@@ -307,9 +309,9 @@ class LinkManager : public sigc::trackable
     struct SourceInfo
     {
       Async::AudioSource      *source;
-      Async::AudioSplitter    *splitter;
+      Async::AudioSplitter    *splitter;  // Null if there is at most one sink
     };
-    typedef std::map<std::string, Async::AudioPassthrough *> ConMap;
+    typedef std::map<std::string, Async::AudioSource *> ConMap;
     struct SinkInfo
     {
       Async::AudioSink      *sink;
@@ -334,6 +336,7 @@ class LinkManager : public sigc::trackable
     LinkMap     links;
     LogicMap    logic_map;
     LogicConSet current_cons;
+    LogicConSet possible_cons;
     SourceMap   sources;
     SinkMap     sinks;
     bool        all_logics_started;
@@ -344,6 +347,13 @@ class LinkManager : public sigc::trackable
 
     std::vector<std::string> getLinkNames(const std::string& logicname);
     void wantedConnections(LogicConSet &want);
+    void possibleConnections(LogicConSet &possible);
+    void addImplicitConnections(LogicConSet &cons);
+    unsigned possibleSinkCount(const std::string& src_name) const;
+    void addConnector(const std::string& src_name,
+                      const std::string& sink_name);
+    void removeConnector(const std::string& src_name,
+                         const std::string& sink_name);
     void updateConnections(void);
     void activateLink(Link &link);
     void deactivateLink(Link &link);
@@ -50,6 +50,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <map>
 #include <list>
 #include <vector>
+#include <chrono>
 
 
 /****************************************************************************
@@ -58,6 +59,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <AsyncApplication.h>
 #include <AsyncConfig.h>
 #include <AsyncTimer.h>
 #include <Rx.h>
@@ -73,6 +75,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncAudioPacer.h>
 #include <AsyncAudioDebugger.h>
 #include <AsyncAudioRecorder.h>
+#include <AsyncAudioProbe.h>
 #include <common.h>
 #include <config.h>
 
@@ -169,7 +172,8 @@ Logic::Logic(void)
     tx_ctcss_mask(0),
     currently_set_tx_ctrl_mode(Tx::TX_OFF), is_online(true),
     dtmf_digit_handler(0),                  state_pty(0),
-    dtmf_ctrl_pty(0),                       command_pty(0)
+    dtmf_ctrl_pty(0),                       command_pty(0),
+    module_load_pending(false)
 {
   rgr_sound_timer.expired.connect(sigc::hide(
         mem_fun(*this, &Logic::sendRgrSound)));
@@ -616,15 +620,17 @@ bool Logic::initialize(Async::Config& cfgobj, const std::string& logic_name)
 
   loadModules();
 
+    // The module event handlers need to know about all modules, also the
+    // ones that have not been loaded yet
   string loaded_modules;
-  list<Module*>::const_iterator mit;
-  for (mit=modules.begin(); mit!=modules.end(); ++mit)
+  vector<ModuleSpec>::const_iterator mit;
+  for (mit=module_specs.begin(); mit!=module_specs.end(); ++mit)
   {
     if (!loaded_modules.empty())
     {
       loaded_modules += " ";
     }
-    loaded_modules += (*mit)->name();
+    loaded_modules += mit->name;
   }
   event_handler->setVariable("loaded_modules", loaded_modules);
 
@@ -639,11 +645,20 @@ bool Logic::initialize(Async::Config& cfgobj, const std::string& logic_name)
     event_handler->setVariable(var, value);
   }
 
+  auto tcl_start = std::chrono::steady_clock::now();
   if (!event_handler->initialize())
   {
     cleanup();
     return false;
   }
+  cout << "\tEvent handler initialized in "
+       << std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - tcl_start).count()
+       << "ms" << endl;
+
+    // Load the modules from the main loop so that the logic core is up and
+    // running while the modules initialize
+  scheduleModuleLoad();
 
   if (LocationInfo::has_instance())
   {
@@ -870,6 +885,16 @@ Module *Logic::findModule(int id)
     }
   }
 
+    // Load the module now if it has not been loaded yet
+  vector<ModuleSpec>::iterator sit;
+  for (sit=module_specs.begin(); sit!=module_specs.end(); ++sit)
+  {
+    if ((sit->id == id) && !sit->load_attempted)
+    {
+      return loadModule(*sit);
+    }
+  }
+
   return 0;
 
 } /* Logic::findModule */
@@ -886,11 +911,36 @@ Module *Logic::findModule(const string& name)
     }
   }
 
+    // Load the module now if it has not been loaded yet
+  vector<ModuleSpec>::iterator sit;
+  for (sit=module_specs.begin(); sit!=module_specs.end(); ++sit)
+  {
+    if ((sit->name == name) && !sit->load_attempted)
+    {
+      return loadModule(*sit);
+    }
+  }
+
   return 0;
 
 } /* Logic::findModule */
 
 
+list<pair<int, string> > Logic::availableModules(void) const
+{
+  list<pair<int, string> > available;
+  vector<ModuleSpec>::const_iterator it;
+  for (it=module_specs.begin(); it!=module_specs.end(); ++it)
+  {
+    if (!it->load_failed)
+    {
+      available.push_back(make_pair(it->id, it->name));
+    }
+  }
+  return available;
+} /* Logic::availableModules */
+
+
 void Logic::dtmfDigitDetected(char digit, int duration)
 {
   if (active_module != 0)
@@ -1129,11 +1179,31 @@ void Logic::commandPtyCmdReceived(const void *buf, size_t count)
     }
     cfg().setValue(section, tag, value);
   }
+  else if (cmd == "AUDIO_PROFILE")
+  {
+    std::string subcmd;
+    ss >> subcmd;
+    if (subcmd.empty())
+    {
+      Async::AudioProbe::printAll(std::cout);
+    }
+    else if (subcmd == "RESET")
+    {
+      Async::AudioProbe::resetAll();
+    }
+    else
+    {
+      std::cerr << "*** ERROR: Invalid PTY command in logic "
+                << name() << ": \"" << cmdline << "\". "
+                << "Usage: AUDIO_PROFILE [RESET]"
+                << std::endl;
+    }
+  }
   else
   {
     std::cerr << "*** ERROR: Unknown PTY command in logic "
               << name() << ": \"" << cmdline << "\". "
-              << "Valid commands are: CFG"
+              << "Valid commands are: CFG, AUDIO_PROFILE"
               << std::endl;
   }
 } /* Logic::commandPtyCmdReceived */
@@ -1259,32 +1329,94 @@ void Logic::loadModules(void)
     if (comma == modules.end())
     {
       string module_name(begin, modules.end());
-      loadModule(module_name);
+      registerModule(module_name);
     }
     else
     {
       string module_name(begin, comma);
-      loadModule(module_name);
+      registerModule(module_name);
       begin = comma + 1;
     }
   } while (comma != modules.end());
 } /* Logic::loadModules */
 
 
-void Logic::loadModule(const string& module_cfg_name)
+/*
+ * @brief: Register a module without loading it
+ *
+ * Everything that need to be in place before the event handler is
+ * initialized, or that is needed to activate the module, is set up here.
+ * The module plugin itself is loaded later by loadModule.
+ */
+bool Logic::registerModule(const string& module_cfg_name)
 {
+  ModuleSpec spec;
+  spec.cfg_name = module_cfg_name;
+  spec.name = module_cfg_name;
+  cfg().getValue(module_cfg_name, "NAME", spec.name);
+  spec.id = -1;
+  cfg().getValue(module_cfg_name, "ID", spec.id);
+  spec.load_on_demand = false;
+  cfg().getValue(module_cfg_name, "LOAD_ON_DEMAND", spec.load_on_demand);
+  spec.load_attempted = false;
+  spec.load_failed = false;
+
+    // Define the module namespace and its configuration variables so that
+    // the module event handler is set up even if the module is not loaded
+  event_handler->processEvent("namespace eval " + spec.name + " {}");
+  list<string> vars = cfg().listSection(module_cfg_name);
+  list<string>::const_iterator cfgit;
+  for (cfgit=vars.begin(); cfgit!=vars.end(); ++cfgit)
+  {
+    string value;
+    cfg().getValue(module_cfg_name, *cfgit, value);
+    event_handler->setVariable(spec.name + "::CFG_" + *cfgit, value);
+  }
+
+  if (spec.id >= 0)
+  {
+    stringstream ss;
+    ss << spec.id;
+    ModuleActivateCmd *cmd = new ModuleActivateCmd(&cmd_parser, ss.str(), this);
+    if (!cmd->addToParser())
+    {
+      cerr << "\n*** ERROR: Failed to add module activation command for "
+           << "module \"" << module_cfg_name << "\" in logic \"" << name()
+           << "\". This is probably due to having set up two modules with the "
+           << "same module id or choosing a module id that is the same as "
+           << "another command.\n\n";
+      delete cmd;
+      return false;
+    }
+  }
+
+  if (spec.load_on_demand)
+  {
+    std::cout << name() << ": Module \"" << module_cfg_name
+              << "\" will be loaded on demand" << std::endl;
+  }
+
+  module_specs.push_back(spec);
+  return true;
+
+} /* Logic::registerModule */
+
+
+Module *Logic::loadModule(ModuleSpec& spec)
+{
+  const string& module_cfg_name = spec.cfg_name;
+  spec.load_attempted = true;
+  spec.load_failed = true;
+
   std::cout << name() << ": Loading module \"" << module_cfg_name << "\""
             << std::endl;
 
+  auto load_start = std::chrono::steady_clock::now();
+
   string module_path;
   cfg().getValue("GLOBAL", "MODULE_PATH", module_path);
 
-  string plugin_name = module_cfg_name;
-  cfg().getValue(module_cfg_name, "NAME", plugin_name);
-
-    // Define the module namespace so that we can set some variables in it
-  event_handler->processEvent("namespace eval " + plugin_name + " {}");
-
+  string plugin_name = spec.name;
   cfg().getValue(module_cfg_name, "PLUGIN_NAME", plugin_name);
 
   void *handle = NULL;
@@ -1298,7 +1430,7 @@ void Logic::loadModule(const string& module_cfg_name)
       cerr << "*** ERROR: Failed to load module "
         << module_cfg_name.c_str() << " into logic " << name() << ": "
         << dlerror() << endl;
-      return;
+      return 0;
     }
   }
   else
@@ -1314,7 +1446,7 @@ void Logic::loadModule(const string& module_cfg_name)
         cerr << "*** ERROR: Failed to load module "
           << module_cfg_name.c_str() << " into logic " << name() << ": "
           << dlerror() << endl;
-        return;
+        return 0;
       }
     }
   }
@@ -1326,7 +1458,7 @@ void Logic::loadModule(const string& module_cfg_name)
       	 << module_cfg_name.c_str() << " in logic " << name() << ": "
          << dlerror() << endl;
     dlclose(handle);
-    return;
+    return 0;
   }
   cout << "\tFound " << link_map->l_name << endl;
 
@@ -1337,16 +1469,18 @@ void Logic::loadModule(const string& module_cfg_name)
       	 << module_cfg_name.c_str() << " in logic " << name() << ": "
          << dlerror() << endl;
     dlclose(handle);
-    return;
+    return 0;
   }
 
+  auto init_start = std::chrono::steady_clock::now();
+
   Module *module = init(handle, this, module_cfg_name.c_str());
   if (module == 0)
   {
     cerr << "*** ERROR: Creation failed for module "
       	 << module_cfg_name.c_str() << " in logic " << name() << endl;
     dlclose(handle);
-    return;
+    return 0;
   }
 
   if (!module->initialize())
@@ -1355,26 +1489,7 @@ void Logic::loadModule(const string& module_cfg_name)
       	 << module_cfg_name.c_str() << " in logic " << name() << endl;
     delete module;
     dlclose(handle);
-    return;
-  }
-
-  if (module->id() >= 0)
-  {
-    stringstream ss;
-    ss << module->id();
-    ModuleActivateCmd *cmd = new ModuleActivateCmd(&cmd_parser, ss.str(), this);
-    if (!cmd->addToParser())
-    {
-      cerr << "\n*** ERROR: Failed to add module activation command for "
-           << "module \"" << module_cfg_name << "\" in logic \"" << name()
-           << "\". This is probably due to having set up two modules with the "
-           << "same module id or choosing a module id that is the same as "
-           << "another command.\n\n";
-      delete cmd;
-      delete module;
-      dlclose(handle);
-      return;
-    }
+    return 0;
   }
 
     // Connect module audio output to the module audio selector
@@ -1386,10 +1501,64 @@ void Logic::loadModule(const string& module_cfg_name)
   audio_to_module_splitter->enableSink(module, false);
 
   modules.push_back(module);
+  spec.load_failed = false;
+
+  auto load_end = std::chrono::steady_clock::now();
+  cout << "\tModule " << module->name() << " loaded in "
+       << std::chrono::duration_cast<std::chrono::milliseconds>(
+            load_end - load_start).count()
+       << "ms (initialization "
+       << std::chrono::duration_cast<std::chrono::milliseconds>(
+            load_end - init_start).count()
+       << "ms)" << endl;
+
+  return module;
 
 } /* Logic::loadModule */
 
 
+void Logic::scheduleModuleLoad(void)
+{
+  if (module_load_pending)
+  {
+    return;
+  }
+  vector<ModuleSpec>::const_iterator it;
+  for (it=module_specs.begin(); it!=module_specs.end(); ++it)
+  {
+    if (!it->load_on_demand && !it->load_attempted)
+    {
+      module_load_pending = true;
+      Async::Application::app().runTask(
+          mem_fun(*this, &Logic::loadNextModule));
+      return;
+    }
+  }
+} /* Logic::scheduleModuleLoad */
+
+
+/*
+ * @brief: Load the next module that is not loaded on demand
+ *
+ * Only one module is loaded for each main loop iteration so that audio and
+ * other events are handled in between.
+ */
+void Logic::loadNextModule(void)
+{
+  module_load_pending = false;
+  vector<ModuleSpec>::iterator it;
+  for (it=module_specs.begin(); it!=module_specs.end(); ++it)
+  {
+    if (!it->load_on_demand && !it->load_attempted)
+    {
+      loadModule(*it);
+      break;
+    }
+  }
+  scheduleModuleLoad();
+} /* Logic::loadNextModule */
+
+
 void Logic::unloadModules(void)
 {
   deactivateModule(0);
@@ -1402,6 +1571,7 @@ void Logic::unloadModules(void)
     dlclose(plugin_handle);
   }
   modules.clear();
+  module_specs.clear();
 } /* logic::unloadModules */
 
 
@@ -184,6 +184,16 @@ class Logic : public LogicBase
     Module *findModule(const std::string& name);
     std::list<Module*> moduleList(void) const { return modules; }
 
+    /**
+     * @brief   Get the id and name of all configured modules
+     * @return  Returns a list of id/name pairs in configuration order
+     *
+     * Modules that are configured to be loaded on demand, or that have not
+     * been loaded in the background yet, are included in the list. Modules
+     * that failed to load are not.
+     */
+    std::list<std::pair<int, std::string> > availableModules(void) const;
+
     const std::string& callsign(void) const { return m_callsign; }
 
     Rx &rx(void) const { return *m_rx; }
@@ -248,6 +258,16 @@ class Logic : public LogicBase
       time_t last_tx_sec;
     };
 
+    struct ModuleSpec
+    {
+      std::string cfg_name;
+      std::string name;
+      int         id;
+      bool        load_on_demand;
+      bool        load_attempted;
+      bool        load_failed;
+    };
+
     Rx	      	      	      	    *m_rx;
     Tx	      	      	      	    *m_tx;
     MsgHandler	      	      	    *msg_handler;
@@ -295,9 +315,14 @@ class Logic : public LogicBase
     Async::Pty                      *dtmf_ctrl_pty;
     std::map<uint16_t, uint32_t>    m_ctcss_to_tg;
     Async::Pty                      *command_pty;
+    std::vector<ModuleSpec>         module_specs;
+    bool                            module_load_pending;
 
     void loadModules(void);
-    void loadModule(const std::string& module_name);
+    bool registerModule(const std::string& module_cfg_name);
+    Module *loadModule(ModuleSpec& spec);
+    void scheduleModuleLoad(void);
+    void loadNextModule(void);
     void unloadModules(void);
     void processCommandQueue(void);
     void processCommand(const std::string &cmd, bool force_core_cmd=false);
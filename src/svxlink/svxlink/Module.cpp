@@ -241,6 +241,12 @@ list<Module*> Module::moduleList(void)
 } /* Module::moduleList */
 
 
+list<pair<int, string> > Module::availableModules(void)
+{
+  return logic()->availableModules();
+} /* Module::availableModules */
+
+
 void Module::setIdle(bool is_idle)
 {
   if (m_tmo_timer != 0)
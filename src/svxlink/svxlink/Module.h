@@ -450,6 +450,16 @@ class Module : public sigc::trackable, public Async::AudioSink,
      * loaded into the same logic core as this module.
      */
     std::list<Module*> moduleList(void);
+
+    /**
+     * @brief 	Retrieve the id and name of all available modules
+     * @return	Returns a list of id/name pairs
+     *
+     * In contrast to moduleList, this list also contain modules that have
+     * not been loaded yet. Use findModule to get hold of, and load, one of
+     * these modules.
+     */
+    std::list<std::pair<int, std::string> > availableModules(void);
     
     /**
      * @brief 	Tell the logic core if the module is idle or not
@@ -97,9 +97,9 @@ using namespace Async;
 class QsoRecorder::FileEncoder : public Exec
 {
   public:
-    string basename;
-    FileEncoder(const char *shell, string basename)
-      : Exec(shell), basename(basename)
+    string filename;
+    FileEncoder(const char *shell, string filename)
+      : Exec(shell), filename(filename)
     {}
 };
 
@@ -142,7 +142,7 @@ namespace {
 QsoRecorder::QsoRecorder(Logic *logic)
   : recorder(0), hard_chunk_limit(0), soft_chunk_limit(0), max_dirsize(0),
     default_active(false), tmo_timer(0), logic(logic), qso_tmo_timer(0),
-    min_samples(0)
+    min_samples(0), file_ext("wav")
 {
   selector = new AudioSelector;
 } /* QsoRecorder::QsoRecorder */
@@ -165,6 +165,19 @@ bool QsoRecorder::initialize(const Config &cfg, const string &name)
     return false;
   }
 
+  string format("WAV");
+  cfg.getValue(name, "FORMAT", format);
+  if (format == "OPUS")
+  {
+    file_ext = "opus";
+  }
+  else if (format != "WAV")
+  {
+    cerr << "*** ERROR: Unknown format \"" << format << "\" specified in "
+         << name << "/FORMAT. Valid formats are WAV and OPUS.\n";
+    return false;
+  }
+
   unsigned max_time = 0;
   cfg.getValue(name, "MAX_TIME", max_time);
   unsigned soft_time = 0;
@@ -280,7 +293,7 @@ void QsoRecorder::openFile(void)
     string filename(rec_dir);
     filename += "/.qsorec_";
     filename += logic->name();
-    filename += ".wav";
+    filename += "." + file_ext;
     recorder = new AudioRecorder(filename);
     recorder->setMaxRecordingTime(hard_chunk_limit, soft_chunk_limit);
     recorder->maxRecordingTimeReached.connect(
@@ -301,7 +314,7 @@ void QsoRecorder::closeFile(void)
 {
   if (recorder != 0)
   {
-    string oldpath(rec_dir + "/.qsorec_" + logic->name() + ".wav");
+    string oldpath(rec_dir + "/.qsorec_" + logic->name() + "." + file_ext);
 
     if (!recorder->closeFile())
     {
@@ -327,32 +340,33 @@ void QsoRecorder::closeFile(void)
       localtime_r(&end_time.tv_sec, &tm);
       strftime(timestamp, sizeof(timestamp), "%Y-%m-%d_%H%M%S", &tm);
       basename += timestamp;
-      string newpath = rec_dir + "/" + basename + ".wav";
+      string filename(basename + "." + file_ext);
+      string newpath = rec_dir + "/" + filename;
       if (rename(oldpath.c_str(), newpath.c_str()) != 0)
       {
         perror("QsoRecorder rename");
       }
 
       cout << logic->name() << ": Wrote QSO recorder file "
-           << basename << ".wav\n";
+           << filename << "\n";
 
         // Execute external audio file handler (e.g. encoder) if configured
       if (!encoder_cmd.empty())
       {
         cout << logic->name() << ": Starting encoding for file "
-             << basename << ".wav\n";
+             << filename << "\n";
         const char *shell = getenv("SHELL");
         if (shell == NULL)
         {
           shell = "/bin/sh";
         }
-        FileEncoder *enc = new FileEncoder(shell, basename);
+        FileEncoder *enc = new FileEncoder(shell, filename);
         enc->appendArgument("-c");
         string cmdline(encoder_cmd);
         replace_all(cmdline, "%f", newpath);
         replace_all(cmdline, "%d", rec_dir);
         replace_all(cmdline, "%b", basename);
-        replace_all(cmdline, "%n", basename + ".wav");
+        replace_all(cmdline, "%n", filename);
         enc->appendArgument(cmdline);
         enc->stdoutData.connect(
             mem_fun(*this, &QsoRecorder::handleEncoderPrintouts));
@@ -465,7 +479,7 @@ void QsoRecorder::handleEncoderPrintouts(const char *buf, int cnt)
 void QsoRecorder::encoderExited(QsoRecorder::FileEncoder *enc)
 {
   cout << logic->name() << ": Encoding done for file "
-             << enc->basename << ".wav\n";
+             << enc->filename << "\n";
   if (enc->ifExited() && (enc->exitStatus() != 0))
   {
     cerr << "*** ERROR: QSO recorder external audio file handler in logic "
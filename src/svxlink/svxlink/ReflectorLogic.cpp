@@ -35,6 +35,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <fstream>
 #include <iomanip>
 #include <algorithm>
+#include <cstdlib>
 #include <iterator>
 #include <limits>
 
@@ -134,6 +135,9 @@ ReflectorLogic::ReflectorLogic(void)
   : m_msg_type(0), m_udp_sock(0),
     m_logic_con_in(0), m_logic_con_out(0),
     m_reconnect_timer(60000, Timer::TYPE_ONESHOT, false),
+    m_reconnect_min_time(2000), m_reconnect_max_time(120000),
+    m_reconnect_backoff_percent(100), m_reconnect_randomize_percent(100),
+    m_reconnect_time(m_reconnect_min_time),
     m_next_udp_tx_seq(0), m_next_udp_rx_seq(0),
     m_heartbeat_timer(1000, Timer::TYPE_PERIODIC, false), m_dec(0),
     m_flush_timeout_timer(3000, Timer::TYPE_ONESHOT, false),
@@ -248,6 +252,20 @@ bool ReflectorLogic::initialize(Async::Config& cfgobj, const std::string& logic_
     }
   }
 
+  cfg().getValue(name(), "RECONNECT_MIN_TIME", m_reconnect_min_time);
+  cfg().getValue(name(), "RECONNECT_MAX_TIME", m_reconnect_max_time);
+  cfg().getValue(name(), "RECONNECT_BACKOFF_PERCENT",
+                 m_reconnect_backoff_percent);
+  cfg().getValue(name(), "RECONNECT_RANDOMIZE_PERCENT",
+                 m_reconnect_randomize_percent);
+  m_reconnect_min_time = std::max(m_reconnect_min_time, 100U);
+  m_reconnect_max_time = std::max(m_reconnect_max_time, m_reconnect_min_time);
+  m_reconnect_time = m_reconnect_min_time;
+  m_con.setReconnectMinTime(m_reconnect_min_time);
+  m_con.setReconnectMaxTime(m_reconnect_max_time);
+  m_con.setReconnectBackoffPercent(m_reconnect_backoff_percent);
+  m_con.setReconnectRandomizePercent(m_reconnect_randomize_percent);
+
   if (!cfg().getValue(name(), "CALLSIGN", m_callsign) || m_callsign.empty())
   {
     std::cerr << "*** ERROR: " << name()
@@ -760,6 +778,7 @@ void ReflectorLogic::onConnected(void)
             << m_con.remoteHost() << ":" << m_con.remotePort()
             << " (" << (m_con.isPrimary() ? "primary" : "secondary") << ")"
             << std::endl;
+  m_proto_ver.set(MsgProtoVer::MAJOR, MsgProtoVer::MINOR);
   sendMsg(MsgProtoVer());
   m_udp_heartbeat_tx_cnt = m_udp_heartbeat_tx_cnt_reset;
   m_udp_heartbeat_rx_cnt = UDP_HEARTBEAT_RX_CNT_RESET;
@@ -781,8 +800,18 @@ void ReflectorLogic::onDisconnected(TcpConnection *con,
   cout << name() << ": Disconnected from " << m_con.remoteHost() << ":"
        << m_con.remotePort() << ": "
        << TcpConnection::disconnectReasonStr(reason) << endl;
-  //m_reconnect_timer.setTimeout(1000 + std::rand() % 5000);
-  m_reconnect_timer.setEnable(reason == TcpConnection::DR_ORDERED_DISCONNECT);
+    // The TCP client handle reconnects after connection failures by itself.
+    // When we disconnected on purpose, e.g. on a protocol error or when the
+    // server rejected the login, we need to reconnect ourselves. A randomized
+    // and increasing delay is used so that nodes do not all come back at the
+    // same time.
+  if (reason == TcpConnection::DR_ORDERED_DISCONNECT)
+  {
+    unsigned reconnect_time = nextReconnectTime();
+    cout << name() << ": Reconnecting in " << reconnect_time << "ms" << endl;
+    m_reconnect_timer.setTimeout(reconnect_time);
+    m_reconnect_timer.setEnable(true);
+  }
   delete m_udp_sock;
   m_udp_sock = 0;
   m_next_udp_tx_seq = 0;
@@ -856,6 +885,9 @@ void ReflectorLogic::onFrameReceived(FramedTcpConnection *con,
     case MsgNodeJoined::TYPE:
       handleMsgNodeJoined(ss);
       break;
+    case MsgNodesJoined::TYPE:
+      handleMsgNodesJoined(ss);
+      break;
     case MsgNodeLeft::TYPE:
       handleMsgNodeLeft(ss);
       break;
@@ -904,11 +936,19 @@ void ReflectorLogic::handleMsgProtoVerDowngrade(std::istream& is)
     disconnect();
     return;
   }
-  cout << name() << ": Server too old and we cannot downgrade to protocol version "
-       << msg.majorVer() << "." << msg.minorVer() << " from "
-       << MsgProtoVer::MAJOR << "." << MsgProtoVer::MINOR
-       << endl;
-  disconnect();
+  ProtoVer server_ver(msg.majorVer(), msg.minorVer());
+  if ((server_ver < ProtoVer(2, 0)) || !(server_ver < m_proto_ver))
+  {
+    cout << name() << ": Server too old and we cannot downgrade to protocol "
+            "version " << msg.majorVer() << "." << msg.minorVer() << " from "
+         << m_proto_ver.majorVer() << "." << m_proto_ver.minorVer() << endl;
+    disconnect();
+    return;
+  }
+  cout << name() << ": Downgrading to protocol version "
+       << msg.majorVer() << "." << msg.minorVer() << endl;
+  m_proto_ver = server_ver;
+  sendMsg(MsgProtoVer(msg.majorVer(), msg.minorVer()));
 } /* ReflectorLogic::handleMsgProtoVerDowngrade */
 
 
@@ -1005,6 +1045,10 @@ void ReflectorLogic::handleMsgServerInfo(std::istream& is)
       break;
     }
   }
+  if (!selected_codec.empty() && (m_proto_ver >= ProtoVer(2, 1)))
+  {
+    sendMsg(MsgSelectCodec(selected_codec));
+  }
   cout << name() << ": ";
   if (!selected_codec.empty())
   {
@@ -1022,6 +1066,7 @@ void ReflectorLogic::handleMsgServerInfo(std::istream& is)
       mem_fun(*this, &ReflectorLogic::udpDatagramReceived));
 
   m_con_state = STATE_CONNECTED;
+  m_reconnect_time = m_reconnect_min_time;
 
   std::ostringstream node_info_os;
   Json::StreamWriterBuilder builder;
@@ -1135,6 +1180,25 @@ void ReflectorLogic::handleMsgNodeJoined(std::istream& is)
 } /* ReflectorLogic::handleMsgNodeJoined */
 
 
+void ReflectorLogic::handleMsgNodesJoined(std::istream& is)
+{
+  MsgNodesJoined msg;
+  if (!msg.unpack(is))
+  {
+    cerr << "*** ERROR[" << name() << "]: Could not unpack MsgNodesJoined\n";
+    disconnect();
+    return;
+  }
+  if (m_verbose)
+  {
+    for (const auto& callsign : msg.nodes())
+    {
+      std::cout << name() << ": Node joined: " << callsign << std::endl;
+    }
+  }
+} /* ReflectorLogic::handleMsgNodesJoined */
+
+
 void ReflectorLogic::handleMsgNodeLeft(std::istream& is)
 {
   MsgNodeLeft msg;
@@ -1468,6 +1532,16 @@ void ReflectorLogic::reconnect(void)
 } /* ReflectorLogic::reconnect */
 
 
+unsigned ReflectorLogic::nextReconnectTime(void)
+{
+  unsigned t = m_reconnect_time;
+  m_reconnect_time = std::min(
+      t + std::max(t * m_reconnect_backoff_percent / 100, 1U),
+      m_reconnect_max_time);
+  return t + std::rand() % std::max(t * m_reconnect_randomize_percent / 100, 1U);
+} /* ReflectorLogic::nextReconnectTime */
+
+
 bool ReflectorLogic::isConnected(void) const
 {
   return m_con.isConnected();
@@ -61,6 +61,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  ****************************************************************************/
 
 #include "LogicBase.h"
+#include "../reflector/ProtoVer.h"
 
 
 /****************************************************************************
@@ -216,11 +217,17 @@ class ReflectorLogic : public LogicBase
     unsigned                          m_msg_type;
     Async::UdpSocket*                 m_udp_sock;
     uint32_t                          m_client_id;
+    ProtoVer                          m_proto_ver;
     std::string                       m_auth_key;
     std::string                       m_callsign;
     Async::AudioStreamStateDetector*  m_logic_con_in;
     Async::AudioStreamStateDetector*  m_logic_con_out;
     Async::Timer                      m_reconnect_timer;
+    unsigned                          m_reconnect_min_time;
+    unsigned                          m_reconnect_max_time;
+    unsigned                          m_reconnect_backoff_percent;
+    unsigned                          m_reconnect_randomize_percent;
+    unsigned                          m_reconnect_time;
     uint16_t                          m_next_udp_tx_seq;
     uint16_t                          m_next_udp_rx_seq;
     Async::Timer                      m_heartbeat_timer;
@@ -269,6 +276,7 @@ class ReflectorLogic : public LogicBase
     void handleMsgAuthChallenge(std::istream& is);
     void handleMsgNodeList(std::istream& is);
     void handleMsgNodeJoined(std::istream& is);
+    void handleMsgNodesJoined(std::istream& is);
     void handleMsgNodeLeft(std::istream& is);
     void handleMsgTalkerStart(std::istream& is);
     void handleMsgTalkerStop(std::istream& is);
@@ -284,6 +292,7 @@ class ReflectorLogic : public LogicBase
     void connect(void);
     void disconnect(void);
     void reconnect(void);
+    unsigned nextReconnectTime(void);
     bool isConnected(void) const;
     bool isLoggedIn(void) const { return m_con_state == STATE_CONNECTED; }
     void allEncodedSamplesFlushed(void);
@@ -55,6 +55,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cstring>
 #include <set>
 #include <cerrno>
+#include <chrono>
 
 
 /****************************************************************************
@@ -68,6 +69,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncTimer.h>
 #include <AsyncFdWatch.h>
 #include <AsyncAudioIO.h>
+#include <AsyncAudioProbe.h>
 #include <LocationInfo.h>
 #include <common.h>
 #include <config.h>
@@ -128,12 +130,15 @@ static void stdout_handler(FdWatch *w);
 static void initialize_logics(Config &cfg);
 static void sighup_handler(int signal);
 static void sigterm_handler(int signal);
+static void sigusr1_handler(int signal);
 static void handle_unix_signal(int signum);
 static bool logfile_open(void);
 static void logfile_reopen(const char *reason);
 static bool logfile_write_timestamp(void);
 static void logfile_write(const char *buf);
 static void logfile_flush(void);
+static void startup_stage_done(const string& stage);
+static void print_startup_stages(void);
 
 
 /****************************************************************************
@@ -160,6 +165,9 @@ static vector<LogicBase*> logic_vec;
 static FdWatch	      	  *stdin_watch = 0;
 static FdWatch	      	  *stdout_watch = 0;
 static string         	  tstamp_format;
+static vector<pair<string, std::chrono::steady_clock::duration> >
+                          startup_stages;
+static std::chrono::steady_clock::time_point startup_stage_start;
 
 
 /****************************************************************************
@@ -188,10 +196,19 @@ int main(int argc, char **argv)
 {
   setlocale(LC_ALL, "");
 
+  startup_stage_start = std::chrono::steady_clock::now();
+
+    // Seed the pseudo random number generator so that the randomized
+    // reconnect delays differ between nodes
+  std::srand(static_cast<unsigned>(
+        std::chrono::system_clock::now().time_since_epoch().count()) ^
+      static_cast<unsigned>(getpid()));
+
   CppApplication app;
   app.catchUnixSignal(SIGHUP);
   app.catchUnixSignal(SIGINT);
   app.catchUnixSignal(SIGTERM);
+  app.catchUnixSignal(SIGUSR1);
   app.unixSignalCaught.connect(sigc::ptr_fun(&handle_unix_signal));
 
   parse_arguments(argc, const_cast<const char **>(argv));
@@ -480,6 +497,8 @@ int main(int argc, char **argv)
   cfg.getValue("GLOBAL", "CARD_CHANNELS", card_channels);
   AudioIO::setChannels(card_channels);
 
+  startup_stage_done("Configuration");
+
     // Init locationinfo
   if (cfg.getValue("GLOBAL", "LOCATION_INFO", value))
   {
@@ -489,6 +508,7 @@ int main(int argc, char **argv)
            << "check configuration section LOCATION_INFO=" << value << "\n";
       exit(1);
     }
+    startup_stage_done("LocationInfo");
   }
 
     // Init Logiclinking
@@ -500,6 +520,7 @@ int main(int argc, char **argv)
            << "GLOBAL/LINKS=" << value << ".\n";
       exit(1);
     }
+    startup_stage_done("Link manager");
   }
 
   initialize_logics(cfg);
@@ -507,8 +528,11 @@ int main(int argc, char **argv)
   if (LinkManager::hasInstance())
   {
     LinkManager::instance()->allLogicsStarted();
+    startup_stage_done("Logic linking");
   }
 
+  print_startup_stages();
+
   struct termios org_termios;
   if (logfile_name == 0)
   {
@@ -766,6 +790,7 @@ static void initialize_logics(Config &cfg)
     }
 
     logic_vec.push_back(logic);
+    startup_stage_done("Logic " + logic_name);
   } while (comma != logics.end());
   
   if (logic_vec.size() == 0)
@@ -810,6 +835,12 @@ static void sigterm_handler(int signal)
 } /* sigterm_handler */
 
 
+static void sigusr1_handler(int signal)
+{
+  AudioProbe::printAll(cout);
+} /* sigusr1_handler */
+
+
 static void handle_unix_signal(int signum)
 {
   switch (signum)
@@ -821,6 +852,9 @@ static void handle_unix_signal(int signum)
     case SIGTERM:
       sigterm_handler(signum);
       break;
+    case SIGUSR1:
+      sigusr1_handler(signum);
+      break;
   }
 } /* handle_unix_signal */
 
@@ -952,6 +986,37 @@ static void logfile_flush(void)
 
 
 
+/*
+ * Record the time spent since the previous startup stage was done
+ */
+static void startup_stage_done(const string& stage)
+{
+  auto now = std::chrono::steady_clock::now();
+  startup_stages.push_back(make_pair(stage, now - startup_stage_start));
+  startup_stage_start = now;
+} /* startup_stage_done */
+
+
+static void print_startup_stages(void)
+{
+  using std::chrono::milliseconds;
+  using std::chrono::duration_cast;
+
+  cout << "\n--- Startup time per stage:\n";
+  std::chrono::steady_clock::duration total(0);
+  vector<pair<string, std::chrono::steady_clock::duration> >::const_iterator it;
+  for (it=startup_stages.begin(); it!=startup_stages.end(); ++it)
+  {
+    cout << "\t" << setw(32) << left << it->first << right << setw(6)
+         << duration_cast<milliseconds>(it->second).count() << "ms\n";
+    total += it->second;
+  }
+  cout << "\t" << setw(32) << left << "Total" << right << setw(6)
+       << duration_cast<milliseconds>(total).count() << "ms" << endl;
+} /* print_startup_stages */
+
+
+
 /*
  * This file has not been truncated
  */
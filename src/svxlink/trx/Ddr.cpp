@@ -50,6 +50,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <algorithm>
 #include <iterator>
 #include <deque>
+#include <chrono>
 
 
 /****************************************************************************
@@ -970,7 +971,7 @@ class Ddr::Channel : public sigc::trackable, public Async::AudioSource
       : sample_rate(sample_rate), channelizer(0),
         fm_demod(32000, 5000.0), ssb_demod(16000), cw_demod(16000), demod(0),
         trans(sample_rate, fq_offset), enabled(true), ch_offset(0),
-        fq_offset(fq_offset)
+        fq_offset(fq_offset), profiling(false)
     {
     }
 
@@ -1078,15 +1079,37 @@ class Ddr::Channel : public sigc::trackable, public Async::AudioSource
 
     void iq_received(vector<WbRxRtlSdr::Sample> samples)
     {
-      if (enabled)
+      if (!enabled)
+      {
+        return;
+      }
+
+      vector<WbRxRtlSdr::Sample> translated, channelized;
+      if (!profiling)
       {
-        vector<WbRxRtlSdr::Sample> translated, channelized;
         trans.iq_received(translated, samples);
         channelizer->iq_received(channelized, translated);
         demod->iq_received(channelized);
+        return;
       }
+
+      Clock::time_point t0 = Clock::now();
+      trans.iq_received(translated, samples);
+      Clock::time_point t1 = Clock::now();
+      channelizer->iq_received(channelized, translated);
+      Clock::time_point t2 = Clock::now();
+      demod->iq_received(channelized);
+      Clock::time_point t3 = Clock::now();
+      stats.samples += samples.size();
+      stats.translate += t1 - t0;
+      stats.channelize += t2 - t1;
+      stats.demod += t3 - t2;
     };
 
+    void enableProfiling(bool enable) { profiling = enable; }
+    const IqStats& iqStats(void) const { return stats; }
+    void resetIqStats(void) { stats = IqStats(); }
+
     void enable(void)
     {
       enabled = true;
@@ -1113,6 +1136,8 @@ class Ddr::Channel : public sigc::trackable, public Async::AudioSource
     bool enabled;
     int ch_offset;
     int fq_offset;
+    bool profiling;
+    IqStats stats;
 }; /* Channel */
 
 
@@ -1228,6 +1253,9 @@ bool Ddr::initialize(void)
     return false;
   }
   channel->preDemod.connect(preDemod.make_slot());
+  bool iq_profiling = false;
+  cfg.getValue(name(), "AUDIO_PROFILING", iq_profiling);
+  channel->enableProfiling(iq_profiling);
   rtl->iqReceived.connect(mem_fun(*channel, &Channel::iq_received));
   rtl->readyStateChanged.connect(readyStateChanged.make_slot());
 
@@ -1260,6 +1288,30 @@ bool Ddr::initialize(void)
 } /* Ddr:initialize */
 
 
+void Ddr::enableIqProfiling(bool enable)
+{
+  if (channel != 0)
+  {
+    channel->enableProfiling(enable);
+  }
+} /* Ddr::enableIqProfiling */
+
+
+Ddr::IqStats Ddr::iqStats(void) const
+{
+  return (channel != 0) ? channel->iqStats() : IqStats();
+} /* Ddr::iqStats */
+
+
+void Ddr::resetIqStats(void)
+{
+  if (channel != 0)
+  {
+    channel->resetIqStats();
+  }
+} /* Ddr::resetIqStats */
+
+
 void Ddr::tunerFqChanged(uint32_t center_fq)
 {
   updateFqOffset();
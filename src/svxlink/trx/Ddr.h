@@ -37,6 +37,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
+#include <chrono>
+#include <cstdint>
 
 
 /****************************************************************************
@@ -118,6 +120,22 @@ extracted from this wideband signal and a demodulator is applied.
 class Ddr : public LocalRxBase
 {
   public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief   Accumulated processing time for the I/Q stages of a DDR
+     *
+     * The demod time include the processing of the whole audio chain that
+     * is fed synchronously from the demodulator.
+     */
+    struct IqStats
+    {
+      uint64_t          samples = 0;  ///< Wideband I/Q samples processed
+      Clock::duration   translate {}; ///< Time spent in frequency translation
+      Clock::duration   channelize {};///< Time spent in decimation/filtering
+      Clock::duration   demod {};     ///< Time spent in demod and audio chain
+    };
+
     static Ddr *find(const std::string &name);
 
     /**
@@ -185,6 +203,25 @@ class Ddr : public LocalRxBase
      * the channel samples available for other types of signal processing.
      */
     sigc::signal<void, const std::vector<RtlTcp::Sample>&> preDemod;
+
+    /**
+     * @brief   Enable or disable timing of the I/Q processing stages
+     * @param   enable Set to \em true to enable timing
+     *
+     * Timing is also enabled by the AUDIO_PROFILING configuration variable.
+     */
+    void enableIqProfiling(bool enable);
+
+    /**
+     * @brief   Get the accumulated I/Q stage timing
+     * @returns Returns the timing accumulated since the last reset
+     */
+    IqStats iqStats(void) const;
+
+    /**
+     * @brief   Reset the accumulated I/Q stage timing
+     */
+    void resetIqStats(void);
     
   protected:
     /**
@@ -41,6 +41,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cmath>
 #include <cstring>
 #include <limits>
+#include <sstream>
 #include <json/json.h>
 
 
@@ -62,6 +63,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncAudioFifo.h>
 #include <AsyncAudioStreamStateDetector.h>
 #include <AsyncAudioFsf.h>
+#include <AsyncAudioProbe.h>
 #include <AsyncUdpSocket.h>
 #include <common.h>
 
@@ -80,6 +82,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "multirate_filter_coeff.h"
 #include "Sel5Decoder.h"
 #include "AfskDemodulator.h"
+#include "FskDemodulator.h"
 #include "Synchronizer.h"
 #include "HdlcDeframer.h"
 #include "Tx.h"
@@ -237,7 +240,8 @@ LocalRxBase::LocalRxBase(Config &cfg, const std::string& name)
     tone_dets(0), sql_valve(0), delay(0), sql_tail_elim(0),
     preamp_gain(0), mute_valve(0), sql_hangtime(0), sql_extended_hangtime(0),
     sql_extended_hangtime_thresh(0), input_fifo(0), dtmf_muting_pre(0),
-    ob_afsk_deframer(0), ib_afsk_deframer(0), audio_dev_keep_open(false)
+    ob_afsk_deframer(0), ib_afsk_deframer(0), audio_dev_keep_open(false),
+    fullband_splitter(0), audio_profiling(false)
 {
 } /* LocalRxBase::LocalRxBase */
 
@@ -278,6 +282,8 @@ bool LocalRxBase::initialize(void)
   }
   
   cfg().getValue(name(), "PREAMP", preamp_gain);
+
+  cfg().getValue(name(), "AUDIO_PROFILING", audio_profiling);
   
   bool peak_meter = false;
   cfg().getValue(name(), "PEAK_METER", peak_meter);
@@ -322,7 +328,7 @@ bool LocalRxBase::initialize(void)
   {
     AudioAmp *preamp = new AudioAmp;
     preamp->setGain(preamp_gain);
-    prev_src->registerSink(preamp, true);
+    prev_src->registerSink(profiled(preamp, "Preamp"), true);
     prev_src = preamp;
   }
   
@@ -330,7 +336,7 @@ bool LocalRxBase::initialize(void)
   if (peak_meter)
   {
     PeakMeter *peak_meter = new PeakMeter(name());
-    prev_src->registerSink(peak_meter, true);
+    prev_src->registerSink(profiled(peak_meter, "PeakMeter"), true);
     prev_src = peak_meter;
   }
   
@@ -340,13 +346,14 @@ bool LocalRxBase::initialize(void)
   {
     AudioDecimator *d1 = new AudioDecimator(3, coeff_48_16_wide,
 					    coeff_48_16_wide_taps);
-    prev_src->registerSink(d1, true);
+    prev_src->registerSink(profiled(d1, "Decimator48to16"), true);
     prev_src = d1;
   }
 
   AudioSplitter *siglevdet_splitter = 0;
   siglevdet_splitter = new AudioSplitter;
-  prev_src->registerSink(siglevdet_splitter, true);
+  prev_src->registerSink(
+      profiled(siglevdet_splitter, "SigLevDetSplitter"), true);
   prev_src = 0;
 
     // Create the signal level detector
@@ -358,7 +365,7 @@ bool LocalRxBase::initialize(void)
   siglevdet->setIntegrationTime(0);
   siglevdet->signalLevelUpdated.connect(
       mem_fun(*this, &LocalRxBase::onSignalLevelUpdated));
-  siglevdet_splitter->addSink(siglevdet, true);
+  siglevdet_splitter->addSink(profiled(siglevdet, "SigLevDet"), true);
   dataReceived.connect(mem_fun(siglevdet, &SigLevDet::frameReceived));
 
     // Add a passthrough element to use as a connector between the splitter and
@@ -374,7 +381,7 @@ bool LocalRxBase::initialize(void)
   if (audioSampleRate() > 8000)
   {
     AudioDecimator *d2 = new AudioDecimator(2, coeff_16_8, coeff_16_8_taps);
-    prev_src->registerSink(d2, true);
+    prev_src->registerSink(profiled(d2, "Decimator16to8"), true);
     prev_src = d2;
   }
 #endif
@@ -390,13 +397,14 @@ bool LocalRxBase::initialize(void)
     //deemph_filt->setOutputGain(7.0f);
 
     DeemphasisFilter *deemph_filt = new DeemphasisFilter;
-    prev_src->registerSink(deemph_filt, true);
+    prev_src->registerSink(profiled(deemph_filt, "Deemphasis"), true);
     prev_src = deemph_filt;
   }
   
     // Create a splitter to distribute full bandwidth audio to all consumers
   fullband_splitter = new AudioSplitter;
-  prev_src->registerSink(fullband_splitter, true);
+  prev_src->registerSink(
+      profiled(fullband_splitter, "FullbandSplitter"), true);
   prev_src = fullband_splitter;
 
     // Create the configured squelch detector and initialize it
@@ -437,7 +445,7 @@ bool LocalRxBase::initialize(void)
                          sql_extended_hangtime_thresh);
 
   squelch_det->squelchOpen.connect(mem_fun(*this, &LocalRxBase::onSquelchOpen));
-  fullband_splitter->addSink(squelch_det, true);
+  fullband_splitter->addSink(profiled(squelch_det, "Squelch"), true);
 
   squelchOpen.connect(
       sigc::hide(sigc::mem_fun(*this, &LocalRxBase::publishSquelchState)));
@@ -468,7 +476,7 @@ bool LocalRxBase::initialize(void)
     coeff[46] = 0.39811024;
     AudioFsf *fsf = new AudioFsf(N, coeff);
     //prev_src->registerSink(fsf, true);
-    fullband_splitter->addSink(fsf, true);
+    fullband_splitter->addSink(profiled(fsf, "ObAfskFilter"), true);
     AudioSource *prev_src = fsf;
 
     AfskDemodulator *fsk_demod =
@@ -495,15 +503,43 @@ bool LocalRxBase::initialize(void)
     //cfg().getValue(name(), "IB_AFSK_CENTER_FQ", fc);
     unsigned shift = 1000;
     //cfg().getValue(name(), "IB_AFSK_SHIFT", shift);
+    string modulation("AFSK");
+    cfg().getValue(name(), "IB_AFSK_MODULATION", modulation);
+    if ((modulation != "AFSK") && (modulation != "GFSK"))
+    {
+      cerr << "*** ERROR: Illegal value for config variable " << name()
+           << "/IB_AFSK_MODULATION (" << modulation << "). Valid values "
+              "are AFSK and GFSK." << endl;
+      return false;
+    }
     unsigned baudrate = 1200;
-    //cfg().getValue(name(), "IB_AFSK_BAUDRATE", baudrate);
-
-    AfskDemodulator *fsk_demod =
-      new AfskDemodulator(fc - shift/2, fc + shift/2, baudrate);
-    fullband_splitter->addSink(fsk_demod, true);
-    AudioSource *prev_src = fsk_demod;
+    AudioSource *prev_src = 0;
+    if (modulation == "GFSK")
+    {
+      baudrate = 4800;
+      cfg().getValue(name(), "IB_AFSK_BAUDRATE", baudrate);
+      if ((baudrate == 0) || (3 * baudrate > INTERNAL_SAMPLE_RATE))
+      {
+        cerr << "*** ERROR: Config variable " << name()
+             << "/IB_AFSK_BAUDRATE out of range (" << baudrate
+             << "). Valid range is 1 to " << (INTERNAL_SAMPLE_RATE / 3)
+             << "." << endl;
+        return false;
+      }
+      FskDemodulator *fsk_demod = new FskDemodulator(baudrate);
+      fullband_splitter->addSink(profiled(fsk_demod, "IbFskDemod"), true);
+      prev_src = fsk_demod;
+    }
+    else
+    {
+      AfskDemodulator *fsk_demod =
+        new AfskDemodulator(fc - shift/2, fc + shift/2, baudrate);
+      fullband_splitter->addSink(profiled(fsk_demod, "IbAfskDemod"), true);
+      prev_src = fsk_demod;
+    }
 
     Synchronizer *sync = new Synchronizer(baudrate);
+    sync->setDescrambling(modulation == "GFSK");
     prev_src->registerSink(sync, true);
     prev_src = 0;
 
@@ -516,7 +552,7 @@ bool LocalRxBase::initialize(void)
 
     // Create a new audio splitter to handle tone detectors
   tone_dets = new AudioSplitter;
-  prev_src->registerSink(tone_dets, true);
+  prev_src->registerSink(profiled(tone_dets, "ToneDetSplitter"), true);
   prev_src = tone_dets;
 
     // Filter out the voice band, removing high- and subaudible frequencies,
@@ -526,13 +562,15 @@ bool LocalRxBase::initialize(void)
 #else
   AudioFilter *voiceband_filter = new AudioFilter("BpCh12/-0.1/300-3500");
 #endif
-  prev_src->registerSink(voiceband_filter, true);
+  prev_src->registerSink(
+      profiled(voiceband_filter, "VoicebandFilter"), true);
   prev_src = voiceband_filter;
 
     // Create an audio splitter to distribute the voiceband audio to all
     // other consumers
   AudioSplitter *voiceband_splitter = new AudioSplitter;
-  prev_src->registerSink(voiceband_splitter, true);
+  prev_src->registerSink(
+      profiled(voiceband_splitter, "VoicebandSplitter"), true);
   prev_src = voiceband_splitter;
 
     // Create the configured type of DTMF decoder and add it to the splitter
@@ -551,7 +589,7 @@ bool LocalRxBase::initialize(void)
         mem_fun(*this, &LocalRxBase::dtmfDigitActivated));
     dtmf_dec->digitDeactivated.connect(
         mem_fun(*this, &LocalRxBase::dtmfDigitDeactivated));
-    voiceband_splitter->addSink(dtmf_dec, true);
+    voiceband_splitter->addSink(profiled(dtmf_dec, "DtmfDecoder"), true);
 
     bool dtmf_muting = false;
     cfg().getValue(name(), "DTMF_MUTING", dtmf_muting);
@@ -576,20 +614,20 @@ bool LocalRxBase::initialize(void)
     }
     sel5_dec->sequenceDetected.connect(
         mem_fun(*this, &LocalRxBase::sel5Detected));
-    voiceband_splitter->addSink(sel5_dec, true);
+    voiceband_splitter->addSink(profiled(sel5_dec, "Sel5Decoder"), true);
   }
 
     // Create an audio valve to use as squelch and connect it to the splitter
   sql_valve = new AudioValve;
   sql_valve->setOpen(false);
-  prev_src->registerSink(sql_valve, true);
+  prev_src->registerSink(profiled(sql_valve, "SquelchValve"), true);
   prev_src = sql_valve;
 
     // Create the state detector
   AudioStreamStateDetector *state_det = new AudioStreamStateDetector;
   state_det->sigStreamStateChanged.connect(
             mem_fun(*this, &LocalRxBase::audioStreamStateChange));
-  prev_src->registerSink(state_det, true);
+  prev_src->registerSink(profiled(state_det, "StateDetector"), true);
   prev_src = state_det;
 
     // If we need a delay line (e.g. for DTMF muting and/or squelch tail
@@ -597,7 +635,7 @@ bool LocalRxBase::initialize(void)
   if (delay_line_len > 0)
   {
     delay = new AudioDelayLine(delay_line_len);
-    prev_src->registerSink(delay, true);
+    prev_src->registerSink(profiled(delay, "DelayLine"), true);
     prev_src = delay;
   }
 
@@ -612,14 +650,14 @@ bool LocalRxBase::initialize(void)
     limit->setAttack(2);
     limit->setDecay(20);
     limit->setOutputGain(1);
-    prev_src->registerSink(limit, true);
+    prev_src->registerSink(profiled(limit, "Limiter"), true);
     prev_src = limit;
   }
 
     // Clip audio to limit its amplitude
   AudioClipper *clipper = new AudioClipper;
   clipper->setClipLevel(0.98);
-  prev_src->registerSink(clipper, true);
+  prev_src->registerSink(profiled(clipper, "Clipper"), true);
   prev_src = clipper;
 
     // Remove high frequencies generated by the previous clipping
@@ -628,7 +666,8 @@ bool LocalRxBase::initialize(void)
 #else
   AudioFilter *splatter_filter = new AudioFilter("LpCh9/-0.05/3500");
 #endif
-  prev_src->registerSink(splatter_filter, true);
+  prev_src->registerSink(
+      profiled(splatter_filter, "SplatterFilter"), true);
   prev_src = splatter_filter;
   
     // Set the previous audio pipe object to handle audio distribution for
@@ -650,7 +689,7 @@ bool LocalRxBase::initialize(void)
     assert(calldet != 0);
     calldet->setPeakThresh(13);
     calldet->activated.connect(mem_fun(*this, &LocalRxBase::tone1750detected));
-    voiceband_splitter->addSink(calldet, true);
+    voiceband_splitter->addSink(profiled(calldet, "Tone1750Detector"), true);
     //cout << "### Enabling 1750Hz muting\n";
   }
 
@@ -740,7 +779,9 @@ bool LocalRxBase::addToneDetector(float fq, int bw, float thresh,
   det->setDetectToneFrequencyTolerancePercent(50.0f * bw / fq);
   det->detected.connect(sigc::mem_fun(*this, &LocalRxBase::onToneDetected));
   
-  tone_dets->addSink(det, true);
+  std::ostringstream ss;
+  ss << "ToneDetector" << fq;
+  tone_dets->addSink(profiled(det, ss.str()), true);
   
   return true;
 
@@ -1009,6 +1050,19 @@ void LocalRxBase::cfgUpdated(const std::string& section, const std::string& tag)
 } /* LocalRxBase::cfgUpdated */
 
 
+Async::AudioSink *LocalRxBase::profiled(Async::AudioSink *sink,
+                                        const std::string& stage)
+{
+  if (!audio_profiling)
+  {
+    return sink;
+  }
+  Async::AudioProbe *probe = new Async::AudioProbe(name() + ":" + stage);
+  probe->registerSink(sink, true);
+  return probe;
+} /* LocalRxBase::profiled */
+
+
 /*
  * This file has not been truncated
  */
@@ -282,6 +282,7 @@ class LocalRxBase : public Rx
     HdlcDeframer *              ib_afsk_deframer;
     bool                        audio_dev_keep_open;
     Async::AudioSplitter *      fullband_splitter;
+    bool                        audio_profiling;
 
     int audioRead(float *samples, int count);
     void dtmfDigitActivated(char digit);
@@ -298,6 +299,8 @@ class LocalRxBase : public Rx
     void rxReadyStateChanged(void);
     void publishSquelchState(void);
     void cfgUpdated(const std::string& section, const std::string& tag);
+    Async::AudioSink *profiled(Async::AudioSink *sink,
+                               const std::string& stage);
 
 };  /* class LocalRxBase */
 
@@ -74,7 +74,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <common.h>
 #include <HdlcFramer.h>
 #include <AfskModulator.h>
+#include <FskModulator.h>
 #include <AsyncAudioFsf.h>
+#include <AsyncAudioProbe.h>
 
 
 /****************************************************************************
@@ -251,7 +253,8 @@ LocalTx::LocalTx(Config& cfg, const string& name)
     fsk_mod(0), /*fsk_valve(0),*/ input_handler(0), ptt_ctrl(0),
     audio_valve(0), siglev_sine_gen(0), ptt_hangtimer(0), ptt(0),
     last_rx_id(Rx::ID_UNKNOWN), fsk_first_packet_transmitted(false),
-    hdlc_framer_ib(0), fsk_mod_ib(0), ctrl_pty(0), audio_dev_keep_open(false)
+    hdlc_framer_ib(0), fsk_mod_ib(0), ctrl_pty(0), audio_dev_keep_open(false),
+    audio_profiling(false)
 {
 
 } /* LocalTx::LocalTx */
@@ -435,6 +438,8 @@ bool LocalTx::initialize(void)
     return false;
   }
   
+  cfg.getValue(name(), "AUDIO_PROFILING", audio_profiling);
+
   AudioSource *prev_src = 0;
   
     // The input handler is where audio enters this TX object
@@ -469,7 +474,7 @@ bool LocalTx::initialize(void)
     */
 
     PreemphasisFilter *preemph = new PreemphasisFilter;
-    prev_src->registerSink(preemph, true);
+    prev_src->registerSink(profiled(preemph, "Preemphasis"), true);
     prev_src = preemph;
   }
 
@@ -484,13 +489,13 @@ bool LocalTx::initialize(void)
     limit->setAttack(2);
     limit->setDecay(20);
     limit->setOutputGain(1);
-    prev_src->registerSink(limit, true);
+    prev_src->registerSink(profiled(limit, "Limiter"), true);
     prev_src = limit;
   }
 
     // Clip audio to limit its amplitude
   AudioClipper *clipper = new AudioClipper;
-  prev_src->registerSink(clipper, true);
+  prev_src->registerSink(profiled(clipper, "Clipper"), true);
   prev_src = clipper;
   
 #if 0
@@ -512,7 +517,8 @@ bool LocalTx::initialize(void)
   AudioFilter *voiceband_filter =
     new AudioFilter("LpBu20/3500 x HpCh12/-0.05/300");
 #endif
-  prev_src->registerSink(voiceband_filter, true);
+  prev_src->registerSink(
+      profiled(voiceband_filter, "VoicebandFilter"), true);
   prev_src = voiceband_filter;
 
     // Create a valve so that we can control when to transmit audio
@@ -520,7 +526,7 @@ bool LocalTx::initialize(void)
   audio_valve = new AudioValve;
   audio_valve->setBlockWhenClosed(true);
   audio_valve->setOpen(true);
-  prev_src->registerSink(audio_valve, true);
+  prev_src->registerSink(profiled(audio_valve, "AudioValve"), true);
   prev_src = audio_valve;
   #endif
   
@@ -568,10 +574,11 @@ bool LocalTx::initialize(void)
 
     AudioFilter *voice_filter = new AudioFilter("LpCh10/-0.5/4500");
     voice_filter->setOutputGain(voice_gain);
-    prev_src->registerSink(voice_filter, true);
+    prev_src->registerSink(profiled(voice_filter, "ObAfskVoiceFilter"), true);
     prev_src = voice_filter;
     AudioFilter *voice_filter2 = new AudioFilter("LpCh10/-0.5/4500");
-    prev_src->registerSink(voice_filter2, true);
+    prev_src->registerSink(
+        profiled(voice_filter2, "ObAfskVoiceFilter2"), true);
     prev_src = voice_filter2;
 
       // Create a mixer so that we can mix other audio with the voice audio
@@ -629,8 +636,29 @@ bool LocalTx::initialize(void)
     //cfg.getValue(name(), "IB_AFSK_CENTER_FQ", fc);
     unsigned shift = 1000;
     //cfg.getValue(name(), "IB_AFSK_SHIFT", shift);
+    string modulation("AFSK");
+    cfg.getValue(name(), "IB_AFSK_MODULATION", modulation);
+    if ((modulation != "AFSK") && (modulation != "GFSK"))
+    {
+      cerr << "*** ERROR: Illegal value for config variable " << name()
+           << "/IB_AFSK_MODULATION (" << modulation << "). Valid values "
+              "are AFSK and GFSK." << endl;
+      return false;
+    }
     unsigned baudrate = 1200;
-    //cfg.getValue(name(), "IB_AFSK_BAUDRATE", baudrate);
+    if (modulation == "GFSK")
+    {
+      baudrate = 4800;
+      cfg.getValue(name(), "IB_AFSK_BAUDRATE", baudrate);
+      if ((baudrate == 0) || (3 * baudrate > INTERNAL_SAMPLE_RATE))
+      {
+        cerr << "*** ERROR: Config variable " << name()
+             << "/IB_AFSK_BAUDRATE out of range (" << baudrate
+             << "). Valid range is 1 to " << (INTERNAL_SAMPLE_RATE / 3)
+             << "." << endl;
+        return false;
+      }
+    }
     float afsk_level = -6;
     cfg.getValue(name(), "IB_AFSK_LEVEL", afsk_level);
     unsigned afsk_tx_delay = 100;
@@ -641,11 +669,22 @@ bool LocalTx::initialize(void)
     hdlc_framer_ib->setStartFlagCnt(
         static_cast<size_t>(ceil(afsk_tx_delay * baudrate / 8000.0)));
 
-      // Create the inband AFSK modulator
-    fsk_mod_ib = new AfskModulator(fc - shift / 2, fc + shift / 2, baudrate,
-                                afsk_level);
-    hdlc_framer_ib->sendBits.connect(
-        mem_fun(fsk_mod_ib, &AfskModulator::sendBits));
+      // Create the inband modulator
+    if (modulation == "GFSK")
+    {
+      FskModulator *gfsk_mod = new FskModulator(baudrate, afsk_level);
+      hdlc_framer_ib->sendBits.connect(
+          mem_fun(gfsk_mod, &FskModulator::sendBits));
+      fsk_mod_ib = gfsk_mod;
+    }
+    else
+    {
+      AfskModulator *afsk_mod = new AfskModulator(
+          fc - shift / 2, fc + shift / 2, baudrate, afsk_level);
+      hdlc_framer_ib->sendBits.connect(
+          mem_fun(afsk_mod, &AfskModulator::sendBits));
+      fsk_mod_ib = afsk_mod;
+    }
 
     AudioPacer *pacer = new AudioPacer(INTERNAL_SAMPLE_RATE, 256, 0);
     fsk_mod_ib->registerSink(pacer);
@@ -667,7 +706,7 @@ bool LocalTx::initialize(void)
   ptt_ctrl->transmitterStateChange.connect(mem_fun(*this, &LocalTx::transmit));
   ptt_ctrl->preTransmitterStateChange.connect(
       mem_fun(*this, &LocalTx::preTransmitterStateChange));
-  prev_src->registerSink(ptt_ctrl, true);
+  prev_src->registerSink(profiled(ptt_ctrl, "PttCtrl"), true);
   prev_src = ptt_ctrl;
 
   float master_gain = 0.0f;
@@ -675,7 +714,8 @@ bool LocalTx::initialize(void)
   {
     AudioAmp *master_gain_stage = new AudioAmp;
     master_gain_stage->setGain(master_gain);
-    prev_src->registerSink(master_gain_stage, true);
+    prev_src->registerSink(
+        profiled(master_gain_stage, "MasterGain"), true);
     prev_src = master_gain_stage;
   }
 
@@ -685,7 +725,7 @@ bool LocalTx::initialize(void)
       // Interpolate sample rate to 16kHz
     AudioInterpolator *i1 = new AudioInterpolator(2, coeff_16_8,
                                                   coeff_16_8_taps);
-    prev_src->registerSink(i1, true);
+    prev_src->registerSink(profiled(i1, "Interpolator8to16"), true);
     prev_src = i1;
   }
 #endif
@@ -700,12 +740,12 @@ bool LocalTx::initialize(void)
     AudioInterpolator *i2 = new AudioInterpolator(3, coeff_48_16,
                                                   coeff_48_16_taps);
 #endif
-    prev_src->registerSink(i2, true);
+    prev_src->registerSink(profiled(i2, "Interpolator16to48"), true);
     prev_src = i2;
   }
   
     // Finally connect the whole audio pipe to the audio device
-  prev_src->registerSink(audio_io, true);
+  prev_src->registerSink(profiled(audio_io, "AudioIO"), true);
 
   string ctrl_pty_name;
   if (cfg.getValue(name(), "CTRL_PTY", ctrl_pty_name))
@@ -1110,6 +1150,19 @@ void LocalTx::sendFskDtmf(const string &digits, unsigned duration)
 } /* LocalTx::sendFskDtmf */
 
 
+Async::AudioSink *LocalTx::profiled(Async::AudioSink *sink,
+                                    const std::string& stage)
+{
+  if (!audio_profiling)
+  {
+    return sink;
+  }
+  Async::AudioProbe *probe = new Async::AudioProbe(name() + ":" + stage);
+  probe->registerSink(sink, true);
+  return probe;
+} /* LocalTx::profiled */
+
+
 
 /*
  * This file has not been truncated
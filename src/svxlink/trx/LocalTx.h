@@ -82,6 +82,7 @@ class DtmfEncoder;
 class PttCtrl;
 class HdlcFramer;
 class AfskModulator;
+class FskModulator;
 
 
 /****************************************************************************
@@ -233,9 +234,10 @@ class LocalTx : public Tx
     char                    last_rx_id;
     bool                    fsk_first_packet_transmitted;
     HdlcFramer              *hdlc_framer_ib;
-    AfskModulator           *fsk_mod_ib;
+    Async::AudioSource      *fsk_mod_ib;
     RefCountingPty          *ctrl_pty;
     bool                    audio_dev_keep_open;
+    bool                    audio_profiling;
     
     void txTimeoutOccured(Async::Timer *t);
     bool setPtt(bool tx, bool with_hangtime=false);
@@ -245,6 +247,8 @@ class LocalTx : public Tx
     bool preTransmitterStateChange(bool do_transmit);
     void sendFskSiglev(char rxid, uint8_t siglev);
     void sendFskDtmf(const std::string &digits, unsigned duration);
+    Async::AudioSink *profiled(Async::AudioSink *sink,
+                               const std::string& stage);
 
 };  /* class LocalTx */
 
@@ -0,0 +1,386 @@
+/**
+@file	 RtlFile.cpp
+@brief   An RtlSdr backend that replays recorded IQ samples from a file
+@author  agent
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncApplication.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "RtlFile.h"
+
+
+
+/****************************************************************************
+ *
+ * Namespaces to use
+ *
+ ****************************************************************************/
+
+using namespace std;
+using namespace Async;
+
+
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+  // The pace timer interval, which is also the length of one block
+#define BLOCK_INTERVAL_MS     10
+
+  // If the pace has fallen this many blocks behind, restart pacing
+#define MAX_CATCH_UP_BLOCKS   50
+
+
+/****************************************************************************
+ *
+ * Local class definitions
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Prototypes
+ *
+ ****************************************************************************/
+
+static bool endsWith(const string &str, const string &suffix);
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+
+/****************************************************************************
+ *
+ * Local Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Public member functions
+ *
+ ****************************************************************************/
+
+bool RtlFile::parseFormat(const string &name, Format &fmt)
+{
+  if (name == "auto")
+  {
+    fmt = FORMAT_AUTO;
+  }
+  else if (name == "cu8")
+  {
+    fmt = FORMAT_CU8;
+  }
+  else if (name == "cf32")
+  {
+    fmt = FORMAT_CF32;
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+} /* RtlFile::parseFormat */
+
+
+RtlFile::RtlFile(const string &filename, Format fmt)
+  : filename(filename), fmt(fmt), is_ready(false), realtime(true),
+    loop(false), task_pending(false),
+    pace_timer(BLOCK_INTERVAL_MS, Timer::TYPE_PERIODIC, false),
+    blocks_fed(0)
+{
+  if (this->fmt == FORMAT_AUTO)
+  {
+    this->fmt = endsWith(filename, ".cf32") ? FORMAT_CF32 : FORMAT_CU8;
+  }
+
+  pace_timer.expired.connect(mem_fun(*this, &RtlFile::paceTimerExpired));
+
+  file.open(filename.c_str(), ios::in | ios::binary);
+  if (!file.is_open())
+  {
+    cerr << "*** ERROR: Could not open IQ file \"" << filename << "\": "
+         << strerror(errno) << endl;
+    return;
+  }
+
+    // Start feeding samples when the main loop is running so that the
+    // owner has a chance to connect to the signals first.
+  Application::app().runTask(mem_fun(*this, &RtlFile::start));
+} /* RtlFile::RtlFile */
+
+
+RtlFile::~RtlFile(void)
+{
+} /* RtlFile::~RtlFile */
+
+
+void RtlFile::setRealtime(bool enable)
+{
+  if (enable == realtime)
+  {
+    return;
+  }
+  realtime = enable;
+
+  if (!is_ready)
+  {
+    return;
+  }
+
+  if (realtime)
+  {
+    restartPacing();
+  }
+  else
+  {
+    pace_timer.setEnable(false);
+    scheduleFeed();
+  }
+} /* RtlFile::setRealtime */
+
+
+
+/****************************************************************************
+ *
+ * Protected member functions
+ *
+ ****************************************************************************/
+
+void RtlFile::handleSetSampleRate(uint32_t rate)
+{
+  if (is_ready && realtime)
+  {
+    restartPacing();
+  }
+} /* RtlFile::handleSetSampleRate */
+
+
+
+/****************************************************************************
+ *
+ * Private member functions
+ *
+ ****************************************************************************/
+
+void RtlFile::start(void)
+{
+  setReady(true);
+  if (realtime)
+  {
+    restartPacing();
+  }
+  else
+  {
+    scheduleFeed();
+  }
+} /* RtlFile::start */
+
+
+void RtlFile::setReady(bool ready)
+{
+  if (ready != is_ready)
+  {
+    is_ready = ready;
+    readyStateChanged();
+  }
+} /* RtlFile::setReady */
+
+
+/*
+ * @brief: Read one 10ms block from the file and feed it to the receivers
+ *
+ * Returns false when the end of the file has been reached and looping is
+ * disabled.
+ */
+bool RtlFile::feedBlock(void)
+{
+  const size_t samp_size = (fmt == FORMAT_CF32) ? sizeof(Sample) : 2;
+  const size_t samp_count = blockSize() / 2;
+  buf.resize(samp_count * samp_size);
+
+  file.read(&buf[0], buf.size());
+  size_t read_cnt = file.gcount() / samp_size;
+  if ((read_cnt == 0) && loop && file.eof())
+  {
+    file.clear();
+    file.seekg(0);
+    file.read(&buf[0], buf.size());
+    read_cnt = file.gcount() / samp_size;
+  }
+
+  if (read_cnt > 0)
+  {
+    ++blocks_fed;
+    if (fmt == FORMAT_CF32)
+    {
+      handleIq(reinterpret_cast<const Sample *>(&buf[0]), read_cnt);
+    }
+    else
+    {
+      handleIq(reinterpret_cast<const complex<uint8_t> *>(&buf[0]),
+               read_cnt);
+    }
+  }
+
+  if (read_cnt < samp_count)
+  {
+      // Nothing could be read even after rewinding if the file does not
+      // contain a single complete sample. Looping would then never end.
+    if (loop && (read_cnt > 0) && !file.bad())
+    {
+      file.clear();
+      file.seekg(0);
+      return true;
+    }
+    if (file.bad())
+    {
+      cerr << "*** ERROR: Read error on IQ file \"" << filename << "\"\n";
+    }
+    else if (loop)
+    {
+      cerr << "*** ERROR: The IQ file \"" << filename << "\" does not "
+              "contain any samples\n";
+    }
+    pace_timer.setEnable(false);
+    setReady(false);
+    endOfFile();
+    return false;
+  }
+
+  return true;
+} /* RtlFile::feedBlock */
+
+
+/*
+ * @brief: Feed one block and reschedule when running as fast as possible
+ *
+ * One block is fed per main loop iteration so that timers and file
+ * descriptors are still serviced while a file is replayed at full speed.
+ */
+void RtlFile::feedTask(void)
+{
+  task_pending = false;
+  if (realtime || !is_ready)
+  {
+    return;
+  }
+  if (feedBlock())
+  {
+    scheduleFeed();
+  }
+} /* RtlFile::feedTask */
+
+
+void RtlFile::scheduleFeed(void)
+{
+  if (!task_pending)
+  {
+    task_pending = true;
+    Application::app().runTask(mem_fun(*this, &RtlFile::feedTask));
+  }
+} /* RtlFile::scheduleFeed */
+
+
+void RtlFile::paceTimerExpired(Async::Timer *t)
+{
+  Clock::duration elapsed = Clock::now() - pace_start;
+  uint64_t due = 1 + chrono::duration_cast<chrono::milliseconds>(elapsed)
+                       .count() / BLOCK_INTERVAL_MS;
+  if (due > blocks_fed + MAX_CATCH_UP_BLOCKS)
+  {
+    cerr << "*** WARNING: IQ file replay of \"" << filename
+         << "\" fell behind. Restarting pacing.\n";
+    restartPacing();
+    return;
+  }
+  while (is_ready && realtime && (blocks_fed < due))
+  {
+    if (!feedBlock())
+    {
+      return;
+    }
+  }
+} /* RtlFile::paceTimerExpired */
+
+
+void RtlFile::restartPacing(void)
+{
+  blocks_fed = 0;
+  pace_start = Clock::now();
+  pace_timer.setEnable(false);
+  pace_timer.setEnable(true);
+  feedBlock();
+} /* RtlFile::restartPacing */
+
+
+static bool endsWith(const string &str, const string &suffix)
+{
+  return (str.size() >= suffix.size()) &&
+         (str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0);
+} /* endsWith */
+
+
+
+/*
+ * This file has not been truncated
+ */
@@ -0,0 +1,249 @@
+/**
+@file	 RtlFile.h
+@brief   An RtlSdr backend that replays recorded IQ samples from a file
+@author  agent
+@date	 2026-10-18
+
+\verbatim
+SvxLink - A Multi Purpose Voice Services System for Ham Radio Use
+Copyright (C) 2003-2022 Tobias Blomberg / SM0SVX
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+\endverbatim
+*/
+
+#ifndef RTL_FILE_INCLUDED
+#define RTL_FILE_INCLUDED
+
+
+/****************************************************************************
+ *
+ * System Includes
+ *
+ ****************************************************************************/
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <chrono>
+
+
+/****************************************************************************
+ *
+ * Project Includes
+ *
+ ****************************************************************************/
+
+#include <AsyncTimer.h>
+
+
+/****************************************************************************
+ *
+ * Local Includes
+ *
+ ****************************************************************************/
+
+#include "RtlSdr.h"
+
+
+/****************************************************************************
+ *
+ * Forward declarations
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Namespace
+ *
+ ****************************************************************************/
+
+//namespace MyNameSpace
+//{
+
+
+/****************************************************************************
+ *
+ * Forward declarations of classes inside of the declared namespace
+ *
+ ****************************************************************************/
+
+  
+
+/****************************************************************************
+ *
+ * Defines & typedefs
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Exported Global Variables
+ *
+ ****************************************************************************/
+
+
+
+/****************************************************************************
+ *
+ * Class definitions
+ *
+ ****************************************************************************/
+
+/**
+@brief	An RtlSdr backend that replays recorded IQ samples from a file
+@author agent
+@date   2026-10-18
+
+This class read raw IQ samples from a file and feed them into the receiver
+chain just like if they had been received from a real RTL dongle. This make
+it possible to reproduce receiver problems using a recorded capture and to
+benchmark the DDR chain without any hardware.
+
+Two file formats are supported. The "cu8" format is what rtl_sdr write,
+interleaved unsigned 8 bit I and Q values. The "cf32" format is interleaved
+32 bit native endian floating point I and Q values in the range -1 to 1, as
+written by for example GNU Radio. The file does not carry any information
+about the sample rate so the sample rate set on this object must match the
+sample rate that was used when the file was recorded.
+
+In realtime mode the samples are fed at the pace given by the sample rate.
+Otherwise the samples are fed as fast as the receiver chain can consume
+them, one block per main loop iteration, which is useful for benchmarking.
+Tuner settings like center frequency and gain are accepted but ignored.
+*/
+class RtlFile : public RtlSdr
+{
+  public:
+    /**
+     * @brief   The format of the samples in the file
+     */
+    typedef enum
+    {
+      FORMAT_AUTO,  ///< Select format from the file name extension
+      FORMAT_CU8,   ///< Interleaved unsigned 8 bit I/Q (rtl_sdr)
+      FORMAT_CF32   ///< Interleaved 32 bit float I/Q
+    } Format;
+
+    /**
+     * @brief   Parse a format name
+     * @param   name The format name ("auto", "cu8" or "cf32")
+     * @param   fmt Will be set to the parsed format on success
+     * @returns Returns \em true on success or \em false on unknown name
+     */
+    static bool parseFormat(const std::string &name, Format &fmt);
+
+    /**
+     * @brief 	Constructor
+     * @param   filename The path to the file to read IQ samples from
+     * @param   fmt The format of the samples in the file
+     */
+    explicit RtlFile(const std::string &filename, Format fmt=FORMAT_AUTO);
+  
+    /**
+     * @brief 	Destructor
+     */
+    virtual ~RtlFile(void);
+
+    /**
+     * @brief   Select if the samples should be fed in real time
+     * @param   enable Set to \em true to feed samples at the sample rate
+     *
+     * Realtime mode is the default.
+     */
+    void setRealtime(bool enable);
+
+    /**
+     * @brief   Select if the file should be replayed from the start at EOF
+     * @param   enable Set to \em true to loop the file
+     */
+    void setLoop(bool enable) { loop = enable; }
+
+    /**
+     * @brief   Get the format used to interpret the file
+     * @returns Returns the sample format
+     */
+    Format format(void) const { return fmt; }
+
+    /**
+     * @brief   Find out if the file is ready for reading
+     * @returns Returns \em true if the file is open and not at end of file
+     */
+    virtual bool isReady(void) const { return is_ready; }
+
+    /**
+     * @brief   Return a string which identifies the specific dongle
+     * @returns Returns the path to the IQ file
+     */
+    virtual const std::string displayName(void) const { return filename; }
+
+    /**
+     * @brief   A signal that is emitted when all samples have been read
+     *
+     * This signal is not emitted when looping is enabled.
+     */
+    sigc::signal<void> endOfFile;
+
+  protected:
+    virtual void handleSetTunerIfGain(uint16_t stage, int16_t gain) {}
+    virtual void handleSetCenterFq(uint32_t fq) {}
+    virtual void handleSetSampleRate(uint32_t rate);
+    virtual void handleSetGainMode(uint32_t mode) {}
+    virtual void handleSetGain(int32_t gain) {}
+    virtual void handleSetFqCorr(int corr) {}
+    virtual void handleEnableTestMode(bool enable) {}
+    virtual void handleEnableDigitalAgc(bool enable) {}
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    std::string             filename;
+    Format                  fmt;
+    std::ifstream           file;
+    std::vector<char>       buf;
+    bool                    is_ready;
+    bool                    realtime;
+    bool                    loop;
+    bool                    task_pending;
+    Async::Timer            pace_timer;
+    Clock::time_point       pace_start;
+    uint64_t                blocks_fed;
+
+    RtlFile(const RtlFile&) = delete;
+    RtlFile& operator=(const RtlFile&) = delete;
+    void start(void);
+    void setReady(bool ready);
+    bool feedBlock(void);
+    void feedTask(void);
+    void scheduleFeed(void);
+    void paceTimerExpired(Async::Timer *t);
+    void restartPacing(void);
+    
+};  /* class RtlFile */
+
+
+
+//} /* namespace */
+
+#endif /* RTL_FILE_INCLUDED */
+
+
+/*
+ * This file has not been truncated
+ */
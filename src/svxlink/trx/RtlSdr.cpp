@@ -34,6 +34,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include <cstring>
 #include <cstdlib>
+#include <cmath>
 #include <iterator>
 #include <algorithm>
 #include <iostream>
@@ -280,15 +281,12 @@ void RtlSdr::handleIq(const complex<uint8_t> *samples, int samp_count)
 {
   //cout << "RtlSdr::handleIq: samp_count=" << samp_count << endl;
 
+  bool distorted = false;
   vector<Sample> iq;
   iq.reserve(samp_count);
   for (int idx=0; idx<samp_count; ++idx)
   {
-    if ((dist_print_cnt == 0) &&
-        ((samples[idx].real() == 255) || (samples[idx].imag() == 255)))
-    {
-      dist_print_cnt = samp_rate;
-    }
+    distorted |= ((samples[idx].real() == 255) || (samples[idx].imag() == 255));
     float i = samples[idx].real();
     i = i / 127.5f - 1.0f;
     float q = samples[idx].imag();
@@ -296,21 +294,24 @@ void RtlSdr::handleIq(const complex<uint8_t> *samples, int samp_count)
     iq.push_back(complex<float>(i, q));
   }
 
-  if (dist_print_cnt > 0)
+  updateDistPrint(distorted, samp_count);
+
+  iqReceived(iq);
+} /* RtlSdr::handleIq */
+
+
+void RtlSdr::handleIq(const Sample *samples, int samp_count)
+{
+  bool distorted = false;
+  for (int idx=0; idx<samp_count; ++idx)
   {
-    if (dist_print_cnt == static_cast<int>(samp_rate))
-    {
-      cout << "*** WARNING: Distortion detected on Rtl tuner "
-           << displayName() << ". Lower the RF gain\n";
-    }
-    dist_print_cnt -= samp_count;
-    if (dist_print_cnt < 0)
-    {
-      dist_print_cnt = 0;
-    }
+    distorted |= ((fabsf(samples[idx].real()) >= 1.0f) ||
+                  (fabsf(samples[idx].imag()) >= 1.0f));
   }
 
-  iqReceived(iq);
+  updateDistPrint(distorted, samp_count);
+
+  iqReceived(vector<Sample>(samples, samples + samp_count));
 } /* RtlSdr::handleIq */
 
 
@@ -361,6 +362,29 @@ void RtlSdr::updateSettings(void)
 } /* RtlSdr::updateSettings */
 
 
+void RtlSdr::updateDistPrint(bool distorted, int samp_count)
+{
+  if ((dist_print_cnt == 0) && distorted)
+  {
+    dist_print_cnt = samp_rate;
+  }
+
+  if (dist_print_cnt > 0)
+  {
+    if (dist_print_cnt == static_cast<int>(samp_rate))
+    {
+      cout << "*** WARNING: Distortion detected on Rtl tuner "
+           << displayName() << ". Lower the RF gain\n";
+    }
+    dist_print_cnt -= samp_count;
+    if (dist_print_cnt < 0)
+    {
+      dist_print_cnt = 0;
+    }
+  }
+} /* RtlSdr::updateDistPrint */
+
+
 #if 0
 int RtlSdr::dataReceived(Async::TcpConnection *con, void *buf, int count)
 {
@@ -380,6 +380,13 @@ class RtlSdr : public sigc::trackable
      */
     void handleIq(const std::complex<uint8_t> *samples, int samp_count);
 
+    /**
+     * @brief   Handle IQ data already converted to floating point
+     * @param   samples An array of complex float IQ samples in the range -1 to 1
+     * @param   samp_count The number of complex samples
+     */
+    void handleIq(const Sample *samples, int samp_count);
+
     /**
      * @brief   Update all current settings in the dongle
      */
@@ -419,6 +426,7 @@ class RtlSdr : public sigc::trackable
 
     RtlSdr(const RtlSdr&);
     RtlSdr& operator=(const RtlSdr&);
+    void updateDistPrint(bool distorted, int samp_count);
     
 };  /* class RtlSdr */
 
@@ -39,7 +39,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sstream>
 #include <iostream>
 #include <cassert>
-#include <queue>
+#include <memory>
+#include <atomic>
 #include <unistd.h>
 #include <stdio.h>
 #include <errno.h>
@@ -51,7 +52,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  ****************************************************************************/
 
-#include <AsyncFdWatch.h>
+#include <AsyncThreadChannel.h>
 
 
 /****************************************************************************
@@ -93,177 +94,134 @@ class RtlUsb::SampleBuffer : public sigc::trackable
 {
   public:
     SampleBuffer(uint32_t block_size)
-      : block_size(block_size), buf(0), buf_cnt(0), watch(0)
+      : channel(QUEUE_SIZE), block_size(block_size), generation(0),
+        writer_closed(false), overrun_cnt(0), wr_block_size(0),
+        wr_generation(0), buf_cnt(0)
     {
-      pthread_mutex_init(&mutex, NULL);
-
-      buf = new uint8_t[block_size];
-
-      int r = pipe(signal_pipe);
-      assert (r == 0);
-      watch = new FdWatch(signal_pipe[0], FdWatch::FD_WATCH_RD);
-      watch->activity.connect(
-          sigc::hide(mem_fun(*this, &SampleBuffer::removeSamples)));
-    }
-
-    ~SampleBuffer(void)
-    {
-      pthread_mutex_destroy(&mutex);
-      delete [] buf;
-      buf = 0;
-      while (!block_queue.empty())
-      {
-        delete [] block_queue.front();
-        block_queue.pop();
-      }
-      closeReadPipe();
-      closeWritePipe();
-    }
-
-    void closeWritePipe(void)
-    {
-      if (signal_pipe[1] != -1)
-      {
-        if (close(signal_pipe[1]) != 0)
-        {
-          cerr << "*** ERROR: Close error on write end of SampleBuffer pipe: "
-               << strerror(errno) << "\n";
-        }
-        signal_pipe[1] = -1;
-      }
+      assert(channel.initOk());
+      channel.messagesAvailable.connect(
+          mem_fun(*this, &SampleBuffer::removeSamples));
     }
 
-    void closeReadPipe(void)
+      // Must be called by the reader thread when it will not add any
+      // more samples
+    void closeWriter(void)
     {
-      delete watch;
-      watch = 0;
-      if (signal_pipe[0] != -1)
-      {
-        if (close(signal_pipe[0]) != 0)
-        {
-          cerr << "*** ERROR: Close error on read end of SampleBuffer pipe: "
-               << strerror(errno) << endl;
-        }
-        signal_pipe[0] = -1;
-      }
+      writer_closed = true;
+      channel.notify();
     }
 
     void setBlockSize(uint32_t new_block_size)
     {
-      lockMutex();
       block_size = new_block_size;
-      while (!block_queue.empty())
-      {
-        delete block_queue.front();
-        block_queue.pop();
-      }
-      delete [] buf;
-      buf = new uint8_t[block_size];
-      buf_cnt = 0;
-      unlockMutex();
+      clear();
     }
 
     void clear(void)
     {
-      lockMutex();
-      while (!block_queue.empty())
+        // Blocks tagged with an older generation, including the one
+        // currently being filled in by the reader thread, are thrown away
+      ++generation;
+      Block block;
+      while (channel.receive(block))
       {
-        delete [] block_queue.front();
-        block_queue.pop();
       }
-      buf_cnt = 0;
-      unlockMutex();
     }
 
+      // Called by the reader thread
     bool addSamples(const unsigned char *samples, uint32_t len)
     {
-      lockMutex();
+      unsigned gen = generation.load(std::memory_order_relaxed);
+      if ((gen != wr_generation) || !buf)
+      {
+        wr_generation = gen;
+        if (!buf || (block_size != wr_block_size))
+        {
+          wr_block_size = block_size;
+          buf.reset(new uint8_t[wr_block_size]);
+        }
+        buf_cnt = 0;
+      }
+
       while (len > 0)
       {
-        uint32_t cpy_cnt = min(block_size - buf_cnt, len);
-        memcpy(buf + buf_cnt, samples, cpy_cnt);
+        uint32_t cpy_cnt = min(wr_block_size - buf_cnt, len);
+        memcpy(buf.get() + buf_cnt, samples, cpy_cnt);
         buf_cnt += cpy_cnt;
         len -= cpy_cnt;
         samples += cpy_cnt;
-        if (buf_cnt >= block_size)
+        if (buf_cnt >= wr_block_size)
         {
-          block_queue.push(buf);
-          buf = new uint8_t[block_size];
-          buf_cnt = 0;
-          unlockMutex();
-          if (write(signal_pipe[1], "S", 1) != 1)
+          Block block;
+          block.samples = std::move(buf);
+          block.size = wr_block_size;
+          block.generation = wr_generation;
+          if (channel.post(std::move(block)))
+          {
+            buf.reset(new uint8_t[wr_block_size]);
+          }
+          else
           {
-            return false;
+              // The main thread is not keeping up. Drop the block and
+              // reuse its buffer.
+            buf = std::move(block.samples);
+            ++overrun_cnt;
           }
-          lockMutex();
+          buf_cnt = 0;
         }
       }
-      unlockMutex();
       return true;
     }
 
     sigc::signal<void, complex<uint8_t>*, int> handleIq;
-    sigc::signal<void> writePipeClosed;
+    sigc::signal<void> writerClosed;
 
   private:
-    uint32_t          block_size;
-    uint8_t           *buf;
-    uint32_t          buf_cnt;
-    pthread_mutex_t   mutex;
-    int               signal_pipe[2];
-    FdWatch           *watch;
-    queue<uint8_t*>   block_queue;
-
-    void lockMutex(void)
-    {
-      int r = pthread_mutex_lock(&mutex);
-      if (r != 0)
-      {
-        cerr << "*** ERROR: pthread_mutex_lock failed: "
-             << strerror(r) << endl;
-        abort();
-      }
-    }
+    static const size_t QUEUE_SIZE = 256;
 
-    void unlockMutex(void)
+    struct Block
     {
-      int r = pthread_mutex_unlock(&mutex);
-      if (r != 0)
-      {
-        cerr << "*** ERROR: pthread_mutex_unlock failed: "
-             << strerror(r) << endl;
-        abort();
-      }
-    }
+      std::unique_ptr<uint8_t[]>  samples;
+      uint32_t                    size        = 0;
+      unsigned                    generation  = 0;
+    };
+
+    ThreadChannel<Block>        channel;
+    std::atomic<uint32_t>       block_size;
+    std::atomic<unsigned>       generation;
+    std::atomic<bool>           writer_closed;
+    std::atomic<unsigned>       overrun_cnt;
+
+      // Only used by the reader thread
+    std::unique_ptr<uint8_t[]>  buf;
+    uint32_t                    wr_block_size;
+    unsigned                    wr_generation;
+    uint32_t                    buf_cnt;
 
     void removeSamples(void)
     {
-      char read_buf[64];
-      int r = read(signal_pipe[0], read_buf, sizeof(read_buf));
-      if (r == 0)
+      Block block;
+      while (channel.receive(block))
       {
-        closeReadPipe();
-        writePipeClosed();
-        return;
+        if (block.generation == generation.load(std::memory_order_relaxed))
+        {
+          complex<uint8_t> *samples =
+            reinterpret_cast<complex<uint8_t>*>(block.samples.get());
+          handleIq(samples, block.size / 2);
+        }
       }
-      else if (r <= 0)
+
+      unsigned overruns = overrun_cnt.exchange(0);
+      if (overruns > 0)
       {
-        cerr << "*** ERROR: Error while reading SampleBuffer signal pipe\n";
-        abort();
+        cerr << "*** WARNING: " << overruns << " RTL sample block(s) lost "
+                "since the main thread was not keeping up\n";
       }
 
-      lockMutex();
-      while (!block_queue.empty())
+      if (writer_closed.exchange(false))
       {
-        uint8_t *buf = block_queue.front();
-        block_queue.pop();
-        unlockMutex();
-        complex<uint8_t> *samples = reinterpret_cast<complex<uint8_t>*>(buf);
-        handleIq(samples, block_size / 2);
-        delete [] buf;
-        lockMutex();
+        writerClosed();
       }
-      unlockMutex();
     }
 };
 
@@ -583,7 +541,7 @@ void RtlUsb::rtlReader(void)
   {
     cerr << "*** WARNING: Failed to read samples from RTL dongle\n";
   }
-  sample_buf->closeWritePipe();
+  sample_buf->closeWriter();
 } /* RtlUsb::rtlReader */
 
 
@@ -671,7 +629,7 @@ void RtlUsb::initializeDongle(void)
 
   sample_buf = new SampleBuffer(blockSize());
   sample_buf->handleIq.connect(mem_fun(*this, &RtlUsb::handleIq));
-  sample_buf->writePipeClosed.connect(mem_fun(*this, &RtlUsb::verboseClose));
+  sample_buf->writerClosed.connect(mem_fun(*this, &RtlUsb::verboseClose));
 
   r = pthread_create(&rtl_reader_thread, NULL, startRtlReader, this);
   if (r != 0)
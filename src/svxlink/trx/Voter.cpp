@@ -40,6 +40,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <cstdlib>
 #include <utility>
 #include <list>
+#include <deque>
+#include <vector>
+#include <chrono>
 #include <sigc++/bind.h>
 #include <sys/time.h>
 #include <json/json.h>
@@ -55,6 +58,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <AsyncAudioFifo.h>
 #include <AsyncAudioSelector.h>
 #include <AsyncAudioValve.h>
+#include <AsyncAudioPassthrough.h>
 #include <AsyncPty.h>
 #include <AsyncPtyStreamBuf.h>
 
@@ -87,6 +91,7 @@ using namespace Async;
  *
  ****************************************************************************/
 
+typedef std::chrono::steady_clock EnvClock;
 
 
 /****************************************************************************
@@ -95,6 +100,84 @@ using namespace Async;
  *
  ****************************************************************************/
 
+/**
+ * @brief A pass-through audio pipe that keep a short envelope history
+ *
+ * The envelope is stored as the mean absolute sample value over bins of a
+ * fixed number of samples. The history is used by the voter to estimate the
+ * difference in path delay between two receivers by cross correlating their
+ * envelopes.
+ */
+class EnvelopeTap : public AudioPassthrough
+{
+  public:
+    EnvelopeTap(void) : bin_samples(1), max_bins(0), bin_sum(0.0f), bin_cnt(0)
+    {
+    }
+
+    void setHistoryLength(unsigned bin_samples, unsigned max_bins)
+    {
+      this->bin_samples = std::max(bin_samples, 1U);
+      this->max_bins = max_bins;
+      clear();
+    }
+
+    void clear(void)
+    {
+      hist.clear();
+      bin_sum = 0.0f;
+      bin_cnt = 0;
+    }
+
+      // Copy the history, newest bin first, as it would look at the given
+      // time. Bins that should have been received by then but have not
+      // yet arrived are set to -1.
+    void history(std::vector<float> &env, EnvClock::time_point now) const
+    {
+      env.clear();
+      if (hist.empty())
+      {
+        return;
+      }
+      long long elapsed_us = std::chrono::duration_cast<
+        std::chrono::microseconds>(now - last_write).count();
+      long long elapsed = std::max(elapsed_us, 0LL) * INTERNAL_SAMPLE_RATE
+                          / 1000000 + bin_cnt;
+      env.assign(elapsed / bin_samples, -1.0f);
+      env.insert(env.end(), hist.rbegin(), hist.rend());
+    }
+
+    virtual int writeSamples(const float *samples, int count)
+    {
+      int ret = AudioPassthrough::writeSamples(samples, count);
+      for (int i=0; i<ret; ++i)
+      {
+        bin_sum += std::fabs(samples[i]);
+        if (++bin_cnt == bin_samples)
+        {
+          hist.push_back(bin_sum / bin_cnt);
+          if (hist.size() > max_bins)
+          {
+            hist.pop_front();
+          }
+          bin_sum = 0.0f;
+          bin_cnt = 0;
+        }
+      }
+      last_write = EnvClock::now();
+      return ret;
+    }
+
+  private:
+    unsigned            bin_samples;
+    unsigned            max_bins;
+    std::deque<float>   hist;
+    float               bin_sum;
+    unsigned            bin_cnt;
+    EnvClock::time_point last_write;
+};
+
+
 /**
  * @brief A class that represents a satellite receiver
  * 
@@ -105,11 +188,16 @@ using namespace Async;
  * its "subscribers".
  * When the receiver close its squelch, the squelch signal is delayed until
  * all audio has been flushed.
+ * If receiver alignment is enabled (max_skew_ms > 0), an envelope history is
+ * also kept so that the voter can estimate the path delay difference to
+ * another receiver. The buffer is then made max_skew_ms longer to make room
+ * for the alignment.
  */
 class Voter::SatRx : public AudioSource, public sigc::trackable
 {
   public:
-    SatRx(Config &cfg, const string &rx_name, int id, int fifo_length_ms)
+    SatRx(Config &cfg, const string &rx_name, int id, int fifo_length_ms,
+          int max_skew_ms)
       : rx_id(id), rx(0), fifo(0), sql_open(false), enabled(true),
         mute_state(Rx::MUTE_ALL), // FIXME: Set this from the Rx object
         sql_open_delay(0)
@@ -131,6 +219,17 @@ class Voter::SatRx : public AudioSource, public sigc::trackable
 
 	AudioSource *prev_src = rx;
 
+	if (max_skew_ms > 0)
+	{
+          unsigned bin_samples = ALIGN_BIN_MS * INTERNAL_SAMPLE_RATE / 1000;
+          unsigned max_bins =
+            (ALIGN_CORR_WINDOW_MS + 2 * max_skew_ms) / ALIGN_BIN_MS;
+          env_tap.setHistoryLength(bin_samples, max_bins);
+	  prev_src->registerSink(&env_tap);
+	  prev_src = &env_tap;
+	  fifo_length_ms += max_skew_ms;
+	}
+
 	if (fifo_length_ms > 0)
 	{
 	  fifo = new AudioFifo(fifo_length_ms * INTERNAL_SAMPLE_RATE / 1000);
@@ -216,6 +315,7 @@ class Voter::SatRx : public AudioSource, public sigc::trackable
         }
 	dtmf_buf.clear();
 	selcall_buf.clear();
+        env_tap.clear();
       }
     }
     
@@ -255,6 +355,24 @@ class Voter::SatRx : public AudioSource, public sigc::trackable
       sql_open_delay = new_sql_open_delay;
     }
     unsigned sqlOpenDelay(void) const { return sql_open_delay; }
+
+    unsigned bufferedSamples(void) const
+    {
+      return (fifo != 0) ? fifo->samplesInFifo(true) : 0;
+    }
+
+    void discardBufferedSamples(unsigned count)
+    {
+      if (fifo != 0)
+      {
+        fifo->discardSamples(count);
+      }
+    }
+
+    void envelopeHistory(std::vector<float> &env, EnvClock::time_point now)
+    {
+      env_tap.history(env, now);
+    }
     
     signal<void, char, int>  	dtmfDigitDetected;
     signal<void, string>  	selcallSequenceDetected;
@@ -279,6 +397,7 @@ class Voter::SatRx : public AudioSource, public sigc::trackable
     Rx		  *rx;
     AudioFifo 	  *fifo;
     AudioValve	  valve;
+    EnvelopeTap   env_tap;
     DtmfBuf   	  dtmf_buf;
     SelcallBuf	  selcall_buf;
     bool      	  sql_open;
@@ -379,7 +498,7 @@ class Voter::SatRx : public AudioSource, public sigc::trackable
 Voter::Voter(Config &cfg, const std::string& name)
   : Rx(cfg, name), cfg(cfg), m_verbose(true), selector(0),
     sm(Macho::State<Top>(this)), is_processing_event(false), command_pty(0),
-    m_print_sat_squelch(false)
+    m_print_sat_squelch(false), m_buffer_length(0), m_max_rx_skew(0)
 {
 } /* Voter::Voter */
 
@@ -455,6 +574,16 @@ bool Voter::initialize(void)
 	 << MAX_BUFFER_LENGTH << ".\n";
     return false;
   }
+  m_buffer_length = buffer_length;
+
+  cfg.getValue(name(), "MAX_RX_SKEW", m_max_rx_skew);
+  if (m_max_rx_skew > MAX_MAX_RX_SKEW)
+  {
+    cerr << "*** ERROR: Config variable " << name() << "/MAX_RX_SKEW out "
+            "of range (" << m_max_rx_skew << "). Valid range is 0 to "
+	 << MAX_MAX_RX_SKEW << ".\n";
+    return false;
+  }
   
   float hysteresis = 100.0f * (DEFAULT_HYSTERESIS - 1.0f);
   cfg.getValue(name(), "HYSTERESIS", hysteresis);
@@ -534,7 +663,8 @@ bool Voter::initialize(void)
     if (!rx_name.empty())
     {
       cout << "\tAdding receiver: " << rx_name << endl;
-      SatRx *srx = new SatRx(cfg, rx_name, rxs.size() + 1, buffer_length);
+      SatRx *srx = new SatRx(cfg, rx_name, rxs.size() + 1, buffer_length,
+                             m_max_rx_skew);
       srx->setSqlOpenDelay(sql_open_delay);
       srx->squelchOpen.connect(mem_fun(*this, &Voter::satSquelchOpen));
       srx->signalLevelUpdated.connect(
@@ -741,6 +871,138 @@ void Voter::printSquelchState(void)
 } /* Voter::printSquelchState */
 
 
+void Voter::trimRxBuffer(SatRx *srx)
+{
+  if (m_max_rx_skew == 0)
+  {
+    return;
+  }
+
+    // The receiver buffer is longer than BUFFER_LENGTH to make room for
+    // alignment. Throw away the oldest audio so that the latency through
+    // the voter does not grow with the maximum skew.
+  unsigned keep = m_buffer_length * INTERNAL_SAMPLE_RATE / 1000;
+  unsigned buffered = srx->bufferedSamples();
+  if (buffered > keep)
+  {
+    srx->discardBufferedSamples(buffered - keep);
+  }
+} /* Voter::trimRxBuffer */
+
+
+void Voter::alignRxSwitch(SatRx *from_srx, SatRx *to_srx)
+{
+  if (m_max_rx_skew == 0)
+  {
+    return;
+  }
+
+    // If no reliable estimate can be made, assume that the path delay is
+    // the same for both receivers
+  int skew_bins = 0;
+  float corr = 0.0f;
+  bool estimated = estimateRxSkew(from_srx, to_srx, skew_bins, corr);
+
+    // The audio output from the old receiver ends at a point in time that
+    // lies bufferedSamples() back from its newest sample. Discard audio
+    // from the new receiver so that its output continue from that same
+    // point, compensating for the difference in path delay.
+  const int bin_samples = ALIGN_BIN_MS * INTERNAL_SAMPLE_RATE / 1000;
+  int buffered = static_cast<int>(to_srx->bufferedSamples());
+  int target = static_cast<int>(from_srx->bufferedSamples())
+               - skew_bins * bin_samples;
+  target = std::min(std::max(target, 0), buffered);
+  to_srx->discardBufferedSamples(buffered - target);
+
+  if (m_verbose)
+  {
+    cout << name() << ": Aligning \"" << to_srx->name() << "\" to \""
+         << from_srx->name() << "\": ";
+    if (estimated)
+    {
+      cout << "skew=" << (skew_bins * static_cast<int>(ALIGN_BIN_MS))
+           << "ms (correlation "
+           << static_cast<int>(std::roundf(100.0f * corr)) << "%)" << endl;
+    }
+    else
+    {
+      cout << "No reliable skew estimate" << endl;
+    }
+  }
+} /* Voter::alignRxSwitch */
+
+
+bool Voter::estimateRxSkew(SatRx *from_srx, SatRx *to_srx, int &skew_bins,
+                           float &corr)
+{
+  EnvClock::time_point now = EnvClock::now();
+  std::vector<float> from_env;
+  std::vector<float> to_env;
+  from_srx->envelopeHistory(from_env, now);
+  to_srx->envelopeHistory(to_env, now);
+
+    // A positive skew means that the audio from to_srx arrive later than
+    // the audio from from_srx. The envelope of from_srx at age a is then
+    // compared to the envelope of to_srx at age a - skew.
+  const int max_lag = m_max_rx_skew / ALIGN_BIN_MS;
+  const int min_window = ALIGN_MIN_CORR_WINDOW_MS / ALIGN_BIN_MS;
+  int window = ALIGN_CORR_WINDOW_MS / ALIGN_BIN_MS;
+  window = std::min(window, static_cast<int>(from_env.size()) - max_lag);
+  window = std::min(window, static_cast<int>(to_env.size()) - 2 * max_lag);
+  if (window < min_window)
+  {
+    return false;
+  }
+
+  float best_corr = -1.0f;
+  int best_lag = 0;
+  for (int lag=-max_lag; lag<=max_lag; ++lag)
+  {
+    double sx = 0.0, sy = 0.0, sxx = 0.0, syy = 0.0, sxy = 0.0;
+    int n = 0;
+    for (int a=max_lag; a<max_lag+window; ++a)
+    {
+      float x = from_env[a];
+      float y = to_env[a - lag];
+      if ((x < 0.0f) || (y < 0.0f))
+      {
+        continue;
+      }
+      sx += x;
+      sy += y;
+      sxx += x * x;
+      syy += y * y;
+      sxy += x * y;
+      ++n;
+    }
+    if (n < min_window)
+    {
+      continue;
+    }
+    double cov = sxy - sx * sy / n;
+    double var = (sxx - sx * sx / n) * (syy - sy * sy / n);
+    if (var <= 0.0)
+    {
+      continue;
+    }
+    float c = static_cast<float>(cov / std::sqrt(var));
+    if (c > best_corr)
+    {
+      best_corr = c;
+      best_lag = lag;
+    }
+  }
+
+  corr = best_corr;
+  if (best_corr < ALIGN_MIN_CORRELATION)
+  {
+    return false;
+  }
+  skew_bins = best_lag;
+  return true;
+} /* Voter::estimateRxSkew */
+
+
 Voter::SatRx *Voter::findBestRx(void) const
 {
   float best_rx_siglev = 0.0f;
@@ -1054,6 +1316,7 @@ void Voter::ActiveRxSelected::init(SatRx *srx)
   {
     voter().muteAllBut(srx, MUTE_CONTENT);
   }
+  voter().trimRxBuffer(srx);
   setState<SquelchOpen>();
 } /* Voter::ActiveRxSelected::init */
 
@@ -1325,6 +1588,7 @@ void Voter::SwitchActiveRx::timerExpired(void)
 	   << "\" (" << switch_to_srx_siglev << ")\n";
     }
     
+    voter().alignRxSwitch(activeSrx(), switch_to_srx);
     changeActiveSrx(switch_to_srx);
     box().switch_to_srx = 0;
   }
@@ -199,6 +199,12 @@ class Voter : public Rx
     static CONSTEXPR unsigned MIN_REVOTE_INTERVAL            = 100;
     static CONSTEXPR unsigned MAX_REVOTE_INTERVAL            = 60000;
     static CONSTEXPR unsigned MAX_RX_SWITCH_DELAY            = 3000;
+    static CONSTEXPR unsigned MAX_MAX_RX_SKEW                = 1000;
+
+    static CONSTEXPR unsigned ALIGN_BIN_MS                   = 2;
+    static CONSTEXPR unsigned ALIGN_CORR_WINDOW_MS           = 200;
+    static CONSTEXPR unsigned ALIGN_MIN_CORR_WINDOW_MS       = 80;
+    static CONSTEXPR float    ALIGN_MIN_CORRELATION          = 0.5f;
 
     class SatRx;
 
@@ -414,6 +420,8 @@ class Voter : public Rx
     Async::Pty            *command_pty;
     std::string           command_buf;
     bool                  m_print_sat_squelch;
+    unsigned              m_buffer_length;
+    unsigned              m_max_rx_skew;
 
     void dispatchEvent(Macho::IEvent<Top> *event);
     void satSquelchOpen(bool is_open, SatRx *rx);
@@ -424,6 +432,10 @@ class Voter : public Rx
     void resetAll(void);
     void printSquelchState(void);
     SatRx *findBestRx(void) const;
+    void trimRxBuffer(SatRx *srx);
+    void alignRxSwitch(SatRx *from_srx, SatRx *to_srx);
+    bool estimateRxSkew(SatRx *from_srx, SatRx *to_srx, int &skew_bins,
+                        float &corr);
     void onCommandPtyInput(const void *buf, size_t count);
     void handlePtyCommand(const std::string &full_command);
     void setRxEnabled(const std::string &rx_name, bool do_enable,
@@ -57,6 +57,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "WbRxRtlSdr.h"
 #include "RtlTcp.h"
+#include "RtlFile.h"
 #ifdef HAS_RTLSDR_SUPPORT
 #include "RtlUsb.h"
 #endif
@@ -154,6 +155,39 @@ WbRxRtlSdr::WbRxRtlSdr(Async::Config &cfg, const string &name)
     //cout << "###   PORT        = " << tcp_port << endl;
     rtl = new RtlTcp(remote_host, tcp_port);
   }
+  else if (rtl_type == "RtlFile")
+  {
+    string filename;
+    if (!cfg.getValue(name, "FILE", filename) || filename.empty())
+    {
+      cerr << "*** ERROR: Config variable " << name << "/FILE not set\n";
+      exit(1);
+    }
+    string format_str = "auto";
+    cfg.getValue(name, "FILE_FORMAT", format_str);
+    RtlFile::Format format;
+    if (!RtlFile::parseFormat(format_str, format))
+    {
+      cerr << "*** ERROR: Unknown IQ file format \"" << format_str
+           << "\" specified in " << name << "/FILE_FORMAT\n";
+      exit(1);
+    }
+    string center_fq_str;
+    if (!cfg.getValue(name, "CENTER_FQ", center_fq_str))
+    {
+      cerr << "*** ERROR: Config variable " << name << "/CENTER_FQ must be "
+              "set to the center frequency of the IQ file\n";
+      exit(1);
+    }
+    bool realtime = true;
+    cfg.getValue(name, "REALTIME", realtime);
+    bool loop = false;
+    cfg.getValue(name, "LOOP", loop);
+    RtlFile *rtl_file = new RtlFile(filename, format);
+    rtl_file->setRealtime(realtime);
+    rtl_file->setLoop(loop);
+    rtl = rtl_file;
+  }
 #ifdef HAS_RTLSDR_SUPPORT
   else if (rtl_type == "RtlUsb")
   {